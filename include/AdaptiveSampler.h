@@ -0,0 +1,71 @@
+#pragma once
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * Decides how often the BME280 is sampled and when readings are published.
+ *
+ * Sampling: a change counts as rapid when a channel moved by more than its
+ * dead-band since the previous sample and at more than its rate threshold
+ * per minute. Rapid change drops the interval straight back to
+ * BME280_SAMPLE_INTERVAL; every calm sample doubles it, up to
+ * BME280_SLOW_INTERVAL.
+ *
+ * Publishing: a reading is published when any channel is a dead-band away
+ * from the last published value, or when SENSOR_HEARTBEAT_INTERVAL has
+ * passed without a publish.
+ *
+ * Each sensor of the SensorRegistry is tracked on its own. Called from the
+ * sensor task only; the counters may be read from anywhere.
+ */
+class AdaptiveSampler {
+public:
+    static AdaptiveSampler& getInstance() {
+        static AdaptiveSampler instance;
+        return instance;
+    }
+
+    // Takes a new reading and returns the interval until the next one (ms)
+    uint32_t onSample(uint8_t sensor, float temperature, float humidity, float pressure);
+
+    bool shouldPublish(uint8_t sensor, float temperature, float humidity, float pressure);
+    void onPublished(uint8_t sensor, float temperature, float humidity, float pressure);
+
+    uint32_t getInterval(uint8_t sensor = 0) const;
+
+    // Counters over all sensors. Samples saved are relative to sampling
+    // every BME280_SAMPLE_INTERVAL; publishes saved are readings held back
+    // by shouldPublish() because nothing changed.
+    uint32_t getSamples() const { return samples; }
+    uint32_t getSamplesSaved() const;
+    uint32_t getPublishes() const { return publishes; }
+    uint32_t getPublishesSaved() const { return publishesSkipped; }
+
+private:
+    AdaptiveSampler();
+    AdaptiveSampler(const AdaptiveSampler&) = delete;
+    AdaptiveSampler& operator=(const AdaptiveSampler&) = delete;
+
+    static const float DEADBAND[3];
+    static const float RATE_PER_MINUTE[3];
+
+    struct Track {
+        uint32_t interval;
+        uint32_t startTime;
+        uint32_t lastSampleTime;
+        uint32_t samples;
+        float lastSample[3];
+        bool haveSample;
+
+        uint32_t lastPublishTime;
+        float lastPublished[3];
+        bool havePublished;
+    };
+
+    Track tracks[SENSOR_MAX_COUNT];
+
+    volatile uint32_t samples;
+    volatile uint32_t publishes;
+    volatile uint32_t publishesSkipped;
+};
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <stdint.h>
+#include "bme280_defs.h"
+
+/**
+ * BME280 compensation formulas (datasheet section 4.2.3 and appendix 8).
+ *
+ * Compensator<int32_t> is the integer path (32-bit, except for the 64-bit
+ * pressure formula) and Compensator<float> the floating point one; the
+ * variant is picked at compile time. t_fine, which temperature compensation
+ * produces and pressure and humidity consume, lives in a Context owned by
+ * the caller, so the functions are reentrant and several sensors can be
+ * compensated side by side.
+ * Temperature has to be compensated first.
+ *
+ * Units:
+ *   int32_t  temperature 0.01 degC, pressure 1/256 Pa, humidity 1/1024 %RH
+ *   float    temperature degC,      pressure Pa, humidity %RH
+ */
+namespace BME280Compensation {
+
+struct Context {
+    int32_t tFine;
+};
+
+template <typename T>
+struct Compensator;
+
+template <>
+struct Compensator<int32_t> {
+    static int32_t temperature(const bme280_calib_data& calib, int32_t adcT, Context& ctx) {
+        int32_t var1 = ((((adcT >> 3) - ((int32_t)calib.dig_t1 << 1))) *
+                        ((int32_t)calib.dig_t2)) >> 11;
+        int32_t var2 = (((((adcT >> 4) - ((int32_t)calib.dig_t1)) *
+                          ((adcT >> 4) - ((int32_t)calib.dig_t1))) >> 12) *
+                        ((int32_t)calib.dig_t3)) >> 14;
+        ctx.tFine = var1 + var2;
+        return (ctx.tFine * 5 + 128) >> 8;
+    }
+
+    // The datasheet's 64-bit formula: the 32-bit one is cheaper but only
+    // resolves whole pascals. Returns 0 for a corrupt calibration (division
+    // by zero).
+    static int32_t pressure(const bme280_calib_data& calib, int32_t adcP, const Context& ctx) {
+        int64_t var1 = ((int64_t)ctx.tFine) - 128000;
+        int64_t var2 = var1 * var1 * (int64_t)calib.dig_p6;
+        var2 = var2 + ((var1 * (int64_t)calib.dig_p5) << 17);
+        var2 = var2 + (((int64_t)calib.dig_p4) << 35);
+        var1 = ((var1 * var1 * (int64_t)calib.dig_p3) >> 8) + ((var1 * (int64_t)calib.dig_p2) << 12);
+        var1 = (((((int64_t)1) << 47) + var1)) * ((int64_t)calib.dig_p1) >> 33;
+        if (var1 == 0) {
+            return 0;
+        }
+
+        int64_t p = 1048576 - adcP;
+        p = (((p << 31) - var2) * 3125) / var1;
+        var1 = (((int64_t)calib.dig_p9) * (p >> 13) * (p >> 13)) >> 25;
+        var2 = (((int64_t)calib.dig_p8) * p) >> 19;
+        return (int32_t)(((p + var1 + var2) >> 8) + (((int64_t)calib.dig_p7) << 4));
+    }
+
+    static int32_t humidity(const bme280_calib_data& calib, int32_t adcH, const Context& ctx) {
+        int32_t v = ctx.tFine - ((int32_t)76800);
+        v = (((((adcH << 14) - (((int32_t)calib.dig_h4) << 20) -
+                (((int32_t)calib.dig_h5) * v)) + ((int32_t)16384)) >> 15) *
+             (((((((v * ((int32_t)calib.dig_h6)) >> 10) *
+                  (((v * ((int32_t)calib.dig_h3)) >> 11) + ((int32_t)32768))) >> 10) +
+                ((int32_t)2097152)) * ((int32_t)calib.dig_h2) + 8192) >> 14));
+        v = v - (((((v >> 15) * (v >> 15)) >> 7) * ((int32_t)calib.dig_h1)) >> 4);
+        v = v < 0 ? 0 : v;
+        v = v > 419430400 ? 419430400 : v;
+        return v >> 12;
+    }
+
+    static float celsius(int32_t t) { return t / 100.0f; }
+    static float hectopascal(int32_t p) { return p / 25600.0f; }
+    static float percent(int32_t h) { return h / 1024.0f; }
+};
+
+template <>
+struct Compensator<float> {
+    static float temperature(const bme280_calib_data& calib, int32_t adcT, Context& ctx) {
+        float var1 = ((float)adcT / 16384.0f - (float)calib.dig_t1 / 1024.0f) * (float)calib.dig_t2;
+        float var2 = (float)adcT / 131072.0f - (float)calib.dig_t1 / 8192.0f;
+        var2 = var2 * var2 * (float)calib.dig_t3;
+        ctx.tFine = (int32_t)(var1 + var2);
+        return (var1 + var2) / 5120.0f;
+    }
+
+    // Returns 0 for a corrupt calibration (division by zero)
+    static float pressure(const bme280_calib_data& calib, int32_t adcP, const Context& ctx) {
+        float var1 = (float)ctx.tFine / 2.0f - 64000.0f;
+        float var2 = var1 * var1 * (float)calib.dig_p6 / 32768.0f;
+        var2 = var2 + var1 * (float)calib.dig_p5 * 2.0f;
+        var2 = var2 / 4.0f + (float)calib.dig_p4 * 65536.0f;
+        var1 = ((float)calib.dig_p3 * var1 * var1 / 524288.0f + (float)calib.dig_p2 * var1) / 524288.0f;
+        var1 = (1.0f + var1 / 32768.0f) * (float)calib.dig_p1;
+        if (var1 == 0.0f) {
+            return 0.0f;
+        }
+
+        float p = 1048576.0f - (float)adcP;
+        p = (p - var2 / 4096.0f) * 6250.0f / var1;
+        var1 = (float)calib.dig_p9 * p * p / 2147483648.0f;
+        var2 = p * (float)calib.dig_p8 / 32768.0f;
+        return p + (var1 + var2 + (float)calib.dig_p7) / 16.0f;
+    }
+
+    static float humidity(const bme280_calib_data& calib, int32_t adcH, const Context& ctx) {
+        float h = (float)ctx.tFine - 76800.0f;
+        h = ((float)adcH - ((float)calib.dig_h4 * 64.0f + (float)calib.dig_h5 / 16384.0f * h)) *
+            ((float)calib.dig_h2 / 65536.0f *
+             (1.0f + (float)calib.dig_h6 / 67108864.0f * h *
+                         (1.0f + (float)calib.dig_h3 / 67108864.0f * h)));
+        h = h * (1.0f - (float)calib.dig_h1 * h / 524288.0f);
+        if (h > 100.0f) return 100.0f;
+        if (h < 0.0f) return 0.0f;
+        return h;
+    }
+
+    static float celsius(float t) { return t; }
+    static float hectopascal(float p) { return p / 100.0f; }
+    static float percent(float h) { return h; }
+};
+
+} // namespace BME280Compensation
@@ -15,6 +15,8 @@
  #include <esp_task_wdt.h>
  #include <esp_core_dump.h>
  #include <esp_system.h>
+ #include <esp_timer.h>
+ #include "BME280Compensation.h"
  
  // BME280 I2C Address (default)
  #define BME280_I2C_ADDR_PRIM          UINT8_C(0x76)
@@ -47,31 +49,57 @@
  constexpr float BME280_PRES_MIN = 300.0f;    // Minimum pressure in hPa
  constexpr float BME280_PRES_MAX = 1100.0f;   // Maximum pressure in hPa
  
+ // Compensation arithmetic, selected with BME280_FIXED_POINT in config.h
+ #if BME280_FIXED_POINT
+ typedef BME280Compensation::Compensator<int32_t> BME280Compensator;
+ #else
+ typedef BME280Compensation::Compensator<float> BME280Compensator;
+ #endif
+ 
  class BME280Handler {
      public:
-         BME280Handler();
+         explicit BME280Handler(uint8_t address = BME280_I2C_ADDR_PRIM);
          bool init();
-         bool takeMeasurement();
+         uint8_t getAddress() const { return deviceAddress; }
+         bool takeMeasurement();  // Blocking single conversion
+         
+         // Timer-paced sampling. The timers only notify the sampling task,
+         // which passes the notification value to handleEvents(); all I2C
+         // traffic stays in that task. Several sensors can share one task by
+         // giving each its own eventShift; handleEvents() takes the whole
+         // notification value and looks at its own bits only.
+         static constexpr uint32_t EVENT_START = 0x01;  // Time for a new conversion
+         static constexpr uint32_t EVENT_READY = 0x02;  // Conversion should be done
+         static constexpr uint8_t EVENT_BITS = 2;
+         bool startSampling(TaskHandle_t task, uint32_t intervalMs, uint8_t eventShift = 0);
+         void stopSampling();
+         void setSampleInterval(uint32_t intervalMs);  // Takes effect from now
+         bool handleEvents(uint32_t events);  // True when a new sample was read
+         uint32_t getMeasurementTimeUs() const { return measurementTimeUs; }
+         
+         // Oversampling factors (1, 2, 4, 8, 16) and IIR coefficient (0, 2,
+         // 4, 8, 16). Call between conversions.
+         bool setAcquisition(uint8_t tempOversampling, uint8_t presOversampling,
+                             uint8_t humOversampling, uint8_t iirCoefficient);
+         
+
          float getTemperature() const { return temperature; }
          float getHumidity() const { return humidity; }
          float getPressure() const { return pressure; }
          bool isWorking() const { return sensorWorking; }
          
      private:
-         // I2C communication helper methods
-         int8_t i2cRead(uint8_t reg_addr, uint8_t *reg_data, uint32_t len, void *intf_ptr);
-         int8_t i2cWrite(uint8_t reg_addr, const uint8_t *reg_data, uint32_t len, void *intf_ptr);
-         bool initI2C();
-         bool tryAddress(uint8_t address);
-         
          // Calibration and measurement methods
          bool readCalibrationData();
          void processRawMeasurements(uint8_t* buffer);
-         float compensateTemperature(int32_t adc_T);
-         float compensatePressure(int32_t adc_P);
-         float compensateHumidity(int32_t adc_H);
          bool validateReadings(float temp, float hum, float pres);
-         void setupSensorSettings();
+         
+         // Forced-mode conversion
+         static uint32_t maxMeasurementTimeUs(uint8_t osrsT, uint8_t osrsP, uint8_t osrsH);
+         bool startConversion();
+         int8_t readConversion();  // 1 = sample read, 0 = still measuring, -1 = error
+         static void timerCallback(void* arg);
+         static void readyTimerCallback(void* arg);
          
          // Sensor state
          uint8_t deviceAddress;
@@ -83,6 +111,16 @@
          bool sensorValid;
          unsigned long lastReadTime;
          
+         // Sampling engine
+         uint8_t ctrlMeas;              // Oversampling bits, mode bits clear
+         uint32_t measurementTimeUs;    // Datasheet maximum for ctrlMeas/ctrl_hum
+         esp_timer_handle_t sampleTimer;
+         esp_timer_handle_t readyTimer;
+         TaskHandle_t samplingTask;
+         uint8_t eventShift;
+         uint32_t sampleIntervalMs;
+         uint8_t readyRetries;
+         
          // Calibration data - using the struct from the BME280 library
          struct bme280_calib_data calibData;
          
@@ -12,6 +12,8 @@ class BabelSensor {
         bool init();
         bool login(const char* username, const char* password);
         float getRemoteTemperature();
+        // millis() of the last successful reading; 0 before the first one
+        unsigned long getLastReadingTime() const { return lastUpdate; }
         bool isAuthenticated() const { return !authToken.isEmpty(); }
         
         // New methods for working with stored credentials
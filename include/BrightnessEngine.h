@@ -0,0 +1,31 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+
+/**
+ * Drives the display OE pin from a dedicated LEDC channel.
+ *
+ * Brightness is given in percent (1-100) and mapped through a gamma table so
+ * equal steps look equal to the eye. Fades are executed by the LEDC fade
+ * hardware, so a day/night transition costs no CPU once it has been started.
+ */
+class BrightnessEngine {
+public:
+    BrightnessEngine();
+
+    bool begin();
+    void setLevel(uint8_t percent);
+    void fadeTo(uint8_t percent, uint32_t durationMs);
+    uint8_t getLevel() const { return level.load(); }
+
+    // OE duty for a brightness percentage (active low, 0 = fully on)
+    static uint16_t dutyForPercent(uint8_t percent);
+
+private:
+    static const uint16_t GAMMA_TABLE[101];
+
+    bool initialized;
+    bool fadeAvailable;
+    std::atomic<uint8_t> level;
+};
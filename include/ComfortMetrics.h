@@ -0,0 +1,77 @@
+#pragma once
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include "config.h"
+
+/**
+ * Comfort values derived from each sensor's filtered readings: dew point,
+ * absolute humidity, heat index and pressure reduced to sea level.
+ *
+ * The math avoids the libm transcendentals. Saturation vapour pressure
+ * (Magnus, over water) comes from a 1 degC table interpolated linearly, and
+ * the dew point is the same table searched backwards. The heat index follows
+ * the NOAA algorithm: Steadman's simple formula, and the Rothfusz regression
+ * with its corrections once that reaches 80 degF. The sea-level reduction
+ * is the hypsometric formula with exp() replaced by a short series (the
+ * exponent stays below 0.6 up to 5000 m).
+ *
+ * update() is called from the sensor task with every sample; the values are
+ * only recomputed when an input moved by at least one hundredth or the
+ * altitude changed. get() may be called from any task.
+ */
+class ComfortMetrics {
+public:
+    struct Values {
+        float dewPoint;             // degC
+        float absoluteHumidity;     // g/m3
+        float heatIndex;            // degC
+        float seaLevelPressure;     // hPa
+    };
+
+    static constexpr int16_t MIN_ALTITUDE = -500;
+    static constexpr int16_t MAX_ALTITUDE = 5000;
+
+    static ComfortMetrics& getInstance() {
+        static ComfortMetrics instance;
+        return instance;
+    }
+
+    // Station altitude in metres for the sea-level reduction
+    void setAltitude(int16_t meters);
+    int16_t getAltitude() const { return altitude; }
+
+    // Returns true when the values of the sensor were recomputed
+    bool update(uint8_t sensor, float temperature, float humidity, float pressure);
+
+    // False for an unknown sensor or one without a reading
+    bool get(uint8_t sensor, Values& values) const;
+
+    uint32_t getComputed() const { return computed; }
+    uint32_t getSkipped() const { return skipped; }  // Samples with unchanged inputs
+
+    // The formulas, degC / %RH / hPa / m in
+    static float saturationPressure(float temperature);
+    static float dewPoint(float temperature, float humidity);
+    static float absoluteHumidity(float temperature, float humidity);
+    static float heatIndex(float temperature, float humidity);
+    static float seaLevelPressure(float pressure, float temperature, float altitude);
+
+private:
+    ComfortMetrics();
+    ComfortMetrics(const ComfortMetrics&) = delete;
+    ComfortMetrics& operator=(const ComfortMetrics&) = delete;
+
+    mutable portMUX_TYPE lock;
+    volatile int16_t altitude;
+    volatile uint32_t altitudeGeneration;
+
+    // Inputs in hundredths as last computed, per sensor
+    int32_t inputs[SENSOR_MAX_COUNT][3];
+    uint32_t inputGeneration[SENSOR_MAX_COUNT];
+    bool valid[SENSOR_MAX_COUNT];
+    Values values[SENSOR_MAX_COUNT];
+
+    volatile uint32_t computed;
+    volatile uint32_t skipped;
+};
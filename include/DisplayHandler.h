@@ -8,9 +8,14 @@
 #endif
 
 #include <Arduino.h>
+#include <atomic>
 #include <ShiftRegister74HC595.h>
 #include <esp_task_wdt.h>
+#include <esp_timer.h>
 #include "GlobalState.h"
+#include "BrightnessEngine.h"
+#include "SegmentFont.h"
+#include "DisplayPlaylist.h"
 
 /* Define indices for each character */
 // Alphabetic characters (0-16)
@@ -106,36 +111,108 @@ class DisplayHandler {
         static constexpr uint8_t MAX_MUTEX_ATTEMPTS = 5;
         static constexpr TickType_t MUTEX_TIMEOUT = pdMS_TO_TICKS(100);
         static constexpr TickType_t MUTEX_WAIT = pdMS_TO_TICKS(50);
+
+        // Longest message accepted by showMessage(), in display positions
+        static constexpr uint16_t MESSAGE_MAX_LENGTH = 64;
     
-        // Display buffers
-        uint8_t displayBuffer[DISPLAY_COUNT];
-        uint8_t dpBuffer[DISPLAY_COUNT];
-    
-        // Add MODE_DURATIONS as static member
-        static const unsigned long MODE_DURATIONS[6];
+        // Published segment frame: byte i holds the raw segment pattern of
+        // digit i (decimal point already applied). Producers replace the whole
+        // word in one store, so the render path never sees a torn frame and
+        // never has to wait for a lock.
+        std::atomic<uint32_t> pendingFrame;
     
         // Existing private members
         ShiftRegister74HC595<4> sr;
-        SemaphoreHandle_t displayMutex;
-        bool displayValid;
-        DisplayMode currentMode;
-        unsigned long modeStartTime;
-        unsigned long lastUpdate;
-        uint8_t currentBrightness;
+        SemaphoreHandle_t displayMutex;  // Guards displayPreferences and message writers
+        std::atomic<bool> displayValid;
+        std::atomic<DisplayMode> currentMode;
+        std::atomic<uint8_t> currentSensor;  // SensorRegistry index for sensor modes
+        std::atomic<unsigned long> modeStartTime;
+        std::atomic<uint32_t> modeDuration;
+        BrightnessEngine brightness;
         DisplayPreferences displayPreferences;
+
+        // Last frame shifted out to the 74HC595 chain. Only the task holding
+        // latchBusy touches these; a new frame is latched when it differs.
+        std::atomic_flag latchBusy = ATOMIC_FLAG_INIT;
+        uint32_t latchedFrame;
+        bool frameLatched;
+        uint32_t framesRendered;    // Display task refreshes
+        uint32_t framesLatched;
+        uint32_t subframesLatched;  // Written by the subframe timer
+
+        // Per-digit brightness: each refresh cycle is split into
+        // DISPLAY_SUBFRAME_COUNT subframes and a digit is only latched on for
+        // as many of them as its level allows. The subframe timer only runs
+        // while at least one digit is dimmed.
+        std::atomic<uint8_t> digitSubframes[DISPLAY_COUNT];
+        esp_timer_handle_t subframeTimer;
+        std::atomic<bool> subframeTimerRunning;
+        uint8_t subframeIndex;
+
+        // Scrolling message: the text is rendered once into a strip of segment
+        // bytes followed by a blank gap, and the scroll timer slides a
+        // DISPLAY_COUNT-wide window over it. Two strips let a new message be
+        // built while the timer is still reading the current one.
+        struct MessageStrip {
+            uint8_t segments[MESSAGE_MAX_LENGTH + DISPLAY_COUNT];
+            uint16_t steps;  // Window positions per pass, 1 for static text
+        };
+        MessageStrip messageStrips[2];
+        std::atomic<uint8_t> activeStrip;
+        std::atomic<bool> messageActive;
+        std::atomic<uint32_t> messageTicksLeft;
+        uint16_t scrollPosition;
+        DisplayMode messageReturnMode;
+        esp_timer_handle_t scrollTimer;
+
+        // Rotation schedule. setDisplayPreferences() compiles a new playlist
+        // into the inactive slot and then flips activePlaylist. Readers take
+        // no lock: snapshotPlaylist() copies the active slot and retries if
+        // its sequence number moved, which only happens when two saves in a
+        // row reach the slot it had picked. The number is odd while a slot
+        // is being compiled.
+        DisplayPlaylist playlists[2];
+        std::atomic<uint32_t> playlistSeq[2];
+        std::atomic<uint8_t> activePlaylist;
+        std::atomic<uint8_t> playlistIndex;
+        // Copy of displayPreferences.useSensorhub for the lock-free rotation
+        std::atomic<bool> sensorhubEnabled;
+
+        // Event-driven refresh: the display task sleeps in waitForChange()
+        // until the next deadline, or until wake() notifies it early.
+        std::atomic<TaskHandle_t> taskHandle;
+        uint32_t wakeups;
+        uint32_t notifiedWakeups;
     
         // Add private method declarations
         void updateDisplay();
+        bool latchFrame(uint32_t frame);
+        bool shiftOut(uint32_t frame);
+        void latchSubframe();
+        static void subframeCallback(void* arg);
+        void advanceMessage();
+        bool isConditionMet(const PlaylistEntry& entry) const;
+        void snapshotPlaylist(DisplayPlaylist& copy) const;
+        uint32_t msUntilNextChange() const;
+        bool colonPhase() const;
+        static void scrollCallback(void* arg);
     
     public:
         DisplayHandler();
         bool init();
         void setDigit(uint8_t position, uint8_t value, bool dp = false);
+        void showFrame(uint32_t frame);  // Packed frame from SegmentFont
+        void showText(const char* text) { showFrame(SegmentFont::renderText(text)); }
         void update();
         void setMode(DisplayMode mode);
         void nextMode();
         void clear();
-        bool setBrightness(uint8_t brightness);
+        bool setBrightness(uint8_t level);
+        void fadeBrightness(uint8_t level);  // Over BRIGHTNESS_FADE_MS
+        void fadeBrightness(uint8_t level, uint32_t durationMs);
+        void setDigitBrightness(uint8_t position, uint8_t percent);
+        uint8_t getBrightness() const { return brightness.getLevel(); }
         
         // Add public method declarations
         void showTime(int hours, int minutes);
@@ -144,12 +221,33 @@ class DisplayHandler {
         void showHumidity(float humidity);
         void showPressure(float pressure);
         void showRemoteTemp(float temp);
+        void showDewPoint(float dewPoint);
+        void showAbsoluteHumidity(float absoluteHumidity);
+        void showHeatIndex(float heatIndex);
+        void showSeaLevelPressure(float pressure);
+        bool showMessage(const char* text);
+        void cancelMessage();
+        bool isMessageActive() const { return messageActive.load(); }
         void test();
     
         // Existing public methods
-        DisplayMode getCurrentMode() const { return currentMode; }
+        DisplayMode getCurrentMode() const { return currentMode.load(); }
+        uint8_t getCurrentSensor() const { return currentSensor.load(); }
         void setDisplayPreferences(const DisplayPreferences& prefs);
         const DisplayPreferences& getDisplayPreferences() const { return displayPreferences; }
         void applyNightModeBrightness(int currentHour);
         bool isMutexValid() const { return displayMutex != nullptr; }
+
+        // Refresh statistics: frames composed vs. frames actually shifted out
+        // by the display task; per-digit dimming latches are counted apart
+        uint32_t getFramesRendered() const { return framesRendered; }
+        uint32_t getFramesLatched() const { return framesLatched; }
+        uint32_t getSubframesLatched() const { return subframesLatched; }
+
+        // Display task scheduling
+        void setTaskHandle(TaskHandle_t handle) { taskHandle.store(handle); }
+        void wake();
+        void waitForChange();
+        uint32_t getWakeups() const { return wakeups; }
+        uint32_t getNotifiedWakeups() const { return notifiedWakeups; }
     };
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <Arduino.h>
+#include "SystemDefinitions.h"
+
+// When a playlist entry may be shown
+enum class PlaylistCondition : uint8_t {
+    ALWAYS = 0,
+    CLOCK = 1,      // Local time is available
+    SENSOR = 2,     // BME280 is working and its data is fresh
+    REMOTE = 3      // Sensorhub is enabled and its last reading is under DISPLAY_DATA_MAX_AGE old
+};
+
+// One compiled schedule slot (4 bytes)
+struct PlaylistEntry {
+    uint8_t mode;           // DisplayMode
+    uint8_t condition : 4;  // PlaylistCondition
+    uint8_t sensor : 4;     // SensorRegistry index for sensor modes
+    uint16_t durationMs;
+};
+
+/**
+ * Display rotation compiled from a textual playlist such as
+ *
+ *   "time:8,date:2,temp:2,hum:2,pres:2,remote:3"
+ *
+ * Each entry is mode:seconds[:condition]. Without a condition the mode's
+ * natural one is used (time/date need the clock, the sensor modes the local
+ * sensor, remote the sensorhub). Sensor modes are temp, hum, pres and the
+ * derived dew, abshum, heat and slp; they show sensor 0 unless another one
+ * is picked with an index, e.g. "temp@1:2". An empty playlist selects the built-in
+ * default rotation. Invalid entries are dropped at compile time and
+ * compile() returns false; if nothing valid remains the default is used.
+ */
+class DisplayPlaylist {
+public:
+    static constexpr uint8_t MAX_ENTRIES = 12;
+
+    DisplayPlaylist();
+
+    bool compile(const String& spec);
+    void loadDefaults();
+    String toString() const;
+
+    uint8_t size() const { return count; }
+    const PlaylistEntry& entry(uint8_t index) const { return entries[index]; }
+    uint16_t durationFor(DisplayMode mode) const;
+
+private:
+    PlaylistEntry entries[MAX_ENTRIES];
+    uint8_t count;
+
+    static bool parseMode(const String& name, DisplayMode& mode, uint8_t& sensor);
+    static bool parseCondition(const String& name, PlaylistCondition& condition);
+    static PlaylistCondition defaultCondition(DisplayMode mode);
+};
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <lwip/dns.h>
+
+/**
+ * dns_gethostbyname() run on the lwIP thread, which owns the resolver's
+ * state: the raw API must not be called from another task. The caller
+ * waits only for the lookup to be started, never for the answer.
+ *
+ * Returns ERR_OK with address filled in for an address or a cached name,
+ * ERR_INPROGRESS when found will be called (on the lwIP thread) later,
+ * and another error when the lookup could not be started.
+ */
+err_t dnsLookup(const char* hostname, ip_addr_t* address, dns_found_callback found, void* arg);
@@ -5,7 +5,6 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
 #include <WiFiClientSecure.h>
-#include <PubSubClient.h>
 
 // Forward declaration instead of including the header
 class DisplayHandler;  // Add this line
@@ -26,7 +25,13 @@ public:
     float getHumidity() const { return sensorData.humidity; }
     float getPressure() const { return sensorData.pressure; }
     float getRemoteTemperature() const { return sensorData.remoteTemperature; }
+    // False until the first reading arrives and once the last one is older
+    // than maxAgeMs
+    bool isRemoteFresh(uint32_t maxAgeMs) const {
+        return sensorData.remoteValid && millis() - sensorData.remoteUpdate < maxAgeMs;
+    }
     bool isBMEWorking() const { return systemStatus.bmeWorking; }
+    uint32_t getSensorUpdateTime() const { return sensorData.lastUpdate; }
     DisplayHandler* getDisplay() { return display; }
     SemaphoreHandle_t getMutex() const { return mutex; }
 
@@ -34,15 +39,14 @@ public:
     void setBMEWorking(bool status) { systemStatus.bmeWorking = status; }
     void setMutex(SemaphoreHandle_t newMutex) { mutex = newMutex; }
     
-    void updateSensorData(float temp, float hum, float pres) {
-        sensorData.temperature = temp;
-        sensorData.humidity = hum;
-        sensorData.pressure = pres;
-        sensorData.lastUpdate = millis();
-    }
+    // Also records the reading in SensorHistory and HistoryLog
+    void updateSensorData(float temp, float hum, float pres);
 
-    void setRemoteTemperature(float temp) { 
-        sensorData.remoteTemperature = temp; 
+    // receivedAt is the millis() of the sensorhub reading, not of this call
+    void setRemoteTemperature(float temp, uint32_t receivedAt) {
+        sensorData.remoteTemperature = temp;
+        sensorData.remoteUpdate = receivedAt;
+        sensorData.remoteValid = true;
     }
 
     void setDisplay(DisplayHandler* newDisplay) { 
@@ -60,6 +64,8 @@ private:
         float humidity;
         float pressure;
         float remoteTemperature;
+        uint32_t remoteUpdate;
+        bool remoteValid;
         uint32_t lastUpdate;
     };
 
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <Arduino.h>
+#include <SPIFFS.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <functional>
+#include "config.h"
+
+/**
+ * Sensor history persisted on SPIFFS as an append-only binary log.
+ *
+ * Readings are averaged over HISTORY_LOG_INTERVAL and stored as records in
+ * 256-byte pages, the SPIFFS page size. A page starts with a header holding
+ * the absolute time and values of its first record; the following records
+ * are 8-byte deltas (seconds, then int16 per channel in hundredths). A
+ * delta that does not fit simply starts a new page.
+ *
+ * Pages are appended whole to segment files /history/<id>.bin of up to
+ * HISTORY_SEGMENT_PAGES pages. Nothing is ever rewritten: when the segment
+ * limit or the free space runs out, the oldest segment file is deleted, so
+ * flash wear is spread by SPIFFS and no index file is updated on every write.
+ * The page being filled lives in RTC memory and survives watchdog and
+ * software resets.
+ *
+ * The seek index (first timestamp per segment) is rebuilt at boot from the
+ * page headers; within a segment pages are found by binary search on their
+ * header timestamps, so a time range is located with a few small reads.
+ */
+class HistoryLog {
+public:
+    static constexpr size_t PAGE_SIZE = 256;
+
+    // One decoded record: Unix time and values in hundredths of
+    // degC, %RH and hPa
+    struct Record {
+        uint32_t time;
+        int32_t values[3];
+    };
+
+    // Return false to stop reading
+    typedef std::function<bool(const Record&)> RecordCallback;
+
+    static HistoryLog& getInstance() {
+        static HistoryLog instance;
+        return instance;
+    }
+
+    // Call after SPIFFS is mounted
+    bool begin();
+
+    // Feeds one reading; a record is logged per HISTORY_LOG_INTERVAL once
+    // the clock is set
+    void add(float temperature, float humidity, float pressure);
+
+    // Calls back for each record with from <= time <= to, oldest first, and
+    // returns the number of records delivered
+    size_t read(uint32_t from, uint32_t to, RecordCallback callback);
+
+    // Diagnostics
+    uint8_t getSegmentCount() const { return segmentCount; }
+    uint32_t getPagesWritten() const { return pagesWritten; }
+    uint32_t getOldestTime() const;
+
+private:
+    HistoryLog();
+    HistoryLog(const HistoryLog&) = delete;
+    HistoryLog& operator=(const HistoryLog&) = delete;
+
+    struct Segment {
+        uint32_t id;
+        uint32_t firstTime;
+        uint16_t pages;
+        bool sealed;            // No further pages go into this file
+    };
+
+    bool loadSegment(uint32_t id, Segment& segment);
+    void appendRecord(uint32_t time, const int32_t values[3]);
+    void writePage();
+    bool startSegment();
+    void dropOldestSegment();
+    size_t decodePage(const uint8_t* page, uint32_t from, uint32_t to,
+                      RecordCallback& callback, bool& stop);
+
+    SemaphoreHandle_t mutex;
+    bool ready;
+
+    Segment segments[HISTORY_MAX_SEGMENTS];
+    uint8_t segmentCount;
+    uint32_t nextPageSequence;
+    uint32_t pagesWritten;
+
+    // Averaging of the readings for the current interval
+    uint32_t intervalStart;
+    float sums[3];
+    uint16_t sampleCount;
+};
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "config.h"
+
+/**
+ * Owner of the I2C bus: every sensor transaction goes through here.
+ *
+ * read() and write() are single register transactions with every Wire
+ * result checked. readBatch() sorts a set of register reads and merges the
+ * ones that are close together (I2C_COALESCE_GAP) into bursts of up to
+ * I2C_MAX_BURST bytes, so scattered blocks such as the BME280 calibration
+ * cost one transaction per cluster instead of one per block. writePairs()
+ * sends register/value pairs in one transaction for devices that accept
+ * that (the BME280 does).
+ *
+ * A slave reset halfway through a read can keep SDA low forever. When a
+ * transaction fails with SDA low, or after I2C_RECOVERY_THRESHOLD failures
+ * in a row, the controller is released, SCL is clocked until the slave
+ * lets go (at most nine pulses), a STOP is sent and the controller is set
+ * up again; the transaction is then retried once.
+ *
+ * Latency is recorded per transaction kind in a log2 histogram, starting
+ * at 64 us. All of this uses plain Wire and GPIO calls, so the NativeHAL
+ * fault injection (held SDA, NACKs) exercises the same paths on the host.
+ */
+class I2CBus {
+public:
+    enum Kind : uint8_t {
+        READ,
+        WRITE,
+        PROBE,
+        KIND_COUNT
+    };
+
+    static constexpr uint8_t HISTOGRAM_BUCKETS = 8;
+
+    struct Stats {
+        uint32_t count;
+        uint32_t errors;
+        uint32_t maxUs;
+        uint64_t totalUs;
+        uint32_t buckets[HISTOGRAM_BUCKETS];
+    };
+
+    struct Read {
+        uint8_t reg;
+        uint8_t length;
+        uint8_t* data;
+    };
+
+    struct Write {
+        uint8_t reg;
+        uint8_t value;
+    };
+
+    static I2CBus& getInstance() {
+        static I2CBus instance;
+        return instance;
+    }
+
+    bool begin(int sda, int scl, uint32_t frequency);
+
+    bool probe(uint8_t address);
+    bool read(uint8_t address, uint8_t reg, uint8_t* data, size_t length);
+    bool write(uint8_t address, uint8_t reg, const uint8_t* data, size_t length);
+    bool readBatch(uint8_t address, const Read* reads, uint8_t count);
+    bool writePairs(uint8_t address, const Write* writes, uint8_t count);
+
+    // Frees a bus held low by a slave; true when SDA is high afterwards
+    bool recover();
+
+    // Diagnostics
+    Stats getStats(Kind kind) const;
+    uint32_t getRecoveries() const { return recoveries; }
+    uint32_t getFailedRecoveries() const { return failedRecoveries; }
+    uint32_t getTransactionsSaved() const { return transactionsSaved; }
+    static uint32_t bucketLimitUs(uint8_t bucket);  // Upper bound, 0 = open-ended
+    static const char* kindName(Kind kind);
+
+private:
+    I2CBus();
+    I2CBus(const I2CBus&) = delete;
+    I2CBus& operator=(const I2CBus&) = delete;
+
+    bool readOnce(uint8_t address, uint8_t reg, uint8_t* data, size_t length);
+    bool writeOnce(uint8_t address, uint8_t reg, const uint8_t* data, size_t length);
+    bool writePairsOnce(uint8_t address, const Write* writes, uint8_t count);
+    bool afterFailure();  // True when the bus was recovered and a retry makes sense
+    bool recoverLocked();
+    bool lock();
+    void unlock();
+    void record(Kind kind, int64_t startUs, bool ok);
+
+    SemaphoreHandle_t mutex;
+    mutable portMUX_TYPE statsLock;
+    int sdaPin;
+    int sclPin;
+    uint32_t frequency;
+    uint8_t consecutiveErrors;
+
+    Stats stats[KIND_COUNT];
+    volatile uint32_t recoveries;
+    volatile uint32_t failedRecoveries;
+    volatile uint32_t transactionsSaved;
+};
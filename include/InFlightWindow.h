@@ -0,0 +1,86 @@
+#pragma once
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include "config.h"
+#include "MessageRing.h"
+
+/**
+ * QoS 1 publishes that were sent but not yet acknowledged, oldest first.
+ * At most MQTT_INFLIGHT_WINDOW are outstanding at a time. Their copies are
+ * kept in a MessageRing of MQTT_INFLIGHT_BYTES so they can be sent again,
+ * with the same packet IDs, after a reconnect.
+ *
+ * Brokers acknowledge QoS 1 in order, so a PUBACK normally releases the
+ * oldest message; one for a message further back is remembered until
+ * everything in front of it is acknowledged as well.
+ *
+ * The time from the last send to the PUBACK is recorded in a log2
+ * histogram starting at 8 ms, to size the window against the round trip.
+ *
+ * Not locked: MQTTManager only uses it with its client lock held.
+ * getStats() may be called from any task.
+ */
+class InFlightWindow {
+public:
+    typedef MessageRing::Message Message;
+
+    static constexpr uint8_t HISTOGRAM_BUCKETS = 8;
+
+    struct Stats {
+        uint32_t sent;
+        uint32_t acknowledged;
+        uint32_t retransmitted;
+        uint32_t unknownAcks;       // PUBACKs for nothing outstanding
+        uint32_t lastMs;
+        uint32_t maxMs;
+        uint64_t totalMs;
+        uint32_t buckets[HISTOGRAM_BUCKETS];
+        uint8_t depth;
+        uint16_t bytes;
+    };
+
+    InFlightWindow();
+
+    // Keeps a copy before it is sent; false while the window is full
+    bool add(const char* topic, const char* payload, bool retained, uint16_t packetId);
+
+    // Releases the message; false for an ID that is not outstanding
+    bool acknowledge(uint16_t packetId);
+
+    // Retransmission: index 0 is the oldest. The copy is valid until the
+    // next call.
+    bool get(uint8_t index, Message& message, uint16_t& packetId);
+    void resent(uint8_t index);
+
+    bool contains(uint16_t packetId) const;
+    uint8_t depth() const { return count; }
+    uint32_t oldestAgeMs() const;   // Since the oldest was last sent, 0 when empty
+
+    Stats getStats() const;
+    static uint32_t bucketLimitMs(uint8_t bucket);  // Upper bound, 0 = open-ended
+
+private:
+    static constexpr uint8_t KEEP = 0x04;   // Publish retained; not coalesced here
+
+    struct Slot {
+        uint16_t packetId;
+        bool acknowledged;
+        uint32_t sentAt;
+    };
+
+    Slot& slot(uint8_t index) { return slots[(head + index) % MQTT_INFLIGHT_WINDOW]; }
+    const Slot& slot(uint8_t index) const { return slots[(head + index) % MQTT_INFLIGHT_WINDOW]; }
+    void record(uint32_t latencyMs);
+    void updateDepth();
+
+    alignas(4) uint8_t storage[MQTT_INFLIGHT_BYTES];
+    MessageRing ring;
+    Slot slots[MQTT_INFLIGHT_WINDOW];
+    uint8_t head;
+    uint8_t count;
+
+    char scratch[MQTT_QUEUE_MAX_MESSAGE];
+    mutable portMUX_TYPE statsLock;
+    Stats stats;
+};
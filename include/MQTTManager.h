@@ -4,17 +4,23 @@
 
 #include <Arduino.h>
 #include <WiFiClient.h>
-#include <PubSubClient.h>
+#include <lwip/dns.h>
+#include <atomic>
 #include <functional>
 
 // Include required headers
 #include "PreferencesManager.h" // Include full definition instead of forward declaration
+#include "PublishQueue.h"
+#include "MessageSpool.h"
+#include "MQTTTransport.h"
+#include "InFlightWindow.h"
 
 // These constants match what was in the original implementation
 #define MQTT_RECONNECT_INTERVAL 5000
 #define INITIAL_RECONNECT_DELAY 500
 #define MAX_RECONNECT_DELAY 60000
-#define PUBLISH_RATE_LIMIT 50
+#define MQTT_STABLE_CONNECTION 60000   // Up this long before the backoff starts over
+#define MQTT_POLL_MS 20                // How often step() looks for a CONNACK or PUBACK
 
 // Define a callback type for message handling
 using MQTTMessageHandler = std::function<void(const String&, const String&)>;
@@ -27,22 +33,96 @@ public:
     bool begin(PreferencesManager& prefs);
     bool begin();  // Overload for backward compatibility
     
-    // Connection management
+    // Connection state machine, advanced by step() in the network task; the
+    // only place that reconnects. Every failure goes to BACKOFF, which
+    // doubles from INITIAL_RECONNECT_DELAY up to MAX_RECONNECT_DELAY and is
+    // jittered by up to half so a fleet does not return in lockstep. The
+    // backoff only starts over once a connection has held for
+    // MQTT_STABLE_CONNECTION, so a broker that drops every connection right
+    // away is not hammered.
+    enum class ConnectionState : uint8_t {
+        IDLE,           // Not started, or stopped by forceDisconnect()
+        RESOLVING,      // Broker name to address
+        CONNECTING,     // TCP connect
+        HANDSHAKE,      // CONNECT sent, waiting for the CONNACK
+        SUBSCRIBING,    // Online status and subscriptions sent, waiting for the SUBACKs
+        CONNECTED,
+        BACKOFF         // Waiting for the next attempt
+    };
+
+    // Connection management. connect() only starts an attempt when none is
+    // under way; loop() and maintainConnection() serve a live connection
+    // and never connect themselves.
     void loop();
     bool connect();
     bool connected();
     bool maintainConnection();  // Original method for compatibility
     void forceDisconnect();
 
-    // Publishing methods
+    // Any task: asks step() to drop a live connection. It is handled like
+    // any other drop, so the reconnect waits for the backoff.
+    void requestReconnect();
+
+    // Network task only: takes one step of the connection and returns the
+    // ms until the next is due. Never waits on the network: the name lookup
+    // (asynchronous lwIP resolver), the TCP connect (non-blocking socket)
+    // and the CONNACK are polled, each given up after MQTT_CONNECT_TIMEOUT_MS.
+    uint32_t step();
+    ConnectionState getState() const { return state; }
+    static const char* stateName(ConnectionState state);
+
+    struct ConnectionStats {
+        uint32_t attempts;          // Connection attempts started
+        uint32_t failures;          // Attempts that ended in backoff
+        uint32_t connects;
+        uint32_t drops;             // Established connections that were lost
+        uint32_t flaps;             // Drops within MQTT_STABLE_CONNECTION
+        uint32_t lastReconnectMs;   // From losing the connection to having it back
+        uint32_t maxReconnectMs;
+        uint32_t backoffMs;         // Current base delay, before jitter
+    };
+    ConnectionStats getConnectionStats() const;
+
+    // Publishing methods, kept for existing callers: the same as enqueue(),
+    // so they never wait on the broker
     bool publish(const String& topic, const String& payload);
     bool publish(const char* topic, const char* payload, bool retained = false);  // Original signature
     bool publishSensorData(const String& payload);
     bool publishRelayCommand(const String& payload);
+
+    // Non-blocking: hands the message to the PublishQueue, which the network
+    // task drains through processQueue(). False if it was refused, in which
+    // case the caller still owns the data. A nullptr payload (a PayloadWriter
+    // that overflowed) is refused as well.
+    bool enqueue(const char* topic, const char* payload, bool retained = false,
+                 PublishQueue::Policy policy = PublishQueue::REJECT);
+
+    // Network task only: sends up to MQTT_QUEUE_BATCH queued messages, one
+    // attempt each, and returns how many went out. After a failure it waits
+    // MQTT_QUEUE_RETRY_MS before the next attempt. With MQTT_QOS 1 they are
+    // sent while the InFlightWindow has room, and kept there until the
+    // PUBACK arrives.
+    uint16_t processQueue();
+    InFlightWindow::Stats getInFlightStats() const;
+
+    // Telemetry (sensor readings, diagnostics): queued while connected,
+    // kept in the MessageSpool while not, and behind a spooled backlog so
+    // the order holds. False only if the message was dropped.
+    bool enqueueTelemetry(const char* topic, const char* payload, bool retained = false);
+
+    // Network task only: moves the oldest spooled message into the queue,
+    // at most one per MQTT_SPOOL_REPLAY_INTERVAL while connected
+    void replaySpool();
     
-    // Discovery methods
+    // Discovery methods. Sensor 0 keeps the original entity IDs and state
+    // topic; further sensors get an index suffix on both. The configs are
+    // queued retained, so nothing here waits on the broker. When the queue
+    // fills up, publishHomeAssistantDiscovery() returns false and the next
+    // call resumes at the entity that did not fit; true once all are queued.
     bool publishHomeAssistantDiscovery();
-    bool publishSensorDiscovery(const char* sensorType, const char* unit, const char* deviceClass);
+    bool publishSensorDiscovery(const char* sensorType, const char* unit, const char* deviceClass,
+                                uint8_t sensor = 0);
+    static void sensorStateTopic(uint8_t sensor, char* topic, size_t size);
     
     // Configuration
     void setBufferSize(uint16_t size);
@@ -67,15 +147,57 @@ private:
     WiFiClient wifiClient;
     
     // MQTT Client
-    PubSubClient mqttClient;
+    MQTTTransport mqttClient;
+    InFlightWindow window;
     
+    // The transport is not thread safe: everything that uses mqttClient or
+    // the window holds this. Recursive so a holder can call the other locking methods.
+    SemaphoreHandle_t clientLock;
+
     // Connection state
-    bool isConnected;
-    unsigned long lastReconnectAttempt;
+    volatile bool isConnected;
+    volatile ConnectionState state;
+    unsigned long stateSince;
+    unsigned long nextAttempt;
+    unsigned long connectedAt;
+    unsigned long downSince;
+    uint16_t outageAttempts;
+    ConnectionStats connectionStats;
+    mutable portMUX_TYPE statsLock;
+    bool sessionPresent;
+    uint16_t lastPacketId;
+    uint16_t discoveryNext;     // Entity to queue next, 0 when no round is under way
     unsigned long reconnectInterval;
-    unsigned long lastPublishTime;
     unsigned long currentReconnectDelay;
+    unsigned long lastQueueFailure;
+    uint32_t failedSequence;
+    uint8_t failedAttempts;
+    unsigned long lastReplay;
+    std::atomic<bool> reconnectRequested;
     
+    // DNS results arrive on the lwIP thread, tagged with the name they are
+    // for, so the answer to an abandoned lookup of another broker is ignored
+    static void dnsFound(const char* name, const ip_addr_t* ipaddr, void* arg);
+    char resolvingName[128];
+    std::atomic<uint32_t> resolvedAddress;
+    std::atomic<bool> resolveFailed;
+
+    // Socket of a TCP connect still under way, -1 when there is none. Only
+    // touched with the client lock held.
+    int pendingSocket;
+
+    enum class TcpProgress : uint8_t { WAITING, CONNECTED, FAILED };
+    void startResolve();
+    bool startTcpConnect(uint32_t address);
+    TcpProgress pollTcpConnect();
+    void closePendingSocket();
+
+    void setState(ConnectionState next);
+    void startAttempt();
+    uint32_t retryLater(const char* reason);
+    uint16_t nextPacketId();
+    void handleAck(uint16_t packetId);
+
     // Message handling
     void callback(char* topic, byte* payload, unsigned int length);
     void handleMessage(char* topic, byte* payload, unsigned int length);
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "config.h"
+
+/**
+ * The fixed MQTT topics of this device, joined from the config.h names by
+ * the preprocessor. They are string literals in flash, so publishing or
+ * subscribing never builds a topic on the heap. The per-sensor state topics
+ * carry an index and are formatted by MQTTManager::sensorStateTopic() into
+ * a caller buffer.
+ */
+#define MQTT_DEVICE_PREFIX "chaoticvolt/" MQTT_CLIENT_ID "/"
+
+namespace MQTTTopics {
+
+constexpr const char* STATUS = MQTT_DEVICE_PREFIX MQTT_TOPIC_AUX_DISPLAY "/status";
+constexpr const char* SENSORS = MQTT_DEVICE_PREFIX MQTT_TOPIC_AUX_DISPLAY "/sensors";
+constexpr const char* DIAGNOSTICS = MQTT_DEVICE_PREFIX MQTT_TOPIC_AUX_DISPLAY "/diagnostics";
+constexpr const char* WARNINGS = MQTT_DEVICE_PREFIX MQTT_TOPIC_AUX_DISPLAY "/warnings";
+constexpr const char* TASKS = MQTT_DEVICE_PREFIX MQTT_TOPIC_AUX_DISPLAY "/system/tasks";
+constexpr const char* RELAY_COMMAND = MQTT_DEVICE_PREFIX MQTT_TOPIC_RELAY "/command";
+constexpr const char* RELAY_STATE = MQTT_DEVICE_PREFIX MQTT_TOPIC_RELAY "/state";
+constexpr const char* DISPLAY_MESSAGE = MQTT_DEVICE_PREFIX MQTT_TOPIC_DISPLAY_MESSAGE;
+
+} // namespace MQTTTopics
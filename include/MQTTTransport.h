@@ -0,0 +1,113 @@
+#pragma once
+
+#include <Arduino.h>
+#include <Client.h>
+#include <functional>
+#include "config.h"
+
+/**
+ * Minimal MQTT 3.1.1 client over an already connected Client. It replaces
+ * PubSubClient, which publishes at QoS 0 only, drops PUBACKs and blocks
+ * while it waits for the CONNACK.
+ *
+ * Nothing here waits on the network: connect() only sends CONNECT and
+ * pollConnack() reports the answer once it has arrived, as pollSubacks()
+ * does for subscriptions; loop() handles what has been received
+ * (publishes, PUBACKs, ping responses) and keeps the connection alive.
+ * QoS 1 publishes carry a packet ID chosen by the caller, who also keeps
+ * the message for retransmission; PUBACKs are handed to the ack callback.
+ * A packet that cannot be written whole closes the socket, so the caller
+ * reconnects instead of sending more after a partial one.
+ *
+ * Buffers are fixed: MQTT_BUFFER_SIZE for outgoing packets and
+ * MQTT_RX_BUFFER_SIZE for incoming ones. Larger incoming messages are
+ * acknowledged and dropped. State codes are PubSubClient's.
+ */
+class MQTTTransport {
+public:
+    typedef std::function<void(char*, uint8_t*, unsigned int)> MessageCallback;
+    typedef std::function<void(uint16_t)> AckCallback;
+
+    static constexpr int CONNECTION_TIMEOUT = -4;
+    static constexpr int CONNECTION_LOST = -3;
+    static constexpr int CONNECT_FAILED = -2;
+    static constexpr int DISCONNECTED = -1;
+    static constexpr int CONNECTED = 0;
+
+    enum class Handshake : uint8_t {
+        WAITING,
+        ACCEPTED,
+        FAILED          // Refused (state() has the return code) or socket closed
+    };
+
+    explicit MQTTTransport(Client& client);
+
+    void setCallback(MessageCallback callback) { messageCallback = callback; }
+    void setAckCallback(AckCallback callback) { ackCallback = callback; }
+    void setKeepAlive(uint16_t seconds) { keepAlive = seconds; }
+
+    // Sends CONNECT; a null user, password or will topic leaves it out.
+    // Without cleanSession the broker keeps subscriptions and unacknowledged
+    // QoS 1 messages across connections.
+    bool connect(const char* clientId, const char* user, const char* password,
+                 const char* willTopic, const char* willMessage, uint8_t willQos, bool willRetain,
+                 bool cleanSession);
+    Handshake pollConnack(bool& sessionPresent);
+
+    // packetId is required for QoS 1; duplicate marks a retransmission
+    bool publish(const char* topic, const char* payload, bool retained,
+                 uint8_t qos = 0, uint16_t packetId = 0, bool duplicate = false);
+    bool subscribe(const char* topic, uint8_t qos = 0);
+
+    // WAITING until the broker has answered every subscribe() since
+    // connect(); FAILED if it refused one or the socket closed
+    Handshake pollSubacks();
+
+    // False once the connection is gone
+    bool loop();
+    bool connected();
+    void disconnect();
+    int state() const { return connectionState; }
+
+private:
+    enum class Receive : uint8_t {
+        HEADER,
+        LENGTH,
+        BODY
+    };
+
+    static constexpr size_t HEADER_ROOM = 5;     // Fixed header: type and up to four length bytes
+
+    bool writePacket(uint8_t header, size_t length);
+    size_t writeString(const char* text, size_t offset);
+    bool readPacket();
+    void handlePacket();
+    void handlePublish();
+    void sendShort(uint8_t header, uint16_t packetId);
+    void closeSocket(int reason);
+
+    Client& client;
+    MessageCallback messageCallback;
+    AckCallback ackCallback;
+    uint16_t keepAlive;
+    uint16_t nextSubscribeId;
+    int connectionState;
+    bool connackReceived;
+    bool sessionPresent;
+    uint8_t connackCode;
+    bool pingOutstanding;
+    uint8_t subacksPending;
+    bool subscribeRefused;
+    unsigned long lastOutbound;
+    unsigned long lastInbound;
+
+    // Incoming packet, assembled as bytes arrive
+    Receive receive;
+    uint8_t rxHeader;
+    uint32_t rxLength;
+    uint32_t rxMultiplier;
+    uint32_t rxReceived;
+
+    uint8_t txBuffer[MQTT_BUFFER_SIZE];
+    uint8_t rxBuffer[MQTT_RX_BUFFER_SIZE + 1];  // Room to terminate the payload
+};
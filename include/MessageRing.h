@@ -0,0 +1,99 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * MQTT messages stored back to back in a caller-provided byte array, oldest
+ * first. Shared by PublishQueue and MessageSpool; it does no locking of its
+ * own.
+ *
+ * A message takes a 16-byte header plus its topic and payload, rounded up to
+ * 4 bytes, and never wraps: when it does not fit in front of the end of the
+ * array it starts again at the beginning.
+ *
+ * A retained message replaces the stored one for the same topic, since only
+ * the latest state matters. It is rewritten in place when the new payload
+ * fits in the old slot. Otherwise the old one is marked dead, skipped and
+ * freed with the messages around it.
+ */
+class MessageRing {
+public:
+    // A message copied out by front(). stamp is whatever the owner stored.
+    struct Message {
+        const char* topic;
+        const char* payload;
+        bool retained;
+        uint8_t flags;
+        uint32_t sequence;
+        uint32_t stamp;
+    };
+
+    enum Result : uint8_t {
+        STORED,
+        COALESCED,  // Replaced a retained message for the same topic
+        FULL
+    };
+
+    // Flags above RETAINED are free for the owner
+    static constexpr uint8_t RETAINED = 0x01;
+    static constexpr uint8_t DEAD = 0x02;
+
+    static constexpr size_t HEADER_SIZE = 16;
+
+    MessageRing(uint8_t* storage, uint16_t capacity);
+
+    // FULL if the message does not fit. With dropOldest, messages are
+    // discarded from the front until it does; the live ones are added to
+    // dropped.
+    Result push(const char* topic, const char* payload, uint8_t flags, uint32_t stamp,
+                bool dropOldest, uint32_t& dropped);
+
+    // Copies the oldest live message into buffer (topic and payload, both
+    // terminated); false when empty or buffer is too small
+    bool front(char* buffer, size_t size, Message& message);
+
+    // Like front() for the index-th live message, 0 being the oldest;
+    // changes nothing
+    bool peek(uint16_t index, char* buffer, size_t size, Message& message);
+
+    // Removes the oldest message if it is still the given one
+    bool pop(uint32_t sequence);
+    void popFront();
+
+    uint16_t depth() const { return live; }     // Messages, dead ones excluded
+    uint16_t bytes() const { return used; }
+    uint16_t capacity() const { return size; }
+
+    // Bytes the message occupies
+    static uint16_t recordSize(size_t topicLength, size_t payloadLength);
+
+private:
+    struct Record {
+        uint16_t size;          // Header, strings and padding
+        uint8_t flags;
+        uint8_t topicLength;
+        uint16_t payloadLength;
+        uint16_t reserved;
+        uint32_t sequence;
+        uint32_t stamp;
+    };
+    static_assert(sizeof(Record) == HEADER_SIZE, "MessageRing header layout");
+
+    Record* at(uint16_t offset) { return reinterpret_cast<Record*>(storage + offset); }
+    uint16_t next(uint16_t offset);
+    bool copy(Record* record, char* buffer, size_t bufferSize, Message& message);
+    bool reserve(uint16_t length, uint16_t& offset);
+    void write(Record* record, const char* topic, size_t topicLength,
+               const char* payload, size_t payloadLength, uint8_t flags, uint32_t stamp);
+
+    uint8_t* storage;
+    uint16_t size;
+    uint16_t head;              // Oldest record
+    uint16_t tail;              // Where the next one goes
+    uint16_t wrapAt;            // End of the records before the wrap
+    bool wrapped;               // Records continue at offset 0
+    uint16_t records;           // Including dead ones
+    uint16_t live;
+    uint16_t used;
+    uint32_t sequence;
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <Arduino.h>
+#include <SPIFFS.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "config.h"
+#include "MessageRing.h"
+
+/**
+ * Store-and-forward for telemetry (sensor readings, diagnostics) while the
+ * broker cannot be reached. MQTTManager::enqueueTelemetry() puts messages
+ * here instead of into the PublishQueue while the connection is down, and
+ * also while a backlog is still replaying, so the order is kept. After a
+ * reconnect the network task replays them through the PublishQueue, one per
+ * MQTT_SPOOL_REPLAY_INTERVAL.
+ *
+ * Messages are kept in a MessageRing of MQTT_SPOOL_BYTES. With
+ * MQTT_SPOOL_SPILL the oldest half is moved to SPIFFS when it fills up, into
+ * append-only segment files /spool/<id>.bin of up to MQTT_SPOOL_SEGMENT_BYTES.
+ * A segment is deleted once it has been replayed, so a reset repeats at most
+ * the rest of one segment. When the segment limit or the free space is
+ * reached, the oldest messages in RAM are dropped instead.
+ *
+ * Each message is stamped when it is stored. Replayed JSON objects get the
+ * capture time added as "ts" (Unix seconds), provided the clock was set at
+ * capture or has been set since in the same boot.
+ */
+class MessageSpool {
+public:
+    typedef MessageRing::Message Message;
+
+    struct Stats {
+        uint32_t stored;
+        uint32_t replayed;
+        uint32_t dropped;       // Lost because RAM and flash were full
+        uint32_t spilled;       // Moved from RAM to SPIFFS
+        uint32_t depth;         // Waiting, in RAM and on flash
+        uint16_t bytes;         // RAM in use
+        uint16_t segments;      // Spill files
+    };
+
+    static MessageSpool& getInstance() {
+        static MessageSpool instance;
+        return instance;
+    }
+
+    // Call after SPIFFS is mounted; picks up spill files from before a reset
+    bool begin();
+
+    // Stamps and keeps the message; false if it had to be dropped
+    bool store(const char* topic, const char* payload, bool retained);
+
+    // Replay side, network task only. front() returns the oldest message
+    // with its timestamp added, in a buffer valid until the next call;
+    // pop() removes it once it was handed on.
+    bool front(Message& message);
+    void pop(const Message& message);
+
+    uint32_t depth() const { return ring.depth() + spilledRecords; }
+    Stats getStats() const;
+
+private:
+    // Owner flags on top of MessageRing's. Retained messages are not
+    // coalesced here, the history is the point.
+    static constexpr uint8_t KEEP = 0x04;       // Publish retained
+    static constexpr uint8_t EPOCH = 0x08;      // stamp is Unix seconds, else monotonic
+    static constexpr uint8_t SPILLED = 0x10;    // front() read it from flash
+
+    MessageSpool();
+    MessageSpool(const MessageSpool&) = delete;
+    MessageSpool& operator=(const MessageSpool&) = delete;
+
+    bool spill();
+    bool openSegment(File& file, size_t length);
+    bool readSpilled(Message& message);
+    void removeFirstSegment();
+    bool captureTime(uint8_t flags, uint32_t stamp, bool currentBoot, uint32_t& epoch) const;
+    void addTimestamp(const Message& raw, bool currentBoot, Message& message);
+
+    SemaphoreHandle_t lock;
+
+    alignas(4) uint8_t storage[MQTT_SPOOL_BYTES];
+    MessageRing ring;
+
+    // Spill segments firstSegment .. nextSegment - 1; older than bootSegment
+    // were written before the last reset
+    bool spillReady;
+    uint32_t firstSegment;
+    uint32_t nextSegment;
+    uint32_t bootSegment;
+    uint32_t readOffset;        // Into firstSegment
+    uint32_t readNext;          // Offset behind the message front() returned
+    uint32_t writeBytes;        // Size of nextSegment - 1
+    uint32_t spilledRecords;
+
+    char raw[MQTT_QUEUE_MAX_MESSAGE];
+    char scratch[MQTT_QUEUE_MAX_MESSAGE];
+    Stats stats;
+};
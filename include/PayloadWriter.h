@@ -0,0 +1,47 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * Writes a flat JSON object into a caller-owned buffer, normally a local
+ * array, without touching the heap:
+ *
+ *   char buffer[96];
+ *   PayloadWriter json(buffer, sizeof(buffer));
+ *   json.add("relay_id", relayId);
+ *   json.add("source", "mqtt");
+ *   mqttManager.publish(topic, json.finish());
+ *
+ * Floats take the number of decimals to print. Strings are escaped. If the
+ * object does not fit, finish() returns nullptr, which MQTTManager::publish()
+ * refuses, so a truncated payload is never sent.
+ */
+class PayloadWriter {
+public:
+    PayloadWriter(char* buffer, size_t size);
+
+    PayloadWriter& add(const char* key, const char* value);
+    PayloadWriter& add(const char* key, bool value);
+    PayloadWriter& add(const char* key, int value);
+    PayloadWriter& add(const char* key, unsigned int value);
+    PayloadWriter& add(const char* key, long value);
+    PayloadWriter& add(const char* key, unsigned long value);
+    PayloadWriter& add(const char* key, double value, uint8_t decimals);
+
+    // Closes the object; nullptr if anything was cut off
+    const char* finish();
+
+    bool overflowed() const { return overflow; }
+    size_t length() const { return used; }
+
+private:
+    void append(const char* text, size_t length);
+    void appendf(const char* format, ...);
+    void key(const char* name);
+
+    char* buffer;
+    size_t size;
+    size_t used;
+    bool overflow;
+    bool first;
+};
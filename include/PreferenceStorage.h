@@ -11,6 +11,8 @@ public:
     virtual String getString(const char* key, const char* defaultValue) = 0;
     virtual bool putUChar(const char* key, uint8_t value) = 0;
     virtual uint8_t getUChar(const char* key, uint8_t defaultValue) = 0;
+    virtual bool putShort(const char* key, int16_t value) = 0;
+    virtual int16_t getShort(const char* key, int16_t defaultValue) = 0;
     virtual bool putBool(const char* key, bool value) = 0;
     virtual bool getBool(const char* key, bool defaultValue) = 0;
     virtual ~PreferenceStorage() = default;
@@ -34,6 +36,8 @@ public:
     String getString(const char* key, const char* defaultValue) override;
     bool putUChar(const char* key, uint8_t value) override;
     uint8_t getUChar(const char* key, uint8_t defaultValue) override;
+    bool putShort(const char* key, int16_t value) override;
+    int16_t getShort(const char* key, int16_t defaultValue) override;
     bool putBool(const char* key, bool value) override;
     bool getBool(const char* key, bool defaultValue) override;
 };
\ No newline at end of file
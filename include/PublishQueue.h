@@ -0,0 +1,88 @@
+#pragma once
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include "config.h"
+#include "MessageRing.h"
+
+/**
+ * Outbound MQTT messages waiting for the network task. Producers (sensor
+ * task, loop(), SystemMonitor) enqueue and return at once; the network task
+ * is woken through its task notification and sends them in order.
+ *
+ * The messages live in a MessageRing over one pre-allocated array of
+ * MQTT_QUEUE_BYTES, so nothing is allocated after construction, and a
+ * retained message replaces the queued one for the same topic.
+ *
+ * When a message does not fit, the policy decides: REJECT refuses it so the
+ * producer can keep it and try again (backpressure), DROP_OLDEST discards
+ * from the front until it fits.
+ */
+class PublishQueue {
+public:
+    enum Policy : uint8_t {
+        REJECT,
+        DROP_OLDEST
+    };
+
+    typedef MessageRing::Message Message;
+
+    struct Stats {
+        uint32_t enqueued;
+        uint32_t coalesced;     // Retained messages that replaced a queued one
+        uint32_t rejected;      // Full, too large or lock timeout
+        uint32_t dropped;       // Discarded by DROP_OLDEST
+        uint32_t sent;
+        uint32_t failed;        // Send attempts that will be retried
+        uint32_t abandoned;     // Still failing after MQTT_QUEUE_MAX_ATTEMPTS
+        uint16_t depth;
+        uint16_t bytes;
+        uint16_t highWater;     // Most bytes in use so far
+    };
+
+    static PublishQueue& getInstance() {
+        static PublishQueue instance;
+        return instance;
+    }
+
+    // Never blocks for longer than MQTT_QUEUE_LOCK_MS. False if refused.
+    bool enqueue(const char* topic, const char* payload, bool retained = false,
+                 Policy policy = REJECT);
+
+    // Task woken on every enqueue
+    void setConsumer(TaskHandle_t task) { consumer = task; }
+    void wake();
+
+    // Consumer side, one task only. front() copies the oldest message into
+    // a buffer owned by the queue, valid until the next call; pop() removes
+    // it after it was sent, unless a producer has replaced it meanwhile.
+    bool front(Message& message);
+    void pop(uint32_t sequence);
+    void failed();
+    void abandon(uint32_t sequence);
+
+    uint16_t depth() const { return ring.depth(); }
+    Stats getStats() const;
+
+private:
+    PublishQueue();
+    PublishQueue(const PublishQueue&) = delete;
+    PublishQueue& operator=(const PublishQueue&) = delete;
+
+    SemaphoreHandle_t lock;
+    volatile TaskHandle_t consumer;
+
+    alignas(4) uint8_t storage[MQTT_QUEUE_BYTES];
+    MessageRing ring;
+
+    void reject();
+
+    char scratch[MQTT_QUEUE_MAX_MESSAGE];
+
+    // Guarded by lock, except rejected and failed: those are also counted
+    // without it (lock timeout, consumer side) and go through statsLock
+    Stats stats;
+    mutable portMUX_TYPE statsLock;
+};
@@ -7,6 +7,7 @@
 #include <ArduinoJson.h>
 #include <HTTPClient.h>
 #include <WiFiClient.h>
+#include <functional>
 #include "config.h"
 #include "SystemDefinitions.h"  // Include SystemDefinitions for shared enums/structs
 
@@ -0,0 +1,264 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Compile-time font and frame renderer for the 4-digit 7-segment display.
+ *
+ * A frame is packed into a uint32_t: byte i is the raw segment pattern of
+ * digit i, in the same active-low bit order as SEGMENT_MAP. Everything here is
+ * constexpr, so a constant screen such as renderText("Init") is folded into a
+ * single literal by the compiler.
+ *
+ *   Bit:  7    6    5    4    3    2    1    0
+ *        [DP] [G]  [F]  [E]  [D]  [C]  [B]  [A]
+ */
+namespace SegmentFont {
+
+constexpr uint8_t FRAME_DIGITS = 4;
+constexpr uint8_t BLANK = 0xFF;
+constexpr uint8_t DP_BIT = 0x80;
+constexpr uint32_t BLANK_FRAME = 0xFFFFFFFFUL;
+
+// Printable ASCII (0x20-0x7F). Letters without a usable 7-segment shape
+// borrow the closest one; '*' is the degree sign.
+constexpr uint8_t ASCII_SEGMENTS[96] = {
+    0b11111111,  // 0x20 ' ': none
+    0b11111111,  // 0x21 '!': none
+    0b11011101,  // 0x22 '"': BF
+    0b11111111,  // 0x23 '#': none
+    0b11111111,  // 0x24 '$': none
+    0b11111111,  // 0x25 '%': none
+    0b11111111,  // 0x26 '&': none
+    0b11011111,  // 0x27 ''': F
+    0b11111111,  // 0x28 '(': none
+    0b11111111,  // 0x29 ')': none
+    0b10011100,  // 0x2A '*': ABFG
+    0b11111111,  // 0x2B '+': none
+    0b11111111,  // 0x2C ',': none
+    0b10111111,  // 0x2D '-': G
+    0b11111111,  // 0x2E '.': none
+    0b11111111,  // 0x2F '/': none
+    0b11000000,  // 0x30 '0': ABCDEF
+    0b11111001,  // 0x31 '1': BC
+    0b10100100,  // 0x32 '2': ABDEG
+    0b10110000,  // 0x33 '3': ABCDG
+    0b10011001,  // 0x34 '4': BCFG
+    0b10010010,  // 0x35 '5': ACDFG
+    0b10000010,  // 0x36 '6': ACDEFG
+    0b11111000,  // 0x37 '7': ABC
+    0b10000000,  // 0x38 '8': ABCDEFG
+    0b10010000,  // 0x39 '9': ABCDFG
+    0b11111111,  // 0x3A ':': none
+    0b11111111,  // 0x3B ';': none
+    0b11111111,  // 0x3C '<': none
+    0b10110111,  // 0x3D '=': DG
+    0b11111111,  // 0x3E '>': none
+    0b10101100,  // 0x3F '?': ABEG
+    0b11111111,  // 0x40 '@': none
+    0b10001000,  // 0x41 'A': ABCEFG
+    0b10000011,  // 0x42 'B': CDEFG
+    0b11000110,  // 0x43 'C': ADEF
+    0b10100001,  // 0x44 'D': BCDEG
+    0b10000110,  // 0x45 'E': ADEFG
+    0b10001110,  // 0x46 'F': AEFG
+    0b10000010,  // 0x47 'G': ACDEFG
+    0b10001001,  // 0x48 'H': BCEFG
+    0b11111001,  // 0x49 'I': BC
+    0b11110001,  // 0x4A 'J': BCD
+    0b10001001,  // 0x4B 'K': BCEFG
+    0b11000111,  // 0x4C 'L': DEF
+    0b11001000,  // 0x4D 'M': ABCEF
+    0b11001000,  // 0x4E 'N': ABCEF
+    0b11000000,  // 0x4F 'O': ABCDEF
+    0b10001100,  // 0x50 'P': ABEFG
+    0b10011000,  // 0x51 'Q': ABCFG
+    0b10101111,  // 0x52 'R': EG
+    0b10010010,  // 0x53 'S': ACDFG
+    0b10000111,  // 0x54 'T': DEFG
+    0b11000001,  // 0x55 'U': BCDEF
+    0b11000001,  // 0x56 'V': BCDEF
+    0b11000001,  // 0x57 'W': BCDEF
+    0b10001001,  // 0x58 'X': BCEFG
+    0b10010001,  // 0x59 'Y': BCDFG
+    0b10100100,  // 0x5A 'Z': ABDEG
+    0b11000110,  // 0x5B '[': ADEF
+    0b11111111,  // 0x5C 'backslash': none
+    0b11110000,  // 0x5D ']': ABCD
+    0b11111111,  // 0x5E '^': none
+    0b11110111,  // 0x5F '_': D
+    0b11111111,  // 0x60 '`': none
+    0b10001000,  // 0x61 'a': ABCEFG
+    0b10000011,  // 0x62 'b': CDEFG
+    0b10100111,  // 0x63 'c': DEG
+    0b10100001,  // 0x64 'd': BCDEG
+    0b10000110,  // 0x65 'e': ADEFG
+    0b10001110,  // 0x66 'f': AEFG
+    0b10000010,  // 0x67 'g': ACDEFG
+    0b10001011,  // 0x68 'h': CEFG
+    0b11111001,  // 0x69 'i': BC
+    0b11110001,  // 0x6A 'j': BCD
+    0b10001001,  // 0x6B 'k': BCEFG
+    0b11001111,  // 0x6C 'l': EF
+    0b10101011,  // 0x6D 'm': CEG
+    0b10101011,  // 0x6E 'n': CEG
+    0b10100011,  // 0x6F 'o': CDEG
+    0b10001100,  // 0x70 'p': ABEFG
+    0b10011000,  // 0x71 'q': ABCFG
+    0b10101111,  // 0x72 'r': EG
+    0b10010010,  // 0x73 's': ACDFG
+    0b10000111,  // 0x74 't': DEFG
+    0b11100011,  // 0x75 'u': CDE
+    0b11100011,  // 0x76 'v': CDE
+    0b11100011,  // 0x77 'w': CDE
+    0b10001001,  // 0x78 'x': BCEFG
+    0b10010001,  // 0x79 'y': BCDFG
+    0b10100100,  // 0x7A 'z': ABDEG
+    0b11111111,  // 0x7B '{': none
+    0b11111111,  // 0x7C '|': none
+    0b11111111,  // 0x7D '}': none
+    0b11111111,  // 0x7E '~': none
+    0b11111111   // 0x7F 'DEL': none
+};
+
+constexpr uint8_t glyph(char c) {
+    return (static_cast<unsigned char>(c) >= 0x20 && static_cast<unsigned char>(c) <= 0x7F)
+               ? ASCII_SEGMENTS[static_cast<unsigned char>(c) - 0x20]
+               : BLANK;
+}
+
+constexpr uint32_t setDigit(uint32_t frame, uint8_t position, uint8_t pattern) {
+    return (frame & ~(0xFFUL << (8 * position))) | ((uint32_t)pattern << (8 * position));
+}
+
+constexpr uint32_t withDecimalPoint(uint32_t frame, uint8_t position) {
+    return position < FRAME_DIGITS ? frame & ~((uint32_t)DP_BIT << (8 * position)) : frame;
+}
+
+// Left-aligned text. A '.' lights the decimal point of the preceding digit
+// instead of taking a position of its own.
+constexpr uint32_t renderText(const char* text) {
+    uint32_t frame = BLANK_FRAME;
+    uint8_t position = 0;
+    for (const char* p = text; *p; p++) {
+        if (*p == '.') {
+            frame = withDecimalPoint(frame, position > 0 ? position - 1 : 0);
+            if (position == 0) {
+                position = 1;
+            }
+            continue;
+        }
+        if (position >= FRAME_DIGITS) {
+            break;
+        }
+        frame = setDigit(frame, position++, glyph(*p));
+    }
+    return frame;
+}
+
+// Renders text into a strip of segment bytes, one per display position, with
+// the same '.' handling as renderText(). Returns the number of bytes written.
+constexpr uint16_t renderStrip(const char* text, uint8_t* strip, uint16_t capacity) {
+    uint16_t length = 0;
+    for (const char* p = text; *p; p++) {
+        if (*p == '.') {
+            if (length == 0) {
+                if (capacity == 0) {
+                    break;
+                }
+                strip[length++] = BLANK;
+            }
+            strip[length - 1] &= (uint8_t)~DP_BIT;
+            continue;
+        }
+        if (length >= capacity) {
+            break;
+        }
+        strip[length++] = glyph(*p);
+    }
+    return length;
+}
+
+constexpr uint8_t countDigits(uint32_t value) {
+    uint8_t digits = 1;
+    while (value >= 10) {
+        value /= 10;
+        digits++;
+    }
+    return digits;
+}
+
+/**
+ * Right-aligned fixed-point number: value is in units of 10^-decimals, so
+ * renderNumber(213, 1, 'C') shows "21.3C". An optional prefix takes the first
+ * digit, an optional suffix the last one. Leading zeros are added up to
+ * minDigits as far as they fit. If the number is too wide, decimals are
+ * dropped (rounding half away from zero); if it still does not fit the frame
+ * shows dashes.
+ */
+constexpr uint32_t renderNumber(int value, uint8_t decimals = 0, char suffix = '\0',
+                                uint8_t minDigits = 1, char prefix = '\0') {
+    const int width = FRAME_DIGITS - (suffix ? 1 : 0) - (prefix ? 1 : 0);
+    bool negative = value < 0;
+    uint32_t magnitude = negative ? 0U - (uint32_t)value : (uint32_t)value;
+
+    uint8_t digits = 0;
+    for (;;) {
+        digits = countDigits(magnitude);
+        if (digits < decimals + 1) {
+            digits = decimals + 1;
+        }
+        if (digits + (negative ? 1 : 0) <= width) {
+            break;
+        }
+        if (decimals == 0) {
+            return renderText("----");
+        }
+        magnitude = (magnitude + 5) / 10;
+        decimals--;
+        if (magnitude == 0) {
+            negative = false;
+        }
+    }
+
+    // Zero padding never pushes the number out of the frame
+    const int room = width - (negative ? 1 : 0);
+    const int padded = minDigits < room ? minDigits : room;
+    if (digits < padded) {
+        digits = padded;
+    }
+
+    uint32_t frame = BLANK_FRAME;
+    int position = FRAME_DIGITS - 1;
+    if (suffix) {
+        frame = setDigit(frame, position--, glyph(suffix));
+    }
+    for (uint8_t i = 0; i < digits; i++) {
+        uint8_t pattern = glyph((char)('0' + magnitude % 10));
+        if (decimals > 0 && i == decimals) {
+            pattern &= (uint8_t)~DP_BIT;
+        }
+        frame = setDigit(frame, position--, pattern);
+        magnitude /= 10;
+    }
+    if (negative) {
+        frame = setDigit(frame, position--, glyph('-'));
+    }
+    if (prefix) {
+        frame = setDigit(frame, 0, glyph(prefix));
+    }
+    return frame;
+}
+
+// Rounds to the requested number of decimals before rendering
+constexpr uint32_t renderNumber(float value, uint8_t decimals = 0, char suffix = '\0',
+                                uint8_t minDigits = 1, char prefix = '\0') {
+    float scaled = value;
+    for (uint8_t i = 0; i < decimals; i++) {
+        scaled *= 10.0f;
+    }
+    return renderNumber((int)(scaled < 0 ? scaled - 0.5f : scaled + 0.5f),
+                        decimals, suffix, minDigits, prefix);
+}
+
+} // namespace SegmentFont
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include "config.h"
+
+/**
+ * Per-channel software filtering of BME280 readings, plus the sensor's own
+ * oversampling and IIR settings, configured from a textual spec such as
+ *
+ *   "iir:16,temp:2:3:1,hum:1:3:1,pres:2:3:1"
+ *
+ * "iir:<n>" is the hardware IIR coefficient (0, 2, 4, 8 or 16). Channel
+ * entries are channel:oversampling:median:ema with oversampling 1, 2, 4, 8
+ * or 16, an odd median window of 1 to MAX_MEDIAN samples (1 = off) and the
+ * EMA weight of a new sample, 0 < ema <= 1 (1 = off). Entries left out keep
+ * their defaults; an empty spec is all defaults.
+ *
+ * Each sample is first checked against the channel's valid range. An
+ * out-of-range value is rejected and the channel repeats its last output.
+ * Accepted values pass through the median window, then the EMA. All state
+ * is fixed-size and kept per sensor; the settings apply to all sensors.
+ *
+ * setSettings() may be called from any task; apply() runs in the sensor
+ * task and picks new settings up on its next call.
+ */
+class SensorFilter {
+public:
+    enum Channel : uint8_t {
+        TEMPERATURE,
+        HUMIDITY,
+        PRESSURE,
+        CHANNEL_COUNT
+    };
+
+    static constexpr uint8_t MAX_MEDIAN = 7;
+
+    struct ChannelSettings {
+        uint8_t oversampling;   // 1, 2, 4, 8, 16
+        uint8_t median;         // Odd, 1..MAX_MEDIAN
+        float ema;              // Weight of a new sample
+    };
+
+    struct Settings {
+        uint8_t iirCoefficient; // 0, 2, 4, 8, 16
+        ChannelSettings channels[CHANNEL_COUNT];
+    };
+
+    static SensorFilter& getInstance() {
+        static SensorFilter instance;
+        return instance;
+    }
+
+    // Invalid entries are skipped and make parse() return false
+    static bool parse(const String& spec, Settings& settings);
+    static void loadDefaults(Settings& settings);
+    static String toString(const Settings& settings);
+
+    void setSettings(const Settings& settings);
+    Settings getSettings() const;
+    uint32_t getGeneration() const { return generation; }  // Bumped by setSettings()
+
+    // Filters temperature, humidity and pressure of one sensor in place.
+    // Returns false while a rejected channel has no earlier output to fall
+    // back on.
+    bool apply(uint8_t sensor, float values[CHANNEL_COUNT]);
+
+    uint32_t getRejected() const { return rejected; }
+
+private:
+    SensorFilter();
+    SensorFilter(const SensorFilter&) = delete;
+    SensorFilter& operator=(const SensorFilter&) = delete;
+
+    struct ChannelState {
+        float window[MAX_MEDIAN];
+        uint8_t next;
+        uint8_t filled;
+        float output;
+        bool haveOutput;
+    };
+
+    static float median(const float* values, uint8_t count);
+    void reset();
+
+    mutable portMUX_TYPE lock;
+    Settings settings;
+    Settings pending;
+    volatile uint32_t generation;
+    uint32_t appliedGeneration;
+    ChannelState state[SENSOR_MAX_COUNT][CHANNEL_COUNT];
+    volatile uint32_t rejected;
+};
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include "config.h"
+
+/**
+ * Recent BME280 readings plus running statistics, all in static storage.
+ *
+ * Samples go into a fixed ring of HISTORY_CAPACITY entries; once it is full
+ * the oldest one is overwritten. Each sample is also folded into three
+ * rollup windows (1 minute, 1 hour, 24 hours). A window is a small ring of
+ * time buckets, so add() touches one bucket per window and is O(1); a query
+ * merges the buckets that are still inside the window. The oldest bucket of
+ * a window may be partly expired, so a window covers between (n-1)/n and
+ * the whole of its nominal span.
+ */
+class SensorHistory {
+public:
+    enum Channel : uint8_t {
+        TEMPERATURE,
+        HUMIDITY,
+        PRESSURE,
+        CHANNEL_COUNT
+    };
+
+    enum Window : uint8_t {
+        WINDOW_1M,
+        WINDOW_1H,
+        WINDOW_24H,
+        WINDOW_COUNT
+    };
+
+    struct Sample {
+        uint32_t timeMs;                 // Monotonic milliseconds since boot
+        float values[CHANNEL_COUNT];
+    };
+
+    struct Stats {
+        uint32_t count;
+        float min[CHANNEL_COUNT];
+        float max[CHANNEL_COUNT];
+        float mean[CHANNEL_COUNT];
+    };
+
+    static SensorHistory& getInstance() {
+        static SensorHistory instance;
+        return instance;
+    }
+
+    void add(float temperature, float humidity, float pressure);
+
+    // Copies out the sample at position index, 0 being the oldest. Returns
+    // false once index runs past the end.
+    bool getSample(size_t index, Sample& sample) const;
+    size_t size() const;
+    size_t capacity() const { return HISTORY_CAPACITY; }
+
+    bool getStats(Window window, Stats& stats) const;
+
+    static const char* windowName(Window window);
+    static const char* channelName(Channel channel);
+
+private:
+    SensorHistory();
+    SensorHistory(const SensorHistory&) = delete;
+    SensorHistory& operator=(const SensorHistory&) = delete;
+
+    struct Bucket {
+        uint32_t epoch;                  // Monotonic seconds / bucket length
+        uint32_t count;
+        float min[CHANNEL_COUNT];
+        float max[CHANNEL_COUNT];
+        float sum[CHANNEL_COUNT];
+    };
+
+    struct WindowLayout {
+        uint16_t bucketSeconds;
+        uint8_t bucketCount;
+        uint8_t firstBucket;             // Offset into buckets[]
+    };
+
+    static const WindowLayout LAYOUT[WINDOW_COUNT];
+    static const size_t TOTAL_BUCKETS = 12 + 60 + 24;
+
+    mutable portMUX_TYPE lock;
+    Sample samples[HISTORY_CAPACITY];
+    size_t head;                         // Next slot to write
+    size_t count;
+    Bucket buckets[TOTAL_BUCKETS];
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include "BME280Handler.h"
+#include "config.h"
+
+/**
+ * The environmental sensors on the I2C bus, found by one scan at boot.
+ *
+ * Every address a BME280 can answer on (0x76, 0x77) is probed once and a
+ * driver is set up for each sensor that initializes. Sensors are numbered
+ * in address order; index 0 is the primary sensor that feeds GlobalState
+ * and the history. Display, MQTT and the web API address sensors by index.
+ *
+ * Per-sensor state is kept as parallel arrays, so walking one field over
+ * all sensors touches a single small array. All drivers share the sampling
+ * task: sensor i uses notification bits starting at i * EVENT_BITS.
+ */
+class SensorRegistry {
+public:
+    static constexpr uint8_t MAX_SENSORS = SENSOR_MAX_COUNT;
+
+    struct Reading {
+        float temperature;
+        float humidity;
+        float pressure;
+        uint32_t updateTime;    // millis() of the reading, 0 = none yet
+    };
+
+    static SensorRegistry& getInstance() {
+        static SensorRegistry instance;
+        return instance;
+    }
+
+    // Scans the bus and initializes the sensors found; call once after
+    // I2CBus::begin(). Returns the number of sensors.
+    uint8_t begin();
+
+    uint8_t count() const { return sensorCount; }
+    uint8_t getAddress(uint8_t index) const;
+    BME280Handler& driver(uint8_t index) { return drivers[index]; }
+
+    // Sampling task side
+    bool startSampling(TaskHandle_t task, uint32_t intervalMs);
+    uint32_t handleEvents(uint32_t events);  // Bit i set: sensor i has a new sample
+    void update(uint8_t index, float temperature, float humidity, float pressure);
+
+    // Readers; false for an unknown index or one without a reading
+    bool getReading(uint8_t index, Reading& reading) const;
+    bool isFresh(uint8_t index, uint32_t maxAgeMs) const;
+
+private:
+    SensorRegistry();
+    SensorRegistry(const SensorRegistry&) = delete;
+    SensorRegistry& operator=(const SensorRegistry&) = delete;
+
+    mutable portMUX_TYPE lock;
+    uint8_t sensorCount;
+    BME280Handler drivers[MAX_SENSORS];
+
+    // Per-sensor state, indexed like drivers
+    uint8_t addresses[MAX_SENSORS];
+    float temperatures[MAX_SENSORS];
+    float humidities[MAX_SENSORS];
+    float pressures[MAX_SENSORS];
+    uint32_t updateTimes[MAX_SENSORS];
+};
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <Arduino.h>
+#include <AsyncUDP.h>
+#include <lwip/dns.h>
+#include <atomic>
+#include <functional>
+
+// One NTP exchange, reduced per RFC 4330
+struct SntpSample {
+    uint8_t server;      // Index into the configured server list
+    uint8_t stratum;
+    int64_t offsetUs;    // Server clock minus the local system clock
+    uint32_t rttUs;      // Round-trip delay, excluding server processing
+    int64_t utcUs;       // Server time at monoUs
+    int64_t monoUs;      // esp_timer time the sample refers to
+};
+
+// success is false when no server produced a usable sample
+typedef std::function<void(bool success, const SntpSample& sample)> SntpResultCallback;
+
+/**
+ * Asynchronous SNTP client.
+ *
+ * requestSync() queries every configured server in turn and the sample with
+ * the shortest round trip is reported through the result callback. All work
+ * happens in loop(), which only polls state: DNS runs through lwIP's
+ * asynchronous resolver and replies are timestamped on arrival by the
+ * AsyncUDP task, so the caller is never blocked.
+ *
+ * Servers are given as "host[:port],host[:port],...", which also allows a
+ * local stand-in server to be used for testing.
+ */
+class SntpClient {
+public:
+    static constexpr uint8_t MAX_SERVERS = 4;
+    static constexpr size_t MAX_HOST_LENGTH = 48;
+
+    static SntpClient& getInstance() {
+        static SntpClient instance;
+        return instance;
+    }
+
+    bool begin(const char* serverList);
+    void onResult(SntpResultCallback callback) { resultCallback = callback; }
+    bool requestSync();
+    void loop();
+
+    bool isBusy() const { return state.load() != State::IDLE; }
+    uint8_t getServerCount() const { return serverCount; }
+    const char* getServerHost(uint8_t index) const { return servers[index].host; }
+
+private:
+    SntpClient();
+    SntpClient(const SntpClient&) = delete;
+    SntpClient& operator=(const SntpClient&) = delete;
+
+    enum class State : uint8_t {
+        IDLE,
+        RESOLVING,
+        WAITING
+    };
+
+    struct Server {
+        char host[MAX_HOST_LENGTH];
+        uint16_t port;
+    };
+
+    static constexpr size_t PACKET_SIZE = 48;
+
+    void startServer(uint8_t index);
+    void sendRequest(uint32_t address);
+    void finishServer();
+    bool parseResponse(SntpSample& sample);
+    void onPacket(AsyncUDPPacket& packet);
+    static void dnsFound(const char* name, const ip_addr_t* ipaddr, void* arg);
+
+    AsyncUDP udp;
+    bool listening;
+    Server servers[MAX_SERVERS];
+    uint8_t serverCount;
+
+    std::atomic<State> state;  // Read by the UDP task
+    uint8_t currentServer;
+    unsigned long serverStartTime;
+
+    // DNS results arrive on the lwIP thread; the generation tags each lookup
+    // so a late answer for a server that already timed out is ignored
+    std::atomic<uint32_t> dnsGeneration;
+    std::atomic<uint32_t> resolvedAddress;
+    std::atomic<bool> resolveFailed;
+
+    // Request in flight. The transmit timestamp is a random cookie that the
+    // server echoes back as originate timestamp.
+    uint64_t requestCookie;
+    int64_t requestMonoUs;
+    int64_t requestSystemUs;
+
+    // Reply as captured by the UDP task
+    uint8_t response[PACKET_SIZE];
+    int64_t responseMonoUs;
+    int64_t responseSystemUs;
+    std::atomic<bool> responseReady;
+
+    SntpSample best;
+    bool haveBest;
+    SntpResultCallback resultCallback;
+};
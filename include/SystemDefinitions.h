@@ -12,7 +12,12 @@ enum class DisplayMode {
     TEMPERATURE = 2,
     HUMIDITY = 3,
     PRESSURE = 4,
-    REMOTE_TEMP = 5
+    REMOTE_TEMP = 5,
+    MESSAGE = 6,      // Scrolling text, not part of the rotation
+    DEW_POINT = 7,    // Derived by ComfortMetrics
+    ABS_HUMIDITY = 8,
+    HEAT_INDEX = 9,
+    SEA_LEVEL_PRESSURE = 10
 };
 
 // RelayState enumeration
@@ -59,6 +64,15 @@ struct DisplayPreferences {
     String mqttUsername;
     String mqttPassword;
     uint16_t mqttPublishInterval;
+
+    // Display rotation, see DisplayPlaylist (empty = built-in default)
+    String displayPlaylist;
+
+    // BME280 oversampling and filtering, see SensorFilter (empty = defaults)
+    String sensorFilter;
+
+    // Station altitude in metres for the sea-level pressure
+    int16_t sensorAltitude;
 };
 
 // Relay status structure
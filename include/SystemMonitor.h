@@ -18,6 +18,9 @@ public:
     void update();
     bool checkMemory();
     void monitorTaskStacks(TaskHandle_t* taskHandles, const char** taskNames, size_t numTasks);
+
+    // Queues the diagnostic entity configs, retained. False when the
+    // publish queue filled up; the next call resumes where this one stopped.
     bool publishHomeAssistantDiscovery();
     
     void publishStatus(bool online = true);
@@ -37,7 +40,10 @@ private:
     uint32_t _ntpSyncAttempts;
     uint32_t _ntpSyncSuccesses;
     uint32_t _ntpSyncFailures;
-    unsigned long lastDiscoveryTime;
+    unsigned long lastDiscoveryTime;      // Last complete round, 0 before the first
+    unsigned long lastDiscoveryAttempt;
+    uint8_t discoveryNext;                // Metric to queue next
+    bool discoveryPending;
     
     // Internal methods
     void publishDiagnostics(bool retain = false);
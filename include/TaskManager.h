@@ -8,7 +8,7 @@
 #include "config.h"
 #include "GlobalState.h"
 #include "PreferencesManager.h"
-#include "displayHandler.h"
+#include "DisplayHandler.h"
 #include "auth_manager.h"
 #include "rate_limiter.h"
 #include "MQTTManager.h"
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <sys/time.h>
+#include <time.h>
+
+/**
+ * Wall clock built on the monotonic esp_timer microsecond counter.
+ *
+ * Every NTP sync is taken as a sample (monotonic time, true UTC). The first
+ * sample and corrections larger than TIME_STEP_THRESHOLD_US step the clock;
+ * smaller ones are slewed in at TIME_SLEW_RATE_PPM so the displayed time never
+ * jumps. The error left over between successive syncs is folded into a skew
+ * estimate that corrects the crystal's frequency offset between syncs.
+ */
+class TimeService {
+public:
+    static TimeService& getInstance() {
+        static TimeService instance;
+        return instance;
+    }
+
+    // Feeds one NTP sample: utcUs was true UTC at monotonic time monoUs
+    void onNtpSync(int64_t utcUs, int64_t monoUs);
+
+    bool isValid() const;
+    int64_t monotonicUs() const;
+    int64_t nowUs() const;
+
+    // Local broken-down time plus the milliseconds into the current second
+    bool getLocalTime(struct tm& info, uint16_t* millis = nullptr) const;
+
+    // Diagnostics
+    int32_t getLastOffsetUs() const;     // Correction measured at the last sync
+    float getDriftPpm() const;           // Learned oscillator skew
+    int32_t getSlewRemainingUs() const;  // Correction not yet applied
+    uint32_t getSyncCount() const { return syncCount; }
+    uint32_t getStepCount() const { return stepCount; }
+
+private:
+    TimeService();
+    TimeService(const TimeService&) = delete;
+    TimeService& operator=(const TimeService&) = delete;
+
+    // Clock model: UTC = anchorUtc + elapsed * (1 + skew) + applied slew
+    struct Model {
+        bool valid;
+        int64_t anchorMono;
+        int64_t anchorUtc;
+        int32_t skewPpb;
+        int32_t slewUs;
+    };
+
+    static int64_t utcAt(const Model& model, int64_t monoUs);
+    static int32_t slewAppliedAt(const Model& model, int64_t monoUs);
+
+    Model snapshot() const;
+
+    mutable portMUX_TYPE lock;
+    Model model;
+    int64_t lastSyncMono;
+    int32_t lastOffsetUs;
+    uint32_t syncCount;
+    uint32_t stepCount;
+};
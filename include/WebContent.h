@@ -1025,6 +1025,16 @@ const char PREFERENCES_PAGE_HTML[] PROGMEM = R"rawliteral(
                 </div>
             </div>
             
+            <!-- Display Message Section -->
+            <div class="section">
+                <h2>Display Message</h2>
+                <div class="form-group">
+                    <label for="display-message">Text to show on the clock (scrolls when longer than 4 characters)</label>
+                    <input type="text" id="display-message" class="form-control" maxlength="64" placeholder="Hello">
+                </div>
+                <button type="button" id="display-message-button" class="save-button">Show Message</button>
+            </div>
+            
             <form id="preferences-form">
                 <div class="section">
                     <h2>Night Mode Dimming</h2>
@@ -1082,6 +1092,32 @@ const char PREFERENCES_PAGE_HTML[] PROGMEM = R"rawliteral(
                         </div>
                     </div>
                 </div>
+                <div class="section">
+                    <h2>Display Rotation</h2>
+                    <div class="form-group">
+                        <label for="display-playlist">Playlist</label>
+                        <input type="text" id="display-playlist" name="displayPlaylist" class="form-control"
+                               placeholder="time:8,date:2,temp:2,hum:2,pres:2,remote:3">
+                        <small class="form-text" style="color: var(--subheading-color);">Entries are mode:seconds[:condition]. Modes: time, date, temp, hum, pres, remote, dew (dew point), abshum (absolute humidity), heat (heat index), slp (sea-level pressure).
+                        Add @1 to a sensor mode for the second sensor. Conditions: always, clock, sensor, remote. Leave empty for the default rotation.</small>
+                    </div>
+                </div>
+                <div class="section">
+                    <h2>Sensor Filtering</h2>
+                    <div class="form-group">
+                        <label for="sensor-filter">Filter</label>
+                        <input type="text" id="sensor-filter" name="sensorFilter" class="form-control"
+                               placeholder="iir:16,temp:2:3:1,hum:1:3:1,pres:2:3:1">
+                        <small class="form-text" style="color: var(--subheading-color);">iir:coefficient (0, 2, 4, 8, 16) sets the sensor's own filter.
+                        Channels (temp, hum, pres) are channel:oversampling[:median[:ema]] with oversampling 1-16, an odd median window up to 7 and an EMA weight up to 1 (1 = off). Leave empty for the defaults.</small>
+                    </div>
+                    <div class="form-group">
+                        <label for="sensor-altitude">Altitude (m)</label>
+                        <input type="number" id="sensor-altitude" name="sensorAltitude" class="form-control"
+                               min="-500" max="5000" step="1" placeholder="0">
+                        <small class="form-text" style="color: var(--subheading-color);">Height of the clock above sea level, used to reduce the pressure to sea level.</small>
+                    </div>
+                </div>
                 <div class="section">
                     <h2>Remote Temperature Sensor</h2>
                     <div class="form-group">
@@ -1455,6 +1491,21 @@ const char PREFERENCES_PAGE_HTML[] PROGMEM = R"rawliteral(
                     mqttIntervalField.value = data.mqttPublishInterval;
                 }
                 
+                const playlistField = document.getElementById('display-playlist');
+                if (playlistField) {
+                    playlistField.value = data.displayPlaylist || '';
+                }
+                
+                const filterField = document.getElementById('sensor-filter');
+                if (filterField) {
+                    filterField.value = data.sensorFilter || '';
+                }
+                
+                const altitudeField = document.getElementById('sensor-altitude');
+                if (altitudeField) {
+                    altitudeField.value = data.sensorAltitude || 0;
+                }
+                
                 // Update settings visibility
                 toggleSensorhubSettings();
                 toggleMqttSettings();
@@ -1569,6 +1620,35 @@ const char PREFERENCES_PAGE_HTML[] PROGMEM = R"rawliteral(
                 }
             }
         }
+        function setupDisplayMessage() {
+            const button = document.getElementById('display-message-button');
+            if (!button) return;
+            
+            button.addEventListener('click', async function() {
+                const input = document.getElementById('display-message');
+                try {
+                    const response = await fetchWithTimeout('/api/display/message', {
+                        method: 'POST',
+                        headers: {
+                            'Content-Type': 'application/json',
+                        },
+                        body: JSON.stringify({
+                            message: input.value
+                        })
+                    }, 3000);
+    
+                    const result = await response.json();
+                    if (response.ok && result.success) {
+                        showStatus(input.value ? 'Message sent to display' : 'Display message cleared');
+                    } else {
+                        throw new Error(result.error || 'Failed to show message');
+                    }
+                } catch (error) {
+                    console.error('Error sending display message:', error);
+                    showStatus('Failed to show message: ' + error.message, true);
+                }
+            });
+        }
         // Function to toggle mqtt password visibility
         function toggleMqttPasswordVisibility() {
             const passwordInput = document.getElementById('mqtt-password');
@@ -1707,6 +1787,7 @@ const char PREFERENCES_PAGE_HTML[] PROGMEM = R"rawliteral(
         
         // Setup relay controls
         setupRelayControls();
+        setupDisplayMessage();
         
         // Load data asynchronously
         setTimeout(() => {
@@ -1740,7 +1821,14 @@ const char PREFERENCES_PAGE_HTML[] PROGMEM = R"rawliteral(
                         mqttPublishEnabled: formData.get('mqttPublishEnabled') === 'enabled',
                         mqttBrokerAddress: formData.get('mqttBrokerAddress'),
                         mqttUsername: formData.get('mqttUsername'),
-                        mqttPublishInterval: parseInt(formData.get('mqttPublishInterval'))
+                        mqttPublishInterval: parseInt(formData.get('mqttPublishInterval')),
+                        
+                        // Display rotation
+                        displayPlaylist: formData.get('displayPlaylist') || '',
+                        
+                        // Sensor filtering
+                        sensorFilter: formData.get('sensorFilter') || '',
+                        sensorAltitude: parseInt(formData.get('sensorAltitude')) || 0
                     };
                     
                     // Only include passwords if provided (don't clear existing passwords)
@@ -23,6 +23,12 @@ void handleIcon();
 void handleGetRelayState();
 void handleSetRelayState();
 void handleRelayControl();
+void handleDisplayMessage();
+void handleGetHistory();
+void handleGetHistoryLog();
+void handleGetSensors();
+void handleGetI2CStats();
+void handleGetMqttStats();
 void addCorsHeaders(WebServer* server);
 
 // Helper functions
@@ -18,6 +18,7 @@
 #define MQTT_CLIENT_ID "ablutionoracle1"
 #define MQTT_TOPIC_AUX_DISPLAY "sensor"
 #define MQTT_TOPIC_RELAY "relay"
+#define MQTT_TOPIC_DISPLAY_MESSAGE "display/message"
 #define MQTT_BROKER "homeassistant.local"
 #define MQTT_PORT 1883
 #define MQTT_USER "admin"
@@ -25,7 +26,7 @@
 #define MQTT_SENSORHUB_TOPIC "sensorhub1"
 
 #define MQTT_TOPIC_STATUS "status"
-#define MQTT_QOS 1
+#define MQTT_QOS 1                     // Publishes and the LWT: 0, or 1 with PUBACK tracking
 
 #define BASE_MDNS_NAME "chaoticvolt"
 // mDNS Configuration
@@ -41,10 +42,18 @@
 #define DISPLAY_HUM_DURATION 2000     // 2 seconds
 #define DISPLAY_PRES_DURATION 2000    // 2 seconds
 #define DISPLAY_REMOTE_DURATION 3000  // 2 seconds
+#define DISPLAY_DATA_MAX_AGE 300000   // Skip sensor modes with older data (5 min)
+#define DISPLAY_COLON_BLINK_MS 500    // Colon toggle period in time mode
+#define DISPLAY_MAX_SLEEP_MS 1000     // Longest display task sleep between deadlines
 
 // I2C Configuration (BME280)
 #define I2C_SDA 21
 #define I2C_SCL 22
+#define I2C_CLOCK_HZ 100000
+#define I2C_COALESCE_GAP 4            // Unused bytes read to save a transaction
+#define I2C_MAX_BURST 32              // Longest coalesced read
+#define I2C_MAX_BATCH 8               // Register blocks per readBatch()
+#define I2C_RECOVERY_THRESHOLD 3      // Failures in a row before the bus is reset
 
 // Only define BME280_ADDRESS if not already defined by the library
 #ifndef BME280_ADDRESS
@@ -75,8 +84,12 @@
 #define MQTT_KEEPALIVE 60
 
 // NTP Configuration
-#define NTP_SERVER "pool.ntp.org"
+#define NTP_SERVERS "pool.ntp.org,time.cloudflare.com,time.google.com"  // host[:port], comma separated
+#define SNTP_SERVER_TIMEOUT_MS 1500   // Per server, including DNS
 #define TZ_INFO "CET-1CEST,M3.5.0,M10.5.0/3"
+#define TIME_STEP_THRESHOLD_US 1000000  // Larger NTP corrections are stepped, smaller ones slewed
+#define TIME_SLEW_RATE_PPM 500           // Rate at which corrections are slewed in
+#define TIME_MAX_SKEW_PPM 500            // Limit on the learned oscillator drift
 
 // Task Configuration
 #define STACK_SIZE_DISPLAY 8192
@@ -94,8 +107,43 @@
 
 // Sensor Update Intervals
 #define BME280_UPDATE_INTERVAL 30000  // 30 seconds
+#define BME280_SAMPLE_INTERVAL 2000   // Forced conversion period while readings change (ms)
+#define BME280_SLOW_INTERVAL 30000    // Period once readings are stable (ms)
+#define BME280_READY_RETRY_US 500     // Recheck delay if a conversion overruns
+#define BME280_READY_MAX_RETRIES 4
+#define BME280_FIXED_POINT 1          // 1 = integer compensation, 0 = float
+#define SENSOR_MAX_COUNT 2            // BME280s on the bus, one per address (0x76, 0x77)
+#define SENSOR_DEADBAND_TEMP 0.1f     // Change (degC) that is published / counts as movement
+#define SENSOR_DEADBAND_HUM 0.5f      // %RH
+#define SENSOR_DEADBAND_PRES 0.2f     // hPa
+#define SENSOR_RATE_TEMP 0.3f         // Change per minute that speeds sampling up, degC
+#define SENSOR_RATE_HUM 2.0f          // %RH per minute
+#define SENSOR_RATE_PRES 0.5f         // hPa per minute
+#define SENSOR_HEARTBEAT_INTERVAL 300000  // Publish at least this often (ms)
+#define SENSOR_ALTITUDE 0             // Default station altitude (m) for sea-level pressure
+#define HISTORY_CAPACITY 512          // Samples kept in RAM (about 17 min at 2 s)
+#define HISTORY_LOG_INTERVAL 60       // Seconds averaged into one stored record
+#define HISTORY_SEGMENT_PAGES 64      // 256-byte pages per log file (16 KB)
+#define HISTORY_MAX_SEGMENTS 32       // Log files kept, about 40 days at most
 #define DISPLAY_UPDATE_INTERVAL 100    // 100 ms
 #define MQTT_PUBLISH_INTERVAL 60000    // 60 seconds
+#define MQTT_QUEUE_BYTES 6144          // Outbound publish queue, allocated once
+#define MQTT_QUEUE_MAX_MESSAGE 1280    // Largest topic + payload it accepts
+#define MQTT_QUEUE_LOCK_MS 5           // Producers give up on a busy queue after this
+#define MQTT_QUEUE_BATCH 8             // Messages sent per network task wake-up
+#define MQTT_QUEUE_RETRY_MS 1000       // Pause after a failed send
+#define MQTT_QUEUE_MAX_ATTEMPTS 3      // Sends of one message while connected before it is dropped
+#define MQTT_BUFFER_SIZE 1536          // Outgoing packet buffer, holds the largest queued message
+#define MQTT_RX_BUFFER_SIZE 512        // Incoming packets; larger messages are dropped
+#define MQTT_CONNECT_TIMEOUT_MS 3000   // Longest the name lookup, TCP connect and CONNACK may each take
+#define MQTT_INFLIGHT_WINDOW 4         // QoS 1 publishes sent ahead of their PUBACK
+#define MQTT_INFLIGHT_BYTES 4096       // Copies of those, for retransmission after a reconnect
+#define MQTT_ACK_TIMEOUT_MS 15000      // Reconnect when the oldest stays unacknowledged this long
+#define MQTT_SPOOL_BYTES 8192          // Telemetry kept in RAM while the broker is unreachable
+#define MQTT_SPOOL_SPILL 1             // 1 = move the overflow to SPIFFS, 0 = RAM only
+#define MQTT_SPOOL_SEGMENT_BYTES 16384 // Per spill file
+#define MQTT_SPOOL_MAX_SEGMENTS 8      // Spill files kept, 128 KB at most
+#define MQTT_SPOOL_REPLAY_INTERVAL 200 // ms between replayed messages after a reconnect
  
 // Display PIN Configuration
 #define DATA_PIN 26
@@ -103,6 +151,19 @@
 #define LATCH_PIN 33
 #define OE_PIN 25
 
+// Display brightness engine (OE pin driven by a dedicated LEDC channel)
+#define BRIGHTNESS_LEDC_CHANNEL 0
+#define BRIGHTNESS_PWM_FREQ 5000        // Hz, well above visible flicker
+#define BRIGHTNESS_PWM_RESOLUTION 10    // bits, must match the gamma table
+#define BRIGHTNESS_FADE_MS 1500         // Day/night transition time
+#define DISPLAY_SUBFRAME_COUNT 4        // Per-digit brightness steps
+#define DISPLAY_SUBFRAME_US 1250        // 800 Hz subframes, 200 Hz full cycle
+
+// Scrolling messages
+#define MESSAGE_SCROLL_MS 350           // Time per scroll step
+#define MESSAGE_REPEATS 2               // Passes before returning to rotation
+#define MESSAGE_STATIC_MS 5000          // Display time for messages that fit
+
 // Display configuration
 #define DISPLAY_COUNT 4    // Number of 7-segment displays
 
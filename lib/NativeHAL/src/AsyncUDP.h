@@ -0,0 +1,51 @@
+// AsyncUDP.h - Callback driven UDP socket (native build)
+//
+// Packets are delivered on a dedicated receive thread, which stands in for
+// the async_udp task on the device.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include "IPAddress.h"
+
+class AsyncUDPPacket {
+public:
+    AsyncUDPPacket(uint8_t* data, size_t length, IPAddress remoteIp, uint16_t remotePort)
+        : _data(data), _length(length), _remoteIp(remoteIp), _remotePort(remotePort) {}
+
+    uint8_t* data() { return _data; }
+    size_t length() const { return _length; }
+    IPAddress remoteIP() const { return _remoteIp; }
+    uint16_t remotePort() const { return _remotePort; }
+
+private:
+    uint8_t* _data;
+    size_t _length;
+    IPAddress _remoteIp;
+    uint16_t _remotePort;
+};
+
+typedef std::function<void(AsyncUDPPacket& packet)> AuPacketHandlerFunction;
+
+class AsyncUDP {
+public:
+    AsyncUDP() : _fd(-1), _running(false) {}
+    ~AsyncUDP() { close(); }
+
+    bool listen(uint16_t port);
+    void onPacket(AuPacketHandlerFunction cb) { _handler = cb; }
+    size_t writeTo(const uint8_t* data, size_t len, const IPAddress& addr, uint16_t port);
+    void close();
+    bool connected() const { return _fd >= 0; }
+
+private:
+    void receiveLoop();
+
+    int _fd;
+    std::atomic<bool> _running;
+    std::thread _thread;
+    AuPacketHandlerFunction _handler;
+};
@@ -0,0 +1,16 @@
+// DNSServer.h - Captive portal DNS (native build; the host resolver is used)
+#pragma once
+
+#include "Arduino.h"
+
+class DNSServer {
+public:
+    bool start(const uint16_t port, const String& domainName, const IPAddress& resolvedIP) {
+        (void)port; (void)domainName; (void)resolvedIP;
+        return true;
+    }
+    void stop() {}
+    void processNextRequest() {}
+    void setErrorReplyCode(int code) { (void)code; }
+    void setTTL(uint32_t ttl) { (void)ttl; }
+};
@@ -0,0 +1,18 @@
+// ESPmDNS.h - mDNS responder (native build; advertising is a no-op)
+#pragma once
+
+#include "Arduino.h"
+
+class MDNSResponder {
+public:
+    bool begin(const char* hostName) { return hostName && *hostName; }
+    void end() {}
+    void addService(const char* service, const char* proto, uint16_t port) {
+        (void)service; (void)proto; (void)port;
+    }
+    void addService(const String& service, const String& proto, uint16_t port) {
+        addService(service.c_str(), proto.c_str(), port);
+    }
+};
+
+extern MDNSResponder MDNS;
@@ -0,0 +1,21 @@
+// Esp.h - ESP chip information (native build)
+#pragma once
+
+#include <stdint.h>
+
+class EspClass {
+public:
+    uint32_t getHeapSize();
+    uint32_t getFreeHeap();
+    uint32_t getMinFreeHeap();
+    uint32_t getMaxAllocHeap();
+    uint8_t getCpuFreqMHz() { return 240; }
+    uint32_t getCycleCount();
+    const char* getSdkVersion() { return "native"; }
+    const char* getChipModel() { return "host"; }
+    uint64_t getEfuseMac() { return 0x0000AABBCCDDEEFFULL; }
+    uint32_t getFlashChipSize() { return 4 * 1024 * 1024; }
+    [[noreturn]] void restart();
+};
+
+extern EspClass ESP;
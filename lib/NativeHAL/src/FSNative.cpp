@@ -0,0 +1,376 @@
+// FSNative.cpp - SPIFFS and NVS Preferences on the host filesystem (native build)
+//
+// SPIFFS files live under <fsRoot>/spiffs and Preferences under
+// <fsRoot>/nvs/<namespace>/<key>. SPIFFS has no real directories, so opening
+// a file for writing creates any missing parent directories, matching the
+// device where "/prefs/ns/key" is simply a flat name.
+#include "FS.h"
+#include "SPIFFS.h"
+#include "Preferences.h"
+#include "NativeHAL.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <sstream>
+
+fs::SPIFFSFS SPIFFS;
+
+namespace {
+
+constexpr size_t SPIFFS_PARTITION_BYTES = 0xF0000;
+
+bool makeDirs(const std::string& path) {
+    if (path.empty()) return true;
+    struct stat st;
+    if (stat(path.c_str(), &st) == 0) return S_ISDIR(st.st_mode);
+    size_t slash = path.find_last_of('/');
+    if (slash != std::string::npos && slash > 0 && !makeDirs(path.substr(0, slash))) {
+        return false;
+    }
+    return ::mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+}
+
+bool makeParentDirs(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    return slash == std::string::npos || makeDirs(path.substr(0, slash));
+}
+
+size_t directoryBytes(const std::string& path) {
+    size_t total = 0;
+    DIR* dir = opendir(path.c_str());
+    if (!dir) return 0;
+    while (struct dirent* entry = readdir(dir)) {
+        if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, "..")) continue;
+        std::string child = path + "/" + entry->d_name;
+        struct stat st;
+        if (stat(child.c_str(), &st) != 0) continue;
+        total += S_ISDIR(st.st_mode) ? directoryBytes(child) : (size_t)st.st_size;
+    }
+    closedir(dir);
+    return total;
+}
+
+void removeTree(const std::string& path) {
+    DIR* dir = opendir(path.c_str());
+    if (!dir) {
+        ::remove(path.c_str());
+        return;
+    }
+    while (struct dirent* entry = readdir(dir)) {
+        if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, "..")) continue;
+        removeTree(path + "/" + entry->d_name);
+    }
+    closedir(dir);
+    ::rmdir(path.c_str());
+}
+
+} // namespace
+
+namespace fs {
+
+class FileImpl {
+public:
+    FileImpl(const std::string& hostPath, const std::string& devicePath, FILE* file, DIR* dir)
+        : hostPath(hostPath), devicePath(devicePath), file(file), dir(dir) {
+        size_t slash = devicePath.find_last_of('/');
+        name = slash == std::string::npos ? devicePath : devicePath.substr(slash + 1);
+    }
+    ~FileImpl() { close(); }
+
+    void close() {
+        if (file) fclose(file);
+        if (dir) closedir(dir);
+        file = nullptr;
+        dir = nullptr;
+    }
+
+    std::string hostPath;
+    std::string devicePath;
+    std::string name;
+    FILE* file;
+    DIR* dir;
+};
+
+size_t File::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t File::write(const uint8_t* buf, size_t size) {
+    if (!_impl || !_impl->file) return 0;
+    return fwrite(buf, 1, size, _impl->file);
+}
+
+int File::available() {
+    if (!_impl || !_impl->file) return 0;
+    return (int)(size() - position());
+}
+
+int File::read() {
+    if (!_impl || !_impl->file) return -1;
+    return fgetc(_impl->file);
+}
+
+int File::peek() {
+    if (!_impl || !_impl->file) return -1;
+    int c = fgetc(_impl->file);
+    if (c != EOF) ungetc(c, _impl->file);
+    return c;
+}
+
+void File::flush() {
+    if (_impl && _impl->file) fflush(_impl->file);
+}
+
+size_t File::read(uint8_t* buf, size_t size) {
+    if (!_impl || !_impl->file) return 0;
+    return fread(buf, 1, size, _impl->file);
+}
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+    if (!_impl || !_impl->file) return false;
+    int whence = mode == SeekSet ? SEEK_SET : (mode == SeekCur ? SEEK_CUR : SEEK_END);
+    return fseek(_impl->file, (long)pos, whence) == 0;
+}
+
+size_t File::position() const {
+    if (!_impl || !_impl->file) return 0;
+    long pos = ftell(_impl->file);
+    return pos < 0 ? 0 : (size_t)pos;
+}
+
+size_t File::size() const {
+    if (!_impl) return 0;
+    if (_impl->file) fflush(_impl->file);
+    struct stat st;
+    return stat(_impl->hostPath.c_str(), &st) == 0 ? (size_t)st.st_size : 0;
+}
+
+void File::close() {
+    if (_impl) _impl->close();
+    _impl.reset();
+}
+
+File::operator bool() const {
+    return _impl && (_impl->file || _impl->dir);
+}
+
+const char* File::path() const {
+    return _impl ? _impl->devicePath.c_str() : nullptr;
+}
+
+const char* File::name() const {
+    return _impl ? _impl->name.c_str() : nullptr;
+}
+
+time_t File::getLastWrite() {
+    struct stat st;
+    return _impl && stat(_impl->hostPath.c_str(), &st) == 0 ? st.st_mtime : 0;
+}
+
+bool File::isDirectory() const {
+    return _impl && _impl->dir;
+}
+
+File File::openNextFile(const char* mode) {
+    if (!_impl || !_impl->dir) return File();
+    while (struct dirent* entry = readdir(_impl->dir)) {
+        if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, "..")) continue;
+        std::string devicePath = _impl->devicePath;
+        if (devicePath.empty() || devicePath.back() != '/') devicePath += '/';
+        devicePath += entry->d_name;
+        std::string hostPath = _impl->hostPath + "/" + entry->d_name;
+        struct stat st;
+        if (stat(hostPath.c_str(), &st) != 0) continue;
+        if (S_ISDIR(st.st_mode)) {
+            return File(std::make_shared<FileImpl>(hostPath, devicePath, nullptr, opendir(hostPath.c_str())));
+        }
+        FILE* file = fopen(hostPath.c_str(), mode[0] == 'r' ? "rb" : (mode[0] == 'a' ? "ab" : "wb"));
+        if (file) return File(std::make_shared<FileImpl>(hostPath, devicePath, file, nullptr));
+    }
+    return File();
+}
+
+void File::rewindDirectory() {
+    if (_impl && _impl->dir) rewinddir(_impl->dir);
+}
+
+String FS::hostPath(const char* path) const {
+    std::string root = NativeHAL::fsPath(_mountPoint);
+    if (path && *path && *path != '/') root += '/';
+    if (path) root += path;
+    while (root.size() > 1 && root.back() == '/') root.pop_back();
+    return String(root);
+}
+
+File FS::open(const char* path, const char* mode, bool create) {
+    if (!path || !mode) return File();
+    std::string host = hostPath(path).str();
+    struct stat st;
+    bool exists = stat(host.c_str(), &st) == 0;
+
+    if (exists && S_ISDIR(st.st_mode)) {
+        return File(std::make_shared<FileImpl>(host, path, nullptr, opendir(host.c_str())));
+    }
+    if (mode[0] == 'r' && !exists && !create) {
+        return File();
+    }
+    if (mode[0] != 'r' || create) {
+        makeParentDirs(host);
+    }
+    const char* hostMode = mode[0] == 'r' ? (strchr(mode, '+') ? "r+b" : "rb")
+                         : mode[0] == 'a' ? (strchr(mode, '+') ? "a+b" : "ab")
+                         : (strchr(mode, '+') ? "w+b" : "wb");
+    if (mode[0] == 'r' && !exists && create) {
+        hostMode = "w+b";
+    }
+    FILE* file = fopen(host.c_str(), hostMode);
+    if (!file) return File();
+    return File(std::make_shared<FileImpl>(host, path, file, nullptr));
+}
+
+bool FS::exists(const char* path) {
+    struct stat st;
+    return stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool FS::remove(const char* path) {
+    return ::remove(hostPath(path).c_str()) == 0;
+}
+
+bool FS::rename(const char* pathFrom, const char* pathTo) {
+    String to = hostPath(pathTo);
+    makeParentDirs(to.str());
+    return ::rename(hostPath(pathFrom).c_str(), to.c_str()) == 0;
+}
+
+bool FS::mkdir(const char* path) {
+    return makeDirs(hostPath(path).str());
+}
+
+bool FS::rmdir(const char* path) {
+    return ::rmdir(hostPath(path).c_str()) == 0;
+}
+
+bool SPIFFSFS::begin(bool formatOnFail, const char*, uint8_t, const char*) {
+    if (makeDirs(hostPath("/").str())) {
+        return true;
+    }
+    return formatOnFail && format();
+}
+
+bool SPIFFSFS::format() {
+    std::string root = hostPath("/").str();
+    removeTree(root);
+    return makeDirs(root);
+}
+
+size_t SPIFFSFS::totalBytes() {
+    return SPIFFS_PARTITION_BYTES;
+}
+
+size_t SPIFFSFS::usedBytes() {
+    return directoryBytes(hostPath("/").str());
+}
+
+} // namespace fs
+
+// ---------------------------------------------------------------------------
+// Preferences
+// ---------------------------------------------------------------------------
+
+bool Preferences::begin(const char* name, bool readOnly, const char*) {
+    if (!name || !*name || strlen(name) > 15) {
+        return false;
+    }
+    _dir = NativeHAL::fsPath("nvs") + "/" + name;
+    _readOnly = readOnly;
+    _started = readOnly || makeDirs(_dir);
+    return _started;
+}
+
+std::string Preferences::keyPath(const char* key) const {
+    return _dir + "/" + (key ? key : "");
+}
+
+bool Preferences::clear() {
+    if (!_started || _readOnly) return false;
+    removeTree(_dir);
+    return makeDirs(_dir);
+}
+
+bool Preferences::remove(const char* key) {
+    if (!_started || _readOnly || !key) return false;
+    return ::remove(keyPath(key).c_str()) == 0;
+}
+
+bool Preferences::isKey(const char* key) {
+    struct stat st;
+    return _started && key && stat(keyPath(key).c_str(), &st) == 0;
+}
+
+size_t Preferences::putValue(const char* key, const String& value) {
+    return putBytes(key, value.c_str(), value.length()) == value.length() ? value.length() : 0;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) {
+    if (!_started || _readOnly || !key || strlen(key) > 15) return 0;
+    std::ofstream out(keyPath(key), std::ios::binary | std::ios::trunc);
+    if (!out) return 0;
+    out.write(static_cast<const char*>(value), (std::streamsize)len);
+    return out ? len : 0;
+}
+
+bool Preferences::readValue(const char* key, std::string& out) {
+    if (!_started || !key) return false;
+    std::ifstream in(keyPath(key), std::ios::binary);
+    if (!in) return false;
+    std::ostringstream buffer;
+    buffer << in.rdbuf();
+    out = buffer.str();
+    return true;
+}
+
+bool Preferences::getBool(const char* key, bool defaultValue) {
+    std::string value;
+    return readValue(key, value) ? value == "1" : defaultValue;
+}
+
+int32_t Preferences::getLong(const char* key, int32_t defaultValue) {
+    std::string value;
+    return readValue(key, value) ? (int32_t)strtol(value.c_str(), nullptr, 10) : defaultValue;
+}
+
+float Preferences::getFloat(const char* key, float defaultValue) {
+    std::string value;
+    return readValue(key, value) ? strtof(value.c_str(), nullptr) : defaultValue;
+}
+
+String Preferences::getString(const char* key, const String& defaultValue) {
+    std::string value;
+    return readValue(key, value) ? String(value) : defaultValue;
+}
+
+size_t Preferences::getString(const char* key, char* value, size_t maxLen) {
+    std::string stored;
+    if (!value || !readValue(key, stored) || stored.size() + 1 > maxLen) return 0;
+    memcpy(value, stored.c_str(), stored.size() + 1);
+    return stored.size() + 1;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    std::string value;
+    return readValue(key, value) ? value.size() : 0;
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+    std::string value;
+    if (!buf || !readValue(key, value) || value.size() > maxLen) return 0;
+    memcpy(buf, value.data(), value.size());
+    return value.size();
+}
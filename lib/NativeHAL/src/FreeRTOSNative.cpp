@@ -0,0 +1,448 @@
+// FreeRTOSNative.cpp - FreeRTOS kernel services on std::thread (native build)
+//
+// Every task is a detached std::thread. Queues, mutexes and semaphores share
+// one implementation (a bounded FIFO guarded by a mutex/condvar pair), which is
+// exactly how FreeRTOS builds semaphores on top of queues. Deleting another
+// task cannot kill its thread, so the task is flagged and terminates itself the
+// next time it enters a blocking kernel call.
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "NativeHAL.h"
+
+#include <pthread.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct NativeTask {
+    std::string name;
+    uint32_t stackDepth = 0;
+    std::atomic<bool> deleted{false};
+
+    std::mutex notifyLock;
+    std::condition_variable notifyCv;
+    uint32_t notifyValue = 0;
+    bool notifyPending = false;
+};
+
+struct NativeQueue {
+    UBaseType_t length;
+    UBaseType_t itemSize;
+    std::deque<std::vector<uint8_t>> items;
+    size_t count = 0;       // Tracks zero-sized items (semaphores) as well
+    void* holder = nullptr; // Recursive mutexes: owning task and nesting depth
+    UBaseType_t depth = 0;
+    std::mutex lock;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+};
+
+namespace {
+
+thread_local NativeTask* currentTask = nullptr;
+std::recursive_mutex criticalLock;
+
+NativeTask* mainTask() {
+    static NativeTask* task = [] {
+        NativeTask* t = new NativeTask();
+        t->name = "loopTask";
+        t->stackDepth = 8192;
+        return t;
+    }();
+    return task;
+}
+
+NativeTask* self() {
+    return currentTask ? currentTask : mainTask();
+}
+
+// Called on entry to every blocking primitive: a task deleted by someone else
+// terminates here instead of running on.
+void checkDeleted() {
+    NativeTask* task = currentTask;
+    if (task && task->deleted.load()) {
+        currentTask = nullptr;
+        pthread_exit(nullptr);
+    }
+}
+
+std::chrono::steady_clock::time_point deadlineFor(TickType_t ticks) {
+    return std::chrono::steady_clock::now() + std::chrono::milliseconds(pdTICKS_TO_MS(ticks));
+}
+
+template <typename Pred>
+bool waitFor(std::condition_variable& cv, std::unique_lock<std::mutex>& lk, TickType_t ticks, Pred pred) {
+    if (ticks == portMAX_DELAY) {
+        cv.wait(lk, pred);
+        return true;
+    }
+    return cv.wait_until(lk, deadlineFor(ticks), pred);
+}
+
+BaseType_t queueSend(QueueHandle_t queue, const void* item, TickType_t ticksToWait, bool front, bool overwrite) {
+    if (!queue) return pdFAIL;
+    checkDeleted();
+    std::unique_lock<std::mutex> lk(queue->lock);
+    if (overwrite && queue->count >= queue->length && queue->count > 0) {
+        if (!queue->items.empty()) queue->items.pop_front();
+        queue->count--;
+    }
+    if (!waitFor(queue->notFull, lk, ticksToWait, [queue] { return queue->count < queue->length; })) {
+        return errQUEUE_FULL;
+    }
+    if (queue->itemSize > 0) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(item);
+        std::vector<uint8_t> copy(bytes, bytes + queue->itemSize);
+        if (front) {
+            queue->items.push_front(std::move(copy));
+        } else {
+            queue->items.push_back(std::move(copy));
+        }
+    }
+    queue->count++;
+    queue->notEmpty.notify_one();
+    return pdPASS;
+}
+
+BaseType_t queueReceive(QueueHandle_t queue, void* buffer, TickType_t ticksToWait, bool remove) {
+    if (!queue) return pdFAIL;
+    checkDeleted();
+    std::unique_lock<std::mutex> lk(queue->lock);
+    if (!waitFor(queue->notEmpty, lk, ticksToWait, [queue] { return queue->count > 0; })) {
+        return errQUEUE_EMPTY;
+    }
+    if (queue->itemSize > 0) {
+        if (buffer) memcpy(buffer, queue->items.front().data(), queue->itemSize);
+        if (remove) queue->items.pop_front();
+    }
+    if (remove) {
+        queue->count--;
+        queue->notFull.notify_one();
+    }
+    return pdPASS;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Critical sections
+// ---------------------------------------------------------------------------
+
+void vPortEnterCritical(portMUX_TYPE*) { criticalLock.lock(); }
+void vPortExitCritical(portMUX_TYPE*) { criticalLock.unlock(); }
+void vTaskSuspendAll() { criticalLock.lock(); }
+BaseType_t xTaskResumeAll() { criticalLock.unlock(); return pdFALSE; }
+
+// ---------------------------------------------------------------------------
+// Tasks
+// ---------------------------------------------------------------------------
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char* name, uint32_t stackDepth,
+                                   void* parameters, UBaseType_t, TaskHandle_t* createdTask, BaseType_t) {
+    NativeTask* task = new NativeTask();
+    task->name = name ? name : "";
+    task->stackDepth = stackDepth;
+    if (createdTask) *createdTask = task;
+
+    std::thread([task, code, parameters] {
+        currentTask = task;
+        pthread_setname_np(pthread_self(), task->name.substr(0, 15).c_str());
+        code(parameters);
+        currentTask = nullptr;
+    }).detach();
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t code, const char* name, uint32_t stackDepth,
+                       void* parameters, UBaseType_t priority, TaskHandle_t* createdTask) {
+    return xTaskCreatePinnedToCore(code, name, stackDepth, parameters, priority, createdTask, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    if (!task || task == currentTask) {
+        if (currentTask) {
+            currentTask->deleted = true;
+            currentTask = nullptr;
+            pthread_exit(nullptr);
+        }
+        return;
+    }
+    task->deleted = true;
+    task->notifyCv.notify_all();
+}
+
+void vTaskDelay(TickType_t ticks) {
+    checkDeleted();
+    if (ticks == 0) {
+        std::this_thread::yield();
+    } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(pdTICKS_TO_MS(ticks)));
+    }
+    checkDeleted();
+}
+
+void vTaskDelayUntil(TickType_t* previousWakeTime, TickType_t timeIncrement) {
+    TickType_t target = *previousWakeTime + timeIncrement;
+    TickType_t now = xTaskGetTickCount();
+    *previousWakeTime = target;
+    if ((int32_t)(target - now) > 0) {
+        vTaskDelay(target - now);
+    } else {
+        checkDeleted();
+    }
+}
+
+TickType_t xTaskGetTickCount() {
+    return (TickType_t)(NativeHAL::monotonicMicros() / (1000000ULL / configTICK_RATE_HZ));
+}
+
+TickType_t xTaskGetTickCountFromISR() {
+    return xTaskGetTickCount();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    return self();
+}
+
+const char* pcTaskGetTaskName(TaskHandle_t task) {
+    return (task ? task : self())->name.c_str();
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    // Host stacks are large and not instrumented; report the untouched budget
+    return (task ? task : self())->stackDepth;
+}
+
+BaseType_t xPortGetCoreID() {
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Task notifications
+// ---------------------------------------------------------------------------
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action) {
+    if (!task) return pdFAIL;
+    std::lock_guard<std::mutex> lk(task->notifyLock);
+    switch (action) {
+        case eSetBits:
+            task->notifyValue |= value;
+            break;
+        case eIncrement:
+            task->notifyValue++;
+            break;
+        case eSetValueWithOverwrite:
+            task->notifyValue = value;
+            break;
+        case eSetValueWithoutOverwrite:
+            if (task->notifyPending) return pdFAIL;
+            task->notifyValue = value;
+            break;
+        case eNoAction:
+            break;
+    }
+    task->notifyPending = true;
+    task->notifyCv.notify_all();
+    return pdPASS;
+}
+
+BaseType_t xTaskNotifyFromISR(TaskHandle_t task, uint32_t value, eNotifyAction action, BaseType_t* woken) {
+    if (woken) *woken = pdFALSE;
+    return xTaskNotify(task, value, action);
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    return xTaskNotify(task, 0, eIncrement);
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* woken) {
+    if (woken) *woken = pdFALSE;
+    xTaskNotify(task, 0, eIncrement);
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait) {
+    checkDeleted();
+    NativeTask* task = self();
+    std::unique_lock<std::mutex> lk(task->notifyLock);
+    waitFor(task->notifyCv, lk, ticksToWait, [task] {
+        return task->notifyValue != 0 || task->deleted.load();
+    });
+    uint32_t value = task->notifyValue;
+    if (value != 0) {
+        task->notifyValue = clearCountOnExit ? 0 : value - 1;
+    }
+    task->notifyPending = false;
+    lk.unlock();
+    checkDeleted();
+    return value;
+}
+
+BaseType_t xTaskNotifyWait(uint32_t bitsToClearOnEntry, uint32_t bitsToClearOnExit,
+                           uint32_t* notificationValue, TickType_t ticksToWait) {
+    checkDeleted();
+    NativeTask* task = self();
+    std::unique_lock<std::mutex> lk(task->notifyLock);
+    if (!task->notifyPending) {
+        task->notifyValue &= ~bitsToClearOnEntry;
+    }
+    bool received = waitFor(task->notifyCv, lk, ticksToWait, [task] {
+        return task->notifyPending || task->deleted.load();
+    }) && task->notifyPending;
+    if (notificationValue) *notificationValue = task->notifyValue;
+    if (received) {
+        task->notifyValue &= ~bitsToClearOnExit;
+        task->notifyPending = false;
+    }
+    lk.unlock();
+    checkDeleted();
+    return received ? pdTRUE : pdFALSE;
+}
+
+// ---------------------------------------------------------------------------
+// Queues
+// ---------------------------------------------------------------------------
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    if (length == 0) return nullptr;
+    NativeQueue* queue = new NativeQueue();
+    queue->length = length;
+    queue->itemSize = itemSize;
+    return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue) {
+    delete queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticksToWait) {
+    return queueSend(queue, item, ticksToWait, false, false);
+}
+
+BaseType_t xQueueSendToBack(QueueHandle_t queue, const void* item, TickType_t ticksToWait) {
+    return queueSend(queue, item, ticksToWait, false, false);
+}
+
+BaseType_t xQueueSendToFront(QueueHandle_t queue, const void* item, TickType_t ticksToWait) {
+    return queueSend(queue, item, ticksToWait, true, false);
+}
+
+BaseType_t xQueueOverwrite(QueueHandle_t queue, const void* item) {
+    return queueSend(queue, item, 0, false, true);
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void* item, BaseType_t* woken) {
+    if (woken) *woken = pdFALSE;
+    return queueSend(queue, item, 0, false, false);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* buffer, TickType_t ticksToWait) {
+    return queueReceive(queue, buffer, ticksToWait, true);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void* buffer, TickType_t ticksToWait) {
+    return queueReceive(queue, buffer, ticksToWait, false);
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue) {
+    if (!queue) return pdFAIL;
+    std::lock_guard<std::mutex> lk(queue->lock);
+    queue->items.clear();
+    queue->count = 0;
+    queue->notFull.notify_all();
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+    if (!queue) return 0;
+    std::lock_guard<std::mutex> lk(queue->lock);
+    return (UBaseType_t)queue->count;
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue) {
+    if (!queue) return 0;
+    std::lock_guard<std::mutex> lk(queue->lock);
+    return queue->length - (UBaseType_t)queue->count;
+}
+
+// ---------------------------------------------------------------------------
+// Semaphores
+// ---------------------------------------------------------------------------
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+    return xSemaphoreCreateCounting(1, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary() {
+    return xSemaphoreCreateCounting(1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount, UBaseType_t initialCount) {
+    QueueHandle_t queue = xQueueCreate(maxCount, 0);
+    if (queue) queue->count = initialCount;
+    return queue;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait) {
+    return queueReceive(semaphore, nullptr, ticksToWait, true);
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+    return queueSend(semaphore, nullptr, 0, false, false);
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t semaphore, BaseType_t* woken) {
+    if (woken) *woken = pdFALSE;
+    return queueSend(semaphore, nullptr, 0, false, false);
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() {
+    return xSemaphoreCreateMutex();
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t semaphore, TickType_t ticksToWait) {
+    if (!semaphore) return pdFAIL;
+    void* task = self();
+    {
+        std::lock_guard<std::mutex> lk(semaphore->lock);
+        if (semaphore->holder == task) {
+            semaphore->depth++;
+            return pdTRUE;
+        }
+    }
+    if (xSemaphoreTake(semaphore, ticksToWait) != pdTRUE) {
+        return pdFALSE;
+    }
+    std::lock_guard<std::mutex> lk(semaphore->lock);
+    semaphore->holder = task;
+    semaphore->depth = 1;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t semaphore) {
+    if (!semaphore) return pdFAIL;
+    {
+        std::lock_guard<std::mutex> lk(semaphore->lock);
+        if (semaphore->holder != self()) {
+            return pdFAIL;
+        }
+        if (--semaphore->depth > 0) {
+            return pdTRUE;
+        }
+        semaphore->holder = nullptr;
+    }
+    return xSemaphoreGive(semaphore);
+}
+
+UBaseType_t uxSemaphoreGetCount(SemaphoreHandle_t semaphore) {
+    return uxQueueMessagesWaiting(semaphore);
+}
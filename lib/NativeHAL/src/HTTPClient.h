@@ -0,0 +1,75 @@
+// HTTPClient.h - Minimal HTTP/1.0 client over POSIX sockets (native build)
+//
+// Only plain http:// URLs are supported; https:// is fetched over plain TCP
+// on port 443 which will normally fail on the host, matching a device with
+// no reachable TLS endpoint.
+#pragma once
+
+#include <vector>
+#include "Arduino.h"
+#include "WiFiClient.h"
+
+#define HTTPC_ERROR_CONNECTION_REFUSED  (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED  (-2)
+#define HTTPC_ERROR_SEND_PAYLOAD_FAILED (-3)
+#define HTTPC_ERROR_NOT_CONNECTED       (-4)
+#define HTTPC_ERROR_CONNECTION_LOST     (-5)
+#define HTTPC_ERROR_NO_STREAM           (-6)
+#define HTTPC_ERROR_NO_HTTP_SERVER      (-7)
+#define HTTPC_ERROR_TOO_LESS_RAM        (-8)
+#define HTTPC_ERROR_ENCODING            (-9)
+#define HTTPC_ERROR_STREAM_WRITE        (-10)
+#define HTTPC_ERROR_READ_TIMEOUT        (-11)
+
+typedef enum {
+    HTTP_CODE_OK = 200,
+    HTTP_CODE_CREATED = 201,
+    HTTP_CODE_NO_CONTENT = 204,
+    HTTP_CODE_MOVED_PERMANENTLY = 301,
+    HTTP_CODE_FOUND = 302,
+    HTTP_CODE_BAD_REQUEST = 400,
+    HTTP_CODE_UNAUTHORIZED = 401,
+    HTTP_CODE_FORBIDDEN = 403,
+    HTTP_CODE_NOT_FOUND = 404,
+    HTTP_CODE_INTERNAL_SERVER_ERROR = 500
+} t_http_codes;
+
+class HTTPClient {
+public:
+    bool begin(const String& url);
+    bool begin(WiFiClient& client, const String& url) { (void)client; return begin(url); }
+    void end();
+
+    void setTimeout(uint16_t timeoutMs) { _timeoutMs = timeoutMs; }
+    void setConnectTimeout(int32_t timeoutMs) { _connectTimeoutMs = timeoutMs; }
+    void setReuse(bool reuse) { (void)reuse; }
+    void addHeader(const String& name, const String& value, bool first = false, bool replace = true);
+    void setAuthorization(const char* user, const char* password);
+
+    int GET() { return sendRequest("GET"); }
+    int POST(const String& payload) { return sendRequest("POST", payload); }
+    int POST(const uint8_t* payload, size_t size) { return sendRequest("POST", payload, size); }
+    int PUT(const String& payload) { return sendRequest("PUT", payload); }
+    int sendRequest(const char* type, const String& payload = String());
+    int sendRequest(const char* type, const uint8_t* payload, size_t size);
+
+    int getSize() const { return _size; }
+    String getString();
+    WiFiClient* getStreamPtr() { return _connected ? &_client : nullptr; }
+    WiFiClient& getStream() { return _client; }
+    bool connected() { return _connected && (_client.connected() || _client.available() > 0); }
+    static String errorToString(int error);
+
+private:
+    bool readResponseHeaders();
+
+    WiFiClient _client;
+    String _host;
+    uint16_t _port = 80;
+    String _path;
+    String _headers;
+    uint16_t _timeoutMs = 5000;
+    int32_t _connectTimeoutMs = 5000;
+    int _size = -1;
+    bool _connected = false;
+};
@@ -0,0 +1,27 @@
+// IPAddress.h - IPv4 address value type (native build)
+#pragma once
+
+#include <stdint.h>
+#include "WString.h"
+
+class IPAddress {
+public:
+    IPAddress() : _addr(0) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+        : _addr((uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24)) {}
+    IPAddress(uint32_t address) : _addr(address) {}
+
+    bool fromString(const char* address);
+    bool fromString(const String& address) { return fromString(address.c_str()); }
+    String toString() const;
+
+    operator uint32_t() const { return _addr; }
+    uint8_t operator[](int index) const { return (uint8_t)(_addr >> (index * 8)); }
+    bool operator==(const IPAddress& rhs) const { return _addr == rhs._addr; }
+    bool operator!=(const IPAddress& rhs) const { return _addr != rhs._addr; }
+
+private:
+    uint32_t _addr;     // Network byte order, as on the ESP32
+};
+
+extern const IPAddress INADDR_NONE;
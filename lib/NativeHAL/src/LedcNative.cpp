@@ -0,0 +1,124 @@
+// LedcNative.cpp - LEDC PWM channels and hardware fades (native build)
+#include "NativeHAL.h"
+#include "Arduino.h"
+#include "driver/ledc.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace {
+
+constexpr uint8_t LEDC_CHANNELS = 16;
+constexpr uint8_t NO_PIN = 0xFF;
+constexpr uint32_t FADE_STEP_MS = 10;
+
+struct LedcChannel {
+    std::atomic<uint8_t> pin{NO_PIN};
+    std::atomic<uint32_t> duty{0};
+    std::atomic<uint32_t> fadeGeneration{0};
+};
+
+LedcChannel channels[LEDC_CHANNELS];
+std::atomic<bool> fadeInstalled{false};
+
+void applyDuty(uint8_t channel, uint32_t duty) {
+    channels[channel].duty = duty;
+    uint8_t pin = channels[channel].pin;
+    if (pin != NO_PIN) {
+        NativeHAL::setPinDuty(pin, (int)duty);
+    }
+}
+
+// Arduino channels 0-7 are the high speed group, 8-15 the low speed group
+int channelIndex(ledc_mode_t mode, ledc_channel_t channel) {
+    if (mode >= LEDC_SPEED_MODE_MAX || channel >= LEDC_CHANNEL_MAX) {
+        return -1;
+    }
+    return (mode == LEDC_LOW_SPEED_MODE ? 8 : 0) + (int)channel;
+}
+
+} // namespace
+
+uint32_t ledcSetup(uint8_t channel, uint32_t freq, uint8_t) {
+    return channel < LEDC_CHANNELS ? freq : 0;
+}
+
+void ledcAttachPin(uint8_t pin, uint8_t channel) {
+    if (channel < LEDC_CHANNELS) {
+        channels[channel].pin = pin;
+        NativeHAL::setPinDuty(pin, (int)channels[channel].duty.load());
+    }
+}
+
+void ledcDetachPin(uint8_t pin) {
+    for (auto& channel : channels) {
+        uint8_t expected = pin;
+        channel.pin.compare_exchange_strong(expected, NO_PIN);
+    }
+}
+
+void ledcWrite(uint8_t channel, uint32_t duty) {
+    if (channel < LEDC_CHANNELS) {
+        channels[channel].fadeGeneration++;  // Cancels a running fade
+        applyDuty(channel, duty);
+    }
+}
+
+uint32_t ledcRead(uint8_t channel) {
+    return channel < LEDC_CHANNELS ? channels[channel].duty.load() : 0;
+}
+
+esp_err_t ledc_fade_func_install(int) {
+    bool expected = false;
+    return fadeInstalled.compare_exchange_strong(expected, true) ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+void ledc_fade_func_uninstall() {
+    fadeInstalled = false;
+}
+
+esp_err_t ledc_set_duty_and_update(ledc_mode_t mode, ledc_channel_t channel, uint32_t duty, uint32_t) {
+    int index = channelIndex(mode, channel);
+    if (index < 0 || !fadeInstalled) {
+        return index < 0 ? ESP_ERR_INVALID_ARG : ESP_ERR_INVALID_STATE;
+    }
+    ledcWrite((uint8_t)index, duty);
+    return ESP_OK;
+}
+
+esp_err_t ledc_set_fade_time_and_start(ledc_mode_t mode, ledc_channel_t channel,
+                                       uint32_t targetDuty, uint32_t maxFadeTimeMs,
+                                       ledc_fade_mode_t fadeMode) {
+    int index = channelIndex(mode, channel);
+    if (index < 0 || !fadeInstalled) {
+        return index < 0 ? ESP_ERR_INVALID_ARG : ESP_ERR_INVALID_STATE;
+    }
+
+    uint8_t ch = (uint8_t)index;
+    uint32_t generation = ++channels[ch].fadeGeneration;
+    uint32_t startDuty = channels[ch].duty;
+
+    // Linear ramp in FADE_STEP_MS steps, like the fade unit's duty stepping
+    auto ramp = [ch, generation, startDuty, targetDuty, maxFadeTimeMs]() {
+        uint32_t steps = maxFadeTimeMs / FADE_STEP_MS;
+        for (uint32_t i = 1; i <= steps; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(FADE_STEP_MS));
+            if (channels[ch].fadeGeneration != generation) {
+                return;
+            }
+            int64_t delta = (int64_t)targetDuty - (int64_t)startDuty;
+            applyDuty(ch, (uint32_t)((int64_t)startDuty + delta * (int64_t)i / (int64_t)steps));
+        }
+        if (channels[ch].fadeGeneration == generation) {
+            applyDuty(ch, targetDuty);
+        }
+    };
+
+    if (fadeMode == LEDC_FADE_WAIT_DONE) {
+        ramp();
+    } else {
+        std::thread(ramp).detach();
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,418 @@
+// NativeHAL.cpp - Simulated hardware and Arduino core services (native build)
+#include "NativeHAL.h"
+#include "Arduino.h"
+#include "esp_system.h"
+#include "esp_task_wdt.h"
+
+#include <malloc.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace NativeHAL {
+
+namespace {
+
+const auto processStart = std::chrono::steady_clock::now();
+
+std::atomic<int> pinModes[MAX_PINS];
+std::atomic<int> pinLevels[MAX_PINS];
+std::atomic<int> pinDuties[MAX_PINS];
+
+std::mutex shiftLock;
+ShiftRegisterStats shiftStats = {};
+
+std::mutex& i2cLock() {
+    static std::mutex lock;
+    return lock;
+}
+
+std::map<uint8_t, I2CDevice*>& i2cDevices() {
+    static std::map<uint8_t, I2CDevice*> devices;
+    return devices;
+}
+
+std::map<uint8_t, uint32_t>& i2cFailures() {
+    static std::map<uint8_t, uint32_t> failures;
+    return failures;
+}
+
+std::atomic<int> i2cSdaPin(-1);
+std::atomic<int> i2cSclPin(-1);
+std::atomic<int> i2cHeldClocks(0);
+
+struct PinTableInit {
+    PinTableInit() {
+        for (uint8_t i = 0; i < MAX_PINS; i++) {
+            pinDuties[i] = -1;
+        }
+    }
+} pinTableInit;
+
+} // namespace
+
+uint64_t monotonicMicros() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - processStart).count();
+}
+
+int pinMode(uint8_t pin) { return pin < MAX_PINS ? pinModes[pin].load() : -1; }
+int pinLevel(uint8_t pin) { return pin < MAX_PINS ? pinLevels[pin].load() : -1; }
+int pinDuty(uint8_t pin) { return pin < MAX_PINS ? pinDuties[pin].load() : -1; }
+void setPinMode(uint8_t pin, int mode) { if (pin < MAX_PINS) pinModes[pin] = mode; }
+void setPinLevel(uint8_t pin, int level) { if (pin < MAX_PINS) pinLevels[pin] = level; }
+void setPinDuty(uint8_t pin, int duty) { if (pin < MAX_PINS) pinDuties[pin] = duty; }
+
+void recordShiftLatch(const uint8_t* data, size_t len) {
+    std::lock_guard<std::mutex> lock(shiftLock);
+    if (len > MAX_SHIFT_BYTES) len = MAX_SHIFT_BYTES;
+    shiftStats.latches++;
+    shiftStats.bytesShifted += (uint32_t)len;
+    memcpy(shiftStats.lastFrame, data, len);
+    shiftStats.frameSize = len;
+}
+
+ShiftRegisterStats shiftRegisterStats() {
+    std::lock_guard<std::mutex> lock(shiftLock);
+    return shiftStats;
+}
+
+void attachI2CDevice(uint8_t address, I2CDevice* device) {
+    std::lock_guard<std::mutex> lock(i2cLock());
+    i2cDevices()[address] = device;
+}
+
+void detachI2CDevice(uint8_t address) {
+    std::lock_guard<std::mutex> lock(i2cLock());
+    i2cDevices().erase(address);
+}
+
+I2CDevice* findI2CDevice(uint8_t address) {
+    std::lock_guard<std::mutex> lock(i2cLock());
+    auto it = i2cDevices().find(address);
+    return it == i2cDevices().end() ? nullptr : it->second;
+}
+
+void setI2CPins(int sda, int scl) {
+    i2cSdaPin = sda;
+    i2cSclPin = scl;
+}
+
+void holdI2CData(uint8_t clocks) {
+    i2cHeldClocks = clocks;
+}
+
+bool i2cDataHeld() {
+    return i2cHeldClocks.load() > 0;
+}
+
+void failI2CTransfers(uint8_t address, uint32_t count) {
+    std::lock_guard<std::mutex> lock(i2cLock());
+    i2cFailures()[address] = count;
+}
+
+bool consumeI2CFailure(uint8_t address) {
+    std::lock_guard<std::mutex> lock(i2cLock());
+    auto it = i2cFailures().find(address);
+    if (it == i2cFailures().end() || it->second == 0) {
+        return false;
+    }
+    it->second--;
+    return true;
+}
+
+// Pin hooks for the simulated bus: a held SDA reads low, SCL falling edges
+// count down the hold
+int i2cReadHook(uint8_t pin, int level) {
+    return (int)pin == i2cSdaPin.load() && i2cDataHeld() ? 0 : level;
+}
+
+void i2cWriteHook(uint8_t pin, int previous, int level) {
+    if ((int)pin == i2cSclPin.load() && previous && !level && i2cHeldClocks.load() > 0) {
+        i2cHeldClocks--;
+    }
+}
+
+const std::string& fsRoot() {
+    static const std::string root = [] {
+        const char* env = getenv("NTPCLOCK_FS_ROOT");
+        return std::string(env && *env ? env : "./.native_fs");
+    }();
+    return root;
+}
+
+std::string fsPath(const char* path) {
+    std::string result = fsRoot();
+    if (path && *path != '/') result += '/';
+    if (path) result += path;
+    return result;
+}
+
+uint16_t mapListenPort(uint16_t port) {
+    return port < 1024 ? (uint16_t)(port + 8000) : port;
+}
+
+} // namespace NativeHAL
+
+// ---------------------------------------------------------------------------
+// Arduino core
+// ---------------------------------------------------------------------------
+
+HardwareSerial Serial;
+EspClass ESP;
+const IPAddress INADDR_NONE(0, 0, 0, 0);
+
+static std::mutex serialLock;
+
+size_t HardwareSerial::write(uint8_t c) {
+    std::lock_guard<std::mutex> lock(serialLock);
+    return fwrite(&c, 1, 1, stdout);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    std::lock_guard<std::mutex> lock(serialLock);
+    return fwrite(buffer, 1, size, stdout);
+}
+
+void HardwareSerial::flush() {
+    std::lock_guard<std::mutex> lock(serialLock);
+    fflush(stdout);
+}
+
+unsigned long millis() {
+    return (unsigned long)(NativeHAL::monotonicMicros() / 1000ULL);
+}
+
+unsigned long micros() {
+    return (unsigned long)NativeHAL::monotonicMicros();
+}
+
+void delay(uint32_t ms) {
+    vTaskDelay(pdMS_TO_TICKS(ms));
+}
+
+void delayMicroseconds(uint32_t us) {
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield() {
+    std::this_thread::yield();
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    NativeHAL::setPinMode(pin, mode);
+    if (mode & PULLUP) {
+        // Nothing else drives the line in the simulation
+        NativeHAL::setPinLevel(pin, HIGH);
+    }
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    int previous = NativeHAL::pinLevel(pin);
+    NativeHAL::setPinLevel(pin, val ? HIGH : LOW);
+    NativeHAL::i2cWriteHook(pin, previous, val ? HIGH : LOW);
+}
+
+int digitalRead(uint8_t pin) {
+    int level = NativeHAL::pinLevel(pin);
+    return NativeHAL::i2cReadHook(pin, level < 0 ? LOW : level);
+}
+
+void analogWrite(uint8_t pin, int value) {
+    NativeHAL::setPinDuty(pin, value);
+}
+
+uint16_t analogRead(uint8_t) {
+    return 0;
+}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax) {
+    if (inMax == inMin) return outMin;
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+static std::mt19937& rng() {
+    static std::mt19937 generator(std::random_device{}());
+    return generator;
+}
+
+long random(long howBig) {
+    if (howBig <= 0) return 0;
+    return (long)(rng()() % (unsigned long)howBig);
+}
+
+long random(long howSmall, long howBig) {
+    if (howSmall >= howBig) return howSmall;
+    return random(howBig - howSmall) + howSmall;
+}
+
+void randomSeed(unsigned long seed) {
+    if (seed != 0) rng().seed((uint32_t)seed);
+}
+
+uint32_t esp_random() {
+    return rng()();
+}
+
+// The host clock is assumed NTP-disciplined; configTime only sets the zone
+bool getLocalTime(struct tm* info, uint32_t) {
+    time_t now = time(nullptr);
+    localtime_r(&now, info);
+    return info->tm_year > (2016 - 1900);
+}
+
+void configTime(long gmtOffsetSec, int daylightOffsetSec, const char*, const char*, const char*) {
+    if (gmtOffsetSec == 0 && daylightOffsetSec == 0) {
+        setenv("TZ", "UTC0", 1);
+    }
+    tzset();
+}
+
+// The host clock is never changed by the firmware
+extern "C" int settimeofday(const struct timeval*, const struct timezone*) {
+    return 0;
+}
+
+extern "C" int adjtime(const struct timeval*, struct timeval* olddelta) {
+    if (olddelta) {
+        olddelta->tv_sec = 0;
+        olddelta->tv_usec = 0;
+    }
+    return 0;
+}
+
+void configTzTime(const char* tz, const char*, const char*, const char*) {
+    setenv("TZ", tz, 1);
+    tzset();
+}
+
+bool IPAddress::fromString(const char* address) {
+    unsigned int a, b, c, d;
+    char tail;
+    if (!address || sscanf(address, "%u.%u.%u.%u%c", &a, &b, &c, &d, &tail) != 4 ||
+        a > 255 || b > 255 || c > 255 || d > 255) {
+        return false;
+    }
+    *this = IPAddress(a, b, c, d);
+    return true;
+}
+
+String IPAddress::toString() const {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+    return String(buf);
+}
+
+// ---------------------------------------------------------------------------
+// ESP system services
+// ---------------------------------------------------------------------------
+
+static constexpr uint32_t SIMULATED_HEAP_SIZE = 320 * 1024;
+
+static uint32_t simulatedFreeHeap() {
+    struct mallinfo2 info = mallinfo2();
+    size_t used = info.uordblks;
+    return used >= SIMULATED_HEAP_SIZE ? 0 : (uint32_t)(SIMULATED_HEAP_SIZE - used);
+}
+
+static std::atomic<uint32_t> minimumFreeHeap{SIMULATED_HEAP_SIZE};
+
+static uint32_t trackFreeHeap() {
+    uint32_t freeHeap = simulatedFreeHeap();
+    uint32_t seen = minimumFreeHeap.load();
+    while (freeHeap < seen && !minimumFreeHeap.compare_exchange_weak(seen, freeHeap)) {
+    }
+    return freeHeap;
+}
+
+uint32_t EspClass::getHeapSize() { return SIMULATED_HEAP_SIZE; }
+uint32_t EspClass::getFreeHeap() { return trackFreeHeap(); }
+uint32_t EspClass::getMinFreeHeap() { trackFreeHeap(); return minimumFreeHeap.load(); }
+uint32_t EspClass::getMaxAllocHeap() { return trackFreeHeap(); }
+uint32_t EspClass::getCycleCount() { return (uint32_t)(NativeHAL::monotonicMicros() * getCpuFreqMHz()); }
+
+void EspClass::restart() {
+    esp_restart();
+}
+
+uint32_t esp_get_free_heap_size() { return trackFreeHeap(); }
+uint32_t esp_get_minimum_free_heap_size() { trackFreeHeap(); return minimumFreeHeap.load(); }
+esp_reset_reason_t esp_reset_reason() { return ESP_RST_POWERON; }
+
+void esp_restart() {
+    fflush(stdout);
+    fprintf(stderr, "[NativeHAL] esp_restart() called, exiting\n");
+    _exit(0);
+}
+
+// ---------------------------------------------------------------------------
+// Task watchdog: tracked, reported, never fatal
+// ---------------------------------------------------------------------------
+
+namespace {
+
+std::mutex wdtLock;
+uint32_t wdtTimeoutMs = 0;
+std::map<TaskHandle_t, uint64_t> wdtLastReset;
+std::map<TaskHandle_t, bool> wdtReported;
+
+void wdtMonitor() {
+    for (;;) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        std::lock_guard<std::mutex> lock(wdtLock);
+        uint64_t now = NativeHAL::monotonicMicros();
+        for (auto& entry : wdtLastReset) {
+            bool expired = wdtTimeoutMs && now - entry.second > (uint64_t)wdtTimeoutMs * 1000ULL;
+            if (expired && !wdtReported[entry.first]) {
+                fprintf(stderr, "[NativeHAL] Task watchdog: %s did not reset in time\n",
+                        pcTaskGetTaskName(entry.first));
+                wdtReported[entry.first] = true;
+            }
+        }
+    }
+}
+
+} // namespace
+
+esp_err_t esp_task_wdt_init(uint32_t timeoutSeconds, bool) {
+    static std::once_flag started;
+    {
+        std::lock_guard<std::mutex> lock(wdtLock);
+        wdtTimeoutMs = timeoutSeconds * 1000;
+    }
+    std::call_once(started, [] { std::thread(wdtMonitor).detach(); });
+    return ESP_OK;
+}
+
+esp_err_t esp_task_wdt_add(TaskHandle_t task) {
+    std::lock_guard<std::mutex> lock(wdtLock);
+    TaskHandle_t handle = task ? task : xTaskGetCurrentTaskHandle();
+    wdtLastReset[handle] = NativeHAL::monotonicMicros();
+    wdtReported[handle] = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_task_wdt_delete(TaskHandle_t task) {
+    std::lock_guard<std::mutex> lock(wdtLock);
+    TaskHandle_t handle = task ? task : xTaskGetCurrentTaskHandle();
+    wdtLastReset.erase(handle);
+    wdtReported.erase(handle);
+    return ESP_OK;
+}
+
+esp_err_t esp_task_wdt_reset() {
+    std::lock_guard<std::mutex> lock(wdtLock);
+    TaskHandle_t handle = xTaskGetCurrentTaskHandle();
+    auto it = wdtLastReset.find(handle);
+    if (it == wdtLastReset.end()) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    it->second = NativeHAL::monotonicMicros();
+    wdtReported[handle] = false;
+    return ESP_OK;
+}
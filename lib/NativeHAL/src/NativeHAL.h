@@ -0,0 +1,94 @@
+/**
+ * NativeHAL.h
+ *
+ * Simulation control surface for the native (Linux) build. The firmware itself
+ * never includes this header: it keeps talking to the Arduino/ESP-IDF/FreeRTOS
+ * APIs, which this library implements on top of std::thread, POSIX sockets and
+ * a local directory. Host-side tools and benchmarks use the functions below to
+ * inspect the simulated hardware (pins, shift register latches, I2C devices).
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+namespace NativeHAL {
+
+// ---------------------------------------------------------------------------
+// Clock
+// ---------------------------------------------------------------------------
+
+// Microseconds since process start (monotonic)
+uint64_t monotonicMicros();
+
+// ---------------------------------------------------------------------------
+// GPIO / PWM
+// ---------------------------------------------------------------------------
+
+constexpr uint8_t MAX_PINS = 40;
+
+int pinMode(uint8_t pin);
+int pinLevel(uint8_t pin);
+int pinDuty(uint8_t pin);        // Last analogWrite() value, -1 if never written
+void setPinMode(uint8_t pin, int mode);
+void setPinLevel(uint8_t pin, int level);
+void setPinDuty(uint8_t pin, int duty);
+
+// ---------------------------------------------------------------------------
+// 74HC595 shift register chain
+// ---------------------------------------------------------------------------
+
+constexpr size_t MAX_SHIFT_BYTES = 8;
+
+struct ShiftRegisterStats {
+    uint32_t latches;                       // Number of times data was latched
+    uint32_t bytesShifted;                  // Total bytes clocked out
+    uint8_t lastFrame[MAX_SHIFT_BYTES];     // Most recently latched frame
+    size_t frameSize;
+};
+
+void recordShiftLatch(const uint8_t* data, size_t len);
+ShiftRegisterStats shiftRegisterStats();
+
+// ---------------------------------------------------------------------------
+// I2C bus
+// ---------------------------------------------------------------------------
+
+class I2CDevice {
+public:
+    virtual ~I2CDevice() = default;
+    // Master write: first byte is normally the register pointer
+    virtual bool write(const uint8_t* data, size_t len) = 0;
+    // Master read: returns number of bytes supplied
+    virtual size_t read(uint8_t* data, size_t len) = 0;
+};
+
+void attachI2CDevice(uint8_t address, I2CDevice* device);
+void detachI2CDevice(uint8_t address);
+I2CDevice* findI2CDevice(uint8_t address);
+
+// Fault injection for the bus error paths. Wire.begin() registers the SDA
+// and SCL pins; while SDA is held, digitalRead() of the SDA pin is LOW and
+// every transaction times out until SCL has been clocked low that often.
+void setI2CPins(int sda, int scl);
+void holdI2CData(uint8_t clocks);       // 0 releases the line
+bool i2cDataHeld();
+// The next 'count' transactions to 'address' are NACKed
+void failI2CTransfers(uint8_t address, uint32_t count);
+bool consumeI2CFailure(uint8_t address);
+
+// ---------------------------------------------------------------------------
+// Filesystem / network
+// ---------------------------------------------------------------------------
+
+// Root directory backing SPIFFS and NVS (env NTPCLOCK_FS_ROOT, default ./.native_fs)
+const std::string& fsRoot();
+std::string fsPath(const char* path);
+
+// Privileged ports (< 1024) are remapped to port + 8000 so the web server
+// runs unprivileged: the device's port 80 becomes 8080 on the host.
+uint16_t mapListenPort(uint16_t port);
+
+} // namespace NativeHAL
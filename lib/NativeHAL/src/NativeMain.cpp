@@ -0,0 +1,16 @@
+// NativeMain.cpp - Process entry point running the Arduino sketch (native build)
+#include "Arduino.h"
+
+#include <signal.h>
+
+int main() {
+    // A peer closing a socket must surface as a write error, not kill the process
+    signal(SIGPIPE, SIG_IGN);
+    setvbuf(stdout, nullptr, _IOLBF, 0);
+
+    setup();
+    for (;;) {
+        loop();
+        yield();
+    }
+}
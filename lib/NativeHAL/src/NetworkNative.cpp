@@ -0,0 +1,820 @@
+// NetworkNative.cpp - WiFi, TCP client, web server, HTTP client and OTA (native build)
+#include "WiFi.h"
+#include "WiFiClient.h"
+#include "WebServer.h"
+#include "HTTPClient.h"
+#include "ESPmDNS.h"
+#include "Update.h"
+#include "NativeHAL.h"
+#include "base64.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <mutex>
+#include <thread>
+
+WiFiClass WiFi;
+MDNSResponder MDNS;
+UpdateClass Update;
+
+// ---------------------------------------------------------------------------
+// WiFiClient
+// ---------------------------------------------------------------------------
+
+struct WiFiClient::Socket {
+    explicit Socket(int fd) : fd(fd) {}
+    ~Socket() { if (fd >= 0) ::close(fd); }
+
+    int fd;
+    int peeked = -1;
+};
+
+WiFiClient::WiFiClient(int fd) : _socket(std::make_shared<Socket>(fd)) {}
+
+int WiFiClient::connect(IPAddress ip, uint16_t port) {
+    return connect(ip, port, (int32_t)_timeout);
+}
+
+int WiFiClient::connect(IPAddress ip, uint16_t port, int32_t timeoutMs) {
+    return connect(ip.toString().c_str(), port, timeoutMs);
+}
+
+int WiFiClient::connect(const char* host, uint16_t port) {
+    return connect(host, port, (int32_t)_timeout);
+}
+
+int WiFiClient::connect(const char* host, uint16_t port, int32_t timeoutMs) {
+    stop();
+
+    struct addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo* result = nullptr;
+    char portStr[8];
+    snprintf(portStr, sizeof(portStr), "%u", port);
+    if (getaddrinfo(host, portStr, &hints, &result) != 0 || !result) {
+        return 0;
+    }
+
+    int fd = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+    if (fd < 0) {
+        freeaddrinfo(result);
+        return 0;
+    }
+
+    // Non-blocking connect bounded by the timeout, then back to blocking
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    int rc = ::connect(fd, result->ai_addr, result->ai_addrlen);
+    freeaddrinfo(result);
+    if (rc < 0 && errno == EINPROGRESS) {
+        struct pollfd pfd = {fd, POLLOUT, 0};
+        int error = 0;
+        socklen_t len = sizeof(error);
+        if (poll(&pfd, 1, timeoutMs) <= 0 ||
+            getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &len) < 0 || error != 0) {
+            ::close(fd);
+            return 0;
+        }
+    } else if (rc < 0) {
+        ::close(fd);
+        return 0;
+    }
+    fcntl(fd, F_SETFL, flags);
+
+    _socket = std::make_shared<Socket>(fd);
+    return 1;
+}
+
+size_t WiFiClient::write(const uint8_t* buf, size_t size) {
+    if (!_socket || _socket->fd < 0) return 0;
+    size_t sent = 0;
+    while (sent < size) {
+        ssize_t n = ::send(_socket->fd, buf + sent, size - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) continue;
+            stop();
+            break;
+        }
+        sent += (size_t)n;
+    }
+    return sent;
+}
+
+int WiFiClient::available() {
+    if (!_socket || _socket->fd < 0) return 0;
+    int pending = 0;
+    if (ioctl(_socket->fd, FIONREAD, &pending) < 0) pending = 0;
+    return pending + (_socket->peeked >= 0 ? 1 : 0);
+}
+
+bool WiFiClient::fillPeek() {
+    if (!_socket || _socket->fd < 0) return false;
+    if (_socket->peeked >= 0) return true;
+    uint8_t c;
+    ssize_t n = ::recv(_socket->fd, &c, 1, MSG_DONTWAIT);
+    if (n == 1) {
+        _socket->peeked = c;
+        return true;
+    }
+    return false;
+}
+
+int WiFiClient::read() {
+    if (!fillPeek()) return -1;
+    int c = _socket->peeked;
+    _socket->peeked = -1;
+    return c;
+}
+
+int WiFiClient::read(uint8_t* buf, size_t size) {
+    if (!_socket || _socket->fd < 0 || size == 0) return -1;
+    size_t count = 0;
+    if (_socket->peeked >= 0) {
+        buf[count++] = (uint8_t)_socket->peeked;
+        _socket->peeked = -1;
+    }
+    if (count < size) {
+        ssize_t n = ::recv(_socket->fd, buf + count, size - count, MSG_DONTWAIT);
+        if (n > 0) count += (size_t)n;
+    }
+    return count > 0 ? (int)count : -1;
+}
+
+int WiFiClient::peek() {
+    return fillPeek() ? _socket->peeked : -1;
+}
+
+void WiFiClient::stop() {
+    if (_socket && _socket->fd >= 0) {
+        ::shutdown(_socket->fd, SHUT_RDWR);
+        ::close(_socket->fd);
+        _socket->fd = -1;
+    }
+    _socket.reset();
+}
+
+uint8_t WiFiClient::connected() {
+    if (!_socket || _socket->fd < 0) return 0;
+    if (_socket->peeked >= 0) return 1;
+    uint8_t c;
+    ssize_t n = ::recv(_socket->fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (n == 0) return 0;       // Orderly shutdown by the peer
+    if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) return 0;
+    return 1;
+}
+
+int WiFiClient::fd() const {
+    return _socket ? _socket->fd : -1;
+}
+
+IPAddress WiFiClient::remoteIP() const {
+    struct sockaddr_in addr = {};
+    socklen_t len = sizeof(addr);
+    if (!_socket || getpeername(_socket->fd, (struct sockaddr*)&addr, &len) != 0) return IPAddress();
+    return IPAddress(addr.sin_addr.s_addr);
+}
+
+uint16_t WiFiClient::remotePort() const {
+    struct sockaddr_in addr = {};
+    socklen_t len = sizeof(addr);
+    if (!_socket || getpeername(_socket->fd, (struct sockaddr*)&addr, &len) != 0) return 0;
+    return ntohs(addr.sin_port);
+}
+
+void WiFiClient::setNoDelay(bool noDelay) {
+    int flag = noDelay ? 1 : 0;
+    if (_socket) setsockopt(_socket->fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+}
+
+// ---------------------------------------------------------------------------
+// WiFi
+// ---------------------------------------------------------------------------
+
+wl_status_t WiFiClass::begin(const char* ssid, const char*, int32_t, const uint8_t*, bool connect) {
+    _ssid = ssid ? ssid : "";
+    if (_mode == WIFI_MODE_NULL) _mode = WIFI_MODE_STA;
+    postEvent(SYSTEM_EVENT_STA_START);
+    if (connect) {
+        _status = WL_CONNECTED;
+        postEvent(SYSTEM_EVENT_STA_CONNECTED);
+        postEvent(SYSTEM_EVENT_STA_GOT_IP);
+    }
+    return _status;
+}
+
+wl_status_t WiFiClass::begin() {
+    return begin(_ssid.c_str());
+}
+
+bool WiFiClass::disconnect(bool wifiOff, bool) {
+    if (_status == WL_CONNECTED) {
+        _status = WL_DISCONNECTED;
+        postEvent(SYSTEM_EVENT_STA_DISCONNECTED, 8);   // ASSOC_LEAVE
+    }
+    if (wifiOff) _mode = WIFI_MODE_NULL;
+    return true;
+}
+
+bool WiFiClass::reconnect() {
+    begin();
+    return true;
+}
+
+int WiFiClass::hostByName(const char* hostname, IPAddress& result) {
+    if (result.fromString(hostname)) {
+        return 1;
+    }
+    struct addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    struct addrinfo* found = nullptr;
+    if (getaddrinfo(hostname, nullptr, &hints, &found) != 0 || !found) {
+        return 0;
+    }
+    result = IPAddress((uint32_t)reinterpret_cast<struct sockaddr_in*>(found->ai_addr)->sin_addr.s_addr);
+    freeaddrinfo(found);
+    return 1;
+}
+
+bool WiFiClass::mode(wifi_mode_t mode) {
+    if (_mode == WIFI_MODE_NULL && mode != WIFI_MODE_NULL) {
+        postEvent(SYSTEM_EVENT_WIFI_READY);
+    }
+    if (mode == WIFI_MODE_NULL && _status == WL_CONNECTED) {
+        disconnect();
+        postEvent(SYSTEM_EVENT_STA_STOP);
+    }
+    _mode = mode;
+    return true;
+}
+
+uint8_t* WiFiClass::macAddress(uint8_t* mac) const {
+    static const uint8_t MAC[6] = {0x24, 0x0A, 0xC4, 0x00, 0x00, 0x01};
+    memcpy(mac, MAC, sizeof(MAC));
+    return mac;
+}
+
+bool WiFiClass::softAP(const char* ssid, const char*, int, int, int) {
+    _mode = _mode == WIFI_MODE_STA ? WIFI_MODE_APSTA : WIFI_MODE_AP;
+    Serial.printf("[NativeHAL] Soft AP '%s' simulated at %s\n", ssid ? ssid : "", _apIP.toString().c_str());
+    postEvent(SYSTEM_EVENT_AP_START);
+    return true;
+}
+
+bool WiFiClass::softAPConfig(IPAddress localIp, IPAddress, IPAddress) {
+    _apIP = localIp;
+    return true;
+}
+
+bool WiFiClass::softAPdisconnect(bool) {
+    postEvent(SYSTEM_EVENT_AP_STOP);
+    _mode = _mode == WIFI_MODE_APSTA ? WIFI_MODE_STA : WIFI_MODE_NULL;
+    return true;
+}
+
+int16_t WiFiClass::scanNetworks(bool, bool) {
+    return 1;
+}
+
+String WiFiClass::SSID(uint8_t index) const {
+    return index == 0 ? String("NativeHostNetwork") : String();
+}
+
+int32_t WiFiClass::RSSI(uint8_t index) const {
+    return index == 0 ? -55 : 0;
+}
+
+wifi_auth_mode_t WiFiClass::encryptionType(uint8_t index) const {
+    return index == 0 ? WIFI_AUTH_WPA2_PSK : WIFI_AUTH_OPEN;
+}
+
+wifi_event_id_t WiFiClass::onEvent(WiFiEventFuncCb callback) {
+    _handlers.push_back(callback);
+    return _handlers.size();
+}
+
+void WiFiClass::removeEvent(wifi_event_id_t id) {
+    if (id > 0 && id <= _handlers.size()) _handlers[id - 1] = nullptr;
+}
+
+// Events are delivered from their own thread, like the ESP32 event loop task
+void WiFiClass::postEvent(WiFiEvent_t event, uint8_t reason) {
+    WiFiEventInfo_t info = {};
+    if (event == SYSTEM_EVENT_STA_DISCONNECTED) {
+        info.wifi_sta_disconnected.reason = reason;
+    } else if (event == SYSTEM_EVENT_STA_GOT_IP) {
+        info.got_ip.ip = IPAddress(127, 0, 0, 1);
+        info.got_ip.netmask = IPAddress(255, 0, 0, 0);
+        info.got_ip.gw = IPAddress(127, 0, 0, 1);
+    }
+    std::vector<WiFiEventFuncCb> handlers = _handlers;
+    static std::mutex eventOrder;
+    std::thread([handlers, event, info] {
+        std::lock_guard<std::mutex> lock(eventOrder);
+        for (const auto& handler : handlers) {
+            if (handler) handler(event, info);
+        }
+    }).detach();
+}
+
+// ---------------------------------------------------------------------------
+// WebServer
+// ---------------------------------------------------------------------------
+
+WebServer::WebServer(int port) : _port((uint16_t)port) {}
+
+WebServer::~WebServer() {
+    stop();
+}
+
+void WebServer::begin() {
+    begin(_port);
+}
+
+void WebServer::begin(uint16_t port) {
+    stop();
+    _port = port;
+    uint16_t hostPort = NativeHAL::mapListenPort(port);
+
+    _listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (_listenFd < 0) return;
+    int reuse = 1;
+    setsockopt(_listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(hostPort);
+    if (bind(_listenFd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(_listenFd, 4) < 0) {
+        Serial.printf("[NativeHAL] WebServer failed to listen on port %u: %s\n", hostPort, strerror(errno));
+        ::close(_listenFd);
+        _listenFd = -1;
+        return;
+    }
+    fcntl(_listenFd, F_SETFL, fcntl(_listenFd, F_GETFL, 0) | O_NONBLOCK);
+    Serial.printf("[NativeHAL] WebServer listening on http://localhost:%u/\n", hostPort);
+}
+
+void WebServer::stop() {
+    if (_listenFd >= 0) {
+        ::close(_listenFd);
+        _listenFd = -1;
+    }
+    _currentClient.stop();
+}
+
+void WebServer::on(const String& uri, HTTPMethod method, THandlerFunction fn) {
+    _routes.push_back({uri, method, fn});
+}
+
+void WebServer::handleClient() {
+    if (_listenFd < 0) return;
+    int fd = accept(_listenFd, nullptr, nullptr);
+    if (fd < 0) return;
+
+    WiFiClient client(fd);
+    client.setTimeout(2000);
+    _currentClient = client;
+    _responseHeaders = String();
+    _contentLength = CONTENT_LENGTH_NOT_SET;
+    _chunked = false;
+
+    if (parseRequest(client)) {
+        bool handled = false;
+        for (const Route& route : _routes) {
+            if (route.uri == _currentUri && (route.method == HTTP_ANY || route.method == _currentMethod)) {
+                route.handler();
+                handled = true;
+                break;
+            }
+        }
+        if (!handled) {
+            if (_notFoundHandler) {
+                _notFoundHandler();
+            } else {
+                send(404, "text/plain", String("Not found: ") + _currentUri);
+            }
+        }
+    }
+
+    if (_chunked && _currentClient.connected()) {
+        _currentClient.write("0\r\n\r\n");
+    }
+    _currentClient.stop();
+}
+
+bool WebServer::parseRequest(WiFiClient& client) {
+    String requestLine = client.readStringUntil('\n');
+    requestLine.trim();
+    int firstSpace = requestLine.indexOf(' ');
+    int secondSpace = requestLine.indexOf(' ', firstSpace + 1);
+    if (firstSpace < 0 || secondSpace < 0) return false;
+
+    String methodStr = requestLine.substring(0, firstSpace);
+    String url = requestLine.substring(firstSpace + 1, secondSpace);
+
+    _currentMethod = HTTP_ANY;
+    if (methodStr == "GET") _currentMethod = HTTP_GET;
+    else if (methodStr == "HEAD") _currentMethod = HTTP_HEAD;
+    else if (methodStr == "POST") _currentMethod = HTTP_POST;
+    else if (methodStr == "PUT") _currentMethod = HTTP_PUT;
+    else if (methodStr == "PATCH") _currentMethod = HTTP_PATCH;
+    else if (methodStr == "DELETE") _currentMethod = HTTP_DELETE;
+    else if (methodStr == "OPTIONS") _currentMethod = HTTP_OPTIONS;
+
+    _args.clear();
+    _requestHeaders.clear();
+    _hostHeader = String();
+    int query = url.indexOf('?');
+    if (query >= 0) {
+        _currentUri = url.substring(0, query);
+        parseArguments(url.substring(query + 1));
+    } else {
+        _currentUri = url;
+    }
+
+    size_t contentLength = 0;
+    String contentType;
+    for (;;) {
+        String line = client.readStringUntil('\n');
+        line.trim();
+        if (line.isEmpty()) break;
+        int colon = line.indexOf(':');
+        if (colon < 0) continue;
+        String name = line.substring(0, colon);
+        String value = line.substring(colon + 1);
+        value.trim();
+        _requestHeaders.push_back({name, value});
+        if (name.equalsIgnoreCase("Host")) _hostHeader = value;
+        else if (name.equalsIgnoreCase("Content-Length")) contentLength = (size_t)value.toInt();
+        else if (name.equalsIgnoreCase("Content-Type")) contentType = value;
+    }
+
+    if (contentLength > 0) {
+        std::string body(contentLength, '\0');
+        size_t got = client.readBytes(&body[0], contentLength);
+        body.resize(got);
+        String plain(body);
+        if (contentType.startsWith("application/x-www-form-urlencoded")) {
+            parseArguments(plain);
+        }
+        _args.push_back({String("plain"), plain});
+    }
+    return true;
+}
+
+void WebServer::parseArguments(const String& data) {
+    int start = 0;
+    while (start < (int)data.length()) {
+        int end = data.indexOf('&', start);
+        if (end < 0) end = data.length();
+        String pair = data.substring(start, end);
+        int eq = pair.indexOf('=');
+        if (eq >= 0) {
+            _args.push_back({urlDecode(pair.substring(0, eq)), urlDecode(pair.substring(eq + 1))});
+        } else if (pair.length() > 0) {
+            _args.push_back({urlDecode(pair), String()});
+        }
+        start = end + 1;
+    }
+}
+
+String WebServer::urlDecode(const String& text) {
+    String decoded;
+    for (unsigned int i = 0; i < text.length(); i++) {
+        char c = text[i];
+        if (c == '+') {
+            decoded += ' ';
+        } else if (c == '%' && i + 2 < text.length()) {
+            char hex[3] = {text[i + 1], text[i + 2], 0};
+            decoded += (char)strtol(hex, nullptr, 16);
+            i += 2;
+        } else {
+            decoded += c;
+        }
+    }
+    return decoded;
+}
+
+String WebServer::arg(const String& name) const {
+    for (const KeyValue& kv : _args) {
+        if (kv.key == name) return kv.value;
+    }
+    return String();
+}
+
+String WebServer::arg(int i) const {
+    return i >= 0 && i < (int)_args.size() ? _args[i].value : String();
+}
+
+String WebServer::argName(int i) const {
+    return i >= 0 && i < (int)_args.size() ? _args[i].key : String();
+}
+
+bool WebServer::hasArg(const String& name) const {
+    for (const KeyValue& kv : _args) {
+        if (kv.key == name) return true;
+    }
+    return false;
+}
+
+String WebServer::header(const String& name) const {
+    for (const KeyValue& kv : _requestHeaders) {
+        if (kv.key.equalsIgnoreCase(name)) return kv.value;
+    }
+    return String();
+}
+
+bool WebServer::hasHeader(const String& name) const {
+    for (const KeyValue& kv : _requestHeaders) {
+        if (kv.key.equalsIgnoreCase(name)) return true;
+    }
+    return false;
+}
+
+void WebServer::sendHeader(const String& name, const String& value, bool first) {
+    String line = name + ": " + value + "\r\n";
+    if (first) {
+        _responseHeaders = line + _responseHeaders;
+    } else {
+        _responseHeaders += line;
+    }
+}
+
+const char* WebServer::responseCodeToString(int code) {
+    switch (code) {
+        case 200: return "OK";
+        case 201: return "Created";
+        case 204: return "No Content";
+        case 301: return "Moved Permanently";
+        case 302: return "Found";
+        case 304: return "Not Modified";
+        case 400: return "Bad Request";
+        case 401: return "Unauthorized";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 429: return "Too Many Requests";
+        case 500: return "Internal Server Error";
+        case 503: return "Service Unavailable";
+        default: return "";
+    }
+}
+
+void WebServer::writeHead(int code, const char* contentType, size_t contentLength) {
+    String head = String("HTTP/1.1 ") + String(code) + " " + responseCodeToString(code) + "\r\n";
+    if (contentType && *contentType) {
+        head += String("Content-Type: ") + contentType + "\r\n";
+    }
+    if (contentLength == CONTENT_LENGTH_UNKNOWN) {
+        head += "Transfer-Encoding: chunked\r\n";
+        _chunked = true;
+    } else {
+        head += String("Content-Length: ") + String((unsigned long)contentLength) + "\r\n";
+    }
+    head += "Connection: close\r\n";
+    head += _responseHeaders;
+    head += "\r\n";
+    _responseHeaders = String();
+    _currentClient.write(head.c_str(), head.length());
+}
+
+void WebServer::send(int code, const char* contentType, const String& content) {
+    size_t length = _contentLength == CONTENT_LENGTH_NOT_SET ? content.length() : _contentLength;
+    writeHead(code, contentType, length);
+    if (content.length() > 0) {
+        sendContent(content);
+    }
+}
+
+void WebServer::sendContent(const char* content, size_t size) {
+    if (size == 0) return;
+    if (_chunked) {
+        char prefix[16];
+        int n = snprintf(prefix, sizeof(prefix), "%zx\r\n", size);
+        _currentClient.write(prefix, n);
+        _currentClient.write(content, size);
+        _currentClient.write("\r\n", 2);
+    } else {
+        _currentClient.write(content, size);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// HTTPClient
+// ---------------------------------------------------------------------------
+
+bool HTTPClient::begin(const String& url) {
+    end();
+    String rest = url;
+    _port = 80;
+    if (rest.startsWith("http://")) {
+        rest = rest.substring(7);
+    } else if (rest.startsWith("https://")) {
+        rest = rest.substring(8);
+        _port = 443;
+    } else {
+        return false;
+    }
+    int slash = rest.indexOf('/');
+    String hostPort = slash >= 0 ? rest.substring(0, slash) : rest;
+    _path = slash >= 0 ? rest.substring(slash) : String("/");
+    int colon = hostPort.indexOf(':');
+    if (colon >= 0) {
+        _host = hostPort.substring(0, colon);
+        _port = (uint16_t)hostPort.substring(colon + 1).toInt();
+    } else {
+        _host = hostPort;
+    }
+    _headers = String();
+    return _host.length() > 0;
+}
+
+void HTTPClient::end() {
+    _client.stop();
+    _connected = false;
+    _size = -1;
+}
+
+void HTTPClient::addHeader(const String& name, const String& value, bool first, bool) {
+    String line = name + ": " + value + "\r\n";
+    _headers = first ? line + _headers : _headers + line;
+}
+
+void HTTPClient::setAuthorization(const char* user, const char* password) {
+    String credentials = String(user) + ":" + password;
+    addHeader("Authorization", String("Basic ") + base64::encode(credentials));
+}
+
+int HTTPClient::sendRequest(const char* type, const String& payload) {
+    return sendRequest(type, reinterpret_cast<const uint8_t*>(payload.c_str()), payload.length());
+}
+
+int HTTPClient::sendRequest(const char* type, const uint8_t* payload, size_t size) {
+    _client.stop();
+    _connected = false;
+    _size = -1;
+    if (!_client.connect(_host.c_str(), _port, _connectTimeoutMs)) {
+        return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+    _client.setTimeout(_timeoutMs);
+
+    String head = String(type) + " " + _path + " HTTP/1.0\r\n";
+    head += String("Host: ") + _host + "\r\n";
+    head += "User-Agent: ESP32HTTPClient\r\n";
+    head += "Connection: close\r\n";
+    head += _headers;
+    if (payload && size > 0) {
+        head += String("Content-Length: ") + String((unsigned long)size) + "\r\n";
+    }
+    head += "\r\n";
+    if (_client.write(head.c_str(), head.length()) != head.length()) {
+        return HTTPC_ERROR_SEND_HEADER_FAILED;
+    }
+    if (payload && size > 0 && _client.write(payload, size) != size) {
+        return HTTPC_ERROR_SEND_PAYLOAD_FAILED;
+    }
+
+    _connected = true;
+    String statusLine = _client.readStringUntil('\n');
+    if (!statusLine.startsWith("HTTP/")) {
+        return statusLine.isEmpty() ? HTTPC_ERROR_READ_TIMEOUT : HTTPC_ERROR_NO_HTTP_SERVER;
+    }
+    int space = statusLine.indexOf(' ');
+    int code = space >= 0 ? (int)statusLine.substring(space + 1).toInt() : 0;
+    if (!readResponseHeaders()) {
+        return HTTPC_ERROR_CONNECTION_LOST;
+    }
+    return code > 0 ? code : HTTPC_ERROR_NO_HTTP_SERVER;
+}
+
+bool HTTPClient::readResponseHeaders() {
+    for (;;) {
+        String line = _client.readStringUntil('\n');
+        line.trim();
+        if (line.isEmpty()) return true;
+        int colon = line.indexOf(':');
+        if (colon < 0) continue;
+        String name = line.substring(0, colon);
+        if (name.equalsIgnoreCase("Content-Length")) {
+            String value = line.substring(colon + 1);
+            value.trim();
+            _size = (int)value.toInt();
+        }
+    }
+}
+
+String HTTPClient::getString() {
+    if (!_connected) return String();
+    std::string body;
+    if (_size >= 0) {
+        body.resize((size_t)_size);
+        body.resize(_client.readBytes(&body[0], (size_t)_size));
+    } else {
+        return _client.readString();
+    }
+    return String(body);
+}
+
+String HTTPClient::errorToString(int error) {
+    switch (error) {
+        case HTTPC_ERROR_CONNECTION_REFUSED: return "connection refused";
+        case HTTPC_ERROR_SEND_HEADER_FAILED: return "send header failed";
+        case HTTPC_ERROR_SEND_PAYLOAD_FAILED: return "send payload failed";
+        case HTTPC_ERROR_NOT_CONNECTED: return "not connected";
+        case HTTPC_ERROR_CONNECTION_LOST: return "connection lost";
+        case HTTPC_ERROR_NO_STREAM: return "no stream";
+        case HTTPC_ERROR_NO_HTTP_SERVER: return "no HTTP server";
+        case HTTPC_ERROR_TOO_LESS_RAM: return "too less ram";
+        case HTTPC_ERROR_ENCODING: return "Transfer-Encoding not supported";
+        case HTTPC_ERROR_STREAM_WRITE: return "Stream write error";
+        case HTTPC_ERROR_READ_TIMEOUT: return "read Timeout";
+        default: return String();
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Update
+// ---------------------------------------------------------------------------
+
+bool UpdateClass::begin(size_t size, int) {
+    abort();
+    if (size == 0) {
+        _error = UPDATE_ERROR_SIZE;
+        return false;
+    }
+    _file = fopen(NativeHAL::fsPath("ota.bin").c_str(), "wb");
+    if (!_file) {
+        _error = UPDATE_ERROR_WRITE;
+        return false;
+    }
+    _size = size;
+    _progress = 0;
+    _error = UPDATE_ERROR_OK;
+    return true;
+}
+
+size_t UpdateClass::write(uint8_t* data, size_t len) {
+    if (!_file || hasError()) return 0;
+    if (_progress == 0 && len > 0) _firstByte = data[0];
+    size_t written = fwrite(data, 1, len, _file);
+    if (written != len) _error = UPDATE_ERROR_WRITE;
+    _progress += written;
+    return written;
+}
+
+size_t UpdateClass::writeStream(Stream& data) {
+    uint8_t buffer[1024];
+    size_t total = 0;
+    for (;;) {
+        size_t n = data.readBytes(buffer, sizeof(buffer));
+        if (n == 0) break;
+        total += write(buffer, n);
+    }
+    return total;
+}
+
+bool UpdateClass::end(bool evenIfRemaining) {
+    if (!_file) return false;
+    fclose(_file);
+    _file = nullptr;
+    if (hasError()) return false;
+    if (!evenIfRemaining && _size != UPDATE_SIZE_UNKNOWN && _progress != _size) {
+        _error = UPDATE_ERROR_SIZE;
+        return false;
+    }
+    if (_firstByte != 0xE9) {
+        _error = UPDATE_ERROR_MAGIC_BYTE;
+        return false;
+    }
+    return true;
+}
+
+void UpdateClass::abort() {
+    if (_file) {
+        fclose(_file);
+        _file = nullptr;
+        _error = UPDATE_ERROR_ABORT;
+    }
+}
+
+const char* UpdateClass::errorString() const {
+    switch (_error) {
+        case UPDATE_ERROR_OK: return "No Error";
+        case UPDATE_ERROR_WRITE: return "Flash Write Failed";
+        case UPDATE_ERROR_SPACE: return "Not Enough Space";
+        case UPDATE_ERROR_SIZE: return "Bad Size Given";
+        case UPDATE_ERROR_MAGIC_BYTE: return "Wrong Magic Byte";
+        case UPDATE_ERROR_ABORT: return "Update Aborted";
+        default: return "UNKNOWN";
+    }
+}
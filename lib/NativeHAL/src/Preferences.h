@@ -0,0 +1,53 @@
+// Preferences.h - NVS key/value store backed by <fsRoot>/nvs (native build)
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "WString.h"
+
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false, const char* partitionLabel = nullptr);
+    void end() { _started = false; }
+
+    bool clear();
+    bool remove(const char* key);
+    bool isKey(const char* key);
+
+    size_t putBool(const char* key, bool value) { return putValue(key, String(value ? "1" : "0")); }
+    size_t putUChar(const char* key, uint8_t value) { return putValue(key, String(value)); }
+    size_t putShort(const char* key, int16_t value) { return putValue(key, String((int)value)); }
+    size_t putUShort(const char* key, uint16_t value) { return putValue(key, String((unsigned int)value)); }
+    size_t putInt(const char* key, int32_t value) { return putValue(key, String((long)value)); }
+    size_t putUInt(const char* key, uint32_t value) { return putValue(key, String((unsigned long)value)); }
+    size_t putLong(const char* key, int32_t value) { return putInt(key, value); }
+    size_t putULong(const char* key, uint32_t value) { return putUInt(key, value); }
+    size_t putFloat(const char* key, float value) { return putValue(key, String(value, 6)); }
+    size_t putString(const char* key, const char* value) { return putValue(key, String(value)); }
+    size_t putString(const char* key, const String& value) { return putValue(key, value); }
+    size_t putBytes(const char* key, const void* value, size_t len);
+
+    bool getBool(const char* key, bool defaultValue = false);
+    uint8_t getUChar(const char* key, uint8_t defaultValue = 0) { return (uint8_t)getLong(key, defaultValue); }
+    int16_t getShort(const char* key, int16_t defaultValue = 0) { return (int16_t)getLong(key, defaultValue); }
+    uint16_t getUShort(const char* key, uint16_t defaultValue = 0) { return (uint16_t)getLong(key, defaultValue); }
+    int32_t getInt(const char* key, int32_t defaultValue = 0) { return (int32_t)getLong(key, defaultValue); }
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0) { return (uint32_t)getLong(key, defaultValue); }
+    int32_t getLong(const char* key, int32_t defaultValue = 0);
+    uint32_t getULong(const char* key, uint32_t defaultValue = 0) { return getUInt(key, defaultValue); }
+    float getFloat(const char* key, float defaultValue = NAN);
+    String getString(const char* key, const String& defaultValue = String());
+    size_t getString(const char* key, char* value, size_t maxLen);
+    size_t getBytesLength(const char* key);
+    size_t getBytes(const char* key, void* buf, size_t maxLen);
+
+private:
+    std::string keyPath(const char* key) const;
+    size_t putValue(const char* key, const String& value);
+    bool readValue(const char* key, std::string& out);
+
+    std::string _dir;
+    bool _started = false;
+    bool _readOnly = false;
+};
@@ -0,0 +1,55 @@
+// Print.cpp - Arduino Print interface (native build)
+#include "Print.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) {
+        if (write(*buffer++)) {
+            n++;
+        } else {
+            break;
+        }
+    }
+    return n;
+}
+
+static size_t vprintTo(Print& out, const char* format, va_list args) {
+    char stackBuf[128];
+    va_list copy;
+    va_copy(copy, args);
+    int len = vsnprintf(stackBuf, sizeof(stackBuf), format, copy);
+    va_end(copy);
+    if (len < 0) {
+        return 0;
+    }
+    if ((size_t)len < sizeof(stackBuf)) {
+        return out.write(reinterpret_cast<const uint8_t*>(stackBuf), len);
+    }
+    char* heapBuf = static_cast<char*>(malloc(len + 1));
+    if (!heapBuf) {
+        return 0;
+    }
+    vsnprintf(heapBuf, len + 1, format, args);
+    size_t n = out.write(reinterpret_cast<const uint8_t*>(heapBuf), len);
+    free(heapBuf);
+    return n;
+}
+
+size_t Print::printf(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    size_t n = vprintTo(*this, format, args);
+    va_end(args);
+    return n;
+}
+
+size_t Print::printf_P(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    size_t n = vprintTo(*this, format, args);
+    va_end(args);
+    return n;
+}
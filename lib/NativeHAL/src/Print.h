@@ -0,0 +1,54 @@
+// Print.h - Arduino Print interface (native build)
+#pragma once
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "WString.h"
+
+class Print {
+public:
+    virtual ~Print() = default;
+
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    size_t write(const char* str) { return str ? write(reinterpret_cast<const uint8_t*>(str), strlen_(str)) : 0; }
+    size_t write(const char* buffer, size_t size) { return write(reinterpret_cast<const uint8_t*>(buffer), size); }
+    virtual void flush() {}
+    virtual int availableForWrite() { return 0; }
+
+    int getWriteError() const { return _writeError; }
+    void clearWriteError() { _writeError = 0; }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+    size_t printf_P(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+    size_t print(const __FlashStringHelper* s) { return write(reinterpret_cast<const char*>(s)); }
+    size_t print(const String& s) { return write(s.c_str(), s.length()); }
+    size_t print(const char* s) { return write(s); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(unsigned char n, int base = DEC) { return printNumber((unsigned long long)n, base); }
+    size_t print(int n, int base = DEC) { return printSigned(n, base); }
+    size_t print(unsigned int n, int base = DEC) { return printNumber((unsigned long long)n, base); }
+    size_t print(long n, int base = DEC) { return printSigned(n, base); }
+    size_t print(unsigned long n, int base = DEC) { return printNumber((unsigned long long)n, base); }
+    size_t print(long long n, int base = DEC) { return printSigned(n, base); }
+    size_t print(unsigned long long n, int base = DEC) { return printNumber(n, base); }
+    size_t print(double n, int digits = 2) { return print(String(n, (unsigned int)digits)); }
+
+    size_t println() { return write("\r\n"); }
+    template <typename T>
+    size_t println(const T& value) { size_t n = print(value); return n + println(); }
+    template <typename T>
+    size_t println(const T& value, int format) { size_t n = print(value, format); return n + println(); }
+
+protected:
+    void setWriteError(int err = 1) { _writeError = err; }
+
+private:
+    static size_t strlen_(const char* s) { size_t n = 0; while (s[n]) n++; return n; }
+    size_t printNumber(unsigned long long n, int base) { return print(String(n, (unsigned char)base)); }
+    size_t printSigned(long long n, int base) { return print(String(n, (unsigned char)base)); }
+
+    int _writeError = 0;
+};
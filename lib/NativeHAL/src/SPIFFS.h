@@ -0,0 +1,22 @@
+// SPIFFS.h - SPIFFS partition backed by <fsRoot>/spiffs (native build)
+#pragma once
+
+#include "FS.h"
+
+namespace fs {
+
+class SPIFFSFS : public FS {
+public:
+    SPIFFSFS() : FS("spiffs") {}
+
+    bool begin(bool formatOnFail = false, const char* basePath = "/spiffs",
+               uint8_t maxOpenFiles = 10, const char* partitionLabel = nullptr);
+    bool format();
+    size_t totalBytes();
+    size_t usedBytes();
+    void end() {}
+};
+
+} // namespace fs
+
+extern fs::SPIFFSFS SPIFFS;
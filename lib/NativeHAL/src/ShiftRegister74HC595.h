@@ -0,0 +1,69 @@
+// ShiftRegister74HC595.h - 74HC595 chain driver recording latches (native build)
+//
+// Same interface as the timtro/ShiftRegister74HC595 library. Instead of
+// bit-banging GPIO, every latch is reported to NativeHAL so host tools can
+// count refreshes and inspect the frame on the "wire".
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include "Arduino.h"
+#include "NativeHAL.h"
+
+template <uint8_t Size>
+class ShiftRegister74HC595 {
+public:
+    ShiftRegister74HC595(const uint8_t serialDataPin, const uint8_t clockPin, const uint8_t latchPin)
+        : _serialDataPin(serialDataPin), _clockPin(clockPin), _latchPin(latchPin) {
+        ::pinMode(serialDataPin, OUTPUT);
+        ::pinMode(clockPin, OUTPUT);
+        ::pinMode(latchPin, OUTPUT);
+        memset(_digitalValues, 0, Size);
+        updateRegisters();
+    }
+
+    void setAll(const uint8_t* digitalValues) {
+        memcpy(_digitalValues, digitalValues, Size);
+        updateRegisters();
+    }
+
+    void setAll_P(const uint8_t* digitalValuesProgmem) {
+        setAll(digitalValuesProgmem);
+    }
+
+    uint8_t* getAll() { return _digitalValues; }
+
+    void set(const uint8_t pin, const uint8_t value) {
+        setNoUpdate(pin, value);
+        updateRegisters();
+    }
+
+    void setNoUpdate(const uint8_t pin, uint8_t value) {
+        if (value == 1) {
+            _digitalValues[pin / 8] |= 1 << (pin % 8);
+        } else {
+            _digitalValues[pin / 8] &= ~(1 << (pin % 8));
+        }
+    }
+
+    void updateRegisters() {
+        // The chain is clocked from the last register to the first, as on hardware
+        uint8_t wire[Size];
+        for (int i = 0; i < Size; i++) {
+            wire[i] = _digitalValues[Size - 1 - i];
+        }
+        NativeHAL::recordShiftLatch(wire, Size);
+        ::digitalWrite(_latchPin, HIGH);
+        ::digitalWrite(_latchPin, LOW);
+    }
+
+    uint8_t get(const uint8_t pin) { return (_digitalValues[pin / 8] >> (pin % 8)) & 1; }
+    void setAllHigh() { memset(_digitalValues, 0xFF, Size); updateRegisters(); }
+    void setAllLow() { memset(_digitalValues, 0x00, Size); updateRegisters(); }
+
+private:
+    uint8_t _serialDataPin;
+    uint8_t _clockPin;
+    uint8_t _latchPin;
+    uint8_t _digitalValues[Size];
+};
@@ -0,0 +1,104 @@
+// UdpNative.cpp - AsyncUDP and lwIP DNS on host sockets (native build)
+#include "AsyncUDP.h"
+#include "lwip/dns.h"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string.h>
+
+bool AsyncUDP::listen(uint16_t port) {
+    close();
+
+    _fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (_fd < 0) {
+        return false;
+    }
+
+    sockaddr_in local;
+    memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    local.sin_port = htons(port);
+    if (bind(_fd, reinterpret_cast<sockaddr*>(&local), sizeof(local)) < 0) {
+        ::close(_fd);
+        _fd = -1;
+        return false;
+    }
+
+    _running = true;
+    _thread = std::thread(&AsyncUDP::receiveLoop, this);
+    return true;
+}
+
+void AsyncUDP::receiveLoop() {
+    uint8_t buffer[1500];
+    while (_running) {
+        pollfd pfd = {_fd, POLLIN, 0};
+        if (poll(&pfd, 1, 100) <= 0) {
+            continue;
+        }
+
+        sockaddr_in remote;
+        socklen_t remoteLen = sizeof(remote);
+        ssize_t n = recvfrom(_fd, buffer, sizeof(buffer), 0,
+                             reinterpret_cast<sockaddr*>(&remote), &remoteLen);
+        if (n < 0 || !_handler) {
+            continue;
+        }
+
+        AsyncUDPPacket packet(buffer, (size_t)n, IPAddress((uint32_t)remote.sin_addr.s_addr),
+                              ntohs(remote.sin_port));
+        _handler(packet);
+    }
+}
+
+size_t AsyncUDP::writeTo(const uint8_t* data, size_t len, const IPAddress& addr, uint16_t port) {
+    if (_fd < 0) {
+        return 0;
+    }
+
+    sockaddr_in remote;
+    memset(&remote, 0, sizeof(remote));
+    remote.sin_family = AF_INET;
+    remote.sin_addr.s_addr = (uint32_t)addr;
+    remote.sin_port = htons(port);
+    ssize_t n = sendto(_fd, data, len, 0, reinterpret_cast<sockaddr*>(&remote), sizeof(remote));
+    return n < 0 ? 0 : (size_t)n;
+}
+
+void AsyncUDP::close() {
+    _running = false;
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+}
+
+err_t dns_gethostbyname(const char* hostname, ip_addr_t* addr, dns_found_callback, void*) {
+    if (!hostname || !addr) {
+        return ERR_ARG;
+    }
+
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+
+    addrinfo* result = nullptr;
+    if (getaddrinfo(hostname, nullptr, &hints, &result) != 0 || !result) {
+        return ERR_VAL;
+    }
+
+    addr->u_addr.ip4.addr = reinterpret_cast<sockaddr_in*>(result->ai_addr)->sin_addr.s_addr;
+    addr->type = IPADDR_TYPE_V4;
+    freeaddrinfo(result);
+    return ERR_OK;
+}
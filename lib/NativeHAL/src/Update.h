@@ -0,0 +1,42 @@
+// Update.h - OTA flash writer (native build)
+//
+// The image is written to <fsRoot>/ota.bin so an update can be inspected on
+// the host; end() validates the ESP32 image magic byte like the bootloader.
+#pragma once
+
+#include <stdio.h>
+#include "Arduino.h"
+
+#define UPDATE_SIZE_UNKNOWN 0xFFFFFFFF
+#define U_FLASH 0
+
+#define UPDATE_ERROR_OK         0
+#define UPDATE_ERROR_WRITE      1
+#define UPDATE_ERROR_SPACE      4
+#define UPDATE_ERROR_SIZE       5
+#define UPDATE_ERROR_MAGIC_BYTE 10
+#define UPDATE_ERROR_ABORT      8
+
+class UpdateClass {
+public:
+    bool begin(size_t size = UPDATE_SIZE_UNKNOWN, int command = U_FLASH);
+    size_t write(uint8_t* data, size_t len);
+    size_t writeStream(Stream& data);
+    bool end(bool evenIfRemaining = false);
+    void abort();
+    bool hasError() const { return _error != UPDATE_ERROR_OK; }
+    uint8_t getError() const { return _error; }
+    const char* errorString() const;
+    bool isFinished() const { return _size != UPDATE_SIZE_UNKNOWN && _progress == _size; }
+    size_t progress() const { return _progress; }
+    size_t size() const { return _size; }
+
+private:
+    FILE* _file = nullptr;
+    size_t _size = 0;
+    size_t _progress = 0;
+    uint8_t _firstByte = 0;
+    uint8_t _error = UPDATE_ERROR_OK;
+};
+
+extern UpdateClass Update;
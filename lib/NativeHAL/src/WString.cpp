@@ -0,0 +1,105 @@
+// WString.cpp - Arduino String on top of std::string (native build)
+#include "WString.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char DIGITS[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+void String::fromUnsigned(unsigned long long value, unsigned char base) {
+    if (base < 2 || base > 36) base = 10;
+    char buf[66];
+    char* p = buf + sizeof(buf) - 1;
+    *p = '\0';
+    do {
+        *--p = DIGITS[value % base];
+        value /= base;
+    } while (value);
+    _s = p;
+}
+
+void String::fromSigned(long long value, unsigned char base) {
+    if (base == 10 && value < 0) {
+        fromUnsigned((unsigned long long)(-(value + 1)) + 1, 10);
+        _s.insert(_s.begin(), '-');
+    } else if (base == 10) {
+        fromUnsigned((unsigned long long)value, 10);
+    } else {
+        // Arduino prints negative numbers in other bases as unsigned 32-bit
+        fromUnsigned((unsigned long long)(uint32_t)value, base);
+    }
+}
+
+void String::fromDouble(double value, unsigned int decimalPlaces) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimalPlaces, value);
+    _s = buf;
+}
+
+bool String::equalsIgnoreCase(const String& s) const {
+    if (_s.size() != s._s.size()) return false;
+    for (size_t i = 0; i < _s.size(); i++) {
+        if (tolower((unsigned char)_s[i]) != tolower((unsigned char)s._s[i])) return false;
+    }
+    return true;
+}
+
+void String::getBytes(unsigned char* buf, unsigned int bufsize, unsigned int index) const {
+    if (!bufsize || !buf) return;
+    if (index >= _s.size()) {
+        buf[0] = 0;
+        return;
+    }
+    size_t n = _s.size() - index;
+    if (n > bufsize - 1) n = bufsize - 1;
+    memcpy(buf, _s.data() + index, n);
+    buf[n] = 0;
+}
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const {
+    if (beginIndex > endIndex) {
+        unsigned int t = endIndex;
+        endIndex = beginIndex;
+        beginIndex = t;
+    }
+    if (beginIndex >= _s.size()) return String();
+    if (endIndex > _s.size()) endIndex = (unsigned int)_s.size();
+    return String(_s.substr(beginIndex, endIndex - beginIndex));
+}
+
+void String::replace(char find, char replace) {
+    for (char& c : _s) {
+        if (c == find) c = replace;
+    }
+}
+
+void String::replace(const String& find, const String& replace) {
+    if (find._s.empty()) return;
+    size_t pos = 0;
+    while ((pos = _s.find(find._s, pos)) != std::string::npos) {
+        _s.replace(pos, find._s.size(), replace._s);
+        pos += replace._s.size();
+    }
+}
+
+void String::toLowerCase() {
+    for (char& c : _s) c = (char)tolower((unsigned char)c);
+}
+
+void String::toUpperCase() {
+    for (char& c : _s) c = (char)toupper((unsigned char)c);
+}
+
+void String::trim() {
+    size_t b = 0;
+    while (b < _s.size() && isspace((unsigned char)_s[b])) b++;
+    size_t e = _s.size();
+    while (e > b && isspace((unsigned char)_s[e - 1])) e--;
+    _s = _s.substr(b, e - b);
+}
+
+long String::toInt() const { return atol(_s.c_str()); }
+float String::toFloat() const { return (float)atof(_s.c_str()); }
+double String::toDouble() const { return atof(_s.c_str()); }
@@ -0,0 +1,143 @@
+// WString.h - Arduino String on top of std::string (native build)
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+class __FlashStringHelper;
+
+#ifndef DEC
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+#endif
+
+class String {
+public:
+    String() {}
+    String(const char* cstr) : _s(cstr ? cstr : "") {}
+    String(const char* cstr, unsigned int length) : _s(cstr ? std::string(cstr, length) : std::string()) {}
+    String(const __FlashStringHelper* str) : String(reinterpret_cast<const char*>(str)) {}
+    explicit String(const std::string& s) : _s(s) {}
+    String(char c) : _s(1, c) {}
+    explicit String(unsigned char value, unsigned char base = 10) { fromUnsigned(value, base); }
+    explicit String(int value, unsigned char base = 10) { fromSigned(value, base); }
+    explicit String(unsigned int value, unsigned char base = 10) { fromUnsigned(value, base); }
+    explicit String(long value, unsigned char base = 10) { fromSigned(value, base); }
+    explicit String(unsigned long value, unsigned char base = 10) { fromUnsigned(value, base); }
+    explicit String(long long value, unsigned char base = 10) { fromSigned(value, base); }
+    explicit String(unsigned long long value, unsigned char base = 10) { fromUnsigned(value, base); }
+    explicit String(float value, unsigned int decimalPlaces = 2) { fromDouble(value, decimalPlaces); }
+    explicit String(double value, unsigned int decimalPlaces = 2) { fromDouble(value, decimalPlaces); }
+
+    unsigned int length() const { return (unsigned int)_s.length(); }
+    bool isEmpty() const { return _s.empty(); }
+    const char* c_str() const { return _s.c_str(); }
+    char* begin() { return &_s[0]; }
+    char* end() { return &_s[0] + _s.length(); }
+    bool reserve(unsigned int size) { _s.reserve(size); return true; }
+    void clear() { _s.clear(); }
+
+    // Concatenation
+    bool concat(const String& str) { _s += str._s; return true; }
+    bool concat(const char* cstr) { if (!cstr) return false; _s += cstr; return true; }
+    bool concat(const char* cstr, unsigned int length) { if (!cstr) return false; _s.append(cstr, length); return true; }
+    bool concat(char c) { _s += c; return true; }
+    bool concat(unsigned char num) { return concat(String(num)); }
+    bool concat(int num) { return concat(String(num)); }
+    bool concat(unsigned int num) { return concat(String(num)); }
+    bool concat(long num) { return concat(String(num)); }
+    bool concat(unsigned long num) { return concat(String(num)); }
+    bool concat(long long num) { return concat(String(num)); }
+    bool concat(unsigned long long num) { return concat(String(num)); }
+    bool concat(float num) { return concat(String(num)); }
+    bool concat(double num) { return concat(String(num)); }
+    bool concat(const __FlashStringHelper* str) { return concat(reinterpret_cast<const char*>(str)); }
+
+    template <typename T>
+    String& operator+=(const T& rhs) { concat(rhs); return *this; }
+
+    // Comparison
+    int compareTo(const String& s) const { return _s.compare(s._s); }
+    bool equals(const String& s) const { return _s == s._s; }
+    bool equals(const char* cstr) const { return cstr && _s == cstr; }
+    bool equalsIgnoreCase(const String& s) const;
+    bool operator==(const String& rhs) const { return equals(rhs); }
+    bool operator==(const char* cstr) const { return equals(cstr); }
+    bool operator!=(const String& rhs) const { return !equals(rhs); }
+    bool operator!=(const char* cstr) const { return !equals(cstr); }
+    bool operator<(const String& rhs) const { return _s < rhs._s; }
+    bool operator>(const String& rhs) const { return _s > rhs._s; }
+    bool startsWith(const String& prefix) const { return _s.compare(0, prefix._s.size(), prefix._s) == 0; }
+    bool endsWith(const String& suffix) const {
+        return _s.size() >= suffix._s.size() &&
+               _s.compare(_s.size() - suffix._s.size(), suffix._s.size(), suffix._s) == 0;
+    }
+
+    // Character access
+    char charAt(unsigned int index) const { return index < _s.size() ? _s[index] : 0; }
+    void setCharAt(unsigned int index, char c) { if (index < _s.size()) _s[index] = c; }
+    char operator[](unsigned int index) const { return charAt(index); }
+    char& operator[](unsigned int index) { return _s[index]; }
+    void getBytes(unsigned char* buf, unsigned int bufsize, unsigned int index = 0) const;
+    void toCharArray(char* buf, unsigned int bufsize, unsigned int index = 0) const {
+        getBytes(reinterpret_cast<unsigned char*>(buf), bufsize, index);
+    }
+
+    // Search
+    int indexOf(char ch, unsigned int fromIndex = 0) const { return toIndex(_s.find(ch, fromIndex)); }
+    int indexOf(const String& str, unsigned int fromIndex = 0) const { return toIndex(_s.find(str._s, fromIndex)); }
+    int lastIndexOf(char ch) const { return toIndex(_s.rfind(ch)); }
+    int lastIndexOf(const String& str) const { return toIndex(_s.rfind(str._s)); }
+    String substring(unsigned int beginIndex) const {
+        return beginIndex < _s.size() ? String(_s.substr(beginIndex)) : String();
+    }
+    String substring(unsigned int beginIndex, unsigned int endIndex) const;
+
+    // Modification
+    void replace(char find, char replace);
+    void replace(const String& find, const String& replace);
+    void remove(unsigned int index) { if (index < _s.size()) _s.erase(index); }
+    void remove(unsigned int index, unsigned int count) { if (index < _s.size()) _s.erase(index, count); }
+    void toLowerCase();
+    void toUpperCase();
+    void trim();
+
+    // Parsing
+    long toInt() const;
+    float toFloat() const;
+    double toDouble() const;
+
+    const std::string& str() const { return _s; }
+
+private:
+    static int toIndex(size_t pos) { return pos == std::string::npos ? -1 : (int)pos; }
+    void fromSigned(long long value, unsigned char base);
+    void fromUnsigned(unsigned long long value, unsigned char base);
+    void fromDouble(double value, unsigned int decimalPlaces);
+
+    std::string _s;
+};
+
+// Arduino returns a StringSumHelper from operator+; libraries (ArduinoJson)
+// detect the type by name, so it is kept as a thin subclass.
+class StringSumHelper : public String {
+public:
+    StringSumHelper(const String& s) : String(s) {}
+    StringSumHelper(const char* p) : String(p) {}
+};
+
+inline StringSumHelper operator+(const String& lhs, const String& rhs) { String r(lhs); r.concat(rhs); return r; }
+inline StringSumHelper operator+(const String& lhs, const char* rhs) { String r(lhs); r.concat(rhs); return r; }
+inline StringSumHelper operator+(const char* lhs, const String& rhs) { String r(lhs); r.concat(rhs); return r; }
+inline StringSumHelper operator+(const String& lhs, char rhs) { String r(lhs); r.concat(rhs); return r; }
+inline StringSumHelper operator+(const String& lhs, int rhs) { String r(lhs); r.concat(rhs); return r; }
+inline StringSumHelper operator+(const String& lhs, unsigned int rhs) { String r(lhs); r.concat(rhs); return r; }
+inline StringSumHelper operator+(const String& lhs, long rhs) { String r(lhs); r.concat(rhs); return r; }
+inline StringSumHelper operator+(const String& lhs, unsigned long rhs) { String r(lhs); r.concat(rhs); return r; }
+inline StringSumHelper operator+(const String& lhs, float rhs) { String r(lhs); r.concat(rhs); return r; }
+inline StringSumHelper operator+(const String& lhs, double rhs) { String r(lhs); r.concat(rhs); return r; }
+inline bool operator==(const char* lhs, const String& rhs) { return rhs == lhs; }
+inline bool operator!=(const char* lhs, const String& rhs) { return rhs != lhs; }
@@ -0,0 +1,100 @@
+// WebServer.h - Synchronous HTTP/1.1 server over POSIX sockets (native build)
+//
+// Same single-client, poll-driven model as the arduino-esp32 WebServer:
+// handleClient() accepts at most one pending connection, reads the request,
+// dispatches it to the first matching handler and closes the connection.
+// Privileged ports are remapped by NativeHAL::mapListenPort (80 -> 8080).
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "Arduino.h"
+#include "WiFiClient.h"
+
+typedef enum {
+    HTTP_ANY,
+    HTTP_GET,
+    HTTP_HEAD,
+    HTTP_POST,
+    HTTP_PUT,
+    HTTP_PATCH,
+    HTTP_DELETE,
+    HTTP_OPTIONS
+} HTTPMethod;
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+#define CONTENT_LENGTH_NOT_SET ((size_t)-2)
+
+class WebServer {
+public:
+    typedef std::function<void(void)> THandlerFunction;
+
+    explicit WebServer(int port = 80);
+    ~WebServer();
+
+    void begin();
+    void begin(uint16_t port);
+    void stop();
+    void close() { stop(); }
+    void handleClient();
+
+    void on(const String& uri, THandlerFunction handler) { on(uri, HTTP_ANY, handler); }
+    void on(const String& uri, HTTPMethod method, THandlerFunction fn);
+    void onNotFound(THandlerFunction fn) { _notFoundHandler = fn; }
+
+    String uri() const { return _currentUri; }
+    HTTPMethod method() const { return _currentMethod; }
+    WiFiClient& client() { return _currentClient; }
+
+    String arg(const String& name) const;
+    String arg(int i) const;
+    String argName(int i) const;
+    int args() const { return (int)_args.size(); }
+    bool hasArg(const String& name) const;
+    String header(const String& name) const;
+    bool hasHeader(const String& name) const;
+    String hostHeader() const { return _hostHeader; }
+
+    void send(int code, const char* contentType = nullptr, const String& content = String());
+    void send(int code, const char* contentType, const char* content) { send(code, contentType, String(content)); }
+    void send(int code, const String& contentType, const String& content) { send(code, contentType.c_str(), content); }
+    void send_P(int code, PGM_P contentType, PGM_P content) { send(code, contentType, String(content)); }
+    void sendHeader(const String& name, const String& value, bool first = false);
+    void setContentLength(size_t contentLength) { _contentLength = contentLength; }
+    void sendContent(const String& content) { sendContent(content.c_str(), content.length()); }
+    void sendContent(const char* content, size_t size);
+
+private:
+    struct Route {
+        String uri;
+        HTTPMethod method;
+        THandlerFunction handler;
+    };
+    struct KeyValue {
+        String key;
+        String value;
+    };
+
+    bool parseRequest(WiFiClient& client);
+    void parseArguments(const String& data);
+    static String urlDecode(const String& text);
+    static const char* responseCodeToString(int code);
+    void writeHead(int code, const char* contentType, size_t contentLength);
+
+    int _listenFd = -1;
+    uint16_t _port;
+
+    std::vector<Route> _routes;
+    THandlerFunction _notFoundHandler;
+
+    WiFiClient _currentClient;
+    String _currentUri;
+    HTTPMethod _currentMethod = HTTP_ANY;
+    String _hostHeader;
+    std::vector<KeyValue> _args;
+    std::vector<KeyValue> _requestHeaders;
+    String _responseHeaders;
+    size_t _contentLength = CONTENT_LENGTH_NOT_SET;
+    bool _chunked = false;
+};
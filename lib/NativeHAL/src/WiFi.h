@@ -0,0 +1,153 @@
+// WiFi.h - Wi-Fi station/AP simulated on the host network (native build)
+//
+// The host is treated as an always-available access point: begin() succeeds
+// immediately and fires the usual STA_START/CONNECTED/GOT_IP events from a
+// worker thread, and localIP() is the loopback address. Scans return one
+// simulated network.
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "Arduino.h"
+#include "IPAddress.h"
+#include "WiFiClient.h"
+#include "esp_wifi.h"
+
+typedef enum {
+    WL_NO_SHIELD = 255,
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_SCAN_COMPLETED = 2,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum {
+    WIFI_MODE_NULL = 0,
+    WIFI_MODE_STA,
+    WIFI_MODE_AP,
+    WIFI_MODE_APSTA
+} wifi_mode_t;
+
+#define WIFI_OFF    WIFI_MODE_NULL
+#define WIFI_STA    WIFI_MODE_STA
+#define WIFI_AP     WIFI_MODE_AP
+#define WIFI_AP_STA WIFI_MODE_APSTA
+
+typedef enum {
+    WIFI_AUTH_OPEN = 0,
+    WIFI_AUTH_WEP,
+    WIFI_AUTH_WPA_PSK,
+    WIFI_AUTH_WPA2_PSK,
+    WIFI_AUTH_WPA_WPA2_PSK
+} wifi_auth_mode_t;
+
+typedef enum {
+    SYSTEM_EVENT_WIFI_READY = 0,
+    SYSTEM_EVENT_SCAN_DONE,
+    SYSTEM_EVENT_STA_START,
+    SYSTEM_EVENT_STA_STOP,
+    SYSTEM_EVENT_STA_CONNECTED,
+    SYSTEM_EVENT_STA_DISCONNECTED,
+    SYSTEM_EVENT_STA_AUTHMODE_CHANGE,
+    SYSTEM_EVENT_STA_GOT_IP,
+    SYSTEM_EVENT_STA_LOST_IP,
+    SYSTEM_EVENT_AP_START = 13,
+    SYSTEM_EVENT_AP_STOP,
+    SYSTEM_EVENT_AP_STACONNECTED,
+    SYSTEM_EVENT_AP_STADISCONNECTED
+} system_event_id_t;
+
+typedef system_event_id_t WiFiEvent_t;
+
+typedef union {
+    struct {
+        uint8_t ssid[32];
+        uint8_t ssid_len;
+        uint8_t bssid[6];
+        uint8_t reason;
+    } wifi_sta_disconnected;
+    struct {
+        uint8_t ssid[32];
+        uint8_t ssid_len;
+        uint8_t bssid[6];
+        uint8_t channel;
+        wifi_auth_mode_t authmode;
+    } wifi_sta_connected;
+    struct {
+        uint32_t ip;
+        uint32_t netmask;
+        uint32_t gw;
+    } got_ip;
+} WiFiEventInfo_t;
+
+typedef std::function<void(WiFiEvent_t event, WiFiEventInfo_t info)> WiFiEventFuncCb;
+typedef size_t wifi_event_id_t;
+
+class WiFiClass {
+public:
+    wl_status_t begin(const char* ssid, const char* passphrase = nullptr, int32_t channel = 0,
+                      const uint8_t* bssid = nullptr, bool connect = true);
+    wl_status_t begin(const String& ssid, const String& passphrase = String()) {
+        return begin(ssid.c_str(), passphrase.c_str());
+    }
+    wl_status_t begin();
+    bool disconnect(bool wifiOff = false, bool eraseAp = false);
+    bool reconnect();
+    wl_status_t status() const { return _status; }
+    bool isConnected() const { return _status == WL_CONNECTED; }
+
+    bool mode(wifi_mode_t mode);
+    wifi_mode_t getMode() const { return _mode; }
+    void persistent(bool persistent) { (void)persistent; }
+    bool setAutoReconnect(bool autoReconnect) { _autoReconnect = autoReconnect; return true; }
+    bool getAutoReconnect() const { return _autoReconnect; }
+    bool setHostname(const char* hostname) { _hostname = hostname ? hostname : ""; return true; }
+    const char* getHostname() const { return _hostname.c_str(); }
+    bool setSleep(bool enabled) { (void)enabled; return true; }
+
+    IPAddress localIP() const { return _status == WL_CONNECTED ? IPAddress(127, 0, 0, 1) : IPAddress(); }
+    IPAddress gatewayIP() const { return IPAddress(127, 0, 0, 1); }
+    IPAddress subnetMask() const { return IPAddress(255, 0, 0, 0); }
+    IPAddress dnsIP(uint8_t index = 0) const { (void)index; return IPAddress(127, 0, 0, 53); }
+    String macAddress() const { return String("24:0A:C4:00:00:01"); }
+    uint8_t* macAddress(uint8_t* mac) const;
+    String SSID() const { return _ssid; }
+    int8_t RSSI() const { return _status == WL_CONNECTED ? -55 : 0; }
+    int32_t channel() const { return 6; }
+    int32_t channel(uint8_t index) const { return index == 0 ? 6 : 0; }
+
+    bool softAP(const char* ssid, const char* passphrase = nullptr, int channel = 1,
+                int hidden = 0, int maxConnection = 4);
+    bool softAPConfig(IPAddress localIp, IPAddress gateway, IPAddress subnet);
+    bool softAPdisconnect(bool wifiOff = false);
+    IPAddress softAPIP() const { return _apIP; }
+
+    // Blocking lookup through the host resolver; 1 on success
+    int hostByName(const char* hostname, IPAddress& result);
+
+    int16_t scanNetworks(bool async = false, bool showHidden = false);
+    void scanDelete() {}
+    String SSID(uint8_t index) const;
+    int32_t RSSI(uint8_t index) const;
+    wifi_auth_mode_t encryptionType(uint8_t index) const;
+
+    wifi_event_id_t onEvent(WiFiEventFuncCb callback);
+    void removeEvent(wifi_event_id_t id);
+
+private:
+    void postEvent(WiFiEvent_t event, uint8_t reason = 0);
+
+    wl_status_t _status = WL_IDLE_STATUS;
+    wifi_mode_t _mode = WIFI_MODE_NULL;
+    bool _autoReconnect = true;
+    std::string _hostname = "esp32";
+    String _ssid;
+    IPAddress _apIP = IPAddress(192, 168, 4, 1);
+    std::vector<WiFiEventFuncCb> _handlers;
+};
+
+extern WiFiClass WiFi;
@@ -0,0 +1,40 @@
+// WiFiClient.h - TCP client over POSIX sockets (native build)
+#pragma once
+
+#include <memory>
+#include "Client.h"
+
+class WiFiClient : public Client {
+public:
+    WiFiClient() = default;
+    explicit WiFiClient(int fd);
+    ~WiFiClient() override = default;
+
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(IPAddress ip, uint16_t port, int32_t timeoutMs);
+    int connect(const char* host, uint16_t port) override;
+    int connect(const char* host, uint16_t port, int32_t timeoutMs);
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* buf, size_t size) override;
+    using Print::write;
+    int available() override;
+    int read() override;
+    int read(uint8_t* buf, size_t size) override;
+    int peek() override;
+    void flush() override {}
+    void stop() override;
+    uint8_t connected() override;
+    operator bool() override { return connected(); }
+
+    int fd() const;
+    IPAddress remoteIP() const;
+    uint16_t remotePort() const;
+    void setNoDelay(bool noDelay);
+
+private:
+    struct Socket;
+    bool fillPeek();
+
+    std::shared_ptr<Socket> _socket;
+};
@@ -0,0 +1,16 @@
+// WiFiClientSecure.h - TLS client stand-in (native build)
+//
+// TLS is not simulated: the connection is plain TCP, and certificate setters
+// are accepted and ignored. Point secure endpoints at a local plain-text
+// service when running on the host.
+#pragma once
+
+#include "WiFiClient.h"
+
+class WiFiClientSecure : public WiFiClient {
+public:
+    void setInsecure() {}
+    void setCACert(const char*) {}
+    void setCertificate(const char*) {}
+    void setPrivateKey(const char*) {}
+};
@@ -0,0 +1,57 @@
+// Wire.h - I2C master on the NativeHAL simulated bus (native build)
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Stream.h"
+
+class TwoWire : public Stream {
+public:
+    static constexpr size_t BUFFER_LENGTH = 128;
+
+    explicit TwoWire(uint8_t busNum) : _busNum(busNum) {}
+
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+    bool end() { return true; }
+    bool setClock(uint32_t frequency) { _frequency = frequency; return true; }
+    uint32_t getClock() const { return _frequency; }
+    void setTimeOut(uint16_t timeOutMillis) { _timeoutMs = timeOutMillis; }
+
+    void beginTransmission(uint16_t address);
+    void beginTransmission(int address) { beginTransmission((uint16_t)address); }
+    // 0 = success, 2 = address NACK, 4 = other error, 5 = timeout (same codes
+    // as arduino-esp32)
+    uint8_t endTransmission(bool sendStop = true);
+
+    size_t requestFrom(uint16_t address, size_t size, bool sendStop = true);
+    template <typename A, typename L>
+    uint8_t requestFrom(A address, L size, bool sendStop = true) {
+        return (uint8_t)requestFrom((uint16_t)address, (size_t)size, sendStop);
+    }
+
+    size_t write(uint8_t data) override;
+    size_t write(const uint8_t* data, size_t quantity) override;
+    using Print::write;
+
+    int available() override { return (int)(_rxLength - _rxIndex); }
+    int read() override { return _rxIndex < _rxLength ? _rxBuffer[_rxIndex++] : -1; }
+    int peek() override { return _rxIndex < _rxLength ? _rxBuffer[_rxIndex] : -1; }
+    void flush() override { _rxIndex = _rxLength = 0; _txLength = 0; }
+
+private:
+    uint8_t _busNum;
+    uint32_t _frequency = 100000;
+    uint16_t _timeoutMs = 50;
+
+    uint16_t _txAddress = 0;
+    uint8_t _txBuffer[BUFFER_LENGTH];
+    size_t _txLength = 0;
+    bool _transmitting = false;
+
+    uint8_t _rxBuffer[BUFFER_LENGTH];
+    size_t _rxIndex = 0;
+    size_t _rxLength = 0;
+};
+
+extern TwoWire Wire;
+extern TwoWire Wire1;
@@ -0,0 +1,288 @@
+// WireNative.cpp - I2C master and simulated BME280 (native build)
+#include "Wire.h"
+#include "NativeHAL.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <mutex>
+
+TwoWire Wire(0);
+TwoWire Wire1(1);
+
+bool TwoWire::begin(int sda, int scl, uint32_t frequency) {
+    if (frequency) _frequency = frequency;
+    NativeHAL::setI2CPins(sda, scl);
+    _rxIndex = _rxLength = 0;
+    _txLength = 0;
+    return true;
+}
+
+void TwoWire::beginTransmission(uint16_t address) {
+    _txAddress = address;
+    _txLength = 0;
+    _transmitting = true;
+}
+
+uint8_t TwoWire::endTransmission(bool) {
+    _transmitting = false;
+    if (NativeHAL::i2cDataHeld()) {
+        return 5;  // Bus busy until the timeout
+    }
+    NativeHAL::I2CDevice* device = NativeHAL::findI2CDevice((uint8_t)_txAddress);
+    if (!device || NativeHAL::consumeI2CFailure((uint8_t)_txAddress)) {
+        return 2;
+    }
+    if (_txLength > 0 && !device->write(_txBuffer, _txLength)) {
+        return 4;
+    }
+    return 0;
+}
+
+size_t TwoWire::requestFrom(uint16_t address, size_t size, bool) {
+    _rxIndex = _rxLength = 0;
+    if (size > BUFFER_LENGTH) size = BUFFER_LENGTH;
+    NativeHAL::I2CDevice* device = NativeHAL::findI2CDevice((uint8_t)address);
+    if (!device || NativeHAL::i2cDataHeld() || NativeHAL::consumeI2CFailure((uint8_t)address)) {
+        return 0;
+    }
+    _rxLength = device->read(_rxBuffer, size);
+    return _rxLength;
+}
+
+size_t TwoWire::write(uint8_t data) {
+    if (!_transmitting || _txLength >= BUFFER_LENGTH) {
+        return 0;
+    }
+    _txBuffer[_txLength++] = data;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t quantity) {
+    size_t n = 0;
+    while (n < quantity && write(data[n])) {
+        n++;
+    }
+    return n;
+}
+
+// ---------------------------------------------------------------------------
+// Simulated BME280
+//
+// Register-level model of the Bosch BME280 using the calibration example from
+// the datasheet. The simulated room drifts slowly around 21 C / 45 %RH /
+// 1013 hPa; raw ADC values are found by inverting the datasheet compensation
+// formulas so the firmware's own compensation code produces those readings.
+// Forced conversions keep the status "measuring" bit set for the typical
+// conversion time given by the configured oversampling. A second sensor, set
+// to a cooler and damper room, can be attached at 0x77.
+// ---------------------------------------------------------------------------
+
+namespace {
+
+class SimulatedBME280 : public NativeHAL::I2CDevice {
+public:
+    SimulatedBME280(double temperatureOffset = 0.0, double humidityOffset = 0.0)
+        : _temperatureOffset(temperatureOffset), _humidityOffset(humidityOffset) {
+        reset();
+    }
+
+    bool write(const uint8_t* data, size_t len) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        if (len == 0) return true;
+        _pointer = data[0];
+        for (size_t i = 1; i < len; i++) {
+            writeRegister(_pointer++, data[i]);
+        }
+        return true;
+    }
+
+    size_t read(uint8_t* data, size_t len) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        update();
+        for (size_t i = 0; i < len; i++) {
+            data[i] = _regs[(uint8_t)(_pointer + i)];
+        }
+        _pointer += (uint8_t)len;
+        return len;
+    }
+
+private:
+    // Datasheet calibration example
+    static constexpr uint16_t T1 = 27504;
+    static constexpr int16_t T2 = 26435, T3 = -1000;
+    static constexpr uint16_t P1 = 36477;
+    static constexpr int16_t P2 = -10685, P3 = 3024, P4 = 2855, P5 = 140, P6 = -7;
+    static constexpr int16_t P7 = 15500, P8 = -14600, P9 = 6000;
+    static constexpr uint8_t H1 = 75, H3 = 0;
+    static constexpr int16_t H2 = 362, H4 = 313, H5 = 50;
+    static constexpr int8_t H6 = 30;
+
+    void reset() {
+        memset(_regs, 0, sizeof(_regs));
+        _regs[0xD0] = 0x60;
+        putLE(0x88, T1); putLE(0x8A, (uint16_t)T2); putLE(0x8C, (uint16_t)T3);
+        putLE(0x8E, P1); putLE(0x90, (uint16_t)P2); putLE(0x92, (uint16_t)P3);
+        putLE(0x94, (uint16_t)P4); putLE(0x96, (uint16_t)P5); putLE(0x98, (uint16_t)P6);
+        putLE(0x9A, (uint16_t)P7); putLE(0x9C, (uint16_t)P8); putLE(0x9E, (uint16_t)P9);
+        _regs[0xA1] = H1;
+        putLE(0xE1, (uint16_t)H2);
+        _regs[0xE3] = H3;
+        _regs[0xE4] = (uint8_t)(H4 >> 4);
+        _regs[0xE5] = (uint8_t)((H4 & 0x0F) | ((H5 & 0x0F) << 4));
+        _regs[0xE6] = (uint8_t)(H5 >> 4);
+        _regs[0xE7] = (uint8_t)H6;
+        // Power-on output registers hold the "skipped" markers
+        _regs[0xF7] = 0x80; _regs[0xFA] = 0x80; _regs[0xFD] = 0x80;
+        _conversionEndUs = 0;
+    }
+
+    void putLE(uint8_t reg, uint16_t value) {
+        _regs[reg] = (uint8_t)value;
+        _regs[reg + 1] = (uint8_t)(value >> 8);
+    }
+
+    static uint32_t oversampling(uint8_t code) {
+        static const uint32_t SAMPLES[8] = {0, 1, 2, 4, 8, 16, 16, 16};
+        return SAMPLES[code & 0x07];
+    }
+
+    // Typical conversion time in microseconds (datasheet section 9.1)
+    uint32_t conversionTimeUs() const {
+        uint32_t osT = oversampling(_regs[0xF4] >> 5);
+        uint32_t osP = oversampling(_regs[0xF4] >> 2);
+        uint32_t osH = oversampling(_regs[0xF2]);
+        uint32_t us = 1000 + 2000 * osT;
+        if (osP) us += 2000 * osP + 500;
+        if (osH) us += 2000 * osH + 500;
+        return us;
+    }
+
+    void writeRegister(uint8_t reg, uint8_t value) {
+        if (reg == 0xE0) {
+            if (value == 0xB6) reset();
+            return;
+        }
+        if (reg != 0xF2 && reg != 0xF4 && reg != 0xF5) {
+            return;     // Read-only
+        }
+        _regs[reg] = value;
+        if (reg == 0xF4 && (value & 0x03) == 0x01) {
+            _conversionEndUs = NativeHAL::monotonicMicros() + conversionTimeUs();
+            _forcedPending = true;
+        }
+    }
+
+    void update() {
+        uint64_t now = NativeHAL::monotonicMicros();
+        uint8_t mode = _regs[0xF4] & 0x03;
+        bool measuring = false;
+
+        if (_forcedPending) {
+            if (now >= _conversionEndUs) {
+                sample(now);
+                _forcedPending = false;
+                _regs[0xF4] &= ~0x03;   // Back to sleep
+            } else {
+                measuring = true;
+            }
+        } else if (mode == 0x03) {
+            sample(now);
+        }
+        _regs[0xF3] = measuring ? 0x08 : 0x00;
+    }
+
+    void sample(uint64_t nowUs) {
+        double t = nowUs / 1e6;
+        double tempC = 21.0 + _temperatureOffset + 1.5 * sin(t * 2.0 * M_PI / 600.0);
+        double humidity = 45.0 + _humidityOffset + 5.0 * sin(t * 2.0 * M_PI / 900.0);
+        double pressurePa = 101325.0 + 150.0 * sin(t * 2.0 * M_PI / 1800.0);
+
+        uint32_t adcT = solve(0, 1 << 20, [&](uint32_t adc) { return compensateT(adc); }, tempC, true);
+        double tFine = tFineFor(adcT);
+        uint32_t adcP = solve(0, 1 << 20, [&](uint32_t adc) { return compensateP(adc, tFine); }, pressurePa, false);
+        uint32_t adcH = solve(0, 1 << 16, [&](uint32_t adc) { return compensateH(adc, tFine); }, humidity, true);
+
+        _regs[0xF7] = (uint8_t)(adcP >> 12);
+        _regs[0xF8] = (uint8_t)(adcP >> 4);
+        _regs[0xF9] = (uint8_t)((adcP & 0x0F) << 4);
+        _regs[0xFA] = (uint8_t)(adcT >> 12);
+        _regs[0xFB] = (uint8_t)(adcT >> 4);
+        _regs[0xFC] = (uint8_t)((adcT & 0x0F) << 4);
+        _regs[0xFD] = (uint8_t)(adcH >> 8);
+        _regs[0xFE] = (uint8_t)adcH;
+    }
+
+    // Binary search over a monotonic compensation function
+    template <typename F>
+    static uint32_t solve(uint32_t lo, uint32_t hi, F f, double target, bool increasing) {
+        while (hi - lo > 1) {
+            uint32_t mid = lo + (hi - lo) / 2;
+            bool below = increasing ? f(mid) < target : f(mid) > target;
+            if (below) lo = mid; else hi = mid;
+        }
+        return lo;
+    }
+
+    static double tFineFor(uint32_t adcT) {
+        double var1 = (adcT / 16384.0 - T1 / 1024.0) * T2;
+        double var2 = (adcT / 131072.0 - T1 / 8192.0);
+        return var1 + var2 * var2 * T3;
+    }
+
+    static double compensateT(uint32_t adcT) {
+        return tFineFor(adcT) / 5120.0;
+    }
+
+    static double compensateP(uint32_t adcP, double tFine) {
+        double var1 = tFine / 2.0 - 64000.0;
+        double var2 = var1 * var1 * P6 / 32768.0;
+        var2 = var2 + var1 * P5 * 2.0;
+        var2 = var2 / 4.0 + P4 * 65536.0;
+        var1 = (P3 * var1 * var1 / 524288.0 + P2 * var1) / 524288.0;
+        var1 = (1.0 + var1 / 32768.0) * P1;
+        if (var1 == 0.0) return 0.0;
+        double p = 1048576.0 - adcP;
+        p = (p - var2 / 4096.0) * 6250.0 / var1;
+        var1 = P9 * p * p / 2147483648.0;
+        var2 = p * P8 / 32768.0;
+        return p + (var1 + var2 + P7) / 16.0;
+    }
+
+    static double compensateH(uint32_t adcH, double tFine) {
+        double var1 = tFine - 76800.0;
+        double var2 = H4 * 64.0 + (H5 / 16384.0) * var1;
+        double var3 = adcH - var2;
+        double var4 = H2 / 65536.0;
+        double var5 = 1.0 + (H3 / 67108864.0) * var1;
+        double var6 = 1.0 + (H6 / 67108864.0) * var1 * var5;
+        var6 = var3 * var4 * (var5 * var6);
+        return var6 * (1.0 - H1 * var6 / 524288.0);
+    }
+
+    const double _temperatureOffset;
+    const double _humidityOffset;
+    std::mutex _lock;
+    uint8_t _regs[256];
+    uint8_t _pointer = 0;
+    bool _forcedPending = false;
+    uint64_t _conversionEndUs = 0;
+};
+
+// Attach the sensors before setup() runs: the primary one unless
+// NTPCLOCK_NO_BME280 is set, the secondary one if NTPCLOCK_BME280_SECONDARY is
+struct SimulatedBME280Registration {
+    SimulatedBME280Registration() : secondary(-4.0, 10.0) {
+        if (!getenv("NTPCLOCK_NO_BME280")) {
+            NativeHAL::attachI2CDevice(0x76, &sensor);
+        }
+        if (getenv("NTPCLOCK_BME280_SECONDARY")) {
+            NativeHAL::attachI2CDevice(0x77, &secondary);
+        }
+    }
+    SimulatedBME280 sensor;
+    SimulatedBME280 secondary;
+} simulatedBME280;
+
+} // namespace
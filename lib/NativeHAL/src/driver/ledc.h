@@ -0,0 +1,40 @@
+// driver/ledc.h - LEDC fade API (native build)
+//
+// Only the fade entry points the firmware uses are provided. Channels are the
+// Arduino ledcSetup() channels; the duty ends up in the simulated pin table.
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef enum {
+    LEDC_HIGH_SPEED_MODE = 0,
+    LEDC_LOW_SPEED_MODE,
+    LEDC_SPEED_MODE_MAX,
+} ledc_mode_t;
+
+typedef enum {
+    LEDC_CHANNEL_0 = 0,
+    LEDC_CHANNEL_1,
+    LEDC_CHANNEL_2,
+    LEDC_CHANNEL_3,
+    LEDC_CHANNEL_4,
+    LEDC_CHANNEL_5,
+    LEDC_CHANNEL_6,
+    LEDC_CHANNEL_7,
+    LEDC_CHANNEL_MAX,
+} ledc_channel_t;
+
+typedef enum {
+    LEDC_FADE_NO_WAIT = 0,
+    LEDC_FADE_WAIT_DONE,
+    LEDC_FADE_MAX,
+} ledc_fade_mode_t;
+
+esp_err_t ledc_fade_func_install(int intrAllocFlags);
+void ledc_fade_func_uninstall();
+esp_err_t ledc_set_duty_and_update(ledc_mode_t mode, ledc_channel_t channel,
+                                   uint32_t duty, uint32_t hpoint);
+esp_err_t ledc_set_fade_time_and_start(ledc_mode_t mode, ledc_channel_t channel,
+                                       uint32_t targetDuty, uint32_t maxFadeTimeMs,
+                                       ledc_fade_mode_t fadeMode);
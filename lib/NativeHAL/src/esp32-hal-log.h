@@ -0,0 +1,10 @@
+// esp32-hal-log.h - ESP log macros routed to stderr (native build)
+#pragma once
+
+#include <stdio.h>
+
+#define log_e(format, ...) fprintf(stderr, "[E] " format "\n", ##__VA_ARGS__)
+#define log_w(format, ...) fprintf(stderr, "[W] " format "\n", ##__VA_ARGS__)
+#define log_i(format, ...) fprintf(stderr, "[I] " format "\n", ##__VA_ARGS__)
+#define log_d(format, ...) ((void)0)
+#define log_v(format, ...) ((void)0)
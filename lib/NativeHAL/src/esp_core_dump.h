@@ -0,0 +1,11 @@
+// esp_core_dump.h - Core dump API (native build; no dumps on the host)
+#pragma once
+
+#include <stddef.h>
+#include "esp_err.h"
+
+inline esp_err_t esp_core_dump_image_get(size_t* outAddr, size_t* outSize) {
+    if (outAddr) *outAddr = 0;
+    if (outSize) *outSize = 0;
+    return ESP_ERR_NOT_FOUND;
+}
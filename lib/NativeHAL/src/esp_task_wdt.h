@@ -0,0 +1,13 @@
+// esp_task_wdt.h - Task watchdog (native build)
+//
+// The watchdog is tracked but never fires: a stalled task on the host is
+// reported once on stderr instead of rebooting the process.
+#pragma once
+
+#include "esp_err.h"
+#include "freertos/task.h"
+
+esp_err_t esp_task_wdt_init(uint32_t timeoutSeconds, bool panic);
+esp_err_t esp_task_wdt_add(TaskHandle_t task);
+esp_err_t esp_task_wdt_delete(TaskHandle_t task);
+esp_err_t esp_task_wdt_reset();
@@ -0,0 +1,41 @@
+// freertos/FreeRTOS.h - FreeRTOS kernel types on std::thread (native build)
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int32_t BaseType_t;
+typedef uint32_t UBaseType_t;
+typedef uint32_t StackType_t;
+
+#define configTICK_RATE_HZ      1000
+#define portTICK_PERIOD_MS      ((TickType_t)1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY           ((TickType_t)0xFFFFFFFFUL)
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(((TickType_t)(ms) * configTICK_RATE_HZ) / 1000))
+#define pdTICKS_TO_MS(ticks)    ((uint32_t)(ticks) * 1000 / configTICK_RATE_HZ)
+#define configMAX_PRIORITIES    25
+#define tskNO_AFFINITY          0x7FFFFFFF
+
+#define pdFALSE                 ((BaseType_t)0)
+#define pdTRUE                  ((BaseType_t)1)
+#define pdPASS                  pdTRUE
+#define pdFAIL                  pdFALSE
+#define errQUEUE_EMPTY          ((BaseType_t)0)
+#define errQUEUE_FULL           ((BaseType_t)0)
+
+// Critical sections map onto one process-wide recursive lock
+typedef struct { int unused; } portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED {0}
+void vPortEnterCritical(portMUX_TYPE* mux);
+void vPortExitCritical(portMUX_TYPE* mux);
+#define portENTER_CRITICAL(mux)        vPortEnterCritical(mux)
+#define portEXIT_CRITICAL(mux)         vPortExitCritical(mux)
+#define portENTER_CRITICAL_ISR(mux)    vPortEnterCritical(mux)
+#define portEXIT_CRITICAL_ISR(mux)     vPortExitCritical(mux)
+#define portYIELD_FROM_ISR(...)        ((void)0)
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_DATA_ATTR
+#define RTC_NOINIT_ATTR
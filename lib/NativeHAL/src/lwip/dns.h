@@ -0,0 +1,32 @@
+// lwip/dns.h - Asynchronous DNS lookup (native build)
+//
+// Names are resolved synchronously with getaddrinfo, so the found callback
+// is never invoked; ERR_OK means addr has been filled in.
+#pragma once
+
+#include <stdint.h>
+
+typedef int8_t err_t;
+
+#define ERR_OK          0
+#define ERR_INPROGRESS  -5
+#define ERR_VAL         -6
+#define ERR_ARG         -16
+
+#define IPADDR_TYPE_V4  0U
+
+typedef struct {
+    uint32_t addr;      // Network byte order
+} ip4_addr_t;
+
+typedef struct {
+    union {
+        ip4_addr_t ip4;
+    } u_addr;
+    uint8_t type;
+} ip_addr_t;
+
+typedef void (*dns_found_callback)(const char* name, const ip_addr_t* ipaddr, void* callback_arg);
+
+err_t dns_gethostbyname(const char* hostname, ip_addr_t* addr, dns_found_callback found,
+                        void* callback_arg);
@@ -0,0 +1,16 @@
+// lwip/priv/tcpip_priv.h - Calls into the lwIP thread (native build)
+//
+// There is no lwIP thread here, so the function runs on the caller's.
+#pragma once
+
+#include "lwip/dns.h"
+
+struct tcpip_api_call_data {
+    err_t err;
+};
+
+typedef err_t (*tcpip_api_call_fn)(struct tcpip_api_call_data* call);
+
+inline err_t tcpip_api_call(tcpip_api_call_fn fn, struct tcpip_api_call_data* call) {
+    return fn(call);
+}
@@ -0,0 +1,12 @@
+// lwip/sockets.h - BSD socket API (native build)
+//
+// The host's own sockets, which lwIP's API mirrors.
+#pragma once
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
@@ -0,0 +1,113 @@
+#include "AdaptiveSampler.h"
+
+const float AdaptiveSampler::DEADBAND[3] = {
+    SENSOR_DEADBAND_TEMP, SENSOR_DEADBAND_HUM, SENSOR_DEADBAND_PRES
+};
+
+const float AdaptiveSampler::RATE_PER_MINUTE[3] = {
+    SENSOR_RATE_TEMP, SENSOR_RATE_HUM, SENSOR_RATE_PRES
+};
+
+AdaptiveSampler::AdaptiveSampler()
+    : samples(0),
+      publishes(0),
+      publishesSkipped(0)
+{
+    memset(tracks, 0, sizeof(tracks));
+    for (Track& track : tracks) {
+        track.interval = BME280_SAMPLE_INTERVAL;
+    }
+}
+
+uint32_t AdaptiveSampler::getInterval(uint8_t sensor) const {
+    return sensor < SENSOR_MAX_COUNT ? tracks[sensor].interval : BME280_SAMPLE_INTERVAL;
+}
+
+uint32_t AdaptiveSampler::onSample(uint8_t sensor, float temperature, float humidity, float pressure) {
+    if (sensor >= SENSOR_MAX_COUNT) {
+        return BME280_SAMPLE_INTERVAL;
+    }
+    Track& track = tracks[sensor];
+    const float values[3] = {temperature, humidity, pressure};
+    uint32_t now = millis();
+
+    if (!track.haveSample) {
+        track.startTime = now;
+    } else {
+        uint32_t elapsed = now - track.lastSampleTime;
+        bool rapid = false;
+        for (uint8_t c = 0; c < 3 && elapsed > 0; c++) {
+            float change = fabsf(values[c] - track.lastSample[c]);
+            // Both conditions: the dead-band keeps sensor noise on short
+            // intervals out, the rate keeps slow drift on long ones out
+            if (change >= DEADBAND[c] && change * 60000.0f / elapsed >= RATE_PER_MINUTE[c]) {
+                rapid = true;
+            }
+        }
+
+        uint32_t previous = track.interval;
+        if (rapid) {
+            track.interval = BME280_SAMPLE_INTERVAL;
+        } else if (track.interval < BME280_SLOW_INTERVAL) {
+            track.interval = track.interval * 2 < BME280_SLOW_INTERVAL ? track.interval * 2
+                                                                       : BME280_SLOW_INTERVAL;
+        }
+        if (track.interval != previous) {
+            Serial.printf("[SENSOR] Sensor %u: %s, sampling every %lu ms\n", sensor,
+                          rapid ? "rapid change" : "readings stable",
+                          (unsigned long)track.interval);
+        }
+    }
+
+    memcpy(track.lastSample, values, sizeof(track.lastSample));
+    track.lastSampleTime = now;
+    track.haveSample = true;
+    track.samples++;
+    samples++;
+    return track.interval;
+}
+
+bool AdaptiveSampler::shouldPublish(uint8_t sensor, float temperature, float humidity, float pressure) {
+    if (sensor >= SENSOR_MAX_COUNT) {
+        return false;
+    }
+    const Track& track = tracks[sensor];
+    if (!track.havePublished || millis() - track.lastPublishTime >= SENSOR_HEARTBEAT_INTERVAL) {
+        return true;
+    }
+
+    const float values[3] = {temperature, humidity, pressure};
+    for (uint8_t c = 0; c < 3; c++) {
+        if (fabsf(values[c] - track.lastPublished[c]) >= DEADBAND[c]) {
+            return true;
+        }
+    }
+    publishesSkipped++;
+    return false;
+}
+
+void AdaptiveSampler::onPublished(uint8_t sensor, float temperature, float humidity, float pressure) {
+    if (sensor >= SENSOR_MAX_COUNT) {
+        return;
+    }
+    Track& track = tracks[sensor];
+    track.lastPublished[0] = temperature;
+    track.lastPublished[1] = humidity;
+    track.lastPublished[2] = pressure;
+    track.lastPublishTime = millis();
+    track.havePublished = true;
+    publishes++;
+}
+
+uint32_t AdaptiveSampler::getSamplesSaved() const {
+    uint32_t saved = 0;
+    for (const Track& track : tracks) {
+        if (!track.haveSample) {
+            continue;
+        }
+        // Samples a fixed schedule would have taken since the first one
+        uint32_t fixed = (track.lastSampleTime - track.startTime) / BME280_SAMPLE_INTERVAL + 1;
+        saved += fixed > track.samples ? fixed - track.samples : 0;
+    }
+    return saved;
+}
@@ -7,37 +7,40 @@
 
 #include "BME280Handler.h"
 #include "BME280Registers.h"
+#include "I2CBus.h"
 
-// Store t_fine value globally since it's needed for pressure and humidity compensation
-static int32_t t_fine;
-
-BME280Handler::BME280Handler()
-    : deviceAddress(0x76)
+BME280Handler::BME280Handler(uint8_t address)
+    : deviceAddress(address)
     , temperature(BME280_INVALID_TEMP)
     , humidity(BME280_INVALID_HUM)
     , pressure(BME280_INVALID_PRES)
     , sensorValid(false)
     , lastReadTime(0)
+    , ctrlMeas(0)
+    , measurementTimeUs(0)
+    , sampleTimer(nullptr)
+    , readyTimer(nullptr)
+    , samplingTask(nullptr)
+    , eventShift(0)
+    , sampleIntervalMs(0)
+    , readyRetries(0)
 {
     memset(&calibData, 0, sizeof(calibData));
 }
 
 bool BME280Handler::init() {
-    Serial.println("Starting BME280 initialization...");
-    
-    // Debug I2C detection
-    Wire.beginTransmission(deviceAddress);
-    uint8_t error = Wire.endTransmission();
+    Serial.printf("Starting BME280 initialization at 0x%02X...\n", deviceAddress);
     
-    if (error != 0) {
-        Serial.printf("I2C device not found at address 0x%02X (error: %d)\n", deviceAddress, error);
+    I2CBus& bus = I2CBus::getInstance();
+    if (!bus.probe(deviceAddress)) {
+        Serial.printf("I2C device not found at address 0x%02X\n", deviceAddress);
         return false;
     }
     
     // Read chip ID with delay
     uint8_t chipId;
     delay(10); // Add small delay before reading
-    if (i2cRead(BME280_CHIP_ID_ADDR, &chipId, 1, &deviceAddress) != BME280_OK) {
+    if (!bus.read(deviceAddress, BME280_CHIP_ID_ADDR, &chipId, 1)) {
         Serial.println("Failed to read chip ID");
         return false;
     }
@@ -49,7 +52,7 @@ bool BME280Handler::init() {
     
     // Reset the sensor
     uint8_t reset_cmd = BME280_RESET_CMD;
-    if (i2cWrite(BME280_RESET_ADDR, &reset_cmd, 1, &deviceAddress) != BME280_OK) {
+    if (!bus.write(deviceAddress, BME280_RESET_ADDR, &reset_cmd, 1)) {
         Serial.println("Failed to reset BME280");
         return false;
     }
@@ -61,116 +64,114 @@ bool BME280Handler::init() {
         return false;
     }
 
-    // Configure the sensor
-    // Humidity oversampling x1
-    uint8_t ctrl_hum = 0x01;
-    if (i2cWrite(BME280_CTRL_HUM_ADDR, &ctrl_hum, 1, &deviceAddress) != BME280_OK) {
-        Serial.println("Failed to write ctrl_hum");
-        return false;
-    }
-
-    // Temperature oversampling x2, Pressure oversampling x2, Normal mode
-    uint8_t ctrl_meas = 0x6B;  // 0b01101011
-    if (i2cWrite(BME280_CTRL_MEAS_ADDR, &ctrl_meas, 1, &deviceAddress) != BME280_OK) {
-        Serial.println("Failed to write ctrl_meas");
+    // Configure the sensor while it is still in sleep mode after the reset;
+    // conversions are then started one at a time in forced mode.
+    // Temperature and pressure x2, humidity x1, IIR filter x16.
+    if (!setAcquisition(2, 2, 1, 16)) {
         return false;
     }
 
-    // Config register: Standby 62.5ms, Filter x4
-    uint8_t config = 0x30;  // 0b00110000
-    if (i2cWrite(BME280_CONFIG_ADDR, &config, 1, &deviceAddress) != BME280_OK) {
-        Serial.println("Failed to write config");
-        return false;
-    }
-    
-    Serial.println("BME280 initialization successful");
+    Serial.printf("BME280 initialization successful (conversion time %u us)\n", measurementTimeUs);
     return true;
 }
 
-bool BME280Handler::readCalibrationData() {
-    uint8_t buffer[32];
-    
-    if (i2cRead(0x88, buffer, 6, &deviceAddress) != BME280_OK) {
-        return false;
+uint32_t BME280Handler::maxMeasurementTimeUs(uint8_t osrsT, uint8_t osrsP, uint8_t osrsH) {
+    // Register setting to number of samples: 0 = skipped, 1..5 = 1x..16x
+    auto samples = [](uint8_t osrs) -> uint32_t {
+        return osrs == 0 ? 0 : 1u << ((osrs > 5 ? 5 : osrs) - 1);
+    };
+
+    // Datasheet section 9.1, maximum measurement time
+    uint32_t time = 1250 + 2300 * samples(osrsT);
+    if (osrsP) {
+        time += 2300 * samples(osrsP) + 575;
     }
-    calibData.dig_t1 = (uint16_t)(buffer[1] << 8 | buffer[0]);
-    calibData.dig_t2 = (int16_t)(buffer[3] << 8 | buffer[2]);
-    calibData.dig_t3 = (int16_t)(buffer[5] << 8 | buffer[4]);
-    
-    if (i2cRead(0x8E, buffer, 18, &deviceAddress) != BME280_OK) {
-        return false;
+    if (osrsH) {
+        time += 2300 * samples(osrsH) + 575;
     }
-    calibData.dig_p1 = (uint16_t)(buffer[1] << 8 | buffer[0]);
-    calibData.dig_p2 = (int16_t)(buffer[3] << 8 | buffer[2]);
-    calibData.dig_p3 = (int16_t)(buffer[5] << 8 | buffer[4]);
-    calibData.dig_p4 = (int16_t)(buffer[7] << 8 | buffer[6]);
-    calibData.dig_p5 = (int16_t)(buffer[9] << 8 | buffer[8]);
-    calibData.dig_p6 = (int16_t)(buffer[11] << 8 | buffer[10]);
-    calibData.dig_p7 = (int16_t)(buffer[13] << 8 | buffer[12]);
-    calibData.dig_p8 = (int16_t)(buffer[15] << 8 | buffer[14]);
-    calibData.dig_p9 = (int16_t)(buffer[17] << 8 | buffer[16]);
-
-    uint8_t h1;
-    if (i2cRead(0xA1, &h1, 1, &deviceAddress) != BME280_OK) {
+    return time;
+}
+
+bool BME280Handler::readCalibrationData() {
+    // Four blocks; the first three are nearly adjacent and the bus layer
+    // reads them as one burst
+    uint8_t t[6], p[18], h1, h[7];
+    const I2CBus::Read blocks[] = {
+        {0x88, sizeof(t), t},
+        {0x8E, sizeof(p), p},
+        {0xA1, 1, &h1},
+        {0xE1, sizeof(h), h}
+    };
+    if (!I2CBus::getInstance().readBatch(deviceAddress, blocks, sizeof(blocks) / sizeof(blocks[0]))) {
         return false;
     }
+
+    calibData.dig_t1 = (uint16_t)(t[1] << 8 | t[0]);
+    calibData.dig_t2 = (int16_t)(t[3] << 8 | t[2]);
+    calibData.dig_t3 = (int16_t)(t[5] << 8 | t[4]);
+    
+    calibData.dig_p1 = (uint16_t)(p[1] << 8 | p[0]);
+    calibData.dig_p2 = (int16_t)(p[3] << 8 | p[2]);
+    calibData.dig_p3 = (int16_t)(p[5] << 8 | p[4]);
+    calibData.dig_p4 = (int16_t)(p[7] << 8 | p[6]);
+    calibData.dig_p5 = (int16_t)(p[9] << 8 | p[8]);
+    calibData.dig_p6 = (int16_t)(p[11] << 8 | p[10]);
+    calibData.dig_p7 = (int16_t)(p[13] << 8 | p[12]);
+    calibData.dig_p8 = (int16_t)(p[15] << 8 | p[14]);
+    calibData.dig_p9 = (int16_t)(p[17] << 8 | p[16]);
+
     calibData.dig_h1 = h1;
-    
-    if (i2cRead(0xE1, buffer, 7, &deviceAddress) != BME280_OK) {
-        return false;
-    }
-    
-    calibData.dig_h2 = (int16_t)(buffer[1] << 8 | buffer[0]);
-    calibData.dig_h3 = buffer[2];
-    calibData.dig_h4 = (int16_t)((buffer[3] << 4) | (buffer[4] & 0x0F));
-    calibData.dig_h5 = (int16_t)((buffer[5] << 4) | (buffer[4] >> 4));
-    calibData.dig_h6 = (int8_t)buffer[6];
+    calibData.dig_h2 = (int16_t)(h[1] << 8 | h[0]);
+    calibData.dig_h3 = h[2];
+    calibData.dig_h4 = (int16_t)((h[3] << 4) | (h[4] & 0x0F));
+    calibData.dig_h5 = (int16_t)((h[5] << 4) | (h[4] >> 4));
+    calibData.dig_h6 = (int8_t)h[6];
     
     return true;
 }
 
-bool BME280Handler::takeMeasurement() {
-    esp_task_wdt_reset();
-    
-    // Read current control settings
-    uint8_t ctrl_meas;
-    if (i2cRead(BME280_CTRL_MEAS_ADDR, &ctrl_meas, 1, &deviceAddress) != BME280_OK) {
-        Serial.println("Failed to read ctrl_meas");
-        return false;
-    }
-    
-    // Force measurement
-    ctrl_meas = (ctrl_meas & 0xFC) | 0x01;
-    if (i2cWrite(BME280_CTRL_MEAS_ADDR, &ctrl_meas, 1, &deviceAddress) != BME280_OK) {
+bool BME280Handler::startConversion() {
+    // ctrl_meas is cached, so a conversion costs one register write
+    uint8_t forced = ctrlMeas | BME280_FORCED_MODE;
+    if (!I2CBus::getInstance().write(deviceAddress, BME280_CTRL_MEAS_ADDR, &forced, 1)) {
         Serial.println("Failed to write ctrl_meas");
         return false;
     }
-    
-    // Wait for measurement
-    delay(10);
-    
-    // Read raw values
-    uint8_t buffer[8];
-    if (i2cRead(BME280_PRESS_MSB_ADDR, buffer, 8, &deviceAddress) != BME280_OK) {
+    readyRetries = 0;
+    return true;
+}
+
+int8_t BME280Handler::readConversion() {
+    // One burst from status (0xF3) through hum_lsb (0xFE): the status byte
+    // and all eight data bytes in a single transaction
+    uint8_t buffer[12];
+    if (!I2CBus::getInstance().read(deviceAddress, BME280_STATUS_ADDR, buffer, sizeof(buffer))) {
         Serial.println("Failed to read measurements");
-        return false;
+        return -1;
+    }
+    if (buffer[0] & 0x08) {
+        return 0;  // measuring bit still set
+    }
+
+    processRawMeasurements(buffer + (BME280_PRESS_MSB_ADDR - BME280_STATUS_ADDR));
+
+    // Temperature first, it produces t_fine for the other two. The context
+    // is local, so nothing is shared between conversions or instances.
+    BME280Compensation::Context context;
+    auto t = BME280Compensator::temperature(calibData, rawTemperature, context);
+    auto p = BME280Compensator::pressure(calibData, rawPressure, context);
+    auto h = BME280Compensator::humidity(calibData, rawHumidity, context);
+
+    temperature = BME280Compensator::celsius(t);
+    humidity = BME280Compensator::percent(h);
+    pressure = BME280Compensator::hectopascal(p);
+    if (pressure < BME280_PRES_MIN || pressure > BME280_PRES_MAX) {
+        Serial.printf("Invalid pressure calculated: %.1f hPa\n", pressure);
+        pressure = BME280_INVALID_PRES;
     }
-    
-    // Parse raw values
-    int32_t rawPressure = ((uint32_t)buffer[0] << 12) | ((uint32_t)buffer[1] << 4) | ((uint32_t)buffer[2] >> 4);
-    Serial.print("Raw pressure: 0x");
-    Serial.println(rawPressure, HEX);
-    
-    int32_t rawTemp = ((uint32_t)buffer[3] << 12) | ((uint32_t)buffer[4] << 4) | ((uint32_t)buffer[5] >> 4);
-    int32_t rawHumidity = ((uint32_t)buffer[6] << 8) | (uint32_t)buffer[7];
-    
-    // Calculate temperature first
-    temperature = compensateTemperature(rawTemp);
-    pressure = compensatePressure(rawPressure);
-    humidity = compensateHumidity(rawHumidity);
 
     // Print measurements in smaller chunks to use less stack space
-    Serial.print("Measurements: T=");
+    Serial.printf("Measurements (0x%02X): T=", deviceAddress);
     Serial.print(temperature);
     Serial.print("°C, H=");
     Serial.print(humidity);
@@ -180,9 +181,115 @@ bool BME280Handler::takeMeasurement() {
     
     sensorValid = true;
     lastReadTime = millis();
+    return 1;
+}
+
+bool BME280Handler::takeMeasurement() {
+    esp_task_wdt_reset();
+    
+    if (!startConversion()) {
+        return false;
+    }
+    
+    // Sleep for the worst-case conversion time instead of a fixed guess
+    vTaskDelay(pdMS_TO_TICKS((measurementTimeUs + 999) / 1000) + 1);
+    
+    for (uint8_t attempt = 0; attempt <= BME280_READY_MAX_RETRIES; attempt++) {
+        int8_t result = readConversion();
+        if (result != 0) {
+            return result > 0;
+        }
+        vTaskDelay(1);
+    }
+    Serial.println("BME280 conversion did not complete");
+    return false;
+}
+
+bool BME280Handler::startSampling(TaskHandle_t task, uint32_t intervalMs, uint8_t shift) {
+    samplingTask = task;
+    eventShift = shift;
+
+    if (!sampleTimer) {
+        esp_timer_create_args_t args = {};
+        args.callback = timerCallback;
+        args.arg = this;
+        args.name = "bme280_sample";
+        if (esp_timer_create(&args, &sampleTimer) != ESP_OK) {
+            Serial.println("Failed to create BME280 sample timer");
+            return false;
+        }
+        args.callback = readyTimerCallback;
+        args.name = "bme280_ready";
+        if (esp_timer_create(&args, &readyTimer) != ESP_OK) {
+            Serial.println("Failed to create BME280 ready timer");
+            return false;
+        }
+    }
+
+    esp_timer_stop(sampleTimer);
+    esp_timer_start_periodic(sampleTimer, (uint64_t)intervalMs * 1000ULL);
+    sampleIntervalMs = intervalMs;
+
+    // First sample right away
+    xTaskNotify(samplingTask, EVENT_START << eventShift, eSetBits);
     return true;
 }
 
+void BME280Handler::stopSampling() {
+    if (sampleTimer) {
+        esp_timer_stop(sampleTimer);
+        esp_timer_stop(readyTimer);
+    }
+}
+
+void BME280Handler::setSampleInterval(uint32_t intervalMs) {
+    if (!sampleTimer || intervalMs == sampleIntervalMs) {
+        return;
+    }
+    // Restarting the periodic timer puts the next conversion one full
+    // interval from now
+    esp_timer_stop(sampleTimer);
+    esp_timer_start_periodic(sampleTimer, (uint64_t)intervalMs * 1000ULL);
+    sampleIntervalMs = intervalMs;
+}
+
+void BME280Handler::timerCallback(void* arg) {
+    BME280Handler* self = static_cast<BME280Handler*>(arg);
+    xTaskNotify(self->samplingTask, EVENT_START << self->eventShift, eSetBits);
+}
+
+void BME280Handler::readyTimerCallback(void* arg) {
+    BME280Handler* self = static_cast<BME280Handler*>(arg);
+    xTaskNotify(self->samplingTask, EVENT_READY << self->eventShift, eSetBits);
+}
+
+bool BME280Handler::handleEvents(uint32_t events) {
+    bool sampled = false;
+    events >>= eventShift;
+
+    if (events & EVENT_READY) {
+        int8_t result = readConversion();
+        if (result > 0) {
+            sampled = true;
+        } else if (result == 0 && readyRetries++ < BME280_READY_MAX_RETRIES) {
+            // Conversion ran over the datasheet maximum; look again shortly
+            esp_timer_start_once(readyTimer, BME280_READY_RETRY_US);
+        } else if (result == 0) {
+            Serial.println("BME280 conversion did not complete");
+        }
+    }
+
+    if (events & EVENT_START) {
+        // Bus and task stay idle until the conversion is due
+        esp_timer_stop(readyTimer);
+        if (startConversion()) {
+            esp_timer_start_once(readyTimer, measurementTimeUs);
+        }
+    }
+
+    return sampled;
+}
+
 void BME280Handler::processRawMeasurements(uint8_t* buffer) {
     // Parse the raw measurement data
     uint32_t pressure_msb = (uint32_t)buffer[0] << 12;
@@ -200,75 +307,6 @@ void BME280Handler::processRawMeasurements(uint8_t* buffer) {
     rawHumidity = hum_msb | hum_lsb;
 }
 
-float BME280Handler::compensateTemperature(int32_t adc_T) {
-    int32_t var1 = ((((adc_T >> 3) - ((int32_t)calibData.dig_t1 << 1))) *
-                    ((int32_t)calibData.dig_t2)) >> 11;
-                    
-    int32_t var2 = (((((adc_T >> 4) - ((int32_t)calibData.dig_t1)) *
-                      ((adc_T >> 4) - ((int32_t)calibData.dig_t1))) >> 12) *
-                    ((int32_t)calibData.dig_t3)) >> 14;
-                    
-    t_fine = var1 + var2;
-    float T = (t_fine * 5 + 128) >> 8;
-    return T / 100.0f;
-}
-
-float BME280Handler::compensatePressure(int32_t adc_P) {
-    int64_t var1, var2, p;
-    
-    // Calculate var1
-    var1 = ((int64_t)t_fine) - 128000;
-    var2 = var1 * var1 * (int64_t)calibData.dig_p6;
-    var2 = var2 + ((var1 * (int64_t)calibData.dig_p5) << 17);
-    var2 = var2 + (((int64_t)calibData.dig_p4) << 35);
-    var1 = ((var1 * var1 * (int64_t)calibData.dig_p3) >> 8) + ((var1 * (int64_t)calibData.dig_p2) << 12);
-    var1 = (((((int64_t)1) << 47) + var1)) * ((int64_t)calibData.dig_p1) >> 33;
-    
-    if (var1 == 0) {
-        return BME280_INVALID_PRES;  // Avoid division by zero
-    }
-    
-    // Calculate pressure
-    p = 1048576 - adc_P;
-    p = (((p << 31) - var2) * 3125) / var1;
-    var1 = (((int64_t)calibData.dig_p9) * (p >> 13) * (p >> 13)) >> 25;
-    var2 = (((int64_t)calibData.dig_p8) * p) >> 19;
-    p = ((p + var1 + var2) >> 8) + (((int64_t)calibData.dig_p7) << 4);
-    
-    // Convert to hPa (p is in Pa units)
-    float pressure = ((float)p / 256.0f) / 100.0f;
-    
-    // Validate pressure range
-    if (pressure < BME280_PRES_MIN || pressure > BME280_PRES_MAX) {
-        Serial.printf("Invalid pressure calculated: %.1f hPa\n", pressure);
-        return BME280_INVALID_PRES;
-    }
-    
-    return pressure;
-}
-
-float BME280Handler::compensateHumidity(int32_t adc_H) {
-    int32_t v_x1_u32r;
-    
-    v_x1_u32r = (t_fine - ((int32_t)76800));
-    v_x1_u32r = (((((adc_H << 14) - (((int32_t)calibData.dig_h4) << 20) -
-                    (((int32_t)calibData.dig_h5) * v_x1_u32r)) +
-                   ((int32_t)16384)) >> 15) *
-                 (((((((v_x1_u32r * ((int32_t)calibData.dig_h6)) >> 10) *
-                      (((v_x1_u32r * ((int32_t)calibData.dig_h3)) >> 11) +
-                       ((int32_t)32768))) >> 10) +
-                    ((int32_t)2097152)) * ((int32_t)calibData.dig_h2) +
-                   8192) >> 14));
-                   
-    v_x1_u32r = (v_x1_u32r - (((((v_x1_u32r >> 15) * (v_x1_u32r >> 15)) >> 7) *
-                               ((int32_t)calibData.dig_h1)) >> 4));
-    
-    v_x1_u32r = (v_x1_u32r < 0) ? 0 : v_x1_u32r;
-    v_x1_u32r = (v_x1_u32r > 419430400) ? 419430400 : v_x1_u32r;
-    
-    return (float)(v_x1_u32r >> 12) / 1024.0f;
-}
-
 bool BME280Handler::validateReadings(float temp, float hum, float pres) {
     if (temp < BME280_TEMP_MIN || temp > BME280_TEMP_MAX) {
         Serial.printf("Invalid temperature reading: %.2f°C\n", temp);
@@ -288,74 +326,39 @@ bool BME280Handler::validateReadings(float temp, float hum, float pres) {
     return true;
 }
 
-void BME280Handler::setupSensorSettings() {
-    // Set humidity oversampling to 1x
-    uint8_t ctrl_hum = BME280_OVERSAMPLING_1X;
-    i2cWrite(BME280_CTRL_HUM_ADDR, &ctrl_hum, 1, &deviceAddress);
-    
-    // Set temperature and pressure oversampling to 16x
-    uint8_t ctrl_meas = (BME280_OVERSAMPLING_16X << BME280_CTRL_TEMP_POS) |
-                        (BME280_OVERSAMPLING_16X << BME280_CTRL_PRESS_POS) |
-                        BME280_NORMAL_MODE;
-    i2cWrite(BME280_CTRL_MEAS_ADDR, &ctrl_meas, 1, &deviceAddress);
-    
-    // Set IIR filter coefficient to 16
-    uint8_t config = (BME280_FILTER_COEFF_16 << 2) | BME280_STANDBY_TIME_1000_MS;
-    i2cWrite(BME280_CONFIG_ADDR, &config, 1, &deviceAddress);
-}
+bool BME280Handler::setAcquisition(uint8_t tempOversampling, uint8_t presOversampling,
+                                   uint8_t humOversampling, uint8_t iirCoefficient) {
+    // Factor (1, 2, 4, 8, 16) to register code (1..5); IIR 0 (off) .. 16 to 0..4
+    auto code = [](uint8_t factor) -> uint8_t {
+        uint8_t bits = 0;
+        while (factor > 1 && bits < 4) {
+            factor >>= 1;
+            bits++;
+        }
+        return bits;
+    };
+    uint8_t osrsT = code(tempOversampling) + 1;
+    uint8_t osrsP = code(presOversampling) + 1;
+    uint8_t osrsH = code(humOversampling) + 1;
+    uint8_t filter = iirCoefficient ? code(iirCoefficient) : 0;
 
-int8_t BME280Handler::i2cRead(uint8_t reg_addr, uint8_t *reg_data, uint32_t len, void *intf_ptr) {
-    uint8_t dev_addr = *(uint8_t*)intf_ptr;
-    
-    Wire.beginTransmission(dev_addr);
-    Wire.write(reg_addr);
-    Wire.endTransmission(false);
-    
-    Wire.requestFrom(dev_addr, len);
-    if(Wire.available() != len) {
-        return -1;
-    }
-    
-    for(uint32_t i = 0; i < len; i++) {
-        reg_data[i] = Wire.read();
-    }
-    
-    return 0;
-}
-
-int8_t BME280Handler::i2cWrite(uint8_t reg_addr, const uint8_t *reg_data, uint32_t len, void *intf_ptr) {
-    uint8_t dev_addr = *(uint8_t*)intf_ptr;
-    
-    Wire.beginTransmission(dev_addr);
-    Wire.write(reg_addr);
-    Wire.write(reg_data, len);
-    if(Wire.endTransmission() != 0) {
-        return -1;
-    }
-    
-    return 0;
-}
-
-bool BME280Handler::initI2C() {
-    Wire.begin(I2C_SDA, I2C_SCL);
-    
-    // Try both possible I2C addresses
-    if(tryAddress(BME280_I2C_ADDR_PRIM)) {
-        deviceAddress = BME280_I2C_ADDR_PRIM;
-        return true;
-    }
-    
-    if(tryAddress(BME280_I2C_ADDR_SEC)) {
-        deviceAddress = BME280_I2C_ADDR_SEC;
-        return true;
+    // ctrl_hum only takes effect with the following ctrl_meas write; the
+    // mode bits stay at sleep, conversions set forced mode themselves. The
+    // BME280 takes all three as register/value pairs in one transaction.
+    uint8_t meas = (uint8_t)((osrsT << 5) | (osrsP << 2) | BME280_SLEEP_MODE);
+    const I2CBus::Write writes[] = {
+        {BME280_CTRL_HUM_ADDR, osrsH},
+        {BME280_CONFIG_ADDR, (uint8_t)(filter << 2)},
+        {BME280_CTRL_MEAS_ADDR, meas}
+    };
+    if (!I2CBus::getInstance().writePairs(deviceAddress, writes, sizeof(writes) / sizeof(writes[0]))) {
+        Serial.println("Failed to write BME280 settings");
+        return false;
     }
-    
-    return false;
-}
 
-bool BME280Handler::tryAddress(uint8_t address) {
-    Wire.beginTransmission(address);
-    return Wire.endTransmission() == 0;
+    ctrlMeas = meas;
+    measurementTimeUs = maxMeasurementTimeUs(osrsT, osrsP, osrsH);
+    return true;
 }
 
 // Implement watchdog task
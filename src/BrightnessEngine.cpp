@@ -0,0 +1,85 @@
+#include "BrightnessEngine.h"
+#include "config.h"
+#include <driver/ledc.h>
+
+// OE duty per brightness percent at 10-bit resolution. The visible on-time
+// follows (percent/100)^2.2 between 4% and 75%, the same end points the old
+// linear analogWrite() mapping used. OE is active low, so 1023 is blank.
+const uint16_t BrightnessEngine::GAMMA_TABLE[101] = {
+    1023,  983,  983,  983,  982,  982,  982,  981,  980,  979,  // 0-9%
+     978,  977,  976,  975,  973,  972,  970,  968,  966,  964,  // 10-19%
+     962,  960,  957,  954,  952,  949,  945,  942,  939,  935,  // 20-29%
+     932,  928,  924,  920,  915,  911,  906,  901,  896,  891,  // 30-39%
+     886,  881,  875,  869,  864,  858,  851,  845,  838,  832,  // 40-49%
+     825,  818,  811,  803,  796,  788,  780,  772,  764,  755,  // 50-59%
+     747,  738,  729,  720,  711,  701,  692,  682,  672,  662,  // 60-69%
+     651,  641,  630,  619,  608,  597,  586,  574,  562,  550,  // 70-79%
+     538,  526,  513,  500,  488,  475,  461,  448,  434,  420,  // 80-89%
+     406,  392,  378,  363,  349,  334,  318,  303,  288,  272,  // 90-99%
+     256                                                         // 100%
+};
+
+// Arduino LEDC channels 0-7 map onto the high speed group
+static const ledc_mode_t LEDC_MODE = LEDC_HIGH_SPEED_MODE;
+static const ledc_channel_t LEDC_CHANNEL = static_cast<ledc_channel_t>(BRIGHTNESS_LEDC_CHANNEL);
+
+BrightnessEngine::BrightnessEngine()
+    : initialized(false),
+      fadeAvailable(false),
+      level(0)
+{
+}
+
+bool BrightnessEngine::begin() {
+    if (initialized) {
+        return true;
+    }
+
+    ledcSetup(BRIGHTNESS_LEDC_CHANNEL, BRIGHTNESS_PWM_FREQ, BRIGHTNESS_PWM_RESOLUTION);
+    ledcAttachPin(OE_PIN, BRIGHTNESS_LEDC_CHANNEL);
+    ledcWrite(BRIGHTNESS_LEDC_CHANNEL, GAMMA_TABLE[0]);
+
+    esp_err_t err = ledc_fade_func_install(0);
+    fadeAvailable = (err == ESP_OK || err == ESP_ERR_INVALID_STATE);
+    if (!fadeAvailable) {
+        Serial.printf("[BRIGHTNESS] Hardware fade unavailable (%d), using direct writes\n", err);
+    }
+
+    initialized = true;
+    Serial.printf("[BRIGHTNESS] OE PWM on LEDC channel %d at %d Hz\n",
+                  BRIGHTNESS_LEDC_CHANNEL, BRIGHTNESS_PWM_FREQ);
+    return true;
+}
+
+uint16_t BrightnessEngine::dutyForPercent(uint8_t percent) {
+    return GAMMA_TABLE[percent > 100 ? 100 : percent];
+}
+
+void BrightnessEngine::setLevel(uint8_t percent) {
+    fadeTo(percent, 0);
+}
+
+void BrightnessEngine::fadeTo(uint8_t percent, uint32_t durationMs) {
+    if (!initialized) {
+        return;
+    }
+
+    uint8_t target = constrain(percent, 1, 100);
+    if (target == level.load()) {
+        return;
+    }
+    uint16_t duty = dutyForPercent(target);
+
+    if (!fadeAvailable) {
+        ledcWrite(BRIGHTNESS_LEDC_CHANNEL, duty);
+    } else if (durationMs == 0) {
+        // Fade-aware write; waits for a fade already running on the channel
+        ledc_set_duty_and_update(LEDC_MODE, LEDC_CHANNEL, duty, 0);
+    } else {
+        // Hand the ramp to the LEDC fade unit and return immediately
+        ledc_set_fade_time_and_start(LEDC_MODE, LEDC_CHANNEL, duty, durationMs,
+                                     LEDC_FADE_NO_WAIT);
+    }
+
+    level.store(target);
+}
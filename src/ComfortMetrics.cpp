@@ -0,0 +1,179 @@
+#include "ComfortMetrics.h"
+
+namespace {
+
+// Saturation vapour pressure over water in hPa, Magnus form
+// 6.112 * exp(17.62 * t / (243.12 + t)), at 1 degC steps from TABLE_MIN
+const int TABLE_MIN = -40;
+const float SATURATION_TABLE[] = {
+    0.1902f, 0.2109f, 0.2336f, 0.2586f, 0.2858f, 0.3157f, 0.3484f, 0.3840f,  // -40
+    0.4230f, 0.4654f, 0.5117f, 0.5620f, 0.6168f, 0.6764f, 0.7410f, 0.8112f,  // -32
+    0.8872f, 0.9696f, 1.0588f, 1.1553f, 1.2597f, 1.3723f, 1.4939f, 1.6251f,  // -24
+    1.7665f, 1.9187f, 2.0826f, 2.2589f, 2.4483f, 2.6518f, 2.8703f, 3.1047f,  // -16
+    3.3559f, 3.6251f, 3.9134f, 4.2218f, 4.5517f, 4.9043f, 5.2809f, 5.6830f,  // -8
+    6.1120f, 6.5695f, 7.0570f, 7.5763f, 8.1292f, 8.7174f, 9.3430f, 10.008f,  // 0
+    10.714f, 11.464f, 12.260f, 13.105f, 14.000f, 14.948f, 15.953f, 17.017f,  // 8
+    18.142f, 19.333f, 20.591f, 21.921f, 23.326f, 24.809f, 26.374f, 28.025f,  // 16
+    29.766f, 31.601f, 33.533f, 35.569f, 37.711f, 39.966f, 42.337f, 44.830f,  // 24
+    47.450f, 50.203f, 53.094f, 56.128f, 59.313f, 62.653f, 66.156f, 69.827f,  // 32
+    73.675f, 77.704f, 81.924f, 86.341f, 90.963f, 95.797f, 100.85f, 106.14f,  // 40
+    111.66f, 117.43f, 123.45f, 129.74f, 136.30f, 143.15f, 150.29f, 157.74f,  // 48
+    165.50f, 173.59f, 182.02f, 190.80f, 199.93f, 209.44f, 219.34f, 229.63f,  // 56
+    240.34f, 251.47f, 263.04f, 275.06f, 287.54f, 300.51f, 313.98f, 327.95f,  // 64
+    342.46f, 357.51f, 373.11f, 389.30f, 406.08f, 423.47f, 441.49f, 460.16f,  // 72
+    479.49f, 499.51f, 520.23f, 541.68f, 563.88f, 586.83f                     // 80
+};
+const int TABLE_SIZE = sizeof(SATURATION_TABLE) / sizeof(SATURATION_TABLE[0]);
+const int TABLE_MAX = TABLE_MIN + TABLE_SIZE - 1;
+
+// g / Rd for dry air, K/m
+const float GRAVITY_OVER_RD = 9.80665f / 287.05f;
+const float STANDARD_LAPSE = 0.0065f;  // K/m
+const float KELVIN = 273.15f;
+
+int32_t hundredths(float value) {
+    return (int32_t)(value < 0 ? value * 100.0f - 0.5f : value * 100.0f + 0.5f);
+}
+
+} // namespace
+
+ComfortMetrics::ComfortMetrics()
+    : lock(portMUX_INITIALIZER_UNLOCKED),
+      altitude(SENSOR_ALTITUDE),
+      altitudeGeneration(1),
+      computed(0),
+      skipped(0)
+{
+    memset(inputs, 0, sizeof(inputs));
+    memset(inputGeneration, 0, sizeof(inputGeneration));
+    memset(valid, 0, sizeof(valid));
+    memset(values, 0, sizeof(values));
+}
+
+void ComfortMetrics::setAltitude(int16_t meters) {
+    if (meters < MIN_ALTITUDE) {
+        meters = MIN_ALTITUDE;
+    } else if (meters > MAX_ALTITUDE) {
+        meters = MAX_ALTITUDE;
+    }
+    if (meters == altitude) {
+        return;
+    }
+    portENTER_CRITICAL(&lock);
+    altitude = meters;
+    altitudeGeneration++;
+    portEXIT_CRITICAL(&lock);
+}
+
+float ComfortMetrics::saturationPressure(float temperature) {
+    if (temperature <= TABLE_MIN) {
+        return SATURATION_TABLE[0];
+    }
+    if (temperature >= TABLE_MAX) {
+        return SATURATION_TABLE[TABLE_SIZE - 1];
+    }
+    float position = temperature - TABLE_MIN;
+    int index = (int)position;
+    float fraction = position - index;
+    return SATURATION_TABLE[index] + fraction * (SATURATION_TABLE[index + 1] - SATURATION_TABLE[index]);
+}
+
+float ComfortMetrics::dewPoint(float temperature, float humidity) {
+    // The temperature at which the actual vapour pressure saturates
+    float vapour = saturationPressure(temperature) * humidity / 100.0f;
+    if (vapour <= SATURATION_TABLE[0]) {
+        return TABLE_MIN;
+    }
+    if (vapour >= SATURATION_TABLE[TABLE_SIZE - 1]) {
+        return TABLE_MAX;
+    }
+    int low = 0;
+    int high = TABLE_SIZE - 1;
+    while (high - low > 1) {
+        int middle = (low + high) / 2;
+        if (SATURATION_TABLE[middle] <= vapour) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+    float fraction = (vapour - SATURATION_TABLE[low]) / (SATURATION_TABLE[high] - SATURATION_TABLE[low]);
+    return TABLE_MIN + low + fraction;
+}
+
+float ComfortMetrics::absoluteHumidity(float temperature, float humidity) {
+    // Ideal gas law for water vapour: 100 / Rv (461.5 J/(kg K)) * 1000 g/kg
+    float vapour = saturationPressure(temperature) * humidity / 100.0f;
+    return 216.7f * vapour / (temperature + KELVIN);
+}
+
+float ComfortMetrics::heatIndex(float temperature, float humidity) {
+    // NOAA's algorithm works in degF
+    float t = temperature * 1.8f + 32.0f;
+    float rh = humidity;
+
+    float index = 0.5f * (t + 61.0f + (t - 68.0f) * 1.2f + rh * 0.094f);
+    if ((index + t) / 2.0f >= 80.0f) {
+        index = -42.379f + 2.04901523f * t + 10.14333127f * rh - 0.22475541f * t * rh -
+                0.00683783f * t * t - 0.05481717f * rh * rh + 0.00122874f * t * t * rh +
+                0.00085282f * t * rh * rh - 0.00000199f * t * t * rh * rh;
+        if (rh < 13.0f && t >= 80.0f && t <= 112.0f) {
+            index -= (13.0f - rh) / 4.0f * sqrtf((17.0f - fabsf(t - 95.0f)) / 17.0f);
+        } else if (rh > 85.0f && t >= 80.0f && t <= 87.0f) {
+            index += (rh - 85.0f) / 10.0f * (87.0f - t) / 5.0f;
+        }
+    }
+    return (index - 32.0f) / 1.8f;
+}
+
+float ComfortMetrics::seaLevelPressure(float pressure, float temperature, float altitude) {
+    // Hypsometric equation over a column with the standard lapse rate,
+    // using its mean temperature
+    float meanTemperature = temperature + KELVIN + STANDARD_LAPSE * altitude / 2.0f;
+    float x = GRAVITY_OVER_RD * altitude / meanTemperature;
+
+    // exp(x) to x^6, Horner form
+    float factor = 1.0f + x * (1.0f + x / 2.0f * (1.0f + x / 3.0f * (1.0f + x / 4.0f *
+                   (1.0f + x / 5.0f * (1.0f + x / 6.0f)))));
+    return pressure * factor;
+}
+
+bool ComfortMetrics::update(uint8_t sensor, float temperature, float humidity, float pressure) {
+    if (sensor >= SENSOR_MAX_COUNT) {
+        return false;
+    }
+    const int32_t quantized[3] = {hundredths(temperature), hundredths(humidity), hundredths(pressure)};
+    uint32_t generation = altitudeGeneration;
+    if (valid[sensor] && generation == inputGeneration[sensor] &&
+        memcmp(quantized, inputs[sensor], sizeof(quantized)) == 0) {
+        skipped++;
+        return false;
+    }
+
+    Values result;
+    result.dewPoint = dewPoint(temperature, humidity);
+    result.absoluteHumidity = absoluteHumidity(temperature, humidity);
+    result.heatIndex = heatIndex(temperature, humidity);
+    result.seaLevelPressure = seaLevelPressure(pressure, temperature, altitude);
+
+    portENTER_CRITICAL(&lock);
+    values[sensor] = result;
+    valid[sensor] = true;
+    portEXIT_CRITICAL(&lock);
+
+    memcpy(inputs[sensor], quantized, sizeof(quantized));
+    inputGeneration[sensor] = generation;
+    computed++;
+    return true;
+}
+
+bool ComfortMetrics::get(uint8_t sensor, Values& result) const {
+    if (sensor >= SENSOR_MAX_COUNT) {
+        return false;
+    }
+    portENTER_CRITICAL(&lock);
+    bool available = valid[sensor];
+    result = values[sensor];
+    portEXIT_CRITICAL(&lock);
+    return available;
+}
@@ -2,26 +2,54 @@
 #include "GlobalState.h"
 #include "PreferencesManager.h"
 #include "SystemDefinitions.h"
+#include "TimeService.h"
+#include "SensorRegistry.h"
+#include <algorithm>
 
-const unsigned long DisplayHandler::MODE_DURATIONS[6] = {
-    DISPLAY_TIME_DURATION,    // TIME
-    DISPLAY_DATE_DURATION,    // DATE
-    DISPLAY_TEMP_DURATION,    // TEMPERATURE
-    DISPLAY_HUM_DURATION,     // HUMIDITY
-    DISPLAY_PRES_DURATION,    // PRESSURE
-    DISPLAY_REMOTE_DURATION   // REMOTE_TEMP
-};
+static_assert(DISPLAY_COUNT == SegmentFont::FRAME_DIGITS,
+              "Packed display frames hold exactly four digits");
 
+using SegmentFont::BLANK_FRAME;
+using SegmentFont::renderNumber;
 
 DisplayHandler::DisplayHandler() 
-    : sr(DATA_PIN, CLOCK_PIN, LATCH_PIN),
+    : pendingFrame(BLANK_FRAME),
+      sr(DATA_PIN, CLOCK_PIN, LATCH_PIN),
       displayMutex(nullptr),  // Initialize to nullptr first
       displayValid(false),
       currentMode(DisplayMode::TIME),
+      currentSensor(0),
       modeStartTime(0),
-      lastUpdate(0),
-      currentBrightness(255)
+      modeDuration(DISPLAY_TIME_DURATION),
+      latchedFrame(BLANK_FRAME),
+      frameLatched(false),
+      framesRendered(0),
+      framesLatched(0),
+      subframesLatched(0),
+      subframeTimer(nullptr),
+      subframeTimerRunning(false),
+      subframeIndex(0),
+      activeStrip(0),
+      messageActive(false),
+      messageTicksLeft(0),
+      scrollPosition(0),
+      messageReturnMode(DisplayMode::TIME),
+      scrollTimer(nullptr),
+      activePlaylist(0),
+      playlistIndex(0),
+      sensorhubEnabled(false),
+      taskHandle(nullptr),
+      wakeups(0),
+      notifiedWakeups(0)
 {
+    for (int i = 0; i < DISPLAY_COUNT; i++) {
+        digitSubframes[i] = DISPLAY_SUBFRAME_COUNT;
+    }
+    playlistSeq[0] = 0;
+    playlistSeq[1] = 0;
+    memset(messageStrips, 0, sizeof(messageStrips));
+
+
     // Create mutex with error checking
     displayMutex = xSemaphoreCreateMutex();
     if (!displayMutex) {
@@ -38,16 +66,8 @@ DisplayHandler::DisplayHandler()
     pinMode(OE_PIN, OUTPUT);
     digitalWrite(OE_PIN, HIGH);  // Disable output initially
 
-    // Initialize display buffers under mutex protection
-    if (xSemaphoreTake(displayMutex, MUTEX_TIMEOUT) == pdTRUE) {
-        memset(displayBuffer, CHAR_BLANK, DISPLAY_COUNT);
-        memset(dpBuffer, 0, DISPLAY_COUNT);
-        displayValid = true;
-        xSemaphoreGive(displayMutex);
-        Serial.println("[INIT] Display buffers initialized successfully");
-    } else {
-        Serial.println("[CRITICAL ERROR] Could not initialize display buffers!");
-    }
+    displayValid = true;
+    Serial.println("[INIT] Display buffers initialized successfully");
 }
 
 bool DisplayHandler::init() {
@@ -57,100 +77,275 @@ bool DisplayHandler::init() {
     if (!displayMutex) {
         Serial.println("[CRITICAL] Recreating lost mutex during init");
         displayMutex = xSemaphoreCreateMutex();
+        if (!displayMutex) {
+            Serial.println("[CRITICAL ERROR] Could not create display mutex during init!");
+            return false;
+        }
+    }
+
+    // Initialize display state
+    digitalWrite(OE_PIN, HIGH); // Ensure display is off during init
+    pendingFrame.store(BLANK_FRAME);
+    displayValid = true;
+
+    // Force the first frame out after init
+    while (latchBusy.test_and_set(std::memory_order_acquire)) {
+        taskYIELD();
+    }
+    frameLatched = false;
+    latchBusy.clear(std::memory_order_release);
+
+    // Timer that drives per-digit dimming; started on demand
+    if (!subframeTimer) {
+        esp_timer_create_args_t timerArgs = {};
+        timerArgs.callback = &DisplayHandler::subframeCallback;
+        timerArgs.arg = this;
+        timerArgs.name = "display_subframe";
+        if (esp_timer_create(&timerArgs, &subframeTimer) != ESP_OK) {
+            Serial.println("[ERROR] Could not create display subframe timer");
+            subframeTimer = nullptr;
+        }
     }
 
-    // Much longer mutex wait time
-    const TickType_t xBlockTime = pdMS_TO_TICKS(1000);
+    // Timer that advances scrolling messages; started per message
+    if (!scrollTimer) {
+        esp_timer_create_args_t timerArgs = {};
+        timerArgs.callback = &DisplayHandler::scrollCallback;
+        timerArgs.arg = this;
+        timerArgs.name = "display_scroll";
+        if (esp_timer_create(&timerArgs, &scrollTimer) != ESP_OK) {
+            Serial.println("[ERROR] Could not create display scroll timer");
+            scrollTimer = nullptr;
+        }
+    }
     
-    if (xSemaphoreTake(displayMutex, xBlockTime) == pdTRUE) {
-        Serial.println("[CRITICAL] Mutex taken during init");
-        
-        // Initialize display state
-        digitalWrite(OE_PIN, HIGH); // Ensure display is off during init
-        memset(displayBuffer, CHAR_BLANK, DISPLAY_COUNT);
-        memset(dpBuffer, 0, DISPLAY_COUNT);
-        displayValid = true;
-        
-        xSemaphoreGive(displayMutex);
-        
-        // Enable display output
-        digitalWrite(OE_PIN, LOW);
-        
-        // Set initial brightness
-        setBrightness(75);  // Default to full brightness
-        
-        Serial.println("DisplayHandler::init() - Complete");
-        return true;  // Return true to indicate successful initialization
-    } else {
-        Serial.println("[CRITICAL ERROR] Could not take mutex during init!");
-        return false;  // Return false if initialization failed
+    // Enable display output through the brightness engine
+    brightness.begin();
+    
+    // Set initial brightness
+    setBrightness(75);  // Default to full brightness
+    
+    Serial.println("DisplayHandler::init() - Complete");
+    return true;
+}
+
+bool DisplayHandler::latchFrame(uint32_t frame) {
+    // Only one task shifts out at a time. If another task is already latching,
+    // skip this refresh; it will pick up the newest frame anyway.
+    if (latchBusy.test_and_set(std::memory_order_acquire)) {
+        return false;
     }
+
+    framesRendered++;
+    bool changed = shiftOut(frame);
+    if (changed) {
+        framesLatched++;
+    }
+
+    latchBusy.clear(std::memory_order_release);
+    return changed;
+}
+
+bool DisplayHandler::shiftOut(uint32_t frame) {
+    // Only shift out when the segments actually change
+    if (frameLatched && frame == latchedFrame) {
+        return false;
+    }
+    uint8_t patterns[DISPLAY_COUNT];
+    for (int i = 0; i < DISPLAY_COUNT; i++) {
+        patterns[i] = (uint8_t)(frame >> (8 * i));
+    }
+    sr.setAll(patterns);
+    latchedFrame = frame;
+    frameLatched = true;
+    return true;
 }
 
 void DisplayHandler::updateDisplay() {
-    if (xSemaphoreTake(displayMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        uint8_t patterns[DISPLAY_COUNT];
+    // While digits are dimmed the subframe timer owns the shift registers
+    if (subframeTimerRunning.load()) {
+        return;
+    }
+    latchFrame(pendingFrame.load(std::memory_order_acquire));
+}
+
+void DisplayHandler::subframeCallback(void* arg) {
+    static_cast<DisplayHandler*>(arg)->latchSubframe();
+}
+
+void DisplayHandler::latchSubframe() {
+    if (latchBusy.test_and_set(std::memory_order_acquire)) {
+        return;
+    }
+
+    // Checked under latchBusy: once setDigitBrightness() has stopped the
+    // timer and restored the frame, a callback still in flight cannot latch
+    // a gated one over it
+    if (subframeTimerRunning.load()) {
+        uint8_t slot = subframeIndex;
+        subframeIndex = (subframeIndex + 1) % DISPLAY_SUBFRAME_COUNT;
+
+        // Blank every digit whose level does not reach this subframe.
+        // Latching the gated frame is what switches a digit off, so dimming
+        // stays in step with the frame contents.
+        uint32_t frame = pendingFrame.load(std::memory_order_acquire);
         for (int i = 0; i < DISPLAY_COUNT; i++) {
-            patterns[i] = SEGMENT_MAP[displayBuffer[i]];
-            if (dpBuffer[i]) {
-                patterns[i] &= 0x7F;  // Set decimal point (active low for common anode)
+            if (digitSubframes[i].load(std::memory_order_relaxed) <= slot) {
+                frame |= 0xFFUL << (8 * i);
             }
         }
-        sr.setAll(patterns);
-        xSemaphoreGive(displayMutex);
+        if (shiftOut(frame)) {
+            subframesLatched++;
+        }
+    }
+
+    latchBusy.clear(std::memory_order_release);
+}
+
+void DisplayHandler::setDigitBrightness(uint8_t position, uint8_t percent) {
+    if (position >= DISPLAY_COUNT) {
+        return;
+    }
+
+    uint8_t subframes = 0;
+    if (percent > 0) {
+        subframes = (constrain(percent, 1, 100) * DISPLAY_SUBFRAME_COUNT + 50) / 100;
+        if (subframes == 0) {
+            subframes = 1;
+        }
+    }
+    digitSubframes[position] = subframes;
+
+    bool gating = false;
+    for (int i = 0; i < DISPLAY_COUNT; i++) {
+        if (digitSubframes[i] < DISPLAY_SUBFRAME_COUNT) {
+            gating = true;
+        }
+    }
+
+    if (!subframeTimer) {
+        return;
+    }
+
+    if (gating && !subframeTimerRunning.exchange(true)) {
+        esp_timer_start_periodic(subframeTimer, DISPLAY_SUBFRAME_US);
+    } else if (!gating && subframeTimerRunning.exchange(false)) {
+        esp_timer_stop(subframeTimer);
+
+        // Restore the ungated frame right away. Wait out a subframe being
+        // latched rather than skip, or its gated frame stays on the digits.
+        while (latchBusy.test_and_set(std::memory_order_acquire)) {
+            taskYIELD();
+        }
+        shiftOut(pendingFrame.load(std::memory_order_acquire));
+        latchBusy.clear(std::memory_order_release);
     }
 }
 
+void DisplayHandler::showFrame(uint32_t frame) {
+    pendingFrame.store(frame, std::memory_order_release);
+    displayValid = true;
+}
+
 void DisplayHandler::setDigit(uint8_t position, uint8_t value, bool dp) {
     if (position < DISPLAY_COUNT && value < sizeof(SEGMENT_MAP)/sizeof(SEGMENT_MAP[0])) {
-        if (xSemaphoreTake(displayMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-            displayBuffer[position] = value;
-            dpBuffer[position] = dp;
-            displayValid = true;
-            xSemaphoreGive(displayMutex);
+        uint8_t pattern = SEGMENT_MAP[value];
+        if (dp) {
+            pattern &= 0x7F;
         }
+        const uint32_t shift = 8 * position;
+        const uint32_t mask = 0xFFUL << shift;
+
+        // Replace one byte of the published frame without locking
+        uint32_t current = pendingFrame.load(std::memory_order_relaxed);
+        uint32_t updated;
+        do {
+            updated = (current & ~mask) | ((uint32_t)pattern << shift);
+        } while (!pendingFrame.compare_exchange_weak(current, updated,
+                                                     std::memory_order_release,
+                                                     std::memory_order_relaxed));
+        displayValid = true;
     }
 }
 
 void DisplayHandler::update() {
-    unsigned long now = millis();
-    
-    if (now - modeStartTime >= MODE_DURATIONS[static_cast<int>(currentMode)]) {
+    // Messages end on their own once they have scrolled through
+    DisplayMode mode = currentMode.load();
+    if (mode != DisplayMode::MESSAGE &&
+        millis() - modeStartTime.load() >= modeDuration.load()) {
         nextMode();
-        modeStartTime = now;
     }
     
-    if (now - lastUpdate >= 100) { // 100ms refresh rate
-        if (displayValid) {
-            updateDisplay();
+    // Cheap when nothing changed: latchFrame() skips identical frames
+    if (displayValid) {
+        updateDisplay();
+    }
+}
+
+uint32_t DisplayHandler::msUntilNextChange() const {
+    unsigned long now = millis();
+    uint32_t wait = DISPLAY_MAX_SLEEP_MS;
+    DisplayMode mode = currentMode.load();
+
+    // Mode rotation; a running message is driven by the scroll timer
+    if (mode != DisplayMode::MESSAGE) {
+        uint32_t elapsed = now - modeStartTime.load();
+        uint32_t duration = modeDuration.load();
+        wait = std::min(wait, elapsed >= duration ? 0 : duration - elapsed);
+    }
+
+    if (mode == DisplayMode::TIME || mode == DisplayMode::DATE) {
+        // Minute rollover and colon toggles on the disciplined clock. Time
+        // zones are whole minutes off UTC, so the local minute turns over
+        // together with the UTC one.
+        int64_t utc = TimeService::getInstance().nowUs();
+        if (utc > 0) {
+            uint32_t intoMinute = (uint32_t)((utc % 60000000LL) / 1000);
+            wait = std::min(wait, 60000 - intoMinute);
+            if (mode == DisplayMode::TIME) {
+                wait = std::min(wait, (uint32_t)(DISPLAY_COLON_BLINK_MS - intoMinute % DISPLAY_COLON_BLINK_MS));
+            }
+        } else if (mode == DisplayMode::TIME) {
+            wait = std::min(wait, (uint32_t)(DISPLAY_COLON_BLINK_MS - now % DISPLAY_COLON_BLINK_MS));
         }
-        lastUpdate = now;
     }
+
+    return wait;
 }
 
-void DisplayHandler::showTime(int hours, int minutes) {
-    static bool colonState = true;
-    static unsigned long lastToggle = 0;
-    unsigned long currentMillis = millis();
-    
-    // Toggle colon state every 500ms
-    if (currentMillis - lastToggle >= 500) {
-        colonState = !colonState;
-        lastToggle = currentMillis;
+bool DisplayHandler::colonPhase() const {
+    // Colon is lit for the first half of every second
+    int64_t utc = TimeService::getInstance().nowUs();
+    uint64_t ms = utc > 0 ? (uint64_t)(utc / 1000) : millis();
+    return (ms / DISPLAY_COLON_BLINK_MS) % 2 == 0;
+}
+
+void DisplayHandler::wake() {
+    TaskHandle_t handle = taskHandle.load();
+    if (handle) {
+        xTaskNotifyGive(handle);
     }
+}
+
+void DisplayHandler::waitForChange() {
+    uint32_t wait = msUntilNextChange();
+    // Round up so the task never wakes just before its deadline
+    TickType_t ticks = (wait + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS;
+    if (ulTaskNotifyTake(pdTRUE, ticks) > 0) {
+        notifiedWakeups++;
+    }
+    wakeups++;
+}
+
+void DisplayHandler::showTime(int hours, int minutes) {
+    bool colonState = colonPhase();
     
-    // Convert time digits to correct character indices
-    setDigit(0, CHAR_0 + (hours / 10));
-    setDigit(1, CHAR_0 + (hours % 10), colonState);
-    setDigit(2, CHAR_0 + (minutes / 10));
-    setDigit(3, CHAR_0 + (minutes % 10));
+    uint32_t frame = renderNumber(hours * 100 + minutes, 0, '\0', 4);
+    showFrame(colonState ? SegmentFont::withDecimalPoint(frame, 1) : frame);
 }
 
 void DisplayHandler::showDate(int day, int month) {
-    setDigit(0, CHAR_0 + (day / 10));
-    setDigit(1, CHAR_0 + (day % 10), true);
-    setDigit(2, CHAR_0 + (month / 10));
-    setDigit(3, CHAR_0 + (month % 10));
+    showFrame(SegmentFont::withDecimalPoint(renderNumber(day * 100 + month, 0, '\0', 4), 1));
 }
 
 void DisplayHandler::showTemperature(float temp) {
@@ -158,21 +353,7 @@ void DisplayHandler::showTemperature(float temp) {
         clear();
         return;
     }
-    
-    int whole = abs((int)temp);
-    int decimal = abs((int)(temp * 10) % 10);
-    
-    if (temp < 0) {
-        setDigit(0, CHAR_MINUS);
-        setDigit(1, CHAR_0 + (whole % 10), true);
-        setDigit(2, CHAR_0 + decimal);
-        setDigit(3, CHAR_C);
-    } else {
-        setDigit(0, CHAR_0 + (whole / 10));
-        setDigit(1, CHAR_0 + (whole % 10), true);
-        setDigit(2, CHAR_0 + decimal);
-        setDigit(3, CHAR_C);
-    }
+    showFrame(renderNumber(temp, 1, 'C', 3));
 }
 
 void DisplayHandler::showHumidity(float humidity) {
@@ -180,89 +361,236 @@ void DisplayHandler::showHumidity(float humidity) {
         clear();
         return;
     }
-    
-    int whole = (int)humidity;
-    int decimal = (int)(humidity * 10) % 10;
-    
-    setDigit(0, CHAR_0 + (whole / 10));
-    setDigit(1, CHAR_0 + (whole % 10), true);
-    setDigit(2, CHAR_0 + decimal);
-    setDigit(3, CHAR_h);
+    showFrame(renderNumber(humidity, 1, 'h', 3));
 }
 
 void DisplayHandler::showPressure(float pressure) {
     // Display pressure in hPa, rounded to nearest whole number
-    int hpa = (int)(pressure + 0.5);
-    
-    if (hpa > 9999) hpa = 9999;
-    
-    setDigit(0, CHAR_0 + ((hpa / 1000) % 10));
-    setDigit(1, CHAR_0 + ((hpa / 100) % 10));
-    setDigit(2, CHAR_0 + ((hpa / 10) % 10));
-    setDigit(3, CHAR_0 + (hpa % 10));
+    if (pressure > 9999) pressure = 9999;
+    showFrame(renderNumber(pressure, 0, '\0', 4));
 }
 
 void DisplayHandler::showRemoteTemp(float temp) {
-    /* Serial.println("Showing remote temp: " + String(temp, 2));  // Added precision
-       Serial.printf("Raw temp value: %f\n", temp);  // Log raw value
-       Serial.printf("Temp comparison: %f <= -40: %s\n", temp, temp <= -40 ? "true" : "false");
-    Serial.printf("Temp comparison: %f >= 140: %s\n", temp, temp >= 140 ? "true" : "false");
-     */
     // Don't show invalid temperatures
     if (temp <= -40 || temp >= 140) {
         Serial.printf("Invalid remote temp: %.2f, showing error\n", temp);
-        setDigit(0, CHAR_r);
-        setDigit(1, CHAR_MINUS);
-        setDigit(2, CHAR_MINUS);
-        setDigit(3, CHAR_MINUS);
+        static constexpr uint32_t REMOTE_ERROR_FRAME = SegmentFont::renderText("r---");
+        showFrame(REMOTE_ERROR_FRAME);
+        return;
+    }
+
+    // 'r' for remote, then the value with one decimal where it fits
+    showFrame(renderNumber(temp, 1, '\0', 3, 'r'));
+}
+
+void DisplayHandler::showDewPoint(float dewPoint) {
+    // 'd' for dew point, as "d12.3" or "d-4.5"
+    if (dewPoint < -40 || dewPoint > 85) {
+        clear();
+        return;
+    }
+    showFrame(renderNumber(dewPoint, 1, '\0', 2, 'd'));
+}
+
+void DisplayHandler::showAbsoluteHumidity(float absoluteHumidity) {
+    // 'A' for absolute, in g/m3
+    if (absoluteHumidity < 0 || absoluteHumidity > 999) {
+        clear();
+        return;
+    }
+    showFrame(renderNumber(absoluteHumidity, 1, '\0', 2, 'A'));
+}
+
+void DisplayHandler::showHeatIndex(float heatIndex) {
+    // 'H' for heat index, as "H31.2"
+    if (heatIndex < -40 || heatIndex > 99.9) {
+        clear();
         return;
     }
+    showFrame(renderNumber(heatIndex, 1, '\0', 2, 'H'));
+}
+
+void DisplayHandler::showSeaLevelPressure(float pressure) {
+    // Whole hPa like showPressure(); the last decimal point tells them apart
+    if (pressure > 9999) pressure = 9999;
+    showFrame(SegmentFont::withDecimalPoint(renderNumber(pressure, 0, '\0', 4), 3));
+}
 
-    int wholePart = abs((int)temp);
-    int decimalPart = abs((int)(temp * 10) % 10);
+bool DisplayHandler::showMessage(const char* text) {
+    if (!text || !*text) {
+        cancelMessage();
+        return true;
+    }
+    if (!displayMutex || !scrollTimer) {
+        return false;
+    }
 
-    setDigit(0, CHAR_r);  // 'r' for remote
-    if (temp < 0) {
-        setDigit(1, CHAR_MINUS);
-        setDigit(2, CHAR_0 + (wholePart % 10), true);  // Decimal point
-        setDigit(3, CHAR_0 + decimalPart);
+    // Serialize writers; the scroll timer itself never takes this lock
+    if (xSemaphoreTake(displayMutex, MUTEX_TIMEOUT) != pdTRUE) {
+        Serial.println("[DISPLAY] Message dropped, display busy");
+        return false;
+    }
+
+    // Build the new strip in the buffer the timer is not reading
+    uint8_t next = activeStrip.load() ^ 1;
+    MessageStrip& strip = messageStrips[next];
+    uint16_t length = SegmentFont::renderStrip(text, strip.segments, MESSAGE_MAX_LENGTH);
+    memset(strip.segments + length, SegmentFont::BLANK, DISPLAY_COUNT);
+
+    uint32_t ticks;
+    if (length <= DISPLAY_COUNT) {
+        strip.steps = 1;
+        ticks = MESSAGE_STATIC_MS / MESSAGE_SCROLL_MS;
     } else {
-        setDigit(1, CHAR_0 + (wholePart / 10));
-        setDigit(2, CHAR_0 + (wholePart % 10), true);  // Decimal point
-        setDigit(3, CHAR_0 + decimalPart);
+        strip.steps = length + 1;  // Last window is the blank gap
+        ticks = (uint32_t)strip.steps * MESSAGE_REPEATS;
+    }
+
+    esp_timer_stop(scrollTimer);
+    activeStrip.store(next, std::memory_order_release);
+    scrollPosition = 0;
+    messageTicksLeft.store(ticks);
+
+    if (!messageActive.exchange(true)) {
+        messageReturnMode = currentMode.load();
+    }
+    currentMode.store(DisplayMode::MESSAGE);
+    modeStartTime.store(millis());
+
+    advanceMessage();  // First window right away
+    esp_timer_start_periodic(scrollTimer, (uint64_t)MESSAGE_SCROLL_MS * 1000ULL);
+    xSemaphoreGive(displayMutex);
+
+    Serial.printf("[DISPLAY] Showing message (%u positions): %s\n", length, text);
+    return true;
+}
+
+void DisplayHandler::scrollCallback(void* arg) {
+    static_cast<DisplayHandler*>(arg)->advanceMessage();
+}
+
+void DisplayHandler::advanceMessage() {
+    if (!messageActive.load()) {
+        return;
+    }
+
+    // Publishing a window is just four byte loads, the text was encoded once
+    const MessageStrip& strip = messageStrips[activeStrip.load(std::memory_order_acquire)];
+    uint16_t position = scrollPosition;
+    uint32_t frame = 0;
+    for (int i = 0; i < DISPLAY_COUNT; i++) {
+        frame |= (uint32_t)strip.segments[position + i] << (8 * i);
+    }
+    showFrame(frame);
+    wake();
+    scrollPosition = (position + 1) % strip.steps;
+
+    if (messageTicksLeft.fetch_sub(1) <= 1) {
+        cancelMessage();
+    }
+}
+
+void DisplayHandler::cancelMessage() {
+    if (messageActive.exchange(false)) {
+        if (scrollTimer) {
+            esp_timer_stop(scrollTimer);
+        }
+        currentMode.store(messageReturnMode);
+        modeStartTime.store(millis());
+        wake();
     }
-    
-    /* Serial.printf("Remote temp display: %s%d.%d (%.1f°C)\n", 
-                 temp < 0 ? "-" : "",
-                 wholePart,
-                 decimalPart,
-                 temp);
-    */
 }
 
 void DisplayHandler::setMode(DisplayMode mode) {
-    if (xSemaphoreTake(displayMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        currentMode = mode;
-        modeStartTime = millis();
-        xSemaphoreGive(displayMutex);
+    if (mode == DisplayMode::MESSAGE) {
+        if (!messageActive.load()) {
+            return;  // Nothing to show
+        }
+    } else if (messageActive.exchange(false)) {
+        // An explicit mode change replaces the running message
+        esp_timer_stop(scrollTimer);
+    }
+    if (mode != DisplayMode::MESSAGE) {
+        DisplayPlaylist playlist;
+        snapshotPlaylist(playlist);
+        modeDuration.store(playlist.durationFor(mode));
+        currentSensor.store(0);
+    }
+    currentMode.store(mode);
+    modeStartTime.store(millis());
+    wake();
+}
+
+bool DisplayHandler::isConditionMet(const PlaylistEntry& entry) const {
+    GlobalState& state = GlobalState::getInstance();
+
+    switch (static_cast<PlaylistCondition>(entry.condition)) {
+        case PlaylistCondition::CLOCK: {
+            struct tm timeinfo;
+            return getLocalTime(&timeinfo, 0);
+        }
+        case PlaylistCondition::SENSOR:
+            return state.isBMEWorking() &&
+                   SensorRegistry::getInstance().isFresh(entry.sensor, DISPLAY_DATA_MAX_AGE);
+        case PlaylistCondition::REMOTE: {
+            float remote = state.getRemoteTemperature();
+            return sensorhubEnabled.load() && state.isRemoteFresh(DISPLAY_DATA_MAX_AGE) &&
+                   remote >= -40.0f && remote <= 140.0f;
+        }
+        default:
+            return true;
+    }
+}
+
+void DisplayHandler::snapshotPlaylist(DisplayPlaylist& copy) const {
+    // A retry picks up the slot flipped to meanwhile, which is complete, so
+    // this never waits on a writer
+    while (true) {
+        uint8_t slot = activePlaylist.load(std::memory_order_acquire);
+        uint32_t seq = playlistSeq[slot].load(std::memory_order_acquire);
+        if ((seq & 1) == 0) {
+            copy = playlists[slot];
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (playlistSeq[slot].load(std::memory_order_relaxed) == seq) {
+                return;
+            }
+        }
     }
 }
 
 void DisplayHandler::nextMode() {
-    if (xSemaphoreTake(displayMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        currentMode = static_cast<DisplayMode>((static_cast<int>(currentMode) + 1) % 6);
-        modeStartTime = millis();
-        xSemaphoreGive(displayMutex);
+    // A private copy, so a preference save can compile a new playlist while
+    // this one is walked
+    DisplayPlaylist playlist;
+    snapshotPlaylist(playlist);
+    uint8_t count = playlist.size();
+
+    // Walk the schedule from the slot after the current one and take the
+    // first entry whose condition holds; skipped entries are never rendered.
+    for (uint8_t step = 1; step <= count; step++) {
+        uint8_t index = (playlistIndex.load() + step) % count;
+        const PlaylistEntry& entry = playlist.entry(index);
+        if (isConditionMet(entry)) {
+            playlistIndex.store(index);
+            modeDuration.store(entry.durationMs);
+            currentSensor.store(entry.sensor);
+            currentMode.store(static_cast<DisplayMode>(entry.mode));
+            modeStartTime.store(millis());
+            wake();
+            return;
+        }
     }
+
+    // Nothing is showable; keep the clock up
+    modeDuration.store(DISPLAY_TIME_DURATION);
+    currentMode.store(DisplayMode::TIME);
+    modeStartTime.store(millis());
+    wake();
 }
 
 void DisplayHandler::clear() {
-    if (xSemaphoreTake(displayMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        memset(displayBuffer, CHAR_BLANK, DISPLAY_COUNT);
-        memset(dpBuffer, 0, DISPLAY_COUNT);
-        displayValid = true;
-        xSemaphoreGive(displayMutex);
-    }
+    pendingFrame.store(BLANK_FRAME, std::memory_order_release);
+    displayValid = true;
 }
 
 void DisplayHandler::test() {
@@ -295,7 +623,20 @@ void DisplayHandler::setDisplayPreferences(const DisplayPreferences& prefs) {
     for (uint8_t attempts = 0; attempts < MAX_MUTEX_ATTEMPTS; attempts++) {
         if (xSemaphoreTake(displayMutex, MUTEX_TIMEOUT) == pdTRUE) {
             displayPreferences = prefs;
+            sensorhubEnabled.store(prefs.useSensorhub);
+
+            // Compile into the idle slot, then switch the rotation over.
+            // Writers are serialised by displayMutex.
+            uint8_t next = activePlaylist.load() ^ 1;
+            playlistSeq[next].fetch_add(1, std::memory_order_acq_rel);
+            std::atomic_thread_fence(std::memory_order_release);
+            playlists[next].compile(prefs.displayPlaylist);
+            playlistSeq[next].fetch_add(1, std::memory_order_release);
+            playlistIndex.store(0);
+            activePlaylist.store(next, std::memory_order_release);
             xSemaphoreGive(displayMutex);
+            Serial.printf("[PREFS] Display playlist: %s\n",
+                          playlists[next].toString().c_str());
             
             // Get current time to determine if we're in night mode
             struct tm timeinfo;
@@ -318,42 +659,19 @@ void DisplayHandler::setDisplayPreferences(const DisplayPreferences& prefs) {
     Serial.println("[CRITICAL] Failed to acquire mutex in setDisplayPreferences after max attempts");
 }
 
-bool DisplayHandler::setBrightness(uint8_t brightness) {
-    if (!displayMutex) {
-        Serial.println("[CRITICAL] Display mutex is null in setBrightness");
-        return false;
-    }
-
-    bool mutexTaken = false;
-    
-    // Try multiple times to acquire mutex
-    for (uint8_t attempts = 0; attempts < MAX_MUTEX_ATTEMPTS; attempts++) {
-        if (xSemaphoreTake(displayMutex, MUTEX_TIMEOUT) == pdTRUE) {
-            mutexTaken = true;
-            break;
-        }
-        vTaskDelay(MUTEX_WAIT);
-    }
-    
-    if (!mutexTaken) {
-        Serial.println("[CRITICAL] Failed to acquire mutex in setBrightness");
-        return false;
-    }
-    
-    // Constrain brightness to valid percentage
-    uint8_t constrainedBrightness = constrain(brightness, 1, 100);
-    
-    // For common anode: 245 = dimmest (1%), 64 = brightest (100%)
-    uint8_t pwmValue = map(constrainedBrightness, 1, 100, 245, 64);
-    
-    pinMode(OE_PIN, OUTPUT);
-    analogWrite(OE_PIN, pwmValue);
-    currentBrightness = constrainedBrightness;
-    
-    xSemaphoreGive(displayMutex);
+bool DisplayHandler::setBrightness(uint8_t level) {
+    brightness.setLevel(constrain(level, 1, 100));
     return true;
 }
 
+void DisplayHandler::fadeBrightness(uint8_t level) {
+    fadeBrightness(level, BRIGHTNESS_FADE_MS);
+}
+
+void DisplayHandler::fadeBrightness(uint8_t level, uint32_t durationMs) {
+    brightness.fadeTo(constrain(level, 1, 100), durationMs);
+}
+
 void DisplayHandler::applyNightModeBrightness(int currentHour) {
     Serial.printf("[NIGHT MODE] Applying night mode at hour %d\n", currentHour);
     Serial.printf("[NIGHT MODE] Night mode enabled: %s\n", 
@@ -363,7 +681,7 @@ void DisplayHandler::applyNightModeBrightness(int currentHour) {
         uint8_t dayBright = map(displayPreferences.dayBrightness, 1, 75, 1, 100);
         Serial.printf("[NIGHT MODE] Night mode disabled, using day brightness: %d%%\n", 
                      dayBright);
-        setBrightness(dayBright);
+        fadeBrightness(dayBright);
         return;
     }
 
@@ -390,6 +708,6 @@ void DisplayHandler::applyNightModeBrightness(int currentHour) {
                      targetBrightness);
     }
     
-    Serial.printf("[NIGHT MODE] Setting brightness to: %d%%\n", targetBrightness);
-    setBrightness(targetBrightness);
+    Serial.printf("[NIGHT MODE] Fading brightness to: %d%%\n", targetBrightness);
+    fadeBrightness(targetBrightness);
 }
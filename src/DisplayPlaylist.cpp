@@ -0,0 +1,214 @@
+#include "DisplayPlaylist.h"
+#include "config.h"
+
+namespace {
+
+struct ModeName {
+    const char* name;
+    DisplayMode mode;
+};
+
+const ModeName MODE_NAMES[] = {
+    {"time", DisplayMode::TIME},
+    {"date", DisplayMode::DATE},
+    {"temp", DisplayMode::TEMPERATURE},
+    {"hum", DisplayMode::HUMIDITY},
+    {"pres", DisplayMode::PRESSURE},
+    {"remote", DisplayMode::REMOTE_TEMP},
+    {"dew", DisplayMode::DEW_POINT},
+    {"abshum", DisplayMode::ABS_HUMIDITY},
+    {"heat", DisplayMode::HEAT_INDEX},
+    {"slp", DisplayMode::SEA_LEVEL_PRESSURE}
+};
+
+const char* const CONDITION_NAMES[] = {"always", "clock", "sensor", "remote"};
+
+// Longest slot; keeps the duration in 16 bits
+const uint16_t MAX_DURATION_MS = 60000;
+
+} // namespace
+
+DisplayPlaylist::DisplayPlaylist() : count(0) {
+    loadDefaults();
+}
+
+void DisplayPlaylist::loadDefaults() {
+    const PlaylistEntry defaults[] = {
+        {(uint8_t)DisplayMode::TIME, (uint8_t)PlaylistCondition::CLOCK, 0, DISPLAY_TIME_DURATION},
+        {(uint8_t)DisplayMode::DATE, (uint8_t)PlaylistCondition::CLOCK, 0, DISPLAY_DATE_DURATION},
+        {(uint8_t)DisplayMode::TEMPERATURE, (uint8_t)PlaylistCondition::SENSOR, 0, DISPLAY_TEMP_DURATION},
+        {(uint8_t)DisplayMode::HUMIDITY, (uint8_t)PlaylistCondition::SENSOR, 0, DISPLAY_HUM_DURATION},
+        {(uint8_t)DisplayMode::PRESSURE, (uint8_t)PlaylistCondition::SENSOR, 0, DISPLAY_PRES_DURATION},
+        {(uint8_t)DisplayMode::REMOTE_TEMP, (uint8_t)PlaylistCondition::REMOTE, 0, DISPLAY_REMOTE_DURATION}
+    };
+    count = sizeof(defaults) / sizeof(defaults[0]);
+    memcpy(entries, defaults, sizeof(defaults));
+}
+
+bool DisplayPlaylist::parseMode(const String& name, DisplayMode& mode, uint8_t& sensor) {
+    // mode[@sensor]
+    int at = name.indexOf('@');
+    String modeName = at < 0 ? name : name.substring(0, at);
+    sensor = 0;
+    for (const ModeName& candidate : MODE_NAMES) {
+        if (modeName.equalsIgnoreCase(candidate.name)) {
+            mode = candidate.mode;
+            if (at < 0) {
+                return true;
+            }
+            String index = name.substring(at + 1);
+            bool sensorMode = defaultCondition(mode) == PlaylistCondition::SENSOR;
+            long value = index.toInt();
+            if (!sensorMode || index.length() == 0 || value < 0 || value >= SENSOR_MAX_COUNT ||
+                (value == 0 && index != "0")) {
+                return false;
+            }
+            sensor = (uint8_t)value;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool DisplayPlaylist::parseCondition(const String& name, PlaylistCondition& condition) {
+    for (uint8_t i = 0; i < sizeof(CONDITION_NAMES) / sizeof(CONDITION_NAMES[0]); i++) {
+        if (name.equalsIgnoreCase(CONDITION_NAMES[i])) {
+            condition = static_cast<PlaylistCondition>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+PlaylistCondition DisplayPlaylist::defaultCondition(DisplayMode mode) {
+    switch (mode) {
+        case DisplayMode::TIME:
+        case DisplayMode::DATE:
+            return PlaylistCondition::CLOCK;
+        case DisplayMode::TEMPERATURE:
+        case DisplayMode::HUMIDITY:
+        case DisplayMode::PRESSURE:
+        case DisplayMode::DEW_POINT:
+        case DisplayMode::ABS_HUMIDITY:
+        case DisplayMode::HEAT_INDEX:
+        case DisplayMode::SEA_LEVEL_PRESSURE:
+            return PlaylistCondition::SENSOR;
+        case DisplayMode::REMOTE_TEMP:
+            return PlaylistCondition::REMOTE;
+        default:
+            return PlaylistCondition::ALWAYS;
+    }
+}
+
+bool DisplayPlaylist::compile(const String& spec) {
+    String text = spec;
+    text.trim();
+    if (text.length() == 0) {
+        loadDefaults();
+        return true;
+    }
+
+    PlaylistEntry compiled[MAX_ENTRIES];
+    uint8_t compiledCount = 0;
+    bool allValid = true;
+    int start = 0;
+
+    while (start <= (int)text.length()) {
+        int end = text.indexOf(',', start);
+        if (end < 0) {
+            end = text.length();
+        }
+        String item = text.substring(start, end);
+        item.trim();
+        start = end + 1;
+
+        if (item.length() == 0) {
+            continue;
+        }
+        if (compiledCount >= MAX_ENTRIES) {
+            Serial.printf("[PLAYLIST] More than %d entries, ignoring the rest\n", MAX_ENTRIES);
+            allValid = false;
+            break;
+        }
+
+        // mode:seconds[:condition]
+        int firstColon = item.indexOf(':');
+        int secondColon = firstColon < 0 ? -1 : item.indexOf(':', firstColon + 1);
+        DisplayMode mode;
+        uint8_t sensor;
+        if (firstColon < 0 || !parseMode(item.substring(0, firstColon), mode, sensor)) {
+            Serial.printf("[PLAYLIST] Skipping invalid entry '%s'\n", item.c_str());
+            allValid = false;
+            continue;
+        }
+
+        String seconds = secondColon < 0 ? item.substring(firstColon + 1)
+                                         : item.substring(firstColon + 1, secondColon);
+        float durationSec = seconds.toFloat();
+        if (durationSec <= 0 || durationSec * 1000 > MAX_DURATION_MS) {
+            Serial.printf("[PLAYLIST] Skipping invalid duration in '%s'\n", item.c_str());
+            allValid = false;
+            continue;
+        }
+
+        PlaylistCondition condition = defaultCondition(mode);
+        if (secondColon >= 0 && !parseCondition(item.substring(secondColon + 1), condition)) {
+            Serial.printf("[PLAYLIST] Skipping invalid condition in '%s'\n", item.c_str());
+            allValid = false;
+            continue;
+        }
+
+        compiled[compiledCount].mode = (uint8_t)mode;
+        compiled[compiledCount].condition = (uint8_t)condition;
+        compiled[compiledCount].sensor = sensor;
+        compiled[compiledCount].durationMs = (uint16_t)(durationSec * 1000 + 0.5f);
+        compiledCount++;
+    }
+
+    if (compiledCount == 0) {
+        Serial.println("[PLAYLIST] No valid entries, using default rotation");
+        loadDefaults();
+        return false;
+    }
+
+    memcpy(entries, compiled, compiledCount * sizeof(PlaylistEntry));
+    count = compiledCount;
+    return allValid;
+}
+
+String DisplayPlaylist::toString() const {
+    String result;
+    for (uint8_t i = 0; i < count; i++) {
+        DisplayMode mode = static_cast<DisplayMode>(entries[i].mode);
+        const char* name = "time";
+        for (const ModeName& candidate : MODE_NAMES) {
+            if (candidate.mode == mode) {
+                name = candidate.name;
+            }
+        }
+        if (i > 0) {
+            result += ",";
+        }
+        result += name;
+        if (entries[i].sensor != 0) {
+            result += "@";
+            result += String(entries[i].sensor);
+        }
+        result += ":";
+        result += String(entries[i].durationMs / 1000.0f, entries[i].durationMs % 1000 ? 1 : 0);
+        if (static_cast<PlaylistCondition>(entries[i].condition) != defaultCondition(mode)) {
+            result += ":";
+            result += CONDITION_NAMES[entries[i].condition];
+        }
+    }
+    return result;
+}
+
+uint16_t DisplayPlaylist::durationFor(DisplayMode mode) const {
+    for (uint8_t i = 0; i < count; i++) {
+        if (entries[i].mode == (uint8_t)mode) {
+            return entries[i].durationMs;
+        }
+    }
+    return DISPLAY_TIME_DURATION;
+}
@@ -0,0 +1,29 @@
+#include "DnsLookup.h"
+#include <lwip/priv/tcpip_priv.h>  // tcpip_api_call(), as WiFiGeneric uses it
+
+namespace {
+
+// tcpip_api_call() hands over a pointer to the leading member
+struct LookupCall {
+    struct tcpip_api_call_data call;
+    const char* hostname;
+    ip_addr_t* address;
+    dns_found_callback found;
+    void* arg;
+};
+
+err_t lookupOnLwipThread(struct tcpip_api_call_data* call) {
+    LookupCall* lookup = reinterpret_cast<LookupCall*>(call);
+    return dns_gethostbyname(lookup->hostname, lookup->address, lookup->found, lookup->arg);
+}
+
+} // namespace
+
+err_t dnsLookup(const char* hostname, ip_addr_t* address, dns_found_callback found, void* arg) {
+    LookupCall lookup = {};
+    lookup.hostname = hostname;
+    lookup.address = address;
+    lookup.found = found;
+    lookup.arg = arg;
+    return tcpip_api_call(lookupOnLwipThread, &lookup.call);
+}
@@ -1,4 +1,15 @@
 #include "GlobalState.h"
+#include "SensorHistory.h"
+#include "HistoryLog.h"
 
 // In GlobalDefinitions.cpp
-extern GlobalState* g_state;
\ No newline at end of file
+extern GlobalState* g_state;
+
+void GlobalState::updateSensorData(float temp, float hum, float pres) {
+    sensorData.temperature = temp;
+    sensorData.humidity = hum;
+    sensorData.pressure = pres;
+    sensorData.lastUpdate = millis();
+    SensorHistory::getInstance().add(temp, hum, pres);
+    HistoryLog::getInstance().add(temp, hum, pres);
+}
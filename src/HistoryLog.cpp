@@ -0,0 +1,424 @@
+#include "HistoryLog.h"
+#include "TimeService.h"
+#include <stddef.h>
+
+namespace {
+
+const char* const HISTORY_DIR = "/history";
+const uint32_t PAGE_MAGIC = 0x31484C53;     // "SLH1"
+const uint32_t PENDING_MAGIC = 0x504E4447;
+
+struct PageHeader {
+    uint32_t magic;
+    uint32_t sequence;      // Increments with every page written
+    uint32_t time;          // First record, absolute
+    int32_t base[3];
+    uint16_t count;         // Records in the page, including the first
+    uint16_t checksum;      // Fletcher-16 over the page without this field
+};
+
+struct DeltaRecord {
+    uint16_t seconds;
+    int16_t delta[3];
+};
+
+static_assert(sizeof(PageHeader) == 28, "page header layout");
+static_assert(sizeof(DeltaRecord) == 8, "record layout");
+
+const uint16_t RECORDS_PER_PAGE =
+    1 + (HistoryLog::PAGE_SIZE - sizeof(PageHeader)) / sizeof(DeltaRecord);
+
+// The page being filled, kept where a reset does not clear it
+struct PendingPage {
+    uint32_t magic;
+    uint32_t lastTime;
+    int32_t lastValues[3];
+    union {
+        PageHeader header;
+        uint8_t bytes[HistoryLog::PAGE_SIZE];
+    } page;
+};
+
+RTC_NOINIT_ATTR PendingPage pending;
+
+uint16_t pageChecksum(const uint8_t* page) {
+    const size_t skip = offsetof(PageHeader, checksum);
+    uint16_t a = 0, b = 0;
+    for (size_t i = 0; i < HistoryLog::PAGE_SIZE; i++) {
+        if (i == skip || i == skip + 1) continue;
+        a = (a + page[i]) % 255;
+        b = (b + a) % 255;
+    }
+    return (uint16_t)((b << 8) | a);
+}
+
+bool pageValid(const uint8_t* page) {
+    const PageHeader* header = reinterpret_cast<const PageHeader*>(page);
+    return header->magic == PAGE_MAGIC &&
+           header->count > 0 && header->count <= RECORDS_PER_PAGE &&
+           header->checksum == pageChecksum(page);
+}
+
+void segmentPath(uint32_t id, char* path, size_t size) {
+    snprintf(path, size, "%s/%08lx.bin", HISTORY_DIR, (unsigned long)id);
+}
+
+bool readPage(File& file, uint16_t page, uint8_t* buffer) {
+    return file.seek((uint32_t)page * HistoryLog::PAGE_SIZE) &&
+           file.read(buffer, HistoryLog::PAGE_SIZE) == HistoryLog::PAGE_SIZE &&
+           pageValid(buffer);
+}
+
+void resetPending() {
+    memset(&pending, 0, sizeof(pending));
+    pending.magic = PENDING_MAGIC;
+}
+
+} // namespace
+
+HistoryLog::HistoryLog()
+    : mutex(nullptr),
+      ready(false),
+      segmentCount(0),
+      nextPageSequence(0),
+      pagesWritten(0),
+      intervalStart(0),
+      sampleCount(0)
+{
+    memset(segments, 0, sizeof(segments));
+    memset(sums, 0, sizeof(sums));
+}
+
+bool HistoryLog::loadSegment(uint32_t id, Segment& segment) {
+    char path[32];
+    segmentPath(id, path, sizeof(path));
+    File file = SPIFFS.open(path, FILE_READ);
+    if (!file) {
+        return false;
+    }
+
+    // A torn last page (reset during the write) is left out, and nothing
+    // more is appended behind it
+    segment.id = id;
+    segment.pages = (uint16_t)(file.size() / PAGE_SIZE);
+    segment.sealed = file.size() % PAGE_SIZE != 0;
+    uint8_t page[PAGE_SIZE];
+    bool valid = segment.pages > 0 && file.read(page, PAGE_SIZE) == PAGE_SIZE && pageValid(page);
+    if (valid) {
+        segment.firstTime = reinterpret_cast<PageHeader*>(page)->time;
+        if (file.seek((segment.pages - 1) * PAGE_SIZE) &&
+            file.read(page, PAGE_SIZE) == PAGE_SIZE && pageValid(page)) {
+            uint32_t sequence = reinterpret_cast<PageHeader*>(page)->sequence;
+            if (sequence >= nextPageSequence) {
+                nextPageSequence = sequence + 1;
+            }
+        }
+    }
+    file.close();
+    return valid;
+}
+
+bool HistoryLog::begin() {
+    if (!mutex) {
+        mutex = xSemaphoreCreateMutex();
+        if (!mutex) {
+            return false;
+        }
+    }
+
+    SPIFFS.mkdir(HISTORY_DIR);
+    File dir = SPIFFS.open(HISTORY_DIR);
+    segmentCount = 0;
+    if (dir && dir.isDirectory()) {
+        for (File file = dir.openNextFile(); file; file = dir.openNextFile()) {
+            const char* name = strrchr(file.name(), '/');
+            name = name ? name + 1 : file.name();
+            uint32_t id = strtoul(name, nullptr, 16);
+            file.close();
+
+            Segment segment;
+            if (!loadSegment(id, segment)) {
+                char path[32];
+                segmentPath(id, path, sizeof(path));
+                Serial.printf("[HISTORY] Removing unreadable segment %s\n", path);
+                SPIFFS.remove(path);
+                continue;
+            }
+
+            // Keep the index sorted by id, which is also time order
+            if (segmentCount == HISTORY_MAX_SEGMENTS) {
+                if (id < segments[0].id) {
+                    char path[32];
+                    segmentPath(id, path, sizeof(path));
+                    SPIFFS.remove(path);
+                    continue;
+                }
+                dropOldestSegment();
+            }
+            uint8_t i = segmentCount++;
+            while (i > 0 && segments[i - 1].id > id) {
+                segments[i] = segments[i - 1];
+                i--;
+            }
+            segments[i] = segment;
+        }
+        dir.close();
+    }
+
+    // Pick up the page that was being filled before a reset, unless it made
+    // it to flash already or the memory was not preserved
+    if (pending.magic == PENDING_MAGIC && pending.page.header.count > 0 &&
+        pageValid(pending.page.bytes) && pending.page.header.sequence == nextPageSequence) {
+        Serial.printf("[HISTORY] Restored %u unsaved record(s)\n", pending.page.header.count);
+    } else {
+        resetPending();
+    }
+
+    ready = true;
+    Serial.printf("[HISTORY] %u segment(s), next page %lu\n",
+                  segmentCount, (unsigned long)nextPageSequence);
+    return true;
+}
+
+void HistoryLog::add(float temperature, float humidity, float pressure) {
+    if (!ready || !TimeService::getInstance().isValid()) {
+        return;
+    }
+
+    uint32_t now = (uint32_t)(TimeService::getInstance().nowUs() / 1000000LL);
+    uint32_t interval = now - now % HISTORY_LOG_INTERVAL;
+
+    if (sampleCount > 0 && interval != intervalStart) {
+        int32_t values[3];
+        for (uint8_t c = 0; c < 3; c++) {
+            values[c] = (int32_t)lroundf(sums[c] * 100.0f / sampleCount);
+        }
+        xSemaphoreTake(mutex, portMAX_DELAY);
+        appendRecord(intervalStart, values);
+        xSemaphoreGive(mutex);
+        sampleCount = 0;
+        memset(sums, 0, sizeof(sums));
+    }
+
+    intervalStart = interval;
+    sums[0] += temperature;
+    sums[1] += humidity;
+    sums[2] += pressure;
+    sampleCount++;
+}
+
+void HistoryLog::appendRecord(uint32_t time, const int32_t values[3]) {
+    PageHeader& header = pending.page.header;
+
+    if (time <= pending.lastTime) {
+        return;  // Clock went back; keep the log in time order
+    }
+    if (header.count > 0) {
+        bool fits = header.count < RECORDS_PER_PAGE && time - pending.lastTime <= UINT16_MAX;
+        for (uint8_t c = 0; fits && c < 3; c++) {
+            int32_t delta = values[c] - pending.lastValues[c];
+            fits = delta >= INT16_MIN && delta <= INT16_MAX;
+        }
+        if (!fits) {
+            writePage();
+        }
+    }
+
+    if (header.count == 0) {
+        header.magic = PAGE_MAGIC;
+        header.sequence = nextPageSequence;
+        header.time = time;
+        memcpy(header.base, values, sizeof(header.base));
+    } else {
+        DeltaRecord record;
+        record.seconds = (uint16_t)(time - pending.lastTime);
+        for (uint8_t c = 0; c < 3; c++) {
+            record.delta[c] = (int16_t)(values[c] - pending.lastValues[c]);
+        }
+        memcpy(pending.page.bytes + sizeof(PageHeader) + (header.count - 1) * sizeof(DeltaRecord),
+               &record, sizeof(record));
+    }
+
+    header.count++;
+    pending.lastTime = time;
+    memcpy(pending.lastValues, values, sizeof(pending.lastValues));
+    header.checksum = pageChecksum(pending.page.bytes);
+
+    if (header.count == RECORDS_PER_PAGE) {
+        writePage();
+    }
+}
+
+void HistoryLog::writePage() {
+    Segment* segment = segmentCount ? &segments[segmentCount - 1] : nullptr;
+    uint32_t lastTime = pending.lastTime;
+    if (!segment || segment->sealed || segment->pages >= HISTORY_SEGMENT_PAGES) {
+        if (!startSegment()) {
+            resetPending();
+            pending.lastTime = lastTime;
+            return;
+        }
+        segment = &segments[segmentCount - 1];
+    }
+
+    char path[32];
+    segmentPath(segment->id, path, sizeof(path));
+    File file = SPIFFS.open(path, FILE_APPEND);
+    size_t written = file ? file.write(pending.page.bytes, PAGE_SIZE) : 0;
+    if (file) {
+        file.close();
+    }
+
+    if (written == PAGE_SIZE) {
+        if (segment->pages == 0) {
+            segment->firstTime = pending.page.header.time;
+        }
+        segment->pages++;
+        pagesWritten++;
+    } else {
+        // Never append behind a partial page; carry on in a new segment
+        Serial.printf("[HISTORY] Write to %s failed\n", path);
+        segment->sealed = true;
+    }
+    nextPageSequence++;
+    resetPending();
+    pending.lastTime = lastTime;
+}
+
+bool HistoryLog::startSegment() {
+    const size_t segmentBytes = (size_t)HISTORY_SEGMENT_PAGES * PAGE_SIZE;
+
+    // Make room: keep below the segment limit and leave headroom on the
+    // partition, which is shared with the preferences
+    while (segmentCount > 0 &&
+           (segmentCount >= HISTORY_MAX_SEGMENTS ||
+            SPIFFS.totalBytes() - SPIFFS.usedBytes() < 2 * segmentBytes)) {
+        dropOldestSegment();
+    }
+    if (SPIFFS.totalBytes() - SPIFFS.usedBytes() < segmentBytes) {
+        Serial.println("[HISTORY] Not enough free space for a segment");
+        return false;
+    }
+
+    uint32_t id = segmentCount ? segments[segmentCount - 1].id + 1 : 0;
+    segments[segmentCount].id = id;
+    segments[segmentCount].firstTime = pending.page.header.time;
+    segments[segmentCount].pages = 0;
+    segments[segmentCount].sealed = false;
+    segmentCount++;
+    return true;
+}
+
+void HistoryLog::dropOldestSegment() {
+    if (segmentCount == 0) {
+        return;
+    }
+    char path[32];
+    segmentPath(segments[0].id, path, sizeof(path));
+    SPIFFS.remove(path);
+    memmove(segments, segments + 1, (segmentCount - 1) * sizeof(Segment));
+    segmentCount--;
+}
+
+uint32_t HistoryLog::getOldestTime() const {
+    if (segmentCount > 0) {
+        return segments[0].firstTime;
+    }
+    return pending.page.header.count > 0 ? pending.page.header.time : 0;
+}
+
+size_t HistoryLog::decodePage(const uint8_t* page, uint32_t from, uint32_t to,
+                              RecordCallback& callback, bool& stop) {
+    const PageHeader* header = reinterpret_cast<const PageHeader*>(page);
+    Record record;
+    record.time = header->time;
+    memcpy(record.values, header->base, sizeof(record.values));
+
+    size_t delivered = 0;
+    for (uint16_t i = 0; i < header->count; i++) {
+        if (i > 0) {
+            DeltaRecord delta;
+            memcpy(&delta, page + sizeof(PageHeader) + (i - 1) * sizeof(DeltaRecord), sizeof(delta));
+            record.time += delta.seconds;
+            for (uint8_t c = 0; c < 3; c++) {
+                record.values[c] += delta.delta[c];
+            }
+        }
+        if (record.time > to) {
+            stop = true;
+            break;
+        }
+        if (record.time >= from) {
+            delivered++;
+            if (!callback(record)) {
+                stop = true;
+                break;
+            }
+        }
+    }
+    return delivered;
+}
+
+size_t HistoryLog::read(uint32_t from, uint32_t to, RecordCallback callback) {
+    if (!ready || from > to) {
+        return 0;
+    }
+
+    // Work on a snapshot so the sensor task is not held up while the
+    // caller streams. Segments only ever grow at the end or vanish from
+    // the front, which at worst costs a failed read.
+    Segment index[HISTORY_MAX_SEGMENTS];
+    uint8_t count;
+    uint8_t unsaved[PAGE_SIZE];
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    count = segmentCount;
+    memcpy(index, segments, count * sizeof(Segment));
+    memcpy(unsaved, pending.page.bytes, PAGE_SIZE);
+    xSemaphoreGive(mutex);
+
+    // Last segment starting at or before 'from'
+    uint8_t first = 0;
+    while (first + 1 < count && index[first + 1].firstTime <= from) {
+        first++;
+    }
+
+    size_t delivered = 0;
+    bool stop = false;
+    uint8_t page[PAGE_SIZE];
+    for (uint8_t s = first; s < count && !stop; s++) {
+        char path[32];
+        segmentPath(index[s].id, path, sizeof(path));
+        File file = SPIFFS.open(path, FILE_READ);
+        if (!file) {
+            continue;  // Rotated out meanwhile
+        }
+
+        // Binary search for the last page starting at or before 'from'
+        uint16_t start = 0;
+        if (s == first && index[s].pages > 1) {
+            uint16_t lo = 0, hi = index[s].pages - 1;
+            while (lo < hi) {
+                uint16_t mid = (lo + hi + 1) / 2;
+                if (readPage(file, mid, page) &&
+                    reinterpret_cast<PageHeader*>(page)->time > from) {
+                    hi = mid - 1;
+                } else {
+                    lo = mid;
+                }
+            }
+            start = lo;
+        }
+
+        for (uint16_t p = start; p < index[s].pages && !stop; p++) {
+            if (readPage(file, p, page)) {
+                delivered += decodePage(page, from, to, callback, stop);
+            }
+        }
+        file.close();
+    }
+
+    if (!stop && reinterpret_cast<PageHeader*>(unsaved)->count > 0 && pageValid(unsaved)) {
+        delivered += decodePage(unsaved, from, to, callback, stop);
+    }
+    return delivered;
+}
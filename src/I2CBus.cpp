@@ -0,0 +1,303 @@
+#include "I2CBus.h"
+#include <esp_timer.h>
+
+#ifndef OUTPUT_OPEN_DRAIN
+#define OUTPUT_OPEN_DRAIN 0x12
+#endif
+
+namespace {
+
+const TickType_t LOCK_TIMEOUT = pdMS_TO_TICKS(100);
+const uint8_t RECOVERY_CLOCKS = 9;      // One byte plus the ACK bit
+const uint32_t HALF_PERIOD_US = 5;      // 100 kHz while bit-banging
+const uint32_t FIRST_BUCKET_US = 64;
+
+const char* const KIND_NAMES[I2CBus::KIND_COUNT] = {"read", "write", "probe"};
+
+} // namespace
+
+I2CBus::I2CBus()
+    : mutex(xSemaphoreCreateMutex()),
+      statsLock(portMUX_INITIALIZER_UNLOCKED),
+      sdaPin(-1),
+      sclPin(-1),
+      frequency(I2C_CLOCK_HZ),
+      consecutiveErrors(0),
+      recoveries(0),
+      failedRecoveries(0),
+      transactionsSaved(0)
+{
+    memset(stats, 0, sizeof(stats));
+}
+
+bool I2CBus::begin(int sda, int scl, uint32_t clockHz) {
+    sdaPin = sda;
+    sclPin = scl;
+    frequency = clockHz;
+    if (!Wire.begin(sdaPin, sclPin, frequency)) {
+        return false;
+    }
+
+    // A slave that was mid-byte when the CPU reset may still hold SDA low
+    if (digitalRead(sdaPin) == LOW) {
+        Serial.println("[I2C] SDA held low at boot");
+        recover();
+    }
+    return true;
+}
+
+bool I2CBus::lock() {
+    return mutex && xSemaphoreTake(mutex, LOCK_TIMEOUT) == pdTRUE;
+}
+
+void I2CBus::unlock() {
+    xSemaphoreGive(mutex);
+}
+
+uint32_t I2CBus::bucketLimitUs(uint8_t bucket) {
+    return bucket + 1 < HISTOGRAM_BUCKETS ? FIRST_BUCKET_US << bucket : 0;
+}
+
+const char* I2CBus::kindName(Kind kind) {
+    return kind < KIND_COUNT ? KIND_NAMES[kind] : "unknown";
+}
+
+void I2CBus::record(Kind kind, int64_t startUs, bool ok) {
+    uint32_t elapsed = (uint32_t)(esp_timer_get_time() - startUs);
+    uint8_t bucket = 0;
+    while (bucket + 1 < HISTOGRAM_BUCKETS && elapsed >= bucketLimitUs(bucket)) {
+        bucket++;
+    }
+
+    portENTER_CRITICAL(&statsLock);
+    Stats& entry = stats[kind];
+    entry.count++;
+    entry.totalUs += elapsed;
+    if (elapsed > entry.maxUs) {
+        entry.maxUs = elapsed;
+    }
+    entry.buckets[bucket]++;
+    if (!ok) {
+        entry.errors++;
+    }
+    portEXIT_CRITICAL(&statsLock);
+
+    consecutiveErrors = ok ? 0 : consecutiveErrors + 1;
+}
+
+I2CBus::Stats I2CBus::getStats(Kind kind) const {
+    Stats copy = {};
+    if (kind < KIND_COUNT) {
+        portENTER_CRITICAL(&statsLock);
+        copy = stats[kind];
+        portEXIT_CRITICAL(&statsLock);
+    }
+    return copy;
+}
+
+bool I2CBus::probe(uint8_t address) {
+    if (!lock()) {
+        return false;
+    }
+    int64_t start = esp_timer_get_time();
+    Wire.beginTransmission(address);
+    uint8_t result = Wire.endTransmission();
+    // An absent device NACKs; that is an answer, not a bus error
+    record(PROBE, start, result == 0 || result == 2);
+    unlock();
+    return result == 0;
+}
+
+bool I2CBus::readOnce(uint8_t address, uint8_t reg, uint8_t* data, size_t length) {
+    int64_t start = esp_timer_get_time();
+    Wire.beginTransmission(address);
+    Wire.write(reg);
+    // Repeated start: the register pointer and the data are one transaction
+    bool ok = Wire.endTransmission(false) == 0 &&
+              Wire.requestFrom((uint16_t)address, length, true) == length &&
+              (size_t)Wire.available() == length;
+    if (ok) {
+        for (size_t i = 0; i < length; i++) {
+            data[i] = (uint8_t)Wire.read();
+        }
+    }
+    record(READ, start, ok);
+    return ok;
+}
+
+bool I2CBus::writeOnce(uint8_t address, uint8_t reg, const uint8_t* data, size_t length) {
+    int64_t start = esp_timer_get_time();
+    Wire.beginTransmission(address);
+    Wire.write(reg);
+    bool ok = Wire.write(data, length) == length && Wire.endTransmission() == 0;
+    record(WRITE, start, ok);
+    return ok;
+}
+
+bool I2CBus::writePairsOnce(uint8_t address, const Write* writes, uint8_t count) {
+    int64_t start = esp_timer_get_time();
+    Wire.beginTransmission(address);
+    bool ok = true;
+    for (uint8_t i = 0; i < count && ok; i++) {
+        ok = Wire.write(writes[i].reg) == 1 && Wire.write(writes[i].value) == 1;
+    }
+    ok = Wire.endTransmission() == 0 && ok;
+    record(WRITE, start, ok);
+    return ok;
+}
+
+bool I2CBus::afterFailure() {
+    if (digitalRead(sdaPin) == LOW || consecutiveErrors >= I2C_RECOVERY_THRESHOLD) {
+        return recoverLocked();
+    }
+    return false;
+}
+
+bool I2CBus::read(uint8_t address, uint8_t reg, uint8_t* data, size_t length) {
+    if (!lock()) {
+        return false;
+    }
+    bool ok = readOnce(address, reg, data, length) ||
+              (afterFailure() && readOnce(address, reg, data, length));
+    unlock();
+    return ok;
+}
+
+bool I2CBus::write(uint8_t address, uint8_t reg, const uint8_t* data, size_t length) {
+    if (!lock()) {
+        return false;
+    }
+    bool ok = writeOnce(address, reg, data, length) ||
+              (afterFailure() && writeOnce(address, reg, data, length));
+    unlock();
+    return ok;
+}
+
+bool I2CBus::writePairs(uint8_t address, const Write* writes, uint8_t count) {
+    if (!lock()) {
+        return false;
+    }
+    bool ok = writePairsOnce(address, writes, count) ||
+              (afterFailure() && writePairsOnce(address, writes, count));
+    if (ok && count > 1) {
+        transactionsSaved += count - 1;
+    }
+    unlock();
+    return ok;
+}
+
+bool I2CBus::readBatch(uint8_t address, const Read* reads, uint8_t count) {
+    // Register order, insertion sort over a handful of entries
+    uint8_t order[I2C_MAX_BATCH];
+    if (count > I2C_MAX_BATCH) {
+        return false;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t j = i;
+        while (j > 0 && reads[order[j - 1]].reg > reads[i].reg) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+
+    if (!lock()) {
+        return false;
+    }
+
+    uint8_t buffer[I2C_MAX_BURST];
+    bool ok = true;
+    uint8_t first = 0;
+    while (ok && first < count) {
+        // Grow the burst while the next block starts close enough behind it
+        uint16_t start = reads[order[first]].reg;
+        uint16_t end = start + reads[order[first]].length;
+        uint8_t last = first + 1;
+        while (last < count) {
+            const Read& next = reads[order[last]];
+            uint16_t nextEnd = next.reg + next.length;
+            uint16_t burstEnd = nextEnd > end ? nextEnd : end;
+            if (next.reg > end + I2C_COALESCE_GAP || burstEnd - start > I2C_MAX_BURST) {
+                break;
+            }
+            end = burstEnd;
+            last++;
+        }
+
+        if (last == first + 1 && end - start > I2C_MAX_BURST) {
+            // One block larger than a burst goes straight to its destination
+            const Read& only = reads[order[first]];
+            ok = readOnce(address, only.reg, only.data, only.length) ||
+                 (afterFailure() && readOnce(address, only.reg, only.data, only.length));
+        } else {
+            size_t length = end - start;
+            ok = readOnce(address, (uint8_t)start, buffer, length) ||
+                 (afterFailure() && readOnce(address, (uint8_t)start, buffer, length));
+            for (uint8_t i = first; ok && i < last; i++) {
+                const Read& block = reads[order[i]];
+                memcpy(block.data, buffer + (block.reg - start), block.length);
+            }
+            if (ok) {
+                transactionsSaved += last - first - 1;
+            }
+        }
+        first = last;
+    }
+
+    unlock();
+    return ok;
+}
+
+bool I2CBus::recover() {
+    if (!lock()) {
+        return false;
+    }
+    bool freed = recoverLocked();
+    unlock();
+    return freed;
+}
+
+bool I2CBus::recoverLocked() {
+    if (sdaPin < 0 || sclPin < 0) {
+        return false;
+    }
+
+    // Take the pins away from the controller and drive SCL by hand
+    Wire.end();
+    pinMode(sdaPin, INPUT_PULLUP);
+    pinMode(sclPin, OUTPUT_OPEN_DRAIN);
+    digitalWrite(sclPin, HIGH);
+    delayMicroseconds(HALF_PERIOD_US);
+
+    // Each clock lets the slave shift out one more bit; once it has sent
+    // the rest of its byte it sees SDA high as a NACK and releases the bus
+    uint8_t clocks = 0;
+    while (digitalRead(sdaPin) == LOW && clocks < RECOVERY_CLOCKS) {
+        digitalWrite(sclPin, LOW);
+        delayMicroseconds(HALF_PERIOD_US);
+        digitalWrite(sclPin, HIGH);
+        delayMicroseconds(HALF_PERIOD_US);
+        clocks++;
+    }
+
+    bool freed = digitalRead(sdaPin) == HIGH;
+    if (freed) {
+        // STOP: SDA rises while SCL is high
+        digitalWrite(sclPin, LOW);
+        pinMode(sdaPin, OUTPUT_OPEN_DRAIN);
+        digitalWrite(sdaPin, LOW);
+        delayMicroseconds(HALF_PERIOD_US);
+        digitalWrite(sclPin, HIGH);
+        delayMicroseconds(HALF_PERIOD_US);
+        digitalWrite(sdaPin, HIGH);
+        delayMicroseconds(HALF_PERIOD_US);
+        recoveries++;
+    } else {
+        failedRecoveries++;
+    }
+
+    Wire.begin(sdaPin, sclPin, frequency);
+    consecutiveErrors = 0;
+    Serial.printf("[I2C] Bus recovery %s after %u clock(s)\n", freed ? "succeeded" : "failed", clocks);
+    return freed;
+}
@@ -0,0 +1,139 @@
+#include "InFlightWindow.h"
+
+static_assert(MQTT_INFLIGHT_BYTES >= MQTT_QUEUE_MAX_MESSAGE + MessageRing::HEADER_SIZE + 4,
+              "The in-flight window must hold the largest queued message");
+
+namespace {
+
+const uint32_t FIRST_BUCKET_MS = 8;
+
+} // namespace
+
+InFlightWindow::InFlightWindow()
+    : ring(storage, sizeof(storage)),
+      head(0),
+      count(0),
+      statsLock(portMUX_INITIALIZER_UNLOCKED)
+{
+    memset(slots, 0, sizeof(slots));
+    memset(&stats, 0, sizeof(stats));
+}
+
+bool InFlightWindow::add(const char* topic, const char* payload, bool retained, uint16_t packetId) {
+    if (count >= MQTT_INFLIGHT_WINDOW) {
+        return false;
+    }
+    uint32_t dropped = 0;
+    if (ring.push(topic, payload, retained ? KEEP : 0, packetId, false, dropped) == MessageRing::FULL) {
+        return false;
+    }
+
+    Slot& entry = slot(count);
+    entry.packetId = packetId;
+    entry.acknowledged = false;
+    entry.sentAt = millis();
+    count++;
+
+    portENTER_CRITICAL(&statsLock);
+    stats.sent++;
+    portEXIT_CRITICAL(&statsLock);
+    updateDepth();
+    return true;
+}
+
+bool InFlightWindow::acknowledge(uint16_t packetId) {
+    uint8_t index = 0;
+    while (index < count && (slot(index).packetId != packetId || slot(index).acknowledged)) {
+        index++;
+    }
+    if (index == count) {
+        portENTER_CRITICAL(&statsLock);
+        stats.unknownAcks++;
+        portEXIT_CRITICAL(&statsLock);
+        return false;
+    }
+
+    slot(index).acknowledged = true;
+    record(millis() - slot(index).sentAt);
+
+    // Release from the front up to the first one still outstanding
+    while (count > 0 && slot(0).acknowledged) {
+        ring.popFront();
+        head = (head + 1) % MQTT_INFLIGHT_WINDOW;
+        count--;
+    }
+    updateDepth();
+    return true;
+}
+
+bool InFlightWindow::get(uint8_t index, Message& message, uint16_t& packetId) {
+    if (index >= count || !ring.peek(index, scratch, sizeof(scratch), message)) {
+        return false;
+    }
+    message.retained = message.flags & KEEP;
+    packetId = slot(index).packetId;
+    return true;
+}
+
+void InFlightWindow::resent(uint8_t index) {
+    if (index >= count) {
+        return;
+    }
+    slot(index).sentAt = millis();
+    portENTER_CRITICAL(&statsLock);
+    stats.retransmitted++;
+    portEXIT_CRITICAL(&statsLock);
+}
+
+bool InFlightWindow::contains(uint16_t packetId) const {
+    for (uint8_t i = 0; i < count; i++) {
+        if (slot(i).packetId == packetId) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t InFlightWindow::oldestAgeMs() const {
+    for (uint8_t i = 0; i < count; i++) {
+        if (!slot(i).acknowledged) {
+            return millis() - slot(i).sentAt;
+        }
+    }
+    return 0;
+}
+
+uint32_t InFlightWindow::bucketLimitMs(uint8_t bucket) {
+    return bucket + 1 < HISTOGRAM_BUCKETS ? FIRST_BUCKET_MS << bucket : 0;
+}
+
+void InFlightWindow::record(uint32_t latencyMs) {
+    uint8_t bucket = 0;
+    while (bucket + 1 < HISTOGRAM_BUCKETS && latencyMs >= bucketLimitMs(bucket)) {
+        bucket++;
+    }
+
+    portENTER_CRITICAL(&statsLock);
+    stats.acknowledged++;
+    stats.lastMs = latencyMs;
+    stats.totalMs += latencyMs;
+    if (latencyMs > stats.maxMs) {
+        stats.maxMs = latencyMs;
+    }
+    stats.buckets[bucket]++;
+    portEXIT_CRITICAL(&statsLock);
+}
+
+void InFlightWindow::updateDepth() {
+    portENTER_CRITICAL(&statsLock);
+    stats.depth = count;
+    stats.bytes = ring.bytes();
+    portEXIT_CRITICAL(&statsLock);
+}
+
+InFlightWindow::Stats InFlightWindow::getStats() const {
+    portENTER_CRITICAL(&statsLock);
+    Stats copy = stats;
+    portEXIT_CRITICAL(&statsLock);
+    return copy;
+}
@@ -3,16 +3,57 @@
 #include "config.h"
 #include "RelayControlHandler.h"  // Add this include for RelayState enum
 #include "PreferencesManager.h"   // Add this to access PreferencesManager methods
+#include "GlobalState.h"
+#include "SensorRegistry.h"
+#include "MQTTTopics.h"
+#include "DnsLookup.h"
+#include <WiFi.h>
+#include <lwip/sockets.h>
 #include <ArduinoJson.h>  // Include this for JSON handling in callbacks
 #include <algorithm>      // For std::min
 
+namespace {
+
+// Holds the client lock for the rest of the scope
+class ClientGuard {
+public:
+    explicit ClientGuard(SemaphoreHandle_t lock) : lock(lock) {
+        xSemaphoreTakeRecursive(lock, portMAX_DELAY);
+    }
+    ~ClientGuard() {
+        xSemaphoreGiveRecursive(lock);
+    }
+
+private:
+    SemaphoreHandle_t lock;
+};
+
+} // namespace
+
 MQTTManager::MQTTManager() : 
     mqttClient(wifiClient),
+    clientLock(xSemaphoreCreateRecursiveMutex()),
     isConnected(false),
-    lastReconnectAttempt(0),
+    state(ConnectionState::IDLE),
+    stateSince(0),
+    nextAttempt(0),
+    connectedAt(0),
+    downSince(0),
+    outageAttempts(0),
+    statsLock(portMUX_INITIALIZER_UNLOCKED),
+    sessionPresent(false),
+    lastPacketId(0),
+    discoveryNext(0),
     reconnectInterval(5000),
-    lastPublishTime(0),
-    currentReconnectDelay(INITIAL_RECONNECT_DELAY) {
+    currentReconnectDelay(INITIAL_RECONNECT_DELAY),
+    lastQueueFailure(0),
+    failedSequence(0),
+    failedAttempts(0),
+    lastReplay(0),
+    reconnectRequested(false),
+    resolvedAddress(0),
+    resolveFailed(false),
+    pendingSocket(-1) {
     
     // Initialize with default values that will be overridden by preferences
     mqttBroker = MQTT_BROKER;
@@ -22,16 +63,16 @@ MQTTManager::MQTTManager() :
     mqttPassword = MQTT_PASSWORD;
     mqttTopicAuxDisplay = "sensor";
     mqttTopicRelay = "relay";
+    resolvingName[0] = '\0';
+    memset(&connectionStats, 0, sizeof(connectionStats));
     
-    // Configure the MQTT client with a longer socket timeout
-    mqttClient.setSocketTimeout(15); // 15 seconds timeout
     mqttClient.setKeepAlive(30);     // 30 seconds keepalive
+    mqttClient.setAckCallback([this](uint16_t packetId) {
+        this->handleAck(packetId);
+    });
 }
 
 bool MQTTManager::begin(PreferencesManager& prefs) {
-    // Set buffer size first thing
-    mqttClient.setBufferSize(1024);
-    
     DisplayPreferences displayPrefs = PreferencesManager::loadDisplayPreferences();
     
     // Print debug information about loaded preferences
@@ -66,17 +107,13 @@ bool MQTTManager::begin(PreferencesManager& prefs) {
     Serial.printf("[MQTT] Username: '%s'\n", mqttUsername.c_str());
     Serial.printf("[MQTT] Client ID: '%s'\n", MQTT_CLIENT_ID);
     
-    // Set up the MQTT client 
-    mqttClient.setServer(mqttBroker.c_str(), mqttPort);
-    
-    // Add additional debugging
-    Serial.printf("[MQTT] MQTT client server address set to: %s:%d\n", mqttBroker.c_str(), mqttPort);
-    
     mqttClient.setCallback([this](char* topic, byte* payload, unsigned int length) {
         this->callback(topic, payload, length);
     });
     
-    return connect();
+    // The network task makes the connection, see step()
+    connect();
+    return true;
 }
 
 bool MQTTManager::begin() {
@@ -113,184 +150,148 @@ bool MQTTManager::begin() {
     mqttTopicRelay = "relay";
     
     // Now set up the MQTT client with these values
-    mqttClient.setServer(mqttBroker.c_str(), mqttPort);
     mqttClient.setCallback([this](char* topic, byte* payload, unsigned int length) {
         this->callback(topic, payload, length);
     });
     
-    return connect();
+    // The network task makes the connection, see step()
+    connect();
+    return true;
 }
 
 void MQTTManager::loop() {
-    // Get current time
+    // Connecting is up to step() in the network task
+    if (state != ConnectionState::CONNECTED) {
+        return;
+    }
+
+    ClientGuard guard(clientLock);
+    if (!mqttClient.loop()) {
+        // Noticed by step(), which reconnects
+        isConnected = false;
+        return;
+    }
+
+    // Check for periodic status updates
     unsigned long now = millis();
-    
-    // Check if still connected
-    if (!mqttClient.connected()) {
-        if (isConnected) {
-            // We thought we were connected but we're not
-            Serial.println("[MQTT] Connection lost");
-            isConnected = false;
-            
-            // Force disconnect to clean up resources
-            forceDisconnect();
-        }
-        
-        // Try to reconnect with exponential backoff
-        if (now - lastReconnectAttempt > currentReconnectDelay) {
-            lastReconnectAttempt = now;
-            
-            Serial.printf("[MQTT] Attempting reconnection (backoff: %lu ms)\n", currentReconnectDelay);
-            
-            // Make sure previous connection is fully closed
-            mqttClient.disconnect();
-            wifiClient.stop();
-            delay(100);
-            
-            if (connect()) {
-                Serial.println("[MQTT] Reconnection successful");
-                lastReconnectAttempt = 0;
-                currentReconnectDelay = INITIAL_RECONNECT_DELAY;
-            } else {
-                // Increase backoff time
-                currentReconnectDelay = std::min(currentReconnectDelay * 2, (unsigned long)MAX_RECONNECT_DELAY);
-                Serial.printf("[MQTT] Reconnection failed, next attempt in %lu ms\n", currentReconnectDelay);
-                
-                // Debug current settings
-                Serial.printf("[MQTT] Current settings - Broker: %s, Port: %d, User: %s\n", 
-                              mqttBroker.c_str(), mqttPort, mqttUsername.c_str());
-            }
-        } else {
-            // Add debugging for inactive periods
-            static unsigned long lastDebugOutput = 0;
-            if (now - lastDebugOutput > 10000) { // Every 10 seconds
-                Serial.printf("[MQTT] Waiting %lu ms before next reconnect attempt\n", 
-                             currentReconnectDelay - (now - lastReconnectAttempt));
-                lastDebugOutput = now;
-            }
-        }
-    } else {
-        // Client connected - process incoming messages
-        mqttClient.loop();
-        
-        // Check for periodic status updates
-        static unsigned long lastStatusUpdate = 0;
-        if (now - lastStatusUpdate > 300000) { // Every 5 minutes
-            String statusTopic = String("chaoticvolt/") + String(MQTT_CLIENT_ID) + "/" + String(MQTT_TOPIC_AUX_DISPLAY) + "/status";
-            mqttClient.publish(statusTopic.c_str(), "online", true);
-            lastStatusUpdate = now;
-            Serial.println("[MQTT] Published periodic status update");
-        }
+    static unsigned long lastStatusUpdate = 0;
+    if (now - lastStatusUpdate > 300000) { // Every 5 minutes
+        mqttClient.publish(MQTTTopics::STATUS, "online", true);
+        lastStatusUpdate = now;
+        Serial.println("[MQTT] Published periodic status update");
     }
 }
 
 bool MQTTManager::maintainConnection() {
-    unsigned long now = millis();
-    static unsigned long lastConnectionCheck = 0;
-    
-    // Force a connection check every 30 seconds regardless of state
-    if (now - lastConnectionCheck >= 30000) {
-        lastConnectionCheck = now;
-        Serial.println("[MQTT] Periodic connection check");
-        
-        if (!mqttClient.connected()) {
-            Serial.println("[MQTT] Not connected during periodic check");
-            // Explicitly disconnect to ensure clean state
-            mqttClient.disconnect();
-            wifiClient.stop();
-            delay(100);
-            return connect();
-        } else {
-            // Connected - just return true
-            return true;
-        }
-    }
-    
-    // Regular connection maintenance logic
-    if (!mqttClient.connected()) {
-        // Log current time remaining until reconnect
-        Serial.printf("[MQTT] Not connected, %lu ms until next attempt\n", 
-                    (now - lastReconnectAttempt >= currentReconnectDelay) ? 
-                    0 : (currentReconnectDelay - (now - lastReconnectAttempt)));
-        
-        if (now - lastReconnectAttempt >= currentReconnectDelay) {
-            Serial.println("[MQTT] Connection lost, cleaning up before reconnect");
-            
-            // Ensure complete disconnection
-            forceDisconnect();
-            Serial.println("[MQTT] Previous connection resources released");
-            
-            lastReconnectAttempt = now;
-            
-            if (connect()) {
-                Serial.println("[MQTT] Reconnection successful");
-                currentReconnectDelay = INITIAL_RECONNECT_DELAY;
-                return true;
-            } else {
-                // Limit maximum backoff to 30 seconds
-                currentReconnectDelay = std::min(currentReconnectDelay * 2, (unsigned long)30000);
-                Serial.printf("[MQTT] Reconnection failed, next attempt in %lu ms\n", currentReconnectDelay);
-                return false;
-            }
-        }
-        return false;
-    }
-    
-    // If connected, process incoming messages
-    mqttClient.loop();
-    return true;
+    loop();
+    return isConnected;
 }
 
 bool MQTTManager::connected() {
-    return mqttClient.connected();
+    if (state != ConnectionState::CONNECTED) {
+        return false;
+    }
+
+    // While another task holds the client (a connection step can take
+    // seconds), answer with the last known state instead of waiting
+    if (xSemaphoreTakeRecursive(clientLock, 0) != pdTRUE) {
+        return isConnected;
+    }
+    bool result = mqttClient.connected();
+    xSemaphoreGiveRecursive(clientLock);
+    return result;
 }
 
 bool MQTTManager::publish(const String& topic, const String& payload) {
-    if (!isConnectedToMQTT()) {
-        return false;
-    }
-    
-    return mqttClient.publish(topic.c_str(), payload.c_str());
+    return enqueue(topic.c_str(), payload.c_str());
 }
 
 bool MQTTManager::publish(const char* topic, const char* payload, bool retained) {
-    if (!connected()) {
-        Serial.println("MQTT: Cannot publish - not connected");
+    return enqueue(topic, payload, retained);
+}
+
+bool MQTTManager::enqueue(const char* topic, const char* payload, bool retained,
+                          PublishQueue::Policy policy) {
+    if (!payload) {
+        Serial.printf("MQTT: Payload for %s did not fit, not queued\n", topic);
         return false;
     }
+    return PublishQueue::getInstance().enqueue(topic, payload, retained, policy);
+}
 
-    // Get publish interval from preferences
-    DisplayPreferences prefs = PreferencesManager::loadDisplayPreferences();
-    unsigned long publishInterval = prefs.mqttPublishEnabled ? 
-                                    prefs.mqttPublishInterval * 1000 : // Convert to ms
-                                    PUBLISH_RATE_LIMIT;
-    
-    // Rate limit publishing to respect preferences and prevent broker overload
+uint16_t MQTTManager::processQueue() {
     unsigned long now = millis();
-    if (now - lastPublishTime < publishInterval) {
-        unsigned long waitTime = publishInterval - (now - lastPublishTime);
-        if (waitTime > 50) { // Only delay if significant time remains
-            Serial.printf("MQTT: Rate limiting publish, waiting %lu ms\n", waitTime);
-            delay(50); // Small delay to prevent busy-waiting
-        }
+    if (lastQueueFailure != 0 && now - lastQueueFailure < MQTT_QUEUE_RETRY_MS) {
+        return 0;
     }
+    lastQueueFailure = 0;
 
-    const int maxRetries = 3;
-    for (int retry = 0; retry < maxRetries; retry++) {
-        if (retry > 0) {
-            delay((1 << retry) * 200); // Exponential backoff for retries
-            Serial.printf("MQTT: Retry %d/%d publishing to %s\n", retry+1, maxRetries, topic);
+    PublishQueue& queue = PublishQueue::getInstance();
+    PublishQueue::Message message;
+    uint16_t sent = 0;
+    while (sent < MQTT_QUEUE_BATCH && queue.front(message)) {
+        bool published = false;
+        bool linkUp;
+        bool windowFull = false;
+        bool windowed = false;
+        {
+            ClientGuard guard(clientLock);
+            linkUp = mqttClient.connected();
+            if (linkUp && MQTT_QOS == 0) {
+                published = mqttClient.publish(message.topic, message.payload, message.retained);
+            } else if (linkUp) {
+                // From here on the window owns it: a send that fails is
+                // repeated after the reconnect, like any unacknowledged one
+                uint16_t packetId = nextPacketId();
+                windowFull = !window.add(message.topic, message.payload, message.retained, packetId);
+                if (!windowFull) {
+                    windowed = true;
+                    published = mqttClient.publish(message.topic, message.payload, message.retained, MQTT_QOS,
+                                                   packetId);
+                }
+            }
         }
-
-        if (mqttClient.publish(topic, payload, retained)) {
-            lastPublishTime = millis();
-            return true;
+        if (windowFull) {
+            // The next PUBACK wakes the network task
+            break;
         }
-        
-        Serial.printf("MQTT: Publish attempt %d failed for topic: %s\n", retry + 1, topic);
+        if (windowed && !published) {
+            // The transport has closed the socket; step() reconnects and
+            // sends the window, this one included
+            Serial.printf("MQTT: Publish to %s failed, kept for the reconnect\n", message.topic);
+            queue.pop(message.sequence);
+            queue.failed();
+            isConnected = false;
+            lastQueueFailure = now ? now : 1;
+            break;
+        }
+        if (!published) {
+            // Stays at the front; step() notices the lost link and reconnects.
+            // Telemetry produced meanwhile goes to the spool.
+            if (!linkUp) {
+                isConnected = false;
+            } else if (message.sequence == failedSequence && ++failedAttempts >= MQTT_QUEUE_MAX_ATTEMPTS) {
+                // Refused on a working connection, most likely too large:
+                // do not let it block everything behind it
+                Serial.printf("MQTT: Dropping message to %s after %d attempts\n",
+                              message.topic, MQTT_QUEUE_MAX_ATTEMPTS);
+                queue.abandon(message.sequence);
+                failedAttempts = 0;
+                continue;
+            } else if (message.sequence != failedSequence) {
+                failedSequence = message.sequence;
+                failedAttempts = 1;
+            }
+            Serial.printf("MQTT: Queued publish to %s failed, retrying in %d ms\n",
+                          message.topic, MQTT_QUEUE_RETRY_MS);
+            queue.failed();
+            lastQueueFailure = now ? now : 1;
+            break;
+        }
+        queue.pop(message.sequence);
+        sent++;
     }
-    
-    return false;
+    return sent;
 }
 
 bool MQTTManager::publishSensorData(const String& payload) {
@@ -301,15 +302,41 @@ bool MQTTManager::publishRelayCommand(const String& payload) {
     return publish(mqttTopicRelay, payload);
 }
 
+bool MQTTManager::enqueueTelemetry(const char* topic, const char* payload, bool retained) {
+    if (!payload) {
+        Serial.printf("MQTT: Payload for %s did not fit, not queued\n", topic);
+        return false;
+    }
+    MessageSpool& spool = MessageSpool::getInstance();
+    if (isConnected && spool.depth() == 0 && enqueue(topic, payload, retained)) {
+        return true;
+    }
+    return spool.store(topic, payload, retained);
+}
+
+void MQTTManager::replaySpool() {
+    unsigned long now = millis();
+    if (!isConnected || now - lastReplay < MQTT_SPOOL_REPLAY_INTERVAL) {
+        return;
+    }
+
+    // Through the queue like everything else; a full queue is the broker
+    // not keeping up, so the message simply waits for the next turn
+    MessageSpool& spool = MessageSpool::getInstance();
+    MessageSpool::Message message;
+    if (spool.front(message) && enqueue(message.topic, message.payload, message.retained)) {
+        spool.pop(message);
+        lastReplay = now;
+    }
+}
+
 void MQTTManager::forceDisconnect() {
+    ClientGuard guard(clientLock);
+
     // Properly clean up any existing connection
     if (mqttClient.connected()) {
         // Try to publish offline status before disconnecting
-        String uniqueClientId = MQTT_CLIENT_ID;
-        uniqueClientId.replace(":", "");
-        String statusTopic = String("chaoticvolt/") + uniqueClientId + "/sensor/status";
-        
-        mqttClient.publish(statusTopic.c_str(), "offline", true);
+        mqttClient.publish(MQTTTopics::STATUS, "offline", true);
         delay(10);  // Brief delay to allow message to be sent
         
         mqttClient.disconnect();
@@ -317,131 +344,363 @@ void MQTTManager::forceDisconnect() {
     
     // Always stop the WiFi client to ensure socket is closed
     wifiClient.stop();
+    closePendingSocket();
     
     // Reset state variables
+    if (state == ConnectionState::CONNECTED) {
+        downSince = millis();
+        outageAttempts = 0;
+    }
     isConnected = false;
-    lastReconnectAttempt = 0;
     currentReconnectDelay = INITIAL_RECONNECT_DELAY;
+    setState(ConnectionState::IDLE);
+}
+
+void MQTTManager::requestReconnect() {
+    reconnectRequested.store(true);
+    PublishQueue::getInstance().wake();
 }
 
 bool MQTTManager::connect() {
-    // Reset watchdog to avoid timeouts during connection process
-    esp_task_wdt_reset();
-    
-    // Ensure any existing connections are fully closed
-    mqttClient.disconnect();
-    delay(50);
-    wifiClient.stop();
-    delay(100);
-    
-    // Use the consistent client ID from configuration
-    String uniqueClientId = MQTT_CLIENT_ID;
-    
-    Serial.printf("[MQTT] Connecting to broker %s:%d with client ID: %s\n", 
-                 mqttBroker.c_str(), mqttPort, uniqueClientId.c_str());
-    
-    // First test raw TCP connection to verify network path is clear
-    Serial.printf("[MQTT] Testing TCP connection to %s:%d...\n", mqttBroker.c_str(), mqttPort);
-    WiFiClient testClient;
-    testClient.setTimeout(5000); // 5 second timeout for connection test
-    
-    if (!testClient.connect(mqttBroker.c_str(), mqttPort)) {
-        Serial.println("[MQTT] TCP connection test failed - basic connectivity issue");
-        Serial.printf("[MQTT] Connection error: %d\n", testClient.getWriteError());
-        testClient.stop();
+    // Only a stopped connection is started here. An attempt under way
+    // finishes, and a backoff runs out first, so there is one retry policy.
+    if (state == ConnectionState::IDLE) {
+        Serial.printf("[MQTT] Connecting to broker %s:%d\n", mqttBroker.c_str(), mqttPort);
+        if (downSince == 0) {
+            downSince = millis();
+        }
+        startAttempt();
+    }
+    return connected();
+}
+
+const char* MQTTManager::stateName(ConnectionState state) {
+    switch (state) {
+        case ConnectionState::IDLE: return "idle";
+        case ConnectionState::RESOLVING: return "resolving";
+        case ConnectionState::CONNECTING: return "connecting";
+        case ConnectionState::HANDSHAKE: return "handshake";
+        case ConnectionState::SUBSCRIBING: return "subscribing";
+        case ConnectionState::CONNECTED: return "connected";
+        case ConnectionState::BACKOFF: return "backoff";
+    }
+    return "unknown";
+}
+
+void MQTTManager::setState(ConnectionState next) {
+    state = next;
+    stateSince = millis();
+}
+
+void MQTTManager::startAttempt() {
+    outageAttempts++;
+    portENTER_CRITICAL(&statsLock);
+    connectionStats.attempts++;
+    portEXIT_CRITICAL(&statsLock);
+    setState(ConnectionState::RESOLVING);
+    startResolve();
+}
+
+void MQTTManager::startResolve() {
+    resolvedAddress.store(0);
+    resolveFailed.store(false);
+    snprintf(resolvingName, sizeof(resolvingName), "%s", mqttBroker.c_str());
+
+    // Addresses and cached names come back at once, the rest through dnsFound
+    ip_addr_t address;
+    err_t err = dnsLookup(resolvingName, &address, dnsFound, this);
+    if (err == ERR_OK) {
+        resolvedAddress.store(address.u_addr.ip4.addr);
+    } else if (err != ERR_INPROGRESS) {
+        resolveFailed.store(true);
+    }
+}
+
+void MQTTManager::dnsFound(const char* name, const ip_addr_t* ipaddr, void* arg) {
+    MQTTManager* manager = static_cast<MQTTManager*>(arg);
+    if (!name || strcmp(name, manager->resolvingName) != 0) {
+        return;  // Answer for a lookup that has been abandoned
+    }
+    if (ipaddr && ipaddr->type == IPADDR_TYPE_V4 && ipaddr->u_addr.ip4.addr != 0) {
+        manager->resolvedAddress.store(ipaddr->u_addr.ip4.addr);
+    } else {
+        manager->resolveFailed.store(true);
+    }
+}
+
+bool MQTTManager::startTcpConnect(uint32_t address) {
+    int fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (fd < 0) {
         return false;
     }
-    
-    Serial.println("[MQTT] TCP connection test successful");
-    testClient.stop();
-    delay(100);
-    
-    // Configure longer timeout for the WiFi client
-    wifiClient.setTimeout(15000);  // 15 seconds timeout
-    
-    // Set up Last Will and Testament for clean disconnection detection
-    String statusTopic = String("chaoticvolt/") + uniqueClientId + "/sensor/status";
-    
-    // Reset watchdog again before actual MQTT connection
-    esp_task_wdt_reset();
-    
-    // Connect with credentials if available
-    bool result = false;
-    
-    if (mqttUsername.length() > 0) {
-        Serial.printf("[MQTT] Connecting with credentials: %s\n", mqttUsername.c_str());
-        Serial.printf("[MQTT] Password length: %d characters\n", mqttPassword.length());
-        
-        result = mqttClient.connect(
-            uniqueClientId.c_str(),
-            mqttUsername.c_str(), 
-            mqttPassword.c_str(),
-            statusTopic.c_str(),  // LWT topic
-            0,                    // QoS
-            true,                 // Retain
-            "offline"             // LWT message
-        );
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+    struct sockaddr_in broker;
+    memset(&broker, 0, sizeof(broker));
+    broker.sin_family = AF_INET;
+    broker.sin_addr.s_addr = address;
+    broker.sin_port = htons(mqttPort);
+    if (::connect(fd, reinterpret_cast<struct sockaddr*>(&broker), sizeof(broker)) < 0 &&
+        errno != EINPROGRESS) {
+        close(fd);
+        return false;
+    }
+    pendingSocket = fd;
+    return true;
+}
+
+MQTTManager::TcpProgress MQTTManager::pollTcpConnect() {
+    fd_set writable;
+    FD_ZERO(&writable);
+    FD_SET(pendingSocket, &writable);
+    struct timeval immediately = {0, 0};
+    int ready = select(pendingSocket + 1, nullptr, &writable, nullptr, &immediately);
+    if (ready == 0) {
+        return TcpProgress::WAITING;
+    }
+
+    int error = 0;
+    socklen_t length = sizeof(error);
+    if (ready < 0 || getsockopt(pendingSocket, SOL_SOCKET, SO_ERROR, &error, &length) < 0 || error != 0) {
+        closePendingSocket();
+        return TcpProgress::FAILED;
+    }
+
+    // Back to blocking, the way WiFiClient::connect() leaves its sockets,
+    // and handed over to the client, which closes it from now on
+    fcntl(pendingSocket, F_SETFL, fcntl(pendingSocket, F_GETFL, 0) & ~O_NONBLOCK);
+    wifiClient = WiFiClient(pendingSocket);
+    pendingSocket = -1;
+    return TcpProgress::CONNECTED;
+}
+
+void MQTTManager::closePendingSocket() {
+    if (pendingSocket >= 0) {
+        close(pendingSocket);
+        pendingSocket = -1;
+    }
+}
+
+uint32_t MQTTManager::retryLater(const char* reason) {
+    {
+        ClientGuard guard(clientLock);
+        mqttClient.disconnect();
+        wifiClient.stop();
+        closePendingSocket();
+    }
+    isConnected = false;
+
+    unsigned long now = millis();
+    bool dropped = state == ConnectionState::CONNECTED;
+    bool flap = dropped && now - connectedAt < MQTT_STABLE_CONNECTION;
+    portENTER_CRITICAL(&statsLock);
+    if (dropped) {
+        connectionStats.drops++;
+        if (flap) {
+            connectionStats.flaps++;
+        }
     } else {
-        Serial.println("[MQTT] Connecting without credentials");
-        result = mqttClient.connect(uniqueClientId.c_str());
+        connectionStats.failures++;
     }
-    
-    // Reset watchdog after connection attempt
-    esp_task_wdt_reset();
-    
-    if (result) {
-        Serial.println("[MQTT] Connected successfully!");
-        isConnected = true;
-        
-        // Immediate publish of online status with retain flag
-        if (!mqttClient.publish(statusTopic.c_str(), "online", true)) {
-            Serial.println("[MQTT] Failed to publish initial status message");
-        } else {
-            Serial.println("[MQTT] Published online status");
+    portEXIT_CRITICAL(&statsLock);
+    if (dropped) {
+        downSince = now;
+        outageAttempts = 0;
+    }
+
+    // Somewhere in the upper half of the current delay
+    uint32_t delayMs = currentReconnectDelay / 2 + random(currentReconnectDelay / 2 + 1);
+    Serial.printf("[MQTT] %s%s, next attempt in %lu ms\n", reason, flap ? " (flapping)" : "",
+                  (unsigned long)delayMs);
+    nextAttempt = now + delayMs;
+    currentReconnectDelay = std::min(currentReconnectDelay * 2, (unsigned long)MAX_RECONNECT_DELAY);
+    setState(ConnectionState::BACKOFF);
+    return delayMs;
+}
+
+MQTTManager::ConnectionStats MQTTManager::getConnectionStats() const {
+    portENTER_CRITICAL(&statsLock);
+    ConnectionStats copy = connectionStats;
+    portEXIT_CRITICAL(&statsLock);
+    copy.backoffMs = currentReconnectDelay;
+    return copy;
+}
+
+uint32_t MQTTManager::step() {
+    unsigned long now = millis();
+
+    // Only a live connection is dropped; an attempt under way or a backoff
+    // is left to run its course
+    if (reconnectRequested.exchange(false) && state == ConnectionState::CONNECTED) {
+        return retryLater("Reconnect requested");
+    }
+
+    switch (state) {
+        case ConnectionState::IDLE:
+            return 1000;
+
+        case ConnectionState::BACKOFF:
+            if ((long)(now - nextAttempt) < 0) {
+                return nextAttempt - now;
+            }
+            startAttempt();
+            return 0;
+
+        case ConnectionState::RESOLVING: {
+            // Looked up once per attempt, so a changed DHCP lease or DNS
+            // record is picked up, but never twice for the same connection
+            uint32_t address = resolvedAddress.load();
+            if (address == 0) {
+                if (resolveFailed.load()) {
+                    return retryLater("Broker name did not resolve");
+                }
+                if (now - stateSince >= MQTT_CONNECT_TIMEOUT_MS) {
+                    return retryLater("Broker name lookup timed out");
+                }
+                return MQTT_POLL_MS;
+            }
+            ClientGuard guard(clientLock);
+            wifiClient.stop();
+            if (!startTcpConnect(address)) {
+                return retryLater("TCP connect failed");
+            }
+            setState(ConnectionState::CONNECTING);
+            return 0;
         }
-        
-        // Subscribe to needed topics
-        String relayTopic = String("chaoticvolt/") + uniqueClientId + "/relay/command";
-        if (!mqttClient.subscribe(relayTopic.c_str())) {
-            Serial.println("[MQTT] Failed to subscribe to relay topic");
-        } else {
-            Serial.printf("[MQTT] Subscribed to topic: %s\n", relayTopic.c_str());
+
+        case ConnectionState::CONNECTING: {
+            ClientGuard guard(clientLock);
+            switch (pollTcpConnect()) {
+                case TcpProgress::CONNECTED:
+                    break;
+                case TcpProgress::FAILED:
+                    return retryLater("TCP connect failed");
+                case TcpProgress::WAITING:
+                    if (now - stateSince >= MQTT_CONNECT_TIMEOUT_MS) {
+                        return retryLater("TCP connect timed out");
+                    }
+                    return MQTT_POLL_MS;
+            }
+
+            // Keep the session, so the broker holds on to what it has not
+            // acknowledged and says so in the CONNACK
+            bool credentials = mqttUsername.length() > 0;
+            if (!mqttClient.connect(
+                    MQTT_CLIENT_ID,
+                    credentials ? mqttUsername.c_str() : nullptr,
+                    credentials ? mqttPassword.c_str() : nullptr,
+                    MQTTTopics::STATUS,   // LWT topic
+                    "offline",            // LWT message
+                    MQTT_QOS,
+                    true,                 // Retain
+                    false)) {             // Clean session
+                return retryLater("Sending CONNECT failed");
+            }
+            setState(ConnectionState::HANDSHAKE);
+            return 0;
         }
-        
-        // Reset reconnection parameters on successful connection
-        currentReconnectDelay = INITIAL_RECONNECT_DELAY;
-    } else {
-        int state = mqttClient.state();
-        Serial.printf("[MQTT] Connection failed, state: %d\n", state);
-        
-        // Detailed error reporting
-        switch(state) {
-            case -4: Serial.println("[MQTT] Connection timeout"); break;
-            case -3: Serial.println("[MQTT] Connection lost"); break;
-            case -2: Serial.println("[MQTT] Connection failed"); break;
-            case -1: Serial.println("[MQTT] Client disconnected"); break;
-            case 1: Serial.println("[MQTT] Bad protocol version"); break;
-            case 2: Serial.println("[MQTT] Bad client ID"); break;
-            case 3: Serial.println("[MQTT] Server unavailable"); break;
-            case 4: Serial.println("[MQTT] Bad username/password"); break;
-            case 5: Serial.println("[MQTT] Not authorized"); break;
-            default: Serial.println("[MQTT] Unknown error"); break;
+
+        case ConnectionState::HANDSHAKE: {
+            ClientGuard guard(clientLock);
+            switch (mqttClient.pollConnack(sessionPresent)) {
+                case MQTTTransport::Handshake::ACCEPTED:
+                    if (!mqttClient.publish(MQTTTopics::STATUS, "online", true) ||
+                        !mqttClient.subscribe(MQTTTopics::RELAY_COMMAND) ||
+                        !mqttClient.subscribe(MQTTTopics::DISPLAY_MESSAGE)) {
+                        return retryLater("Subscribing failed");
+                    }
+                    setState(ConnectionState::SUBSCRIBING);
+                    return 0;
+                case MQTTTransport::Handshake::FAILED:
+                    logState("connect");
+                    return retryLater("MQTT handshake failed");
+                case MQTTTransport::Handshake::WAITING:
+                    break;
+            }
+            if (now - stateSince >= MQTT_CONNECT_TIMEOUT_MS) {
+                return retryLater("No CONNACK");
+            }
+            return MQTT_POLL_MS;
+        }
+
+        case ConnectionState::SUBSCRIBING: {
+            ClientGuard guard(clientLock);
+            switch (mqttClient.pollSubacks()) {
+                case MQTTTransport::Handshake::ACCEPTED:
+                    break;
+                case MQTTTransport::Handshake::FAILED:
+                    return retryLater("Subscribing failed");
+                case MQTTTransport::Handshake::WAITING:
+                    if (now - stateSince >= MQTT_CONNECT_TIMEOUT_MS) {
+                        return retryLater("No SUBACK");
+                    }
+                    return MQTT_POLL_MS;
+            }
+
+            // Whatever was not acknowledged before goes again, with the
+            // same packet IDs. DUP only when the broker resumed the session,
+            // otherwise it has no record of the earlier attempt.
+            InFlightWindow::Message message;
+            uint16_t packetId;
+            uint8_t resent = 0;
+            for (uint8_t i = 0; window.get(i, message, packetId); i++) {
+                if (!mqttClient.publish(message.topic, message.payload, message.retained, MQTT_QOS, packetId,
+                                        sessionPresent)) {
+                    // Still in the window for the next connection
+                    return retryLater("Sending unacknowledged messages failed");
+                }
+                window.resent(i);
+                resent++;
+            }
+            if (resent > 0) {
+                Serial.printf("[MQTT] Sent %u unacknowledged message(s) again, session %s\n", resent,
+                              sessionPresent ? "resumed" : "new");
+            }
+            uint32_t outage = now - downSince;
+            Serial.printf("[MQTT] Connected to %s:%d after %u attempt(s), %lu ms\n", mqttBroker.c_str(),
+                          mqttPort, outageAttempts, (unsigned long)outage);
+            portENTER_CRITICAL(&statsLock);
+            connectionStats.connects++;
+            connectionStats.lastReconnectMs = outage;
+            connectionStats.maxReconnectMs = std::max(connectionStats.maxReconnectMs, outage);
+            portEXIT_CRITICAL(&statsLock);
+            connectedAt = now;
+            isConnected = true;
+            setState(ConnectionState::CONNECTED);
+            return 0;
+        }
+
+        case ConnectionState::CONNECTED: {
+            // Read here as well, so PUBACKs are not held up by a busy loop()
+            bool alive;
+            uint32_t ackAge;
+            uint8_t inFlight;
+            {
+                ClientGuard guard(clientLock);
+                alive = mqttClient.loop();
+                ackAge = window.oldestAgeMs();
+                inFlight = window.depth();
+            }
+            if (!alive) {
+                return retryLater("Connection lost");
+            }
+            if (ackAge > MQTT_ACK_TIMEOUT_MS) {
+                // The link looks up but carries nothing; the reconnect
+                // sends the window again
+                return retryLater("No PUBACK");
+            }
+            if (currentReconnectDelay != INITIAL_RECONNECT_DELAY && now - connectedAt >= MQTT_STABLE_CONNECTION) {
+                currentReconnectDelay = INITIAL_RECONNECT_DELAY;
+            }
+            return inFlight > 0 ? MQTT_POLL_MS : 1000;
         }
-        
-        // Additional diagnostics
-        Serial.printf("[MQTT] Using broker: %s:%d\n", mqttBroker.c_str(), mqttPort);
-        Serial.printf("[MQTT] Username: %s (length: %d)\n", mqttUsername.c_str(), mqttUsername.length());
-        Serial.printf("[MQTT] Password length: %d\n", mqttPassword.length());
-        Serial.printf("[MQTT] Client ID: %s\n", uniqueClientId.c_str());
-        
-        isConnected = false;
     }
-    
-    return isConnected;
+    return 1000;
 }
 
 
 bool MQTTManager::subscribe(const char* topic) {
+    ClientGuard guard(clientLock);
     if (!mqttClient.connected()) {
         Serial.println("MQTT: Cannot subscribe - not connected");
         return false;
@@ -497,6 +756,14 @@ void MQTTManager::callback(char* topic, byte* payload, unsigned int length) {
         handleMessage(topic, payload, length);
     }
     
+    // Text for the display; an empty payload cancels the running message
+    if (strcmp(topic, MQTTTopics::DISPLAY_MESSAGE) == 0) {
+        DisplayHandler* display = GlobalState::getInstance().getDisplay();
+        if (display) {
+            display->showMessage(message.c_str());
+        }
+    }
+    
     // Call any registered handler
     if (messageHandler) {
         messageHandler(String(topic), message);
@@ -548,8 +815,7 @@ void MQTTManager::handleCallback(char* topic, byte* payload, unsigned int length
     Serial.printf("MQTT: Received message on topic: %s\n", topic);
     
     // Check if this is a relay command
-    String relayCommandTopic = String("chaoticvolt/") + String(MQTT_CLIENT_ID) + "/" + String(MQTT_TOPIC_RELAY) + "/command";
-    if (String(topic) == relayCommandTopic) {
+    if (strcmp(topic, MQTTTopics::RELAY_COMMAND) == 0) {
         Serial.println("MQTT: Received relay command");
         
         // Handle relay commands
@@ -574,36 +840,85 @@ bool MQTTManager::isConnectedToMQTT() const {
 }
 
 void MQTTManager::setBufferSize(uint16_t size) {
-    mqttClient.setBufferSize(size);
+    // The transport's buffers are fixed at MQTT_BUFFER_SIZE
+    if (size > MQTT_BUFFER_SIZE) {
+        Serial.printf("MQTT: Buffer size %u requested, fixed at %d\n", size, MQTT_BUFFER_SIZE);
+    }
+}
+
+uint16_t MQTTManager::nextPacketId() {
+    do {
+        if (++lastPacketId == 0) {
+            lastPacketId = 1;
+        }
+    } while (window.contains(lastPacketId));
+    return lastPacketId;
+}
+
+void MQTTManager::handleAck(uint16_t packetId) {
+    if (!window.acknowledge(packetId)) {
+        Serial.printf("MQTT: PUBACK for unknown packet %u\n", packetId);
+        return;
+    }
+    // Room in the window again
+    PublishQueue::getInstance().wake();
+}
+
+InFlightWindow::Stats MQTTManager::getInFlightStats() const {
+    return window.getStats();
 }
 
 bool MQTTManager::publishHomeAssistantDiscovery() {
-    Serial.println("Publishing Home Assistant discovery with consistent device identification");
-    
-    // Increase the MQTT buffer size
-    setBufferSize(1024);
-    
-    // Publish discovery information for temperature and humidity - one at a time with delay
-    bool tempSuccess = publishSensorDiscovery("temperature", "°C", "temperature");
-    delay(500); // Add delay between publications to avoid stack issues
-    
-    bool humSuccess = publishSensorDiscovery("humidity", "%", "humidity");
-    
-    return tempSuccess && humSuccess;
+    // Per sensor; the derived ones come from ComfortMetrics in the same
+    // state payload
+    static const char* const entities[][3] = {
+        // Format: sensor type, unit, device class
+        {"temperature", "°C", "temperature"},
+        {"humidity", "%", "humidity"},
+        {"dew_point", "°C", "temperature"},
+        {"absolute_humidity", "g/m³", ""},
+        {"heat_index", "°C", "temperature"},
+        {"sea_level_pressure", "hPa", "pressure"}
+    };
+    const uint8_t perSensor = sizeof(entities) / sizeof(entities[0]);
+    const uint16_t total = SensorRegistry::getInstance().count() * perSensor;
+
+    if (discoveryNext == 0) {
+        if (!enqueue(MQTTTopics::STATUS, "online", true)) {
+            return false;
+        }
+        Serial.printf("Queueing Home Assistant discovery for %u entities\n", total);
+    }
+
+    // A full queue stops here; the next call carries on from this entity
+    while (discoveryNext < total) {
+        const char* const* entity = entities[discoveryNext % perSensor];
+        if (!publishSensorDiscovery(entity[0], entity[1], entity[2], discoveryNext / perSensor)) {
+            return false;
+        }
+        discoveryNext++;
+    }
+    discoveryNext = 0;
+    return true;
 }
 
-bool MQTTManager::publishSensorDiscovery(const char* sensorType, const char* unit, const char* deviceClass) {
-    if (!connected()) {
-        Serial.println("MQTT: Cannot publish discovery - not connected");
-        return false;
+void MQTTManager::sensorStateTopic(uint8_t sensor, char* topic, size_t size) {
+    if (sensor == 0) {
+        snprintf(topic, size, "%s", MQTTTopics::SENSORS);
+    } else {
+        snprintf(topic, size, "%s/%u", MQTTTopics::SENSORS, sensor);
     }
-    
-    // First, set a larger buffer size for the MQTT client to handle larger payloads
-    setBufferSize(1024);
-    
+}
+
+bool MQTTManager::publishSensorDiscovery(const char* sensorType, const char* unit, const char* deviceClass,
+                                         uint8_t sensor) {
     // Create a unique ID with a version suffix to force fresh entity creation
     char uniqueId[64];
-    sprintf(uniqueId, "%s_%s_v3", MQTT_CLIENT_ID, sensorType);
+    if (sensor == 0) {
+        sprintf(uniqueId, "%s_%s_v3", MQTT_CLIENT_ID, sensorType);
+    } else {
+        sprintf(uniqueId, "%s_%s_%u_v3", MQTT_CLIENT_ID, sensorType, sensor);
+    }
     
     // Create the discovery topic
     char discoveryTopic[128];
@@ -611,7 +926,11 @@ bool MQTTManager::publishSensorDiscovery(const char* sensorType, const char* uni
     
     // Create a friendly display name
     char displayName[64];
-    sprintf(displayName, "%s %s", MQTT_CLIENT_ID, sensorType);
+    if (sensor == 0) {
+        sprintf(displayName, "%s %s", MQTT_CLIENT_ID, sensorType);
+    } else {
+        sprintf(displayName, "%s %s %u", MQTT_CLIENT_ID, sensorType, sensor);
+    }
     
     // Construct all components of the payload directly using a StaticJsonDocument
     StaticJsonDocument<512> doc;
@@ -634,7 +953,7 @@ bool MQTTManager::publishSensorDiscovery(const char* sensorType, const char* uni
     
     // Construct state topic directly with sprintf
     char stateTopic[128];
-    sprintf(stateTopic, "chaoticvolt/%s/%s/sensors", MQTT_CLIENT_ID, MQTT_TOPIC_AUX_DISPLAY);
+    sensorStateTopic(sensor, stateTopic, sizeof(stateTopic));
     doc["stat_t"] = stateTopic;
     
     // Set the value template
@@ -656,27 +975,12 @@ bool MQTTManager::publishSensorDiscovery(const char* sensorType, const char* uni
     char payload[512];
     serializeJson(doc, payload, sizeof(payload));
     
-    // Print the exact payload for debugging
-    Serial.println("=== SENSOR DISCOVERY PAYLOAD ===");
-    Serial.println(payload);
-    Serial.println("===============================");
-    
-    // First publish the status as "online" to ensure entity is available
-    publish(availabilityTopic, "online", true);
-    delay(100); // Short delay
-    
-    // Then publish the discovery configuration
-    bool success = publish(discoveryTopic, payload, true);
-    
-    if (success) {
-        Serial.printf("Successfully published discovery for %s sensor\n", sensorType);
-    } else {
-        Serial.printf("Failed to publish discovery for %s sensor\n", sensorType);
+    // Retained, so a queued copy from an earlier round is replaced
+    if (!enqueue(discoveryTopic, payload, true)) {
+        return false;
     }
-    
-    delay(200); // Allow time for broker processing
-    
-    return success;
+    Serial.printf("Queued discovery for %s sensor %u\n", sensorType, sensor);
+    return true;
 }
 
 void MQTTManager::dumpConnectionDetails() {
@@ -685,20 +989,10 @@ void MQTTManager::dumpConnectionDetails() {
     Serial.printf("Username: '%s' (length=%d)\n", mqttUsername.c_str(), mqttUsername.length());
     Serial.printf("Password: (length=%d)\n", mqttPassword.length()); 
     Serial.printf("Client ID: '%s'\n", MQTT_CLIENT_ID);
-    Serial.printf("Last reconnect attempt: %lu ms ago\n", millis() - lastReconnectAttempt);
+    Serial.printf("Connection state: %s for %lu ms\n", stateName(state), millis() - stateSince);
     Serial.printf("Current reconnect delay: %lu ms\n", currentReconnectDelay);
     Serial.printf("Connected state: %s\n", mqttClient.connected() ? "YES" : "NO");
     Serial.printf("Internal state tracker: %s\n", isConnected ? "Connected" : "Disconnected");
     
-    // Test direct TCP connection
-    WiFiClient testClient;
-    testClient.setTimeout(5000);
-    bool tcpTest = testClient.connect(mqttBroker.c_str(), mqttPort);
-    Serial.printf("TCP connection test: %s\n", tcpTest ? "SUCCESS" : "FAILED");
-    if (!tcpTest) {
-        Serial.printf("TCP error: %d\n", testClient.getWriteError());
-    }
-    testClient.stop();
-    
     Serial.println("=======================================");
 }
@@ -0,0 +1,398 @@
+#include "MQTTTransport.h"
+
+namespace {
+
+// Packet types, upper nibble of the fixed header
+const uint8_t CONNECT = 0x10;
+const uint8_t CONNACK = 0x20;
+const uint8_t PUBLISH = 0x30;
+const uint8_t PUBACK = 0x40;
+const uint8_t SUBSCRIBE = 0x80;
+const uint8_t SUBACK = 0x90;
+const uint8_t PINGREQ = 0xC0;
+const uint8_t PINGRESP = 0xD0;
+const uint8_t DISCONNECT = 0xE0;
+
+const uint8_t FLAG_DUP = 0x08;
+const uint8_t FLAG_RETAIN = 0x01;
+
+} // namespace
+
+MQTTTransport::MQTTTransport(Client& client)
+    : client(client),
+      keepAlive(30),
+      nextSubscribeId(0),
+      connectionState(DISCONNECTED),
+      connackReceived(false),
+      sessionPresent(false),
+      connackCode(0),
+      pingOutstanding(false),
+      subacksPending(0),
+      subscribeRefused(false),
+      lastOutbound(0),
+      lastInbound(0),
+      receive(Receive::HEADER),
+      rxHeader(0),
+      rxLength(0),
+      rxMultiplier(1),
+      rxReceived(0)
+{
+}
+
+bool MQTTTransport::connect(const char* clientId, const char* user, const char* password,
+                            const char* willTopic, const char* willMessage, uint8_t willQos,
+                            bool willRetain, bool cleanSession) {
+    if (!client.connected()) {
+        connectionState = CONNECT_FAILED;
+        return false;
+    }
+    connectionState = DISCONNECTED;
+    connackReceived = false;
+    subacksPending = 0;
+    subscribeRefused = false;
+    receive = Receive::HEADER;
+
+    static const uint8_t protocol[] = {0x00, 0x04, 'M', 'Q', 'T', 'T', 0x04};
+    size_t length = HEADER_ROOM;
+    memcpy(txBuffer + length, protocol, sizeof(protocol));
+    length += sizeof(protocol);
+
+    uint8_t flags = cleanSession ? 0x02 : 0x00;
+    if (willTopic) {
+        flags |= 0x04 | (willQos << 3) | (willRetain ? 0x20 : 0x00);
+    }
+    if (user) {
+        flags |= 0x80;
+        if (password) {
+            flags |= 0x40;
+        }
+    }
+    txBuffer[length++] = flags;
+    txBuffer[length++] = keepAlive >> 8;
+    txBuffer[length++] = keepAlive & 0xFF;
+
+    length = writeString(clientId, length);
+    if (willTopic) {
+        length = writeString(willTopic, length);
+        length = writeString(willMessage ? willMessage : "", length);
+    }
+    if (user) {
+        length = writeString(user, length);
+        if (password) {
+            length = writeString(password, length);
+        }
+    }
+    if (length == 0) {
+        connectionState = CONNECT_FAILED;
+        return false;
+    }
+
+    lastInbound = millis();
+    return writePacket(CONNECT, length - HEADER_ROOM);
+}
+
+MQTTTransport::Handshake MQTTTransport::pollConnack(bool& present) {
+    while (!connackReceived && readPacket()) {
+        handlePacket();
+    }
+    if (connackReceived) {
+        if (connackCode != 0) {
+            connectionState = connackCode;
+            client.stop();
+            return Handshake::FAILED;
+        }
+        present = sessionPresent;
+        connectionState = CONNECTED;
+        pingOutstanding = false;
+        return Handshake::ACCEPTED;
+    }
+    if (!client.connected()) {
+        connectionState = CONNECT_FAILED;
+        return Handshake::FAILED;
+    }
+    return Handshake::WAITING;
+}
+
+bool MQTTTransport::publish(const char* topic, const char* payload, bool retained,
+                            uint8_t qos, uint16_t packetId, bool duplicate) {
+    if (!connected()) {
+        return false;
+    }
+    size_t payloadLength = strlen(payload);
+    size_t length = writeString(topic, HEADER_ROOM);
+    if (length == 0 || length + (qos ? 2 : 0) + payloadLength > sizeof(txBuffer)) {
+        return false;
+    }
+    if (qos) {
+        txBuffer[length++] = packetId >> 8;
+        txBuffer[length++] = packetId & 0xFF;
+    }
+    memcpy(txBuffer + length, payload, payloadLength);
+    length += payloadLength;
+
+    uint8_t header = PUBLISH | (qos << 1);
+    if (retained) {
+        header |= FLAG_RETAIN;
+    }
+    if (duplicate && qos) {
+        header |= FLAG_DUP;
+    }
+    return writePacket(header, length - HEADER_ROOM);
+}
+
+bool MQTTTransport::subscribe(const char* topic, uint8_t qos) {
+    if (!connected()) {
+        return false;
+    }
+    if (++nextSubscribeId == 0) {
+        nextSubscribeId = 1;
+    }
+    size_t length = HEADER_ROOM;
+    txBuffer[length++] = nextSubscribeId >> 8;
+    txBuffer[length++] = nextSubscribeId & 0xFF;
+    length = writeString(topic, length);
+    if (length == 0 || length + 1 > sizeof(txBuffer)) {
+        return false;
+    }
+    txBuffer[length++] = qos;
+    if (!writePacket(SUBSCRIBE | 0x02, length - HEADER_ROOM)) {
+        return false;
+    }
+    subacksPending++;
+    return true;
+}
+
+MQTTTransport::Handshake MQTTTransport::pollSubacks() {
+    while (subacksPending > 0 && !subscribeRefused && readPacket()) {
+        handlePacket();
+    }
+    if (subscribeRefused || !connected()) {
+        return Handshake::FAILED;
+    }
+    return subacksPending > 0 ? Handshake::WAITING : Handshake::ACCEPTED;
+}
+
+bool MQTTTransport::loop() {
+    if (!connected()) {
+        return false;
+    }
+
+    // Keep alive: ping when idle, give up when the ping is not answered
+    unsigned long now = millis();
+    unsigned long interval = keepAlive * 1000UL;
+    if (keepAlive && (now - lastInbound > interval || now - lastOutbound > interval)) {
+        if (pingOutstanding) {
+            closeSocket(CONNECTION_TIMEOUT);
+            return false;
+        }
+        sendShort(PINGREQ, 0);
+        lastInbound = now;
+        pingOutstanding = true;
+    }
+
+    while (readPacket()) {
+        handlePacket();
+    }
+    return connected();
+}
+
+bool MQTTTransport::connected() {
+    if (!client.connected()) {
+        if (connectionState == CONNECTED) {
+            closeSocket(CONNECTION_LOST);
+        }
+        return false;
+    }
+    return connectionState == CONNECTED;
+}
+
+void MQTTTransport::disconnect() {
+    if (client.connected()) {
+        sendShort(DISCONNECT, 0);
+    }
+    closeSocket(DISCONNECTED);
+}
+
+void MQTTTransport::closeSocket(int reason) {
+    connectionState = reason;
+    receive = Receive::HEADER;
+    client.flush();
+    client.stop();
+}
+
+size_t MQTTTransport::writeString(const char* text, size_t offset) {
+    size_t length = strlen(text);
+    if (offset == 0 || offset + 2 + length > sizeof(txBuffer)) {
+        return 0;
+    }
+    txBuffer[offset++] = length >> 8;
+    txBuffer[offset++] = length & 0xFF;
+    memcpy(txBuffer + offset, text, length);
+    return offset + length;
+}
+
+bool MQTTTransport::writePacket(uint8_t header, size_t length) {
+    // Remaining length goes right in front of the variable header
+    uint8_t encoded[4];
+    uint8_t digits = 0;
+    size_t remaining = length;
+    do {
+        uint8_t digit = remaining & 0x7F;
+        remaining >>= 7;
+        if (remaining > 0) {
+            digit |= 0x80;
+        }
+        encoded[digits++] = digit;
+    } while (remaining > 0 && digits < sizeof(encoded));
+
+    size_t start = HEADER_ROOM - 1 - digits;
+    txBuffer[start] = header;
+    memcpy(txBuffer + start + 1, encoded, digits);
+    size_t total = length + 1 + digits;
+    size_t written = client.write(txBuffer + start, total);
+    lastOutbound = millis();
+    if (written != total) {
+        // Part of a packet is on the wire; nothing sent after it would
+        // parse, so the connection is dropped and made again
+        closeSocket(CONNECTION_LOST);
+        return false;
+    }
+    return true;
+}
+
+void MQTTTransport::sendShort(uint8_t header, uint16_t packetId) {
+    uint8_t packet[4] = {header, 0, (uint8_t)(packetId >> 8), (uint8_t)(packetId & 0xFF)};
+    size_t length = 2;
+    if (header == PUBACK) {
+        packet[1] = 2;
+        length = 4;
+    }
+    if (client.write(packet, length) != length) {
+        closeSocket(CONNECTION_LOST);
+        return;
+    }
+    lastOutbound = millis();
+}
+
+bool MQTTTransport::readPacket() {
+    while (client.available() > 0) {
+        int value = client.read();
+        if (value < 0) {
+            break;
+        }
+        uint8_t byte = value;
+        lastInbound = millis();
+
+        switch (receive) {
+            case Receive::HEADER:
+                rxHeader = byte;
+                rxLength = 0;
+                rxMultiplier = 1;
+                rxReceived = 0;
+                receive = Receive::LENGTH;
+                break;
+
+            case Receive::LENGTH:
+                rxLength += (byte & 0x7F) * rxMultiplier;
+                rxMultiplier <<= 7;
+                if (byte & 0x80) {
+                    if (rxMultiplier > 0x200000) {
+                        // More than four length bytes: not MQTT
+                        closeSocket(CONNECTION_LOST);
+                        return false;
+                    }
+                    break;
+                }
+                if (rxLength == 0) {
+                    receive = Receive::HEADER;
+                    return true;
+                }
+                receive = Receive::BODY;
+                break;
+
+            case Receive::BODY:
+                // The part that does not fit is counted but not kept
+                if (rxReceived < MQTT_RX_BUFFER_SIZE) {
+                    rxBuffer[rxReceived] = byte;
+                }
+                if (++rxReceived == rxLength) {
+                    receive = Receive::HEADER;
+                    return true;
+                }
+                break;
+        }
+    }
+    return false;
+}
+
+void MQTTTransport::handlePacket() {
+    switch (rxHeader & 0xF0) {
+        case CONNACK:
+            if (rxLength >= 2) {
+                sessionPresent = rxBuffer[0] & 0x01;
+                connackCode = rxBuffer[1];
+                connackReceived = true;
+            }
+            break;
+
+        case PUBLISH:
+            handlePublish();
+            break;
+
+        case PUBACK:
+            if (rxLength >= 2 && ackCallback) {
+                ackCallback((rxBuffer[0] << 8) | rxBuffer[1]);
+            }
+            break;
+
+        case PINGREQ:
+            sendShort(PINGRESP, 0);
+            break;
+
+        case PINGRESP:
+            pingOutstanding = false;
+            break;
+
+        case SUBACK:
+            // 0x80 in place of the granted QoS is a refusal
+            if (subacksPending > 0) {
+                subacksPending--;
+            }
+            if (rxLength >= 3 && rxBuffer[2] == 0x80) {
+                subscribeRefused = true;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+void MQTTTransport::handlePublish() {
+    uint8_t qos = (rxHeader >> 1) & 0x03;
+    if (rxLength < 2) {
+        return;
+    }
+    uint16_t topicLength = (rxBuffer[0] << 8) | rxBuffer[1];
+    size_t offset = 2 + topicLength;
+    uint16_t packetId = 0;
+    if (qos > 0 && offset + 2 <= MQTT_RX_BUFFER_SIZE && offset + 2 <= rxLength) {
+        packetId = (rxBuffer[offset] << 8) | rxBuffer[offset + 1];
+        offset += 2;
+    }
+
+    if (rxLength > MQTT_RX_BUFFER_SIZE || offset > rxLength) {
+        Serial.printf("MQTT: Incoming message of %lu bytes dropped\n", (unsigned long)rxLength);
+    } else if (messageCallback) {
+        // Topic one byte down to make room for its terminator, as
+        // PubSubClient does; the payload is terminated as well
+        memmove(rxBuffer, rxBuffer + 2, topicLength);
+        rxBuffer[topicLength] = '\0';
+        rxBuffer[rxLength] = '\0';
+        messageCallback(reinterpret_cast<char*>(rxBuffer), rxBuffer + offset, rxLength - offset);
+    }
+
+    if (qos == 1 && packetId != 0) {
+        sendShort(PUBACK, packetId);
+    }
+}
@@ -0,0 +1,192 @@
+#include "MessageRing.h"
+
+MessageRing::MessageRing(uint8_t* storage, uint16_t capacity)
+    : storage(storage),
+      size(capacity & ~3),
+      head(0),
+      tail(0),
+      wrapAt(capacity & ~3),
+      wrapped(false),
+      records(0),
+      live(0),
+      used(0),
+      sequence(0)
+{
+}
+
+uint16_t MessageRing::recordSize(size_t topicLength, size_t payloadLength) {
+    return (HEADER_SIZE + topicLength + payloadLength + 2 + 3) & ~3;
+}
+
+uint16_t MessageRing::next(uint16_t offset) {
+    offset += at(offset)->size;
+    if (wrapped && offset == wrapAt) {
+        offset = 0;
+    }
+    return offset;
+}
+
+bool MessageRing::reserve(uint16_t length, uint16_t& offset) {
+    if (records == 0) {
+        head = tail = 0;
+        wrapped = false;
+    }
+    if (!wrapped) {
+        if (size - tail >= length) {
+            offset = tail;
+        } else if (head >= length) {
+            // No room before the end, continue at the beginning
+            wrapAt = tail;
+            wrapped = true;
+            offset = 0;
+        } else {
+            return false;
+        }
+    } else if (head - tail >= length) {
+        offset = tail;
+    } else {
+        return false;
+    }
+    tail = offset + length;
+    records++;
+    used += length;
+    return true;
+}
+
+void MessageRing::popFront() {
+    if (records == 0) {
+        return;
+    }
+    Record* record = at(head);
+    used -= record->size;
+    if (!(record->flags & DEAD)) {
+        live--;
+    }
+    records--;
+    head += record->size;
+    if (wrapped && head == wrapAt) {
+        head = 0;
+        wrapped = false;
+    }
+    if (records == 0) {
+        head = tail = 0;
+        wrapped = false;
+    }
+}
+
+void MessageRing::write(Record* record, const char* topic, size_t topicLength,
+                        const char* payload, size_t payloadLength, uint8_t flags, uint32_t stamp) {
+    record->flags = flags;
+    record->topicLength = topicLength;
+    record->payloadLength = payloadLength;
+    record->reserved = 0;
+    record->sequence = ++sequence;
+    record->stamp = stamp;
+    char* text = reinterpret_cast<char*>(record + 1);
+    memcpy(text, topic, topicLength + 1);
+    memcpy(text + topicLength + 1, payload, payloadLength + 1);
+}
+
+MessageRing::Result MessageRing::push(const char* topic, const char* payload, uint8_t flags,
+                                      uint32_t stamp, bool dropOldest, uint32_t& dropped) {
+    size_t topicLength = strlen(topic);
+    size_t payloadLength = strlen(payload);
+    uint16_t length = recordSize(topicLength, payloadLength);
+    if (topicLength > 255 || length > size) {
+        return FULL;
+    }
+    flags &= ~DEAD;
+
+    // A newer retained state supersedes the stored one
+    Record* replaced = nullptr;
+    if (flags & RETAINED) {
+        uint16_t offset = head;
+        for (uint16_t i = 0; i < records; i++, offset = next(offset)) {
+            Record* record = at(offset);
+            if ((record->flags & (RETAINED | DEAD)) == RETAINED &&
+                record->topicLength == topicLength &&
+                memcmp(record + 1, topic, topicLength) == 0) {
+                replaced = record;
+                break;
+            }
+        }
+    }
+    if (replaced && replaced->size >= length) {
+        write(replaced, topic, topicLength, payload, payloadLength, flags, stamp);
+        return COALESCED;
+    }
+    if (replaced) {
+        replaced->flags |= DEAD;
+        live--;
+    }
+
+    uint16_t offset;
+    while (!reserve(length, offset)) {
+        if (!dropOldest) {
+            if (replaced) {
+                // Nothing was dropped, the old state stays
+                replaced->flags &= ~DEAD;
+                live++;
+            }
+            return FULL;
+        }
+        if (!(at(head)->flags & DEAD)) {
+            dropped++;
+        }
+        popFront();
+    }
+
+    Record* record = at(offset);
+    record->size = length;
+    write(record, topic, topicLength, payload, payloadLength, flags, stamp);
+    live++;
+    return replaced ? COALESCED : STORED;
+}
+
+bool MessageRing::front(char* buffer, size_t bufferSize, Message& message) {
+    while (records > 0 && (at(head)->flags & DEAD)) {
+        popFront();
+    }
+    if (records == 0) {
+        return false;
+    }
+
+    return copy(at(head), buffer, bufferSize, message);
+}
+
+bool MessageRing::peek(uint16_t index, char* buffer, size_t bufferSize, Message& message) {
+    uint16_t offset = head;
+    for (uint16_t i = 0; i < records; i++, offset = next(offset)) {
+        Record* record = at(offset);
+        if (record->flags & DEAD) {
+            continue;
+        }
+        if (index-- == 0) {
+            return copy(record, buffer, bufferSize, message);
+        }
+    }
+    return false;
+}
+
+bool MessageRing::copy(Record* record, char* buffer, size_t bufferSize, Message& message) {
+    size_t length = record->topicLength + record->payloadLength + 2;
+    if (length > bufferSize) {
+        return false;
+    }
+    memcpy(buffer, record + 1, length);
+    message.topic = buffer;
+    message.payload = buffer + record->topicLength + 1;
+    message.retained = record->flags & RETAINED;
+    message.flags = record->flags;
+    message.sequence = record->sequence;
+    message.stamp = record->stamp;
+    return true;
+}
+
+bool MessageRing::pop(uint32_t sent) {
+    if (records > 0 && at(head)->sequence == sent) {
+        popFront();
+        return true;
+    }
+    return false;
+}
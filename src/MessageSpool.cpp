@@ -0,0 +1,344 @@
+#include "MessageSpool.h"
+#include "TimeService.h"
+#include <algorithm>
+
+namespace {
+
+const char* const SPOOL_DIR = "/spool";
+
+// Spilled message: this header, then topic and payload, both terminated
+struct SpillHeader {
+    uint16_t length;            // Header included
+    uint8_t flags;
+    uint8_t topicLength;
+    uint16_t payloadLength;
+    uint16_t reserved;
+    uint32_t stamp;
+};
+
+void segmentPath(uint32_t id, char* path, size_t size) {
+    snprintf(path, size, "%s/%08lx.bin", SPOOL_DIR, (unsigned long)id);
+}
+
+bool headerValid(const SpillHeader& header) {
+    return header.length == sizeof(SpillHeader) + header.topicLength + header.payloadLength + 2 &&
+           header.topicLength + header.payloadLength + 2 <= MQTT_QUEUE_MAX_MESSAGE;
+}
+
+// Messages in a segment, up to a torn one at the end
+uint32_t countRecords(File& file) {
+    uint32_t count = 0;
+    uint32_t offset = 0;
+    SpillHeader header;
+    while (file.seek(offset) &&
+           file.read(reinterpret_cast<uint8_t*>(&header), sizeof(header)) == sizeof(header) &&
+           headerValid(header) && offset + header.length <= file.size()) {
+        offset += header.length;
+        count++;
+    }
+    return count;
+}
+
+} // namespace
+
+MessageSpool::MessageSpool()
+    : lock(xSemaphoreCreateMutex()),
+      ring(storage, sizeof(storage)),
+      spillReady(false),
+      firstSegment(0),
+      nextSegment(0),
+      bootSegment(0),
+      readOffset(0),
+      readNext(0),
+      writeBytes(0),
+      spilledRecords(0)
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+bool MessageSpool::begin() {
+#if MQTT_SPOOL_SPILL
+    xSemaphoreTake(lock, portMAX_DELAY);
+    SPIFFS.mkdir(SPOOL_DIR);
+    File dir = SPIFFS.open(SPOOL_DIR);
+    bool found = false;
+    uint32_t first = 0;
+    uint32_t last = 0;
+    if (dir && dir.isDirectory()) {
+        for (File file = dir.openNextFile(); file; file = dir.openNextFile()) {
+            const char* name = strrchr(file.name(), '/');
+            name = name ? name + 1 : file.name();
+            uint32_t id = strtoul(name, nullptr, 16);
+            uint32_t count = countRecords(file);
+            file.close();
+            if (count == 0) {
+                char path[32];
+                segmentPath(id, path, sizeof(path));
+                SPIFFS.remove(path);
+                continue;
+            }
+            spilledRecords += count;
+            first = found ? std::min(first, id) : id;
+            last = found ? std::max(last, id) : id;
+            found = true;
+        }
+        dir.close();
+    }
+    firstSegment = found ? first : 0;
+    nextSegment = found ? last + 1 : 0;
+    bootSegment = nextSegment;
+    // Never append behind what a reset may have torn
+    writeBytes = MQTT_SPOOL_SEGMENT_BYTES;
+    readOffset = 0;
+    spillReady = true;
+    xSemaphoreGive(lock);
+
+    if (spilledRecords > 0) {
+        Serial.printf("[SPOOL] %lu message(s) from before the reset waiting for replay\n",
+                      (unsigned long)spilledRecords);
+    }
+#endif
+    return true;
+}
+
+bool MessageSpool::store(const char* topic, const char* payload, bool retained) {
+    if (!topic || !payload || strlen(topic) + strlen(payload) + 2 > MQTT_QUEUE_MAX_MESSAGE) {
+        xSemaphoreTake(lock, portMAX_DELAY);
+        stats.dropped++;
+        xSemaphoreGive(lock);
+        return false;
+    }
+
+    // Unix time if the clock is set, otherwise monotonic seconds that
+    // replay converts once it is
+    TimeService& clock = TimeService::getInstance();
+    uint8_t flags = retained ? KEEP : 0;
+    uint32_t stamp;
+    if (clock.isValid()) {
+        stamp = (uint32_t)(clock.nowUs() / 1000000);
+        flags |= EPOCH;
+    } else {
+        stamp = (uint32_t)(clock.monotonicUs() / 1000000);
+    }
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    uint32_t dropped = 0;
+    MessageRing::Result result = ring.push(topic, payload, flags, stamp, false, dropped);
+    if (result == MessageRing::FULL && spill()) {
+        result = ring.push(topic, payload, flags, stamp, false, dropped);
+    }
+    if (result == MessageRing::FULL) {
+        result = ring.push(topic, payload, flags, stamp, true, dropped);
+    }
+    stats.dropped += dropped;
+    if (result != MessageRing::FULL) {
+        stats.stored++;
+    } else {
+        stats.dropped++;
+    }
+    xSemaphoreGive(lock);
+    return result != MessageRing::FULL;
+}
+
+bool MessageSpool::openSegment(File& file, size_t length) {
+    if (file && writeBytes + length <= MQTT_SPOOL_SEGMENT_BYTES) {
+        return true;
+    }
+    if (file) {
+        file.close();
+    }
+
+    // Continue the newest segment while it has room, otherwise start one
+    bool append = nextSegment > firstSegment && writeBytes + length <= MQTT_SPOOL_SEGMENT_BYTES;
+    if (!append) {
+        if (nextSegment - firstSegment >= MQTT_SPOOL_MAX_SEGMENTS ||
+            SPIFFS.totalBytes() - SPIFFS.usedBytes() < 2 * MQTT_SPOOL_SEGMENT_BYTES) {
+            return false;
+        }
+        nextSegment++;
+        writeBytes = 0;
+    }
+
+    char path[32];
+    segmentPath(nextSegment - 1, path, sizeof(path));
+    file = SPIFFS.open(path, FILE_APPEND);
+    return (bool)file;
+}
+
+bool MessageSpool::spill() {
+#if MQTT_SPOOL_SPILL
+    if (!spillReady) {
+        return false;
+    }
+
+    // Oldest first, so everything on flash stays older than what is in RAM
+    File file;
+    bool moved = false;
+    Message message;
+    while (ring.bytes() > ring.capacity() / 2 && ring.front(raw, sizeof(raw), message)) {
+        SpillHeader header;
+        header.topicLength = message.payload - message.topic - 1;
+        header.payloadLength = strlen(message.payload);
+        header.length = sizeof(header) + header.topicLength + header.payloadLength + 2;
+        header.flags = message.flags & (KEEP | EPOCH);
+        header.reserved = 0;
+        header.stamp = message.stamp;
+        uint32_t epoch;
+        if (!(header.flags & EPOCH) && captureTime(message.flags, message.stamp, true, epoch)) {
+            header.stamp = epoch;
+            header.flags |= EPOCH;
+        }
+
+        if (!openSegment(file, header.length)) {
+            break;
+        }
+        size_t written = file.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+        written += file.write(reinterpret_cast<const uint8_t*>(message.topic), header.length - sizeof(header));
+        if (written != header.length) {
+            // Replay stops at the torn message; carry on in a new segment
+            Serial.printf("[SPOOL] Write to segment %lu failed\n", (unsigned long)(nextSegment - 1));
+            writeBytes = MQTT_SPOOL_SEGMENT_BYTES;
+            break;
+        }
+        writeBytes += header.length;
+        spilledRecords++;
+        stats.spilled++;
+        ring.popFront();
+        moved = true;
+    }
+    if (file) {
+        file.close();
+    }
+    return moved;
+#else
+    return false;
+#endif
+}
+
+void MessageSpool::removeFirstSegment() {
+    char path[32];
+    segmentPath(firstSegment, path, sizeof(path));
+    SPIFFS.remove(path);
+    if (firstSegment == nextSegment - 1) {
+        // It was also the one being written
+        writeBytes = MQTT_SPOOL_SEGMENT_BYTES;
+    }
+    firstSegment++;
+    readOffset = 0;
+}
+
+bool MessageSpool::readSpilled(Message& message) {
+    while (firstSegment != nextSegment) {
+        char path[32];
+        segmentPath(firstSegment, path, sizeof(path));
+        File file = SPIFFS.open(path, FILE_READ);
+        SpillHeader header;
+        bool valid = file && file.seek(readOffset) &&
+                     file.read(reinterpret_cast<uint8_t*>(&header), sizeof(header)) == sizeof(header) &&
+                     headerValid(header) &&
+                     file.read(reinterpret_cast<uint8_t*>(raw), header.length - sizeof(header)) ==
+                         header.length - sizeof(header);
+        if (file) {
+            file.close();
+        }
+        if (valid) {
+            message.topic = raw;
+            message.payload = raw + header.topicLength + 1;
+            message.flags = header.flags | SPILLED;
+            message.stamp = header.stamp;
+            message.sequence = readOffset;
+            readNext = readOffset + header.length;
+            return true;
+        }
+
+        // Replayed to the end, or to a torn message
+        removeFirstSegment();
+    }
+    return false;
+}
+
+bool MessageSpool::front(Message& message) {
+    xSemaphoreTake(lock, portMAX_DELAY);
+    Message stored;
+    bool available = false;
+    bool currentBoot = true;
+    if (spillReady && firstSegment != nextSegment) {
+        available = readSpilled(stored);
+        currentBoot = firstSegment >= bootSegment;
+    }
+    if (!available) {
+        // Everything on flash is replayed
+        spilledRecords = 0;
+        available = ring.front(raw, sizeof(raw), stored);
+    }
+    if (available) {
+        addTimestamp(stored, currentBoot, message);
+    }
+    xSemaphoreGive(lock);
+    return available;
+}
+
+void MessageSpool::pop(const Message& message) {
+    xSemaphoreTake(lock, portMAX_DELAY);
+    if (message.flags & SPILLED) {
+        if (firstSegment != nextSegment && message.sequence == readOffset) {
+            readOffset = readNext;
+            if (spilledRecords > 0) {
+                spilledRecords--;
+            }
+            stats.replayed++;
+        }
+    } else if (ring.pop(message.sequence)) {
+        stats.replayed++;
+    }
+    xSemaphoreGive(lock);
+}
+
+bool MessageSpool::captureTime(uint8_t flags, uint32_t stamp, bool currentBoot, uint32_t& epoch) const {
+    if (flags & EPOCH) {
+        epoch = stamp;
+        return true;
+    }
+    TimeService& clock = TimeService::getInstance();
+    if (!currentBoot || !clock.isValid()) {
+        return false;
+    }
+    int64_t age = clock.monotonicUs() / 1000000 - stamp;
+    epoch = (uint32_t)(clock.nowUs() / 1000000 - age);
+    return true;
+}
+
+void MessageSpool::addTimestamp(const Message& stored, bool currentBoot, Message& message) {
+    message = stored;
+    message.retained = stored.flags & KEEP;
+
+    size_t topicLength = strlen(stored.topic);
+    size_t payloadLength = strlen(stored.payload);
+    memcpy(scratch, stored.topic, topicLength + 1);
+    message.topic = scratch;
+    message.payload = scratch + topicLength + 1;
+    char* out = scratch + topicLength + 1;
+    size_t room = sizeof(scratch) - topicLength - 1;
+
+    // Only JSON objects can take the field
+    uint32_t epoch;
+    if (payloadLength >= 2 && stored.payload[0] == '{' && stored.payload[payloadLength - 1] == '}' &&
+        captureTime(stored.flags, stored.stamp, currentBoot, epoch)) {
+        int length = snprintf(out, room, "%.*s%s\"ts\":%lu}", (int)(payloadLength - 1), stored.payload,
+                              payloadLength > 2 ? "," : "", (unsigned long)epoch);
+        if (length > 0 && (size_t)length < room) {
+            return;
+        }
+    }
+    memcpy(out, stored.payload, payloadLength + 1);
+}
+
+MessageSpool::Stats MessageSpool::getStats() const {
+    xSemaphoreTake(lock, portMAX_DELAY);
+    Stats copy = stats;
+    copy.depth = ring.depth() + spilledRecords;
+    copy.bytes = ring.bytes();
+    copy.segments = nextSegment - firstSegment;
+    xSemaphoreGive(lock);
+    return copy;
+}
@@ -0,0 +1,115 @@
+#include "PayloadWriter.h"
+#include <stdarg.h>
+
+PayloadWriter::PayloadWriter(char* buffer, size_t size)
+    : buffer(buffer),
+      size(size),
+      used(0),
+      overflow(false),
+      first(true)
+{
+    append("{", 1);
+}
+
+void PayloadWriter::append(const char* text, size_t length) {
+    // Room is kept for the closing brace and the terminator
+    if (overflow || used + length + 2 > size) {
+        overflow = true;
+        return;
+    }
+    memcpy(buffer + used, text, length);
+    used += length;
+    buffer[used] = '\0';
+}
+
+void PayloadWriter::appendf(const char* format, ...) {
+    char text[24];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    if (length < 0 || length >= (int)sizeof(text)) {
+        overflow = true;
+        return;
+    }
+    append(text, length);
+}
+
+void PayloadWriter::key(const char* name) {
+    if (!first) {
+        append(",", 1);
+    }
+    first = false;
+    append("\"", 1);
+    append(name, strlen(name));
+    append("\":", 2);
+}
+
+PayloadWriter& PayloadWriter::add(const char* name, const char* value) {
+    key(name);
+    append("\"", 1);
+    for (const char* c = value; c && *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            append("\\", 1);
+        }
+        if ((uint8_t)*c >= 0x20) {
+            append(c, 1);
+        }
+    }
+    append("\"", 1);
+    return *this;
+}
+
+PayloadWriter& PayloadWriter::add(const char* name, bool value) {
+    key(name);
+    if (value) {
+        append("true", 4);
+    } else {
+        append("false", 5);
+    }
+    return *this;
+}
+
+PayloadWriter& PayloadWriter::add(const char* name, int value) {
+    key(name);
+    appendf("%d", value);
+    return *this;
+}
+
+PayloadWriter& PayloadWriter::add(const char* name, unsigned int value) {
+    key(name);
+    appendf("%u", value);
+    return *this;
+}
+
+PayloadWriter& PayloadWriter::add(const char* name, long value) {
+    key(name);
+    appendf("%ld", value);
+    return *this;
+}
+
+PayloadWriter& PayloadWriter::add(const char* name, unsigned long value) {
+    key(name);
+    appendf("%lu", value);
+    return *this;
+}
+
+PayloadWriter& PayloadWriter::add(const char* name, double value, uint8_t decimals) {
+    key(name);
+    // JSON has no NaN or infinity
+    if (value != value || value > 1e15 || value < -1e15) {
+        append("null", 4);
+    } else {
+        appendf("%.*f", (int)decimals, value);
+    }
+    return *this;
+}
+
+const char* PayloadWriter::finish() {
+    if (overflow || used + 2 > size) {
+        return nullptr;
+    }
+    buffer[used++] = '}';
+    buffer[used] = '\0';
+    return buffer;
+}
@@ -91,6 +91,15 @@ uint8_t SPIFFSPreferenceStorage::getUChar(const char* key, uint8_t defaultValue)
     return (uint8_t)value.toInt();
 }
 
+bool SPIFFSPreferenceStorage::putShort(const char* key, int16_t value) {
+    return putString(key, String(value).c_str());
+}
+
+int16_t SPIFFSPreferenceStorage::getShort(const char* key, int16_t defaultValue) {
+    String value = getString(key, String(defaultValue).c_str());
+    return (int16_t)value.toInt();
+}
+
 bool SPIFFSPreferenceStorage::putBool(const char* key, bool value) {
     return putString(key, value ? "1" : "0");
 }
@@ -98,6 +98,9 @@ void PreferencesManager::saveDisplayPreferences(const DisplayPreferences& prefs)
         storage->putString("mqttUser", prefs.mqttUsername.c_str());
         storage->putString("mqttPass", prefs.mqttPassword.c_str());
         storage->putUChar("mqttInterval", prefs.mqttPublishInterval);
+        storage->putString("playlist", prefs.displayPlaylist.c_str());
+        storage->putString("sensorFilter", prefs.sensorFilter.c_str());
+        storage->putShort("altitude", prefs.sensorAltitude);
         
         Serial.printf("Saving display preferences - Day: %d%%, Night: %d%%\n", 
                      dayBright, nightBright);
@@ -164,6 +167,9 @@ DisplayPreferences PreferencesManager::loadDisplayPreferences() {
         cachedPreferences.mqttUsername = storage->getString("mqttUser", MQTT_USER);
         cachedPreferences.mqttPassword = storage->getString("mqttPass", MQTT_PASSWORD);
         cachedPreferences.mqttPublishInterval = storage->getUChar("mqttInterval", 60);
+        cachedPreferences.displayPlaylist = storage->getString("playlist", "");
+        cachedPreferences.sensorFilter = storage->getString("sensorFilter", "");
+        cachedPreferences.sensorAltitude = storage->getShort("altitude", SENSOR_ALTITUDE);
         
         Serial.printf("[DEBUG] Loaded preferences:\n"
                      "  Night Mode: %s\n"
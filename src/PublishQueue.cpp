@@ -0,0 +1,103 @@
+#include "PublishQueue.h"
+
+static_assert(MQTT_QUEUE_MAX_MESSAGE + MessageRing::HEADER_SIZE <= MQTT_QUEUE_BYTES,
+              "MQTT_QUEUE_BYTES must hold the largest message");
+
+PublishQueue::PublishQueue()
+    : lock(xSemaphoreCreateMutex()),
+      consumer(nullptr),
+      ring(storage, sizeof(storage)),
+      statsLock(portMUX_INITIALIZER_UNLOCKED)
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+bool PublishQueue::enqueue(const char* topic, const char* payload, bool retained, Policy policy) {
+    if (!topic || !payload) {
+        reject();
+        return false;
+    }
+    size_t payloadLength = strlen(payload);
+    if (strlen(topic) + payloadLength + 2 > MQTT_QUEUE_MAX_MESSAGE) {
+        Serial.printf("[MQTTQ] Message for %s too large (%u bytes)\n", topic, (unsigned)payloadLength);
+        reject();
+        return false;
+    }
+
+    if (xSemaphoreTake(lock, pdMS_TO_TICKS(MQTT_QUEUE_LOCK_MS)) != pdTRUE) {
+        reject();
+        return false;
+    }
+    MessageRing::Result result = ring.push(topic, payload, retained ? MessageRing::RETAINED : 0, 0,
+                                           policy == DROP_OLDEST, stats.dropped);
+    if (result == MessageRing::FULL) {
+        reject();
+        xSemaphoreGive(lock);
+        return false;
+    }
+    stats.enqueued++;
+    if (result == MessageRing::COALESCED) {
+        stats.coalesced++;
+    }
+    if (ring.bytes() > stats.highWater) {
+        stats.highWater = ring.bytes();
+    }
+    xSemaphoreGive(lock);
+
+    wake();
+    return true;
+}
+
+void PublishQueue::reject() {
+    portENTER_CRITICAL(&statsLock);
+    stats.rejected++;
+    portEXIT_CRITICAL(&statsLock);
+}
+
+void PublishQueue::failed() {
+    portENTER_CRITICAL(&statsLock);
+    stats.failed++;
+    portEXIT_CRITICAL(&statsLock);
+}
+
+void PublishQueue::wake() {
+    if (consumer) {
+        xTaskNotifyGive(consumer);
+    }
+}
+
+bool PublishQueue::front(Message& message) {
+    if (xSemaphoreTake(lock, pdMS_TO_TICKS(MQTT_QUEUE_LOCK_MS)) != pdTRUE) {
+        return false;
+    }
+    bool available = ring.front(scratch, sizeof(scratch), message);
+    xSemaphoreGive(lock);
+    return available;
+}
+
+void PublishQueue::pop(uint32_t sent) {
+    xSemaphoreTake(lock, portMAX_DELAY);
+    // Dropped or rewritten while it was on the wire: leave the queue alone
+    ring.pop(sent);
+    stats.sent++;
+    xSemaphoreGive(lock);
+}
+
+void PublishQueue::abandon(uint32_t sequence) {
+    xSemaphoreTake(lock, portMAX_DELAY);
+    if (ring.pop(sequence)) {
+        stats.abandoned++;
+    }
+    xSemaphoreGive(lock);
+}
+
+PublishQueue::Stats PublishQueue::getStats() const {
+    xSemaphoreTake(lock, portMAX_DELAY);
+    portENTER_CRITICAL(&statsLock);
+    Stats copy = stats;
+    portEXIT_CRITICAL(&statsLock);
+    copy.depth = ring.depth();
+    copy.bytes = ring.bytes();
+    xSemaphoreGive(lock);
+    return copy;
+}
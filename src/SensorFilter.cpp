@@ -0,0 +1,217 @@
+#include "SensorFilter.h"
+#include "BME280Handler.h"
+#include "config.h"
+
+namespace {
+
+const char* const CHANNEL_NAMES[SensorFilter::CHANNEL_COUNT] = {"temp", "hum", "pres"};
+
+const float CHANNEL_MIN[SensorFilter::CHANNEL_COUNT] = {
+    BME280_TEMP_MIN, BME280_HUM_MIN, BME280_PRES_MIN
+};
+const float CHANNEL_MAX[SensorFilter::CHANNEL_COUNT] = {
+    BME280_TEMP_MAX, BME280_HUM_MAX, BME280_PRES_MAX
+};
+
+bool isPowerOfTwoUpTo16(long value, bool allowZero) {
+    return (allowZero && value == 0) ||
+           value == 1 || value == 2 || value == 4 || value == 8 || value == 16;
+}
+
+// Splits "a:b:c" into at most 'max' fields; returns the field count
+uint8_t splitFields(const String& item, String* fields, uint8_t max) {
+    uint8_t count = 0;
+    int start = 0;
+    while (count < max) {
+        int end = item.indexOf(':', start);
+        fields[count++] = item.substring(start, end < 0 ? item.length() : end);
+        if (end < 0) {
+            return count;
+        }
+        start = end + 1;
+    }
+    return max + 1;  // Too many fields
+}
+
+} // namespace
+
+SensorFilter::SensorFilter()
+    : lock(portMUX_INITIALIZER_UNLOCKED),
+      generation(0),
+      appliedGeneration(0),
+      rejected(0)
+{
+    loadDefaults(settings);
+    pending = settings;
+    reset();
+}
+
+void SensorFilter::loadDefaults(Settings& result) {
+    // Matches what init() always used: T/P x2, H x1, IIR 16, no software
+    // filtering beyond a 3-sample median against single spikes
+    result.iirCoefficient = 16;
+    result.channels[TEMPERATURE] = {2, 3, 1.0f};
+    result.channels[HUMIDITY] = {1, 3, 1.0f};
+    result.channels[PRESSURE] = {2, 3, 1.0f};
+}
+
+bool SensorFilter::parse(const String& spec, Settings& result) {
+    loadDefaults(result);
+    String text = spec;
+    text.trim();
+
+    bool allValid = true;
+    int start = 0;
+    while (start < (int)text.length()) {
+        int end = text.indexOf(',', start);
+        if (end < 0) {
+            end = text.length();
+        }
+        String item = text.substring(start, end);
+        item.trim();
+        start = end + 1;
+        if (item.length() == 0) {
+            continue;
+        }
+
+        String fields[4];
+        uint8_t count = splitFields(item, fields, 4);
+
+        if (fields[0].equalsIgnoreCase("iir")) {
+            long coefficient = fields[1].toInt();
+            if (count == 2 && fields[1].length() > 0 && isPowerOfTwoUpTo16(coefficient, true) &&
+                coefficient != 1) {
+                result.iirCoefficient = (uint8_t)coefficient;
+                continue;
+            }
+            Serial.printf("[FILTER] Skipping invalid entry '%s'\n", item.c_str());
+            allValid = false;
+            continue;
+        }
+
+        int channel = -1;
+        for (uint8_t c = 0; c < CHANNEL_COUNT; c++) {
+            if (fields[0].equalsIgnoreCase(CHANNEL_NAMES[c])) {
+                channel = c;
+            }
+        }
+
+        // channel:oversampling[:median[:ema]]
+        ChannelSettings parsed = result.channels[channel < 0 ? 0 : channel];
+        bool valid = channel >= 0 && count >= 2 && count <= 4;
+        if (valid) {
+            long oversampling = fields[1].toInt();
+            valid = isPowerOfTwoUpTo16(oversampling, false);
+            parsed.oversampling = (uint8_t)oversampling;
+        }
+        if (valid && count >= 3) {
+            long window = fields[2].toInt();
+            valid = window >= 1 && window <= MAX_MEDIAN && (window & 1);
+            parsed.median = (uint8_t)window;
+        }
+        if (valid && count >= 4) {
+            float ema = fields[3].toFloat();
+            valid = ema > 0.0f && ema <= 1.0f;
+            parsed.ema = ema;
+        }
+
+        if (!valid) {
+            Serial.printf("[FILTER] Skipping invalid entry '%s'\n", item.c_str());
+            allValid = false;
+            continue;
+        }
+        result.channels[channel] = parsed;
+    }
+    return allValid;
+}
+
+String SensorFilter::toString(const Settings& value) {
+    String result = "iir:" + String(value.iirCoefficient);
+    for (uint8_t c = 0; c < CHANNEL_COUNT; c++) {
+        const ChannelSettings& channel = value.channels[c];
+        result += "," + String(CHANNEL_NAMES[c]) + ":" + String(channel.oversampling) + ":" +
+                  String(channel.median) + ":" + String(channel.ema, 2);
+    }
+    return result;
+}
+
+void SensorFilter::setSettings(const Settings& value) {
+    portENTER_CRITICAL(&lock);
+    pending = value;
+    generation++;
+    portEXIT_CRITICAL(&lock);
+}
+
+SensorFilter::Settings SensorFilter::getSettings() const {
+    portENTER_CRITICAL(&lock);
+    Settings copy = pending;
+    portEXIT_CRITICAL(&lock);
+    return copy;
+}
+
+void SensorFilter::reset() {
+    memset(state, 0, sizeof(state));
+}
+
+float SensorFilter::median(const float* values, uint8_t count) {
+    float sorted[MAX_MEDIAN];
+    for (uint8_t i = 0; i < count; i++) {
+        float value = values[i];
+        uint8_t j = i;
+        while (j > 0 && sorted[j - 1] > value) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = value;
+    }
+    if (count & 1) {
+        return sorted[count / 2];
+    }
+    return (sorted[count / 2 - 1] + sorted[count / 2]) / 2.0f;
+}
+
+bool SensorFilter::apply(uint8_t sensor, float values[CHANNEL_COUNT]) {
+    // New settings start the filters over
+    if (generation != appliedGeneration) {
+        portENTER_CRITICAL(&lock);
+        settings = pending;
+        appliedGeneration = generation;
+        portEXIT_CRITICAL(&lock);
+        reset();
+    }
+    if (sensor >= SENSOR_MAX_COUNT) {
+        return false;
+    }
+
+    bool complete = true;
+    for (uint8_t c = 0; c < CHANNEL_COUNT; c++) {
+        ChannelState& channel = state[sensor][c];
+        const ChannelSettings& config = settings.channels[c];
+        float value = values[c];
+
+        if (!(value >= CHANNEL_MIN[c] && value <= CHANNEL_MAX[c])) {
+            rejected++;
+            if (channel.haveOutput) {
+                values[c] = channel.output;
+            } else {
+                complete = false;
+            }
+            continue;
+        }
+
+        channel.window[channel.next] = value;
+        channel.next = (channel.next + 1) % config.median;
+        if (channel.filled < config.median) {
+            channel.filled++;
+        }
+        float filtered = median(channel.window, channel.filled);
+
+        if (channel.haveOutput && config.ema < 1.0f) {
+            filtered = channel.output + config.ema * (filtered - channel.output);
+        }
+        channel.output = filtered;
+        channel.haveOutput = true;
+        values[c] = filtered;
+    }
+    return complete;
+}
@@ -0,0 +1,132 @@
+#include "SensorHistory.h"
+#include <esp_timer.h>
+
+// 1 minute of 5 s buckets, 1 hour of 1 min buckets, 24 hours of 1 h buckets
+const SensorHistory::WindowLayout SensorHistory::LAYOUT[WINDOW_COUNT] = {
+    {5, 12, 0},
+    {60, 60, 12},
+    {3600, 24, 72}
+};
+
+SensorHistory::SensorHistory()
+    : lock(portMUX_INITIALIZER_UNLOCKED),
+      head(0),
+      count(0)
+{
+    memset(samples, 0, sizeof(samples));
+    memset(buckets, 0, sizeof(buckets));
+}
+
+void SensorHistory::add(float temperature, float humidity, float pressure) {
+    int64_t nowUs = esp_timer_get_time();
+    uint32_t nowSeconds = (uint32_t)(nowUs / 1000000LL);
+
+    Sample sample;
+    sample.timeMs = (uint32_t)(nowUs / 1000LL);
+    sample.values[TEMPERATURE] = temperature;
+    sample.values[HUMIDITY] = humidity;
+    sample.values[PRESSURE] = pressure;
+
+    portENTER_CRITICAL(&lock);
+    samples[head] = sample;
+    head = (head + 1) % HISTORY_CAPACITY;
+    if (count < HISTORY_CAPACITY) {
+        count++;
+    }
+
+    for (uint8_t w = 0; w < WINDOW_COUNT; w++) {
+        const WindowLayout& layout = LAYOUT[w];
+        uint32_t epoch = nowSeconds / layout.bucketSeconds;
+        Bucket& bucket = buckets[layout.firstBucket + epoch % layout.bucketCount];
+
+        // A bucket from an earlier lap of the ring starts over
+        if (bucket.epoch != epoch || bucket.count == 0) {
+            bucket.epoch = epoch;
+            bucket.count = 0;
+            for (uint8_t c = 0; c < CHANNEL_COUNT; c++) {
+                bucket.min[c] = sample.values[c];
+                bucket.max[c] = sample.values[c];
+                bucket.sum[c] = 0;
+            }
+        }
+
+        bucket.count++;
+        for (uint8_t c = 0; c < CHANNEL_COUNT; c++) {
+            float value = sample.values[c];
+            if (value < bucket.min[c]) bucket.min[c] = value;
+            if (value > bucket.max[c]) bucket.max[c] = value;
+            bucket.sum[c] += value;
+        }
+    }
+    portEXIT_CRITICAL(&lock);
+}
+
+bool SensorHistory::getSample(size_t index, Sample& sample) const {
+    portENTER_CRITICAL(&lock);
+    bool found = index < count;
+    if (found) {
+        size_t oldest = (head + HISTORY_CAPACITY - count) % HISTORY_CAPACITY;
+        sample = samples[(oldest + index) % HISTORY_CAPACITY];
+    }
+    portEXIT_CRITICAL(&lock);
+    return found;
+}
+
+size_t SensorHistory::size() const {
+    portENTER_CRITICAL(&lock);
+    size_t n = count;
+    portEXIT_CRITICAL(&lock);
+    return n;
+}
+
+bool SensorHistory::getStats(Window window, Stats& stats) const {
+    memset(&stats, 0, sizeof(stats));
+    if (window >= WINDOW_COUNT) {
+        return false;
+    }
+
+    const WindowLayout& layout = LAYOUT[window];
+    uint32_t nowEpoch = (uint32_t)(esp_timer_get_time() / 1000000LL) / layout.bucketSeconds;
+    float sum[CHANNEL_COUNT] = {0};
+
+    portENTER_CRITICAL(&lock);
+    for (uint8_t i = 0; i < layout.bucketCount; i++) {
+        const Bucket& bucket = buckets[layout.firstBucket + i];
+        if (bucket.count == 0 || nowEpoch - bucket.epoch >= layout.bucketCount) {
+            continue;  // Empty or expired
+        }
+        for (uint8_t c = 0; c < CHANNEL_COUNT; c++) {
+            if (stats.count == 0 || bucket.min[c] < stats.min[c]) stats.min[c] = bucket.min[c];
+            if (stats.count == 0 || bucket.max[c] > stats.max[c]) stats.max[c] = bucket.max[c];
+            sum[c] += bucket.sum[c];
+        }
+        stats.count += bucket.count;
+    }
+    portEXIT_CRITICAL(&lock);
+
+    if (stats.count == 0) {
+        return false;
+    }
+    for (uint8_t c = 0; c < CHANNEL_COUNT; c++) {
+        stats.mean[c] = sum[c] / stats.count;
+    }
+    return true;
+}
+
+const char* SensorHistory::windowName(Window window) {
+    switch (window) {
+        case WINDOW_1M: return "1m";
+        case WINDOW_1H: return "1h";
+        case WINDOW_24H: return "24h";
+        default: return "";
+    }
+}
+
+const char* SensorHistory::channelName(Channel channel) {
+    switch (channel) {
+        case TEMPERATURE: return "temperature";
+        case HUMIDITY: return "humidity";
+        case PRESSURE: return "pressure";
+        default: return "";
+    }
+}
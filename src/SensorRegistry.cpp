@@ -0,0 +1,91 @@
+#include "SensorRegistry.h"
+#include "I2CBus.h"
+
+namespace {
+
+// Both addresses the BME280 can be strapped to, in index order
+const uint8_t SCAN_ADDRESSES[] = {BME280_I2C_ADDR_PRIM, BME280_I2C_ADDR_SEC};
+
+} // namespace
+
+SensorRegistry::SensorRegistry()
+    : lock(portMUX_INITIALIZER_UNLOCKED),
+      sensorCount(0)
+{
+    memset(addresses, 0, sizeof(addresses));
+    memset(temperatures, 0, sizeof(temperatures));
+    memset(humidities, 0, sizeof(humidities));
+    memset(pressures, 0, sizeof(pressures));
+    memset(updateTimes, 0, sizeof(updateTimes));
+}
+
+uint8_t SensorRegistry::begin() {
+    sensorCount = 0;
+    for (uint8_t address : SCAN_ADDRESSES) {
+        if (sensorCount >= MAX_SENSORS || !I2CBus::getInstance().probe(address)) {
+            continue;
+        }
+        drivers[sensorCount] = BME280Handler(address);
+        if (!drivers[sensorCount].init()) {
+            Serial.printf("[SENSOR] Device at 0x%02X is not a working BME280\n", address);
+            continue;
+        }
+        addresses[sensorCount] = address;
+        Serial.printf("[SENSOR] Sensor %u: BME280 at 0x%02X\n", sensorCount, address);
+        sensorCount++;
+    }
+    Serial.printf("[SENSOR] %u sensor(s) found\n", sensorCount);
+    return sensorCount;
+}
+
+uint8_t SensorRegistry::getAddress(uint8_t index) const {
+    return index < sensorCount ? addresses[index] : 0;
+}
+
+bool SensorRegistry::startSampling(TaskHandle_t task, uint32_t intervalMs) {
+    bool ok = true;
+    for (uint8_t i = 0; i < sensorCount; i++) {
+        ok = drivers[i].startSampling(task, intervalMs, i * BME280Handler::EVENT_BITS) && ok;
+    }
+    return ok;
+}
+
+uint32_t SensorRegistry::handleEvents(uint32_t events) {
+    uint32_t sampled = 0;
+    for (uint8_t i = 0; i < sensorCount; i++) {
+        if (drivers[i].handleEvents(events)) {
+            sampled |= 1u << i;
+        }
+    }
+    return sampled;
+}
+
+void SensorRegistry::update(uint8_t index, float temperature, float humidity, float pressure) {
+    if (index >= sensorCount) {
+        return;
+    }
+    portENTER_CRITICAL(&lock);
+    temperatures[index] = temperature;
+    humidities[index] = humidity;
+    pressures[index] = pressure;
+    updateTimes[index] = millis();
+    portEXIT_CRITICAL(&lock);
+}
+
+bool SensorRegistry::getReading(uint8_t index, Reading& reading) const {
+    if (index >= sensorCount) {
+        return false;
+    }
+    portENTER_CRITICAL(&lock);
+    reading.temperature = temperatures[index];
+    reading.humidity = humidities[index];
+    reading.pressure = pressures[index];
+    reading.updateTime = updateTimes[index];
+    portEXIT_CRITICAL(&lock);
+    return reading.updateTime != 0;
+}
+
+bool SensorRegistry::isFresh(uint8_t index, uint32_t maxAgeMs) const {
+    Reading reading;
+    return getReading(index, reading) && millis() - reading.updateTime < maxAgeMs;
+}
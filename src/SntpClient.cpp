@@ -0,0 +1,287 @@
+#include "SntpClient.h"
+#include "DnsLookup.h"
+#include "config.h"
+#include <esp_timer.h>
+#include <sys/time.h>
+
+namespace {
+
+const uint16_t NTP_PORT = 123;
+
+// Seconds from the NTP epoch (1900) to the Unix epoch
+const uint32_t NTP_UNIX_OFFSET = 2208988800UL;
+
+int64_t systemTimeUs() {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    return (int64_t)tv.tv_sec * 1000000LL + tv.tv_usec;
+}
+
+uint64_t readTimestamp(const uint8_t* p) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+void writeTimestamp(uint8_t* p, uint64_t value) {
+    for (int i = 7; i >= 0; i--) {
+        p[i] = (uint8_t)value;
+        value >>= 8;
+    }
+}
+
+// NTP 32.32 fixed point to Unix microseconds. Seconds values with the top
+// bit clear are taken to be in era 1 (after February 2036).
+int64_t ntpToUnixUs(uint64_t timestamp) {
+    uint32_t seconds = (uint32_t)(timestamp >> 32);
+    uint32_t fraction = (uint32_t)timestamp;
+    int64_t unixSeconds = (int64_t)seconds - NTP_UNIX_OFFSET;
+    if (!(seconds & 0x80000000UL)) {
+        unixSeconds += 0x100000000LL;
+    }
+    return unixSeconds * 1000000LL + (int64_t)(((uint64_t)fraction * 1000000ULL) >> 32);
+}
+
+} // namespace
+
+SntpClient::SntpClient()
+    : listening(false),
+      serverCount(0),
+      state(State::IDLE),
+      currentServer(0),
+      serverStartTime(0),
+      dnsGeneration(0),
+      resolvedAddress(0),
+      resolveFailed(false),
+      requestCookie(0),
+      requestMonoUs(0),
+      requestSystemUs(0),
+      responseMonoUs(0),
+      responseSystemUs(0),
+      responseReady(false),
+      haveBest(false)
+{
+    memset(servers, 0, sizeof(servers));
+    memset(response, 0, sizeof(response));
+    memset(&best, 0, sizeof(best));
+}
+
+bool SntpClient::begin(const char* serverList) {
+    serverCount = 0;
+
+    // "host[:port],host[:port],..."
+    const char* cursor = serverList;
+    while (cursor && *cursor && serverCount < MAX_SERVERS) {
+        const char* end = strchr(cursor, ',');
+        size_t length = end ? (size_t)(end - cursor) : strlen(cursor);
+
+        while (length > 0 && *cursor == ' ') {
+            cursor++;
+            length--;
+        }
+        while (length > 0 && cursor[length - 1] == ' ') {
+            length--;
+        }
+
+        if (length > 0 && length < MAX_HOST_LENGTH) {
+            Server& server = servers[serverCount];
+            memcpy(server.host, cursor, length);
+            server.host[length] = '\0';
+            server.port = NTP_PORT;
+
+            char* colon = strchr(server.host, ':');
+            if (colon) {
+                *colon = '\0';
+                server.port = (uint16_t)atoi(colon + 1);
+            }
+            if (server.host[0] && server.port) {
+                serverCount++;
+            }
+        } else if (length > 0) {
+            Serial.printf("[NTP] Ignoring server entry of %u characters\n", (unsigned)length);
+        }
+
+        cursor = end ? end + 1 : nullptr;
+    }
+
+    if (!listening) {
+        udp.onPacket([this](AsyncUDPPacket& packet) { onPacket(packet); });
+        listening = udp.listen(0);
+        if (!listening) {
+            Serial.println("[NTP] Failed to open UDP socket");
+        }
+    }
+
+    Serial.printf("[NTP] %u server(s) configured\n", serverCount);
+    return listening && serverCount > 0;
+}
+
+bool SntpClient::requestSync() {
+    if (state != State::IDLE || !listening || serverCount == 0) {
+        return false;
+    }
+    haveBest = false;
+    startServer(0);
+    return true;
+}
+
+void SntpClient::startServer(uint8_t index) {
+    currentServer = index;
+    serverStartTime = millis();
+    responseReady.store(false);
+    resolveFailed.store(false);
+    resolvedAddress.store(0);
+
+    uint32_t generation = dnsGeneration.fetch_add(1) + 1;
+    ip_addr_t address;
+    err_t err = dnsLookup(servers[index].host, &address, dnsFound,
+                          reinterpret_cast<void*>((uintptr_t)generation));
+    if (err == ERR_OK) {
+        sendRequest(address.u_addr.ip4.addr);
+    } else if (err == ERR_INPROGRESS) {
+        state = State::RESOLVING;
+    } else {
+        Serial.printf("[NTP] Cannot resolve %s\n", servers[index].host);
+        finishServer();
+    }
+}
+
+void SntpClient::dnsFound(const char*, const ip_addr_t* ipaddr, void* arg) {
+    SntpClient& client = getInstance();
+    if ((uint32_t)(uintptr_t)arg != client.dnsGeneration.load()) {
+        return;  // Answer for a lookup that has been abandoned
+    }
+    if (ipaddr && ipaddr->type == IPADDR_TYPE_V4 && ipaddr->u_addr.ip4.addr != 0) {
+        client.resolvedAddress.store(ipaddr->u_addr.ip4.addr);
+    } else {
+        client.resolveFailed.store(true);
+    }
+}
+
+void SntpClient::sendRequest(uint32_t address) {
+    uint8_t packet[PACKET_SIZE];
+    memset(packet, 0, sizeof(packet));
+    packet[0] = 0x23;  // LI 0, version 4, mode 3 (client)
+
+    requestCookie = ((uint64_t)esp_random() << 32) | esp_random();
+    writeTimestamp(packet + 40, requestCookie);
+
+    state = State::WAITING;
+    requestSystemUs = systemTimeUs();
+    requestMonoUs = esp_timer_get_time();
+    if (udp.writeTo(packet, sizeof(packet), IPAddress(address), servers[currentServer].port) != sizeof(packet)) {
+        Serial.printf("[NTP] Send to %s failed\n", servers[currentServer].host);
+        finishServer();
+    }
+}
+
+void SntpClient::onPacket(AsyncUDPPacket& packet) {
+    // Timestamp first, everything else can wait for loop()
+    int64_t mono = esp_timer_get_time();
+    int64_t system = systemTimeUs();
+
+    if (state != State::WAITING || packet.length() < PACKET_SIZE || responseReady.load()) {
+        return;
+    }
+    memcpy(response, packet.data(), PACKET_SIZE);
+    responseMonoUs = mono;
+    responseSystemUs = system;
+    responseReady.store(true, std::memory_order_release);
+}
+
+bool SntpClient::parseResponse(SntpSample& sample) {
+    uint8_t leap = response[0] >> 6;
+    uint8_t mode = response[0] & 0x07;
+    uint8_t stratum = response[1];
+
+    if (mode != 4 || leap == 3 || stratum == 0 || stratum > 15) {
+        Serial.printf("[NTP] %s: unusable reply (mode %u, leap %u, stratum %u)\n",
+                      servers[currentServer].host, mode, leap, stratum);
+        return false;
+    }
+    if (readTimestamp(response + 24) != requestCookie) {
+        return false;  // Not the answer to our request
+    }
+    uint64_t transmit = readTimestamp(response + 40);
+    if (transmit == 0) {
+        return false;
+    }
+
+    // t1/t4 are local, t2/t3 the server's receive and transmit times
+    int64_t t2 = ntpToUnixUs(readTimestamp(response + 32));
+    int64_t t3 = ntpToUnixUs(transmit);
+    int64_t serverHold = t3 - t2;
+    int64_t roundTrip = (responseMonoUs - requestMonoUs) - serverHold;
+
+    sample.server = currentServer;
+    sample.stratum = stratum;
+    sample.rttUs = roundTrip > 0 ? (uint32_t)roundTrip : 0;
+    sample.offsetUs = ((t2 - requestSystemUs) + (t3 - responseSystemUs)) / 2;
+    // Symmetric path: the midpoint of t2/t3 matches the local midpoint
+    sample.monoUs = requestMonoUs + (responseMonoUs - requestMonoUs) / 2;
+    sample.utcUs = t2 + serverHold / 2;
+    return true;
+}
+
+void SntpClient::finishServer() {
+    uint8_t next = currentServer + 1;
+    if (next < serverCount) {
+        startServer(next);
+        return;
+    }
+
+    state = State::IDLE;
+    dnsGeneration.fetch_add(1);  // Drop any lookup still outstanding
+
+    if (haveBest) {
+        Serial.printf("[NTP] Using %s: offset %lld us, rtt %u us\n",
+                      servers[best.server].host, (long long)best.offsetUs, best.rttUs);
+    } else {
+        Serial.println("[NTP] No server answered");
+    }
+    if (resultCallback) {
+        resultCallback(haveBest, best);
+    }
+}
+
+void SntpClient::loop() {
+    if (state == State::IDLE) {
+        return;
+    }
+
+    if (state == State::RESOLVING) {
+        uint32_t address = resolvedAddress.load();
+        if (address != 0) {
+            sendRequest(address);
+        } else if (resolveFailed.load()) {
+            Serial.printf("[NTP] Cannot resolve %s\n", servers[currentServer].host);
+            finishServer();
+            return;
+        }
+    }
+
+    if (state == State::WAITING && responseReady.load(std::memory_order_acquire)) {
+        SntpSample sample;
+        if (parseResponse(sample)) {
+            Serial.printf("[NTP] %s: offset %lld us, rtt %u us, stratum %u\n",
+                          servers[currentServer].host, (long long)sample.offsetUs,
+                          sample.rttUs, sample.stratum);
+            // The shortest round trip bounds the offset error most tightly
+            if (!haveBest || sample.rttUs < best.rttUs) {
+                best = sample;
+                haveBest = true;
+            }
+            finishServer();
+            return;
+        }
+        // Stray or invalid packet, keep listening until the timeout
+        responseReady.store(false);
+    }
+
+    if (state != State::IDLE && millis() - serverStartTime >= SNTP_SERVER_TIMEOUT_MS) {
+        Serial.printf("[NTP] %s timed out\n", servers[currentServer].host);
+        finishServer();
+    }
+}
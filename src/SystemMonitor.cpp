@@ -1,6 +1,17 @@
 #include "SystemMonitor.h"
 #include "MQTTManager.h"
 #include "PreferencesManager.h"
+#include "GlobalState.h"
+#include "DisplayHandler.h"
+#include "TimeService.h"
+#include "AdaptiveSampler.h"
+#include "SensorRegistry.h"
+#include "I2CBus.h"
+#include "ComfortMetrics.h"
+#include "MQTTTopics.h"
+#include "PayloadWriter.h"
+#include "PublishQueue.h"
+#include "MessageSpool.h"
 #include "config.h"
 
 // Add the include for reset reason functionality
@@ -15,7 +26,11 @@ SystemMonitor::SystemMonitor(MQTTManager* mqttManager)
     , _lastSuccessfulNtpSync(0)
     , _ntpSyncAttempts(0)
     , _ntpSyncSuccesses(0)
-    , _ntpSyncFailures(0) {
+    , _ntpSyncFailures(0)
+    , lastDiscoveryTime(0)
+    , lastDiscoveryAttempt(0)
+    , discoveryNext(0)
+    , discoveryPending(true) {
     
     // Get the reset reason
     _resetReason = rtc_get_reset_reason(0);  // CPU 0
@@ -44,23 +59,23 @@ void SystemMonitor::update() {
         Serial.println("[MONITOR] Publishing periodic diagnostics");
         publishDiagnostics(true);
         _lastPublishTime = now;
-        
-        // Check if we need to publish discovery information
-        static bool discoveryPublished = false;
-        if (!discoveryPublished && _mqttManager && _mqttManager->connected()) {
-            Serial.println("[MONITOR] Publishing initial diagnostic entities discovery");
-            publishHomeAssistantDiscovery();
-            discoveryPublished = true;
-            publishDiagnostics(true);
-        }
     }
     
-    // Periodic discovery refresh
-    if (lastDiscoveryTime > 0 && now - lastDiscoveryTime >= 3600000) { // Every hour
-        if (_mqttManager && _mqttManager->connected()) {
-            Serial.println("[MONITOR] Refreshing diagnostic entities discovery");
-            publishHomeAssistantDiscovery();
+    // Discovery goes through the publish queue. A round that did not fit
+    // is resumed every MQTT_QUEUE_RETRY_MS; done rounds repeat every hour.
+    if (discoveryPending && now - lastDiscoveryAttempt >= MQTT_QUEUE_RETRY_MS &&
+        _mqttManager && _mqttManager->connected()) {
+        lastDiscoveryAttempt = now;
+        bool firstRound = lastDiscoveryTime == 0;
+        if (publishHomeAssistantDiscovery()) {
+            discoveryPending = false;
+            if (firstRound) {
+                publishDiagnostics(true);
+            }
         }
+    } else if (!discoveryPending && now - lastDiscoveryTime >= 3600000) { // Every hour
+        Serial.println("[MONITOR] Refreshing diagnostic entities discovery");
+        discoveryPending = true;
     }
 }
 
@@ -114,12 +129,13 @@ const char* SystemMonitor::getResetReasonString() const {
 }
 
 void SystemMonitor::publishDiagnostics(bool retain) {
-    if (!_mqttManager || !_mqttManager->connected()) {
+    // Also while disconnected: the spool keeps them for later
+    if (!_mqttManager) {
         return;
     }
     
     // Create JSON document
-    StaticJsonDocument<512> doc;
+    StaticJsonDocument<1024> doc;
     
     // Memory statistics
     size_t freeHeap = esp_get_free_heap_size();  // Define freeHeap here
@@ -157,6 +173,56 @@ void SystemMonitor::publishDiagnostics(bool retain) {
         doc["ntp_last_sync_age_hours"] = -1;
     }
     
+    // Display clock discipline
+    TimeService& clock = TimeService::getInstance();
+    if (clock.isValid()) {
+        doc["time_offset_us"] = clock.getLastOffsetUs();
+        doc["time_drift_ppm"] = clock.getDriftPpm();
+        doc["time_slew_remaining_us"] = clock.getSlewRemainingUs();
+    }
+    
+    // Display refresh statistics - latched/rendered shows how often the
+    // shift registers were actually written
+    DisplayHandler* display = GlobalState::getInstance().getDisplay();
+    if (display) {
+        doc["display_frames_rendered"] = display->getFramesRendered();
+        doc["display_frames_latched"] = display->getFramesLatched();
+        doc["display_subframes_latched"] = display->getSubframesLatched();
+        doc["display_wakeups"] = display->getWakeups();
+        doc["display_notified_wakeups"] = display->getNotifiedWakeups();
+    }
+    
+    // Adaptive sampling: work avoided compared with sampling and publishing
+    // every BME280_SAMPLE_INTERVAL
+    AdaptiveSampler& sampler = AdaptiveSampler::getInstance();
+    doc["sensor_interval_ms"] = sampler.getInterval();
+    doc["sensor_samples"] = sampler.getSamples();
+    doc["sensor_samples_saved"] = sampler.getSamplesSaved();
+    doc["sensor_publishes"] = sampler.getPublishes();
+    doc["sensor_publishes_saved"] = sampler.getPublishesSaved();
+    doc["sensor_count"] = SensorRegistry::getInstance().count();
+    doc["comfort_computed"] = ComfortMetrics::getInstance().getComputed();
+    doc["comfort_skipped"] = ComfortMetrics::getInstance().getSkipped();
+    
+    // I2C bus health; latency histograms are on /api/i2c
+    I2CBus& bus = I2CBus::getInstance();
+    doc["i2c_errors"] = bus.getStats(I2CBus::READ).errors + bus.getStats(I2CBus::WRITE).errors;
+    doc["i2c_recoveries"] = bus.getRecoveries();
+    
+    // Outbound publish queue; the full counters are on /api/mqtt
+    PublishQueue::Stats queue = PublishQueue::getInstance().getStats();
+    doc["mqtt_queue_depth"] = queue.depth;
+    doc["mqtt_queue_rejected"] = queue.rejected;
+    doc["mqtt_queue_dropped"] = queue.dropped;
+    MessageSpool::Stats spool = MessageSpool::getInstance().getStats();
+    doc["mqtt_spool_depth"] = spool.depth;
+    doc["mqtt_spool_dropped"] = spool.dropped;
+    MQTTManager::ConnectionStats connection = _mqttManager->getConnectionStats();
+    doc["mqtt_reconnects"] = connection.connects;
+    doc["mqtt_flaps"] = connection.flaps;
+    InFlightWindow::Stats inflight = _mqttManager->getInFlightStats();
+    doc["mqtt_ack_mean_ms"] = inflight.acknowledged ? (uint32_t)(inflight.totalMs / inflight.acknowledged) : 0;
+    
     // Get current time info if available
     struct tm timeinfo;
     if (getLocalTime(&timeinfo)) {
@@ -169,16 +235,15 @@ void SystemMonitor::publishDiagnostics(bool retain) {
         doc["current_time"] = "unavailable";
     }
     
-    String payload;
-    serializeJson(doc, payload);
+    // Too large for the stack; only this function writes it
+    static char payload[1152];
+    size_t length = serializeJson(doc, payload, sizeof(payload));
 
     Serial.println("[MONITOR] Publishing diagnostics to MQTT");
     
-    // Use MQTT_CLIENT_ID consistently, not a dynamically generated ID
-    String topic = String("chaoticvolt/") + String(MQTT_CLIENT_ID) + "/" + String(MQTT_TOPIC_AUX_DISPLAY) + "/diagnostics";
-    
-    Serial.printf("[MONITOR] Publishing to topic: %s\n", topic.c_str());
-    _mqttManager->publish(topic.c_str(), payload.c_str(), retain);
+    Serial.printf("[MONITOR] Publishing to topic: %s\n", MQTTTopics::DIAGNOSTICS);
+    _mqttManager->enqueueTelemetry(MQTTTopics::DIAGNOSTICS,
+                                   length + 1 < sizeof(payload) ? payload : nullptr, retain);
 }
 
 void SystemMonitor::publishMemoryWarning(size_t freeHeap, bool retain) {
@@ -186,21 +251,18 @@ void SystemMonitor::publishMemoryWarning(size_t freeHeap, bool retain) {
         return;
     }
     
-    StaticJsonDocument<256> doc;
-    doc["free_heap"] = freeHeap;
-    doc["min_free_heap"] = esp_get_minimum_free_heap_size();
-    doc["uptime_ms"] = millis() - _startupTime;
-    doc["warning"] = "Low memory";
-    
-    String payload;
-    serializeJson(doc, payload);
-    
-    // Use consistent topic construction
-    String topic = String("chaoticvolt/") + String(MQTT_CLIENT_ID) + "/" + String(MQTT_TOPIC_AUX_DISPLAY) + "/warnings";
-    
-    Serial.printf("[MONITOR] Publishing to topic: %s\n", topic.c_str());
-    Serial.println(payload); 
-    _mqttManager->publish(topic.c_str(), payload.c_str(), retain);
+    char buffer[128];
+    PayloadWriter json(buffer, sizeof(buffer));
+    json.add("free_heap", freeHeap);
+    json.add("min_free_heap", esp_get_minimum_free_heap_size());
+    json.add("uptime_ms", millis() - _startupTime);
+    json.add("warning", "Low memory");
+    const char* payload = json.finish();
+    
+    Serial.printf("[MONITOR] Publishing to topic: %s\n", MQTTTopics::WARNINGS);
+    Serial.println(payload ? payload : ""); 
+    // Makes room if it has to: this one matters more than older telemetry
+    _mqttManager->enqueue(MQTTTopics::WARNINGS, payload, retain, PublishQueue::DROP_OLDEST);
 }
 
 void SystemMonitor::publishTaskStacks(TaskHandle_t* taskHandles, const char** taskNames, size_t numTasks, bool retain) {
@@ -208,23 +270,19 @@ void SystemMonitor::publishTaskStacks(TaskHandle_t* taskHandles, const char** ta
         return;
     }
 
-    StaticJsonDocument<512> doc;
+    char buffer[256];
+    PayloadWriter json(buffer, sizeof(buffer));
     
     for (size_t i = 0; i < numTasks; i++) {
         if (taskHandles[i]) {
-            doc[taskNames[i]] = uxTaskGetStackHighWaterMark(taskHandles[i]);
+            json.add(taskNames[i], uxTaskGetStackHighWaterMark(taskHandles[i]));
         }
     }
+    const char* payload = json.finish();
     
-    String payload;
-    serializeJson(doc, payload);
-    
-    // Use consistent topic construction
-    String topic = String("chaoticvolt/") + String(MQTT_CLIENT_ID) + "/" + String(MQTT_TOPIC_AUX_DISPLAY) + "/system/tasks";
-    
-    Serial.printf("[MONITOR] Publishing to topic: %s\n", topic.c_str());
-    Serial.println(payload); 
-    _mqttManager->publish(topic.c_str(), payload.c_str(), retain);
+    Serial.printf("[MONITOR] Publishing to topic: %s\n", MQTTTopics::TASKS);
+    Serial.println(payload ? payload : ""); 
+    _mqttManager->enqueue(MQTTTopics::TASKS, payload, retain);
 }
 
 void SystemMonitor::publishStatus(bool online) {
@@ -232,14 +290,11 @@ void SystemMonitor::publishStatus(bool online) {
         return;
     }
     
-    // Use consistent topic construction
-    String statusTopic = String("chaoticvolt/") + String(MQTT_CLIENT_ID) + "/" + String(MQTT_TOPIC_AUX_DISPLAY) + "/status";
-    
     // Publish 'online' or 'offline' status with retain flag
     const char* status = online ? "online" : "offline";
-    _mqttManager->publish(statusTopic.c_str(), status, true);
+    _mqttManager->enqueue(MQTTTopics::STATUS, status, true);
     
-    Serial.printf("[MONITOR] Published status '%s' to: %s\n", status, statusTopic.c_str());
+    Serial.printf("[MONITOR] Queued status '%s' to: %s\n", status, MQTTTopics::STATUS);
 }
 
 void SystemMonitor::loadResetCount() {
@@ -263,15 +318,12 @@ void SystemMonitor::saveResetCount() {
     // prefs.putUInt("reset_count", _resetCount);
 }
 bool SystemMonitor::publishHomeAssistantDiscovery() {
-    if (!_mqttManager || !_mqttManager->connected()) {
-        Serial.println("[MONITOR] Cannot publish discovery - not connected to MQTT");
+    if (!_mqttManager) {
         return false;
     }
     
-    Serial.println("[MONITOR] Publishing diagnostic sensors to Home Assistant");
-    
     // Metrics to register - standard metrics and NTP metrics
-    const char* metrics[][4] = {
+    static const char* const metrics[][4] = {
         // Format: internal name, display name, unit, device class
         {"free_heap", "Free Heap", "bytes", ""},
         {"uptime_hours", "Uptime", "h", "duration"},
@@ -279,18 +331,41 @@ bool SystemMonitor::publishHomeAssistantDiscovery() {
         {"ntp_sync_successes", "NTP Sync Successes", "", ""},
         {"ntp_sync_failures", "NTP Sync Failures", "", ""},
         {"ntp_last_sync_age_hours", "NTP Last Sync Age", "h", "duration"},
-        {"heap_fragmentation", "Heap Fragmentation", "%", ""}
+        {"heap_fragmentation", "Heap Fragmentation", "%", ""},
+        {"display_frames_rendered", "Display Frames Rendered", "", ""},
+        {"display_frames_latched", "Display Frames Latched", "", ""},
+        {"display_wakeups", "Display Task Wakeups", "", ""},
+        {"display_notified_wakeups", "Display Notified Wakeups", "", ""},
+        {"time_offset_us", "Clock NTP Offset", "us", ""},
+        {"time_drift_ppm", "Clock Drift", "ppm", ""},
+        {"time_slew_remaining_us", "Clock Slew Remaining", "us", ""},
+        {"sensor_interval_ms", "Sensor Sample Interval", "ms", ""},
+        {"sensor_samples_saved", "Sensor Samples Saved", "", ""},
+        {"sensor_publishes_saved", "Sensor Publishes Saved", "", ""},
+        {"i2c_errors", "I2C Errors", "", ""},
+        {"i2c_recoveries", "I2C Bus Recoveries", "", ""},
+        {"mqtt_queue_depth", "MQTT Queue Depth", "", ""},
+        {"mqtt_queue_rejected", "MQTT Queue Rejected", "", ""},
+        {"mqtt_queue_dropped", "MQTT Queue Dropped", "", ""},
+        {"mqtt_spool_depth", "MQTT Spool Depth", "", ""},
+        {"mqtt_spool_dropped", "MQTT Spool Dropped", "", ""},
+        {"mqtt_reconnects", "MQTT Connects", "", ""},
+        {"mqtt_flaps", "MQTT Connection Flaps", "", ""},
+        {"mqtt_ack_mean_ms", "MQTT Mean PUBACK Latency", "ms", ""}
     };
     
-    int numMetrics = sizeof(metrics) / sizeof(metrics[0]);
-    Serial.printf("[MONITOR] Publishing discovery for %d metrics\n", numMetrics);
-    
-    bool success = true;
+    const uint8_t numMetrics = sizeof(metrics) / sizeof(metrics[0]);
+    if (discoveryNext == 0) {
+        Serial.printf("[MONITOR] Queueing discovery for %u metrics\n", numMetrics);
+    }
     
-    for (int i = 0; i < numMetrics; i++) {
+    // A full queue stops here; the next call carries on from this metric
+    for (; discoveryNext < numMetrics; discoveryNext++) {
+        const char* const* metric = metrics[discoveryNext];
+
         // Create a unique ID with version suffix
         char uniqueId[64];
-        sprintf(uniqueId, "%s_%s_v3", MQTT_CLIENT_ID, metrics[i][0]);
+        sprintf(uniqueId, "%s_%s_v3", MQTT_CLIENT_ID, metric[0]);
         
         // Create the discovery topic - use the same format as temperature/humidity
         char discoveryTopic[128];
@@ -309,51 +384,49 @@ bool SystemMonitor::publishHomeAssistantDiscovery() {
         device["mf"] = "chaoticvolt";
         
         // Set entity attributes
-        doc["name"] = String(MQTT_CLIENT_ID) + " " + metrics[i][1];
+        char name[96];
+        snprintf(name, sizeof(name), "%s %s", MQTT_CLIENT_ID, metric[1]);
+        doc["name"] = name;
         doc["uniq_id"] = uniqueId;
         
         // Set state topic to the diagnostics topic
-        char stateTopic[128];
-        sprintf(stateTopic, "chaoticvolt/%s/%s/diagnostics", MQTT_CLIENT_ID, MQTT_TOPIC_AUX_DISPLAY);
-        doc["stat_t"] = stateTopic;
+        doc["stat_t"] = MQTTTopics::DIAGNOSTICS;
         
         // Set value template
         char valueTemplate[64];
-        sprintf(valueTemplate, "{{ value_json.%s }}", metrics[i][0]);
+        sprintf(valueTemplate, "{{ value_json.%s }}", metric[0]);
         doc["val_tpl"] = valueTemplate;
         
         // Set unit of measurement if provided
-        if (strlen(metrics[i][2]) > 0) {
-            doc["unit_of_meas"] = metrics[i][2];
+        if (strlen(metric[2]) > 0) {
+            doc["unit_of_meas"] = metric[2];
         }
         
         // Set device class if provided
-        if (strlen(metrics[i][3]) > 0) {
-            doc["dev_cla"] = metrics[i][3];
+        if (strlen(metric[3]) > 0) {
+            doc["dev_cla"] = metric[3];
         }
         
         // Set availability topic
-        char availabilityTopic[128];
-        sprintf(availabilityTopic, "chaoticvolt/%s/%s/status", MQTT_CLIENT_ID, MQTT_TOPIC_AUX_DISPLAY);
-        doc["avty_t"] = availabilityTopic;
+        doc["avty_t"] = MQTTTopics::STATUS;
         
         // Serialize to JSON
-        String payload;
-        serializeJson(doc, payload);
-        
-        Serial.printf("[MONITOR] Publishing discovery for %s to %s\n", metrics[i][0], discoveryTopic);
+        char payload[512];
+        size_t length = serializeJson(doc, payload, sizeof(payload));
         
-        // Publish with retain flag
-        if (!_mqttManager->publish(discoveryTopic, payload.c_str(), true)) {
-            Serial.printf("[MONITOR] Failed to publish discovery for %s\n", metrics[i][0]);
-            success = false;
+        if (length + 1 >= sizeof(payload)) {
+            Serial.printf("[MONITOR] Discovery for %s did not fit, skipped\n", metric[0]);
+            continue;
         }
         
-        // Short delay between publishes to prevent overwhelming broker
-        delay(250);
+        // Retained, so a queued copy from an earlier round is replaced
+        if (!_mqttManager->enqueue(discoveryTopic, payload, true)) {
+            return false;
+        }
     }
     
     // Update discovery time
+    discoveryNext = 0;
     lastDiscoveryTime = millis();
-    return success;
-}
\ No newline at end of file
+    return true;
+}
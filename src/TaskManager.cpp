@@ -7,7 +7,8 @@
 
 #include "TaskManager.h"
 #include "SystemDefinitions.h"
-#include <ArduinoJson.h>
+#include "PayloadWriter.h"
+#include "MQTTTopics.h"
 
 bool TaskManager::initializeTasks() {
 
@@ -154,25 +155,23 @@ void TaskManager::monitorTaskStacks(MQTTManager* mqttManager) {
     
     // Only publish to MQTT if mqttManager is provided and connected
     if (mqttManager && mqttManager->connected()) {
-        StaticJsonDocument<512> doc;
+        char buffer[128];
+        PayloadWriter json(buffer, sizeof(buffer));
         
         if (displayTaskHandle) {
-            doc["display_stack"] = uxTaskGetStackHighWaterMark(displayTaskHandle);
+            json.add("display_stack", uxTaskGetStackHighWaterMark(displayTaskHandle));
         }
         if (sensorTaskHandle) {
-            doc["sensor_stack"] = uxTaskGetStackHighWaterMark(sensorTaskHandle);
+            json.add("sensor_stack", uxTaskGetStackHighWaterMark(sensorTaskHandle));
         }
         if (networkTaskHandle) {
-            doc["network_stack"] = uxTaskGetStackHighWaterMark(networkTaskHandle);
+            json.add("network_stack", uxTaskGetStackHighWaterMark(networkTaskHandle));
         }
         if (watchdogTaskHandle) {
-            doc["watchdog_stack"] = uxTaskGetStackHighWaterMark(watchdogTaskHandle);
+            json.add("watchdog_stack", uxTaskGetStackHighWaterMark(watchdogTaskHandle));
         }
         
-        String payload;
-        serializeJson(doc, payload);
-        
-        mqttManager->publish("system/tasks", payload.c_str(), true);
+        mqttManager->enqueue(MQTTTopics::TASKS, json.finish(), true);
     }
 }
 
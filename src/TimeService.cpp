@@ -0,0 +1,160 @@
+#include "TimeService.h"
+#include "config.h"
+#include <esp_timer.h>
+
+namespace {
+
+const int64_t USEC_PER_SEC = 1000000LL;
+const int64_t PPB = 1000000000LL;
+
+// Shorter sync intervals are too noisy to learn the skew from
+const int64_t MIN_SKEW_INTERVAL_US = 60LL * USEC_PER_SEC;
+
+// value * ppb / 1e9 without overflowing for long intervals
+int64_t scalePpb(int64_t value, int64_t ppb) {
+    return (value / PPB) * ppb + (value % PPB) * ppb / PPB;
+}
+
+int64_t clampSigned(int64_t value, int64_t limit) {
+    if (value > limit) return limit;
+    if (value < -limit) return -limit;
+    return value;
+}
+
+} // namespace
+
+TimeService::TimeService()
+    : lock(portMUX_INITIALIZER_UNLOCKED),
+      model{false, 0, 0, 0, 0},
+      lastSyncMono(0),
+      lastOffsetUs(0),
+      syncCount(0),
+      stepCount(0)
+{
+}
+
+int32_t TimeService::slewAppliedAt(const Model& m, int64_t monoUs) {
+    if (m.slewUs == 0) {
+        return 0;
+    }
+    int64_t elapsed = monoUs - m.anchorMono;
+    int64_t applied = scalePpb(elapsed, TIME_SLEW_RATE_PPM * 1000LL);
+    int64_t magnitude = m.slewUs < 0 ? -(int64_t)m.slewUs : m.slewUs;
+    if (applied >= magnitude) {
+        return m.slewUs;
+    }
+    return (int32_t)(m.slewUs < 0 ? -applied : applied);
+}
+
+int64_t TimeService::utcAt(const Model& m, int64_t monoUs) {
+    int64_t elapsed = monoUs - m.anchorMono;
+    return m.anchorUtc + elapsed + scalePpb(elapsed, m.skewPpb) + slewAppliedAt(m, monoUs);
+}
+
+TimeService::Model TimeService::snapshot() const {
+    portENTER_CRITICAL(&lock);
+    Model copy = model;
+    portEXIT_CRITICAL(&lock);
+    return copy;
+}
+
+void TimeService::onNtpSync(int64_t utcUs, int64_t monoUs) {
+    bool stepped = false;
+    int64_t offset = 0;
+    float driftPpm = 0;
+
+    portENTER_CRITICAL(&lock);
+    if (!model.valid) {
+        stepped = true;
+    } else {
+        int64_t predicted = utcAt(model, monoUs);
+        offset = utcUs - predicted;
+
+        if (offset > TIME_STEP_THRESHOLD_US || offset < -TIME_STEP_THRESHOLD_US) {
+            stepped = true;
+        } else {
+            // Whatever the previous slew did not get to yet is part of the
+            // offset but says nothing about the oscillator
+            int32_t unapplied = model.slewUs - slewAppliedAt(model, monoUs);
+            int64_t interval = monoUs - lastSyncMono;
+            if (interval >= MIN_SKEW_INTERVAL_US) {
+                int64_t driftPpb = (offset - unapplied) * PPB / interval;
+                // Half-gain update smooths out per-sample NTP jitter
+                model.skewPpb = (int32_t)clampSigned(model.skewPpb + driftPpb / 2,
+                                                     TIME_MAX_SKEW_PPM * 1000LL);
+            }
+
+            // Rebase on the current estimate so the clock stays continuous,
+            // then slew the full offset in from here
+            model.anchorUtc = predicted;
+            model.anchorMono = monoUs;
+            model.slewUs = (int32_t)offset;
+        }
+    }
+
+    if (stepped) {
+        model.anchorUtc = utcUs;
+        model.anchorMono = monoUs;
+        model.slewUs = 0;
+        model.valid = true;
+        stepCount++;
+    }
+    lastSyncMono = monoUs;
+    lastOffsetUs = (int32_t)clampSigned(offset, INT32_MAX);
+    syncCount++;
+    driftPpm = model.skewPpb / 1000.0f;
+    portEXIT_CRITICAL(&lock);
+
+    if (stepped) {
+        Serial.printf("[TIME] Clock set from NTP (offset %lld us)\n", (long long)offset);
+    } else {
+        Serial.printf("[TIME] NTP offset %lld us, slewing, drift %.2f ppm\n",
+                      (long long)offset, driftPpm);
+    }
+}
+
+bool TimeService::isValid() const {
+    return snapshot().valid;
+}
+
+int64_t TimeService::monotonicUs() const {
+    return esp_timer_get_time();
+}
+
+int64_t TimeService::nowUs() const {
+    Model m = snapshot();
+    if (!m.valid) {
+        return 0;
+    }
+    return utcAt(m, esp_timer_get_time());
+}
+
+bool TimeService::getLocalTime(struct tm& info, uint16_t* millis) const {
+    Model m = snapshot();
+    if (!m.valid) {
+        return false;
+    }
+    int64_t utc = utcAt(m, esp_timer_get_time());
+    time_t seconds = (time_t)(utc / USEC_PER_SEC);
+    localtime_r(&seconds, &info);
+    if (millis) {
+        *millis = (uint16_t)((utc % USEC_PER_SEC) / 1000);
+    }
+    return true;
+}
+
+int32_t TimeService::getLastOffsetUs() const {
+    portENTER_CRITICAL(&lock);
+    int32_t offset = lastOffsetUs;
+    portEXIT_CRITICAL(&lock);
+    return offset;
+}
+
+float TimeService::getDriftPpm() const {
+    return snapshot().skewPpb / 1000.0f;
+}
+
+int32_t TimeService::getSlewRemainingUs() const {
+    Model m = snapshot();
+    return m.slewUs - slewAppliedAt(m, esp_timer_get_time());
+}
@@ -11,10 +11,23 @@
 #include <base64.h>
 #include "BabelSensor.h"
 #include "WiFiConnectionManager.h"
+#include "SensorHistory.h"
+#include "HistoryLog.h"
+#include "AdaptiveSampler.h"
+#include "SensorFilter.h"
+#include "SensorRegistry.h"
+#include "I2CBus.h"
+#include "ComfortMetrics.h"
+#include "MQTTManager.h"
+#include "PublishQueue.h"
+#include "MessageSpool.h"
+#include "TimeService.h"
+#include <esp_timer.h>
 
 extern BabelSensor babelSensor;
 extern GlobalState* g_state;
 extern PreferencesManager prefsManager;
+extern MQTTManager mqttManager;
 static String cachedPreferencesJson;
 static unsigned long lastPreferencesCacheTime = 0;
 static const unsigned long PREFERENCES_CACHE_DURATION = 10000; // 10 seconds
@@ -150,6 +163,13 @@ void handleGetPreferences() {
     data["hasMqttPassword"] = prefs.mqttPassword.length() > 0;
     data["mqttPublishInterval"] = prefs.mqttPublishInterval;
     
+    // Display rotation
+    data["displayPlaylist"] = prefs.displayPlaylist;
+    
+    // Sensor acquisition and filtering
+    data["sensorFilter"] = prefs.sensorFilter;
+    data["sensorAltitude"] = prefs.sensorAltitude;
+    
     // Cache the serialized response
     cachedPreferencesJson = "";
     serializeJson(doc, cachedPreferencesJson);
@@ -255,6 +275,42 @@ void handleSetPreferences() {
             prefs.mqttPublishInterval = interval;
         }
         
+        if (doc.containsKey("displayPlaylist")) {
+            String playlist = doc["displayPlaylist"].as<String>();
+            playlist.trim();
+            DisplayPlaylist check;
+            if (!check.compile(playlist)) {
+                server->send(400, "application/json", 
+                    "{\"success\":false,\"error\":\"Invalid display playlist\"}");
+                return;
+            }
+            prefs.displayPlaylist = playlist;
+        }
+
+        SensorFilter::Settings filterSettings;
+        bool filterChanged = false;
+        if (doc.containsKey("sensorFilter")) {
+            String filter = doc["sensorFilter"].as<String>();
+            filter.trim();
+            if (!SensorFilter::parse(filter, filterSettings)) {
+                server->send(400, "application/json", 
+                    "{\"success\":false,\"error\":\"Invalid sensor filter\"}");
+                return;
+            }
+            filterChanged = filter != prefs.sensorFilter;
+            prefs.sensorFilter = filter;
+        }
+
+        if (doc.containsKey("sensorAltitude")) {
+            int altitude = doc["sensorAltitude"].as<int>();
+            if (altitude < ComfortMetrics::MIN_ALTITUDE || altitude > ComfortMetrics::MAX_ALTITUDE) {
+                server->send(400, "application/json", 
+                    "{\"success\":false,\"error\":\"Altitude must be between -500 and 5000 m\"}");
+                return;
+            }
+            prefs.sensorAltitude = (int16_t)altitude;
+        }
+        
         // Save preferences (this also updates the cache)
         PreferencesManager::saveDisplayPreferences(prefs);
         
@@ -267,6 +323,12 @@ void handleSetPreferences() {
             display->setDisplayPreferences(prefs);
         }
         
+        // Restarts the filters, so only when something changed
+        if (filterChanged) {
+            SensorFilter::getInstance().setSettings(filterSettings);
+        }
+        ComfortMetrics::getInstance().setAltitude(prefs.sensorAltitude);
+        
         // Update BabelSensor if it exists (assumes global access to it)
         extern BabelSensor babelSensor;
         if (prefs.useSensorhub) {
@@ -443,6 +505,332 @@ void handleRelayControl() {
     server->send(405, "application/json", "{\"success\":false,\"error\":\"Method not allowed\"}");
 }
 
+void handleDisplayMessage() {
+    auto& webManager = WebServerManager::getInstance();
+    WebServer* server = webManager.getServer();
+    if (!server) return;
+
+    addCorsHeaders(server);
+
+    if (!server->hasArg("plain")) {
+        server->send(400, "application/json", "{\"success\":false,\"error\":\"No data received\"}");
+        return;
+    }
+
+    StaticJsonDocument<256> doc;
+    DeserializationError error = deserializeJson(doc, server->arg("plain"));
+    if (error || !doc.containsKey("message")) {
+        server->send(400, "application/json", "{\"success\":false,\"error\":\"Missing message\"}");
+        return;
+    }
+
+    DisplayHandler* display = g_state->getDisplay();
+    if (!display) {
+        server->send(503, "application/json", "{\"success\":false,\"error\":\"Display not ready\"}");
+        return;
+    }
+
+    // An empty message cancels the one currently shown
+    const char* message = doc["message"] | "";
+    if (display->showMessage(message)) {
+        server->send(200, "application/json", "{\"success\":true}");
+    } else {
+        server->send(503, "application/json", "{\"success\":false,\"error\":\"Display busy\"}");
+    }
+}
+
+namespace {
+
+// Collects small formatted pieces and hands them to the server as chunks,
+// so a response never needs more than this buffer
+class ChunkedWriter {
+public:
+    explicit ChunkedWriter(WebServer* server) : server(server), length(0) {}
+
+    void printf(const char* format, ...) {
+        va_list args;
+        va_start(args, format);
+        int n = vsnprintf(buffer + length, sizeof(buffer) - length, format, args);
+        va_end(args);
+        if (n >= 0 && (size_t)n >= sizeof(buffer) - length && length > 0) {
+            // Did not fit behind what is already buffered, retry on its own
+            flush();
+            va_start(args, format);
+            n = vsnprintf(buffer, sizeof(buffer), format, args);
+            va_end(args);
+        }
+        if (n > 0) {
+            length += (size_t)n < sizeof(buffer) - length ? (size_t)n : sizeof(buffer) - length - 1;
+        }
+    }
+
+    void flush() {
+        if (length > 0) {
+            server->sendContent(buffer, length);
+            length = 0;
+        }
+    }
+
+private:
+    WebServer* server;
+    char buffer[512];
+    size_t length;
+};
+
+} // namespace
+
+void handleGetHistory() {
+    auto& webManager = WebServerManager::getInstance();
+    WebServer* server = webManager.getServer();
+    if (!server) return;
+
+    addCorsHeaders(server);
+
+    auto& history = SensorHistory::getInstance();
+    size_t available = history.size();
+    size_t first = 0;
+    if (server->hasArg("limit")) {
+        long limit = server->arg("limit").toInt();
+        if (limit >= 0 && (size_t)limit < available) {
+            first = available - (size_t)limit;
+        }
+    }
+
+    // Samples carry monotonic time; turn it into Unix time once the clock
+    // is set, otherwise report seconds since boot
+    auto& timeService = TimeService::getInstance();
+    bool timeValid = timeService.isValid();
+    int64_t monoNowMs = esp_timer_get_time() / 1000;
+    int64_t offsetMs = timeValid ? timeService.nowUs() / 1000 - monoNowMs : 0;
+
+    server->setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server->send(200, "application/json", "");
+
+    ChunkedWriter out(server);
+    out.printf("{\"capacity\":%u,\"interval_ms\":%u,\"time_valid\":%s,\"rollups\":{",
+               (unsigned)history.capacity(), (unsigned)AdaptiveSampler::getInstance().getInterval(),
+               timeValid ? "true" : "false");
+
+    for (uint8_t w = 0; w < SensorHistory::WINDOW_COUNT; w++) {
+        auto window = (SensorHistory::Window)w;
+        SensorHistory::Stats stats;
+        bool haveStats = history.getStats(window, stats);
+        out.printf("%s\"%s\":{\"count\":%u", w ? "," : "",
+                   SensorHistory::windowName(window), (unsigned)stats.count);
+        for (uint8_t c = 0; haveStats && c < SensorHistory::CHANNEL_COUNT; c++) {
+            out.printf(",\"%s\":{\"min\":%.2f,\"max\":%.2f,\"mean\":%.2f}",
+                       SensorHistory::channelName((SensorHistory::Channel)c),
+                       stats.min[c], stats.max[c], stats.mean[c]);
+        }
+        out.printf("}");
+    }
+
+    out.printf("},\"fields\":[\"time\",\"temperature\",\"humidity\",\"pressure\"],\"samples\":[");
+    SensorHistory::Sample sample;
+    for (size_t i = first; history.getSample(i, sample); i++) {
+        // timeMs wraps with the 32-bit millisecond counter, the age does not
+        uint32_t ageMs = (uint32_t)monoNowMs - sample.timeMs;
+        int64_t timeMs = monoNowMs - ageMs + offsetMs;
+        out.printf("%s[%lld,%.2f,%.2f,%.2f]", i > first ? "," : "",
+                   (long long)(timeMs / 1000),
+                   sample.values[SensorHistory::TEMPERATURE],
+                   sample.values[SensorHistory::HUMIDITY],
+                   sample.values[SensorHistory::PRESSURE]);
+    }
+    out.printf("]}");
+    out.flush();
+    server->sendContent("");
+}
+
+void handleGetHistoryLog() {
+    auto& webManager = WebServerManager::getInstance();
+    WebServer* server = webManager.getServer();
+    if (!server) return;
+
+    addCorsHeaders(server);
+
+    // Unix seconds; the last 24 hours unless a range is given
+    uint32_t now = (uint32_t)(TimeService::getInstance().nowUs() / 1000000LL);
+    uint32_t to = server->hasArg("to") ? strtoul(server->arg("to").c_str(), nullptr, 10) : now;
+    uint32_t from = server->hasArg("from") ? strtoul(server->arg("from").c_str(), nullptr, 10)
+                                           : (to > 86400 ? to - 86400 : 0);
+    if (from > to) {
+        server->send(400, "application/json", "{\"error\":\"from is after to\"}");
+        return;
+    }
+
+    server->setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server->send(200, "application/json", "");
+
+    ChunkedWriter out(server);
+    out.printf("{\"interval_s\":%u,\"from\":%lu,\"to\":%lu,"
+               "\"fields\":[\"time\",\"temperature\",\"humidity\",\"pressure\"],\"samples\":[",
+               (unsigned)HISTORY_LOG_INTERVAL, (unsigned long)from, (unsigned long)to);
+    bool first = true;
+    HistoryLog::getInstance().read(from, to, [&](const HistoryLog::Record& record) {
+        out.printf("%s[%lu,%.2f,%.2f,%.2f]", first ? "" : ",", (unsigned long)record.time,
+                   record.values[0] / 100.0f, record.values[1] / 100.0f, record.values[2] / 100.0f);
+        first = false;
+        return true;
+    });
+    out.printf("]}");
+    out.flush();
+    server->sendContent("");
+}
+
+void handleGetSensors() {
+    auto& webManager = WebServerManager::getInstance();
+    WebServer* server = webManager.getServer();
+    if (!server) return;
+
+    addCorsHeaders(server);
+
+    // All sensors, or the one picked with ?index=N
+    auto& sensors = SensorRegistry::getInstance();
+    uint8_t first = 0;
+    uint8_t last = sensors.count();
+    if (server->hasArg("index")) {
+        String arg = server->arg("index");
+        long index = arg.toInt();
+        if (index < 0 || index >= sensors.count() || (index == 0 && arg != "0")) {
+            server->send(404, "application/json", "{\"error\":\"No such sensor\"}");
+            return;
+        }
+        first = (uint8_t)index;
+        last = first + 1;
+    }
+
+    char response[160 + 288 * SensorRegistry::MAX_SENSORS];
+    size_t length = snprintf(response, sizeof(response), "{\"count\":%u,\"sensors\":[",
+                             sensors.count());
+    uint32_t now = millis();
+    for (uint8_t i = first; i < last && length < sizeof(response); i++) {
+        SensorRegistry::Reading reading;
+        bool valid = sensors.getReading(i, reading);
+        length += snprintf(response + length, sizeof(response) - length,
+                           "%s{\"index\":%u,\"address\":\"0x%02X\",\"valid\":%s",
+                           i > first ? "," : "", i, sensors.getAddress(i),
+                           valid ? "true" : "false");
+        if (valid && length < sizeof(response)) {
+            length += snprintf(response + length, sizeof(response) - length,
+                               ",\"temperature\":%.2f,\"humidity\":%.2f,\"pressure\":%.2f,"
+                               "\"age_ms\":%lu,\"interval_ms\":%lu",
+                               reading.temperature, reading.humidity, reading.pressure,
+                               (unsigned long)(now - reading.updateTime),
+                               (unsigned long)AdaptiveSampler::getInstance().getInterval(i));
+        }
+        ComfortMetrics::Values comfort;
+        if (valid && ComfortMetrics::getInstance().get(i, comfort) && length < sizeof(response)) {
+            length += snprintf(response + length, sizeof(response) - length,
+                               ",\"dew_point\":%.2f,\"absolute_humidity\":%.2f,"
+                               "\"heat_index\":%.2f,\"sea_level_pressure\":%.2f",
+                               comfort.dewPoint, comfort.absoluteHumidity, comfort.heatIndex,
+                               comfort.seaLevelPressure);
+        }
+        if (length < sizeof(response)) {
+            length += snprintf(response + length, sizeof(response) - length, "}");
+        }
+    }
+    if (length < sizeof(response)) {
+        snprintf(response + length, sizeof(response) - length, "]}");
+    }
+    server->send(200, "application/json", response);
+}
+
+void handleGetI2CStats() {
+    auto& webManager = WebServerManager::getInstance();
+    WebServer* server = webManager.getServer();
+    if (!server) return;
+
+    addCorsHeaders(server);
+
+    auto& bus = I2CBus::getInstance();
+    server->setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server->send(200, "application/json", "");
+
+    ChunkedWriter out(server);
+    out.printf("{\"recoveries\":%lu,\"failed_recoveries\":%lu,\"transactions_saved\":%lu,"
+               "\"bucket_limits_us\":[",
+               (unsigned long)bus.getRecoveries(), (unsigned long)bus.getFailedRecoveries(),
+               (unsigned long)bus.getTransactionsSaved());
+    for (uint8_t b = 0; b + 1 < I2CBus::HISTOGRAM_BUCKETS; b++) {
+        out.printf("%s%lu", b ? "," : "", (unsigned long)I2CBus::bucketLimitUs(b));
+    }
+    out.printf("]");
+
+    for (uint8_t k = 0; k < I2CBus::KIND_COUNT; k++) {
+        auto kind = (I2CBus::Kind)k;
+        I2CBus::Stats stats = bus.getStats(kind);
+        out.printf(",\"%s\":{\"count\":%lu,\"errors\":%lu,\"max_us\":%lu,\"mean_us\":%lu,"
+                   "\"histogram\":[",
+                   I2CBus::kindName(kind), (unsigned long)stats.count, (unsigned long)stats.errors,
+                   (unsigned long)stats.maxUs,
+                   (unsigned long)(stats.count ? stats.totalUs / stats.count : 0));
+        for (uint8_t b = 0; b < I2CBus::HISTOGRAM_BUCKETS; b++) {
+            out.printf("%s%lu", b ? "," : "", (unsigned long)stats.buckets[b]);
+        }
+        out.printf("]}");
+    }
+    out.printf("}");
+    out.flush();
+    server->sendContent("");
+}
+
+void handleGetMqttStats() {
+    auto& webManager = WebServerManager::getInstance();
+    WebServer* server = webManager.getServer();
+    if (!server) return;
+
+    addCorsHeaders(server);
+
+    PublishQueue::Stats queue = PublishQueue::getInstance().getStats();
+    MessageSpool::Stats spool = MessageSpool::getInstance().getStats();
+    MQTTManager::ConnectionStats connection = mqttManager.getConnectionStats();
+    InFlightWindow::Stats inflight = mqttManager.getInFlightStats();
+    server->setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server->send(200, "application/json", "");
+
+    ChunkedWriter out(server);
+    out.printf("{\"connection\":{\"state\":\"%s\",\"attempts\":%lu,\"failures\":%lu,\"connects\":%lu,"
+               "\"drops\":%lu,\"flaps\":%lu,\"last_reconnect_ms\":%lu,\"max_reconnect_ms\":%lu,"
+               "\"backoff_ms\":%lu},",
+               MQTTManager::stateName(mqttManager.getState()),
+               (unsigned long)connection.attempts, (unsigned long)connection.failures,
+               (unsigned long)connection.connects, (unsigned long)connection.drops,
+               (unsigned long)connection.flaps, (unsigned long)connection.lastReconnectMs,
+               (unsigned long)connection.maxReconnectMs, (unsigned long)connection.backoffMs);
+    out.printf("\"queue\":{\"depth\":%u,\"bytes\":%u,\"capacity\":%u,\"high_water\":%u,"
+               "\"enqueued\":%lu,\"coalesced\":%lu,\"rejected\":%lu,\"dropped\":%lu,"
+               "\"sent\":%lu,\"failed\":%lu,\"abandoned\":%lu},",
+               queue.depth, queue.bytes, (unsigned)MQTT_QUEUE_BYTES, queue.highWater,
+               (unsigned long)queue.enqueued, (unsigned long)queue.coalesced,
+               (unsigned long)queue.rejected, (unsigned long)queue.dropped,
+               (unsigned long)queue.sent, (unsigned long)queue.failed, (unsigned long)queue.abandoned);
+    out.printf("\"inflight\":{\"qos\":%d,\"window\":%d,\"depth\":%u,\"bytes\":%u,\"sent\":%lu,"
+               "\"acknowledged\":%lu,\"retransmitted\":%lu,\"unknown_acks\":%lu,"
+               "\"ack_last_ms\":%lu,\"ack_max_ms\":%lu,\"ack_mean_ms\":%lu,\"bucket_limits_ms\":[",
+               MQTT_QOS, MQTT_INFLIGHT_WINDOW, inflight.depth, inflight.bytes,
+               (unsigned long)inflight.sent, (unsigned long)inflight.acknowledged,
+               (unsigned long)inflight.retransmitted, (unsigned long)inflight.unknownAcks,
+               (unsigned long)inflight.lastMs, (unsigned long)inflight.maxMs,
+               (unsigned long)(inflight.acknowledged ? inflight.totalMs / inflight.acknowledged : 0));
+    for (uint8_t b = 0; b + 1 < InFlightWindow::HISTOGRAM_BUCKETS; b++) {
+        out.printf("%s%lu", b ? "," : "", (unsigned long)InFlightWindow::bucketLimitMs(b));
+    }
+    out.printf("],\"histogram\":[");
+    for (uint8_t b = 0; b < InFlightWindow::HISTOGRAM_BUCKETS; b++) {
+        out.printf("%s%lu", b ? "," : "", (unsigned long)inflight.buckets[b]);
+    }
+    out.printf("]},");
+    out.printf("\"spool\":{\"depth\":%lu,\"bytes\":%u,\"capacity\":%u,\"segments\":%u,"
+               "\"stored\":%lu,\"replayed\":%lu,\"spilled\":%lu,\"dropped\":%lu}}",
+               (unsigned long)spool.depth, spool.bytes, (unsigned)MQTT_SPOOL_BYTES, spool.segments,
+               (unsigned long)spool.stored, (unsigned long)spool.replayed,
+               (unsigned long)spool.spilled, (unsigned long)spool.dropped);
+    out.flush();
+    server->sendContent("");
+}
+
 void setupWebHandlers() {
     auto& webManager = WebServerManager::getInstance();
     WebServer* server = webManager.getServer();
@@ -476,6 +864,18 @@ void setupWebHandlers() {
         server->send(204);
     });
 
+    // Display message handler
+    server->on("/api/display/message", HTTP_POST, handleDisplayMessage);
+
+    // Sensor history
+    server->on("/api/history", HTTP_GET, handleGetHistory);
+    server->on("/api/history/log", HTTP_GET, handleGetHistoryLog);
+
+    // Current readings per sensor
+    server->on("/api/sensors", HTTP_GET, handleGetSensors);
+    server->on("/api/i2c", HTTP_GET, handleGetI2CStats);
+    server->on("/api/mqtt", HTTP_GET, handleGetMqttStats);
+
     // Icon handler
     server->on("/icon.svg", HTTP_GET, handleIcon);
 
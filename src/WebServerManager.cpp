@@ -259,6 +259,22 @@ void WebServerManager::setupHandlers() {
         }
     });
 
+    // Register display message handler
+    _server->on("/api/display/message", HTTP_POST, handleDisplayMessage);
+
+    // Register sensor history handlers
+    _server->on("/api/history", HTTP_GET, handleGetHistory);
+    _server->on("/api/history/log", HTTP_GET, handleGetHistoryLog);
+
+    // Register current sensor readings handler
+    _server->on("/api/sensors", HTTP_GET, handleGetSensors);
+
+    // Register I2C bus statistics handler
+    _server->on("/api/i2c", HTTP_GET, handleGetI2CStats);
+
+    // Register MQTT publish queue statistics handler
+    _server->on("/api/mqtt", HTTP_GET, handleGetMqttStats);
+
     // Must be last - handle captive portal and 404s
     _server->onNotFound(handleCaptivePortal);
 }
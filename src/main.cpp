@@ -5,6 +5,8 @@
 #include <esp_task_wdt.h>
 #include <esp_system.h>
 #include <time.h>
+#include <sys/time.h>
+#include <esp_timer.h>
 #include "GlobalState.h"
 #include "DisplayHandler.h"
 #include "BME280Handler.h"
@@ -20,6 +22,18 @@
 #include "TaskManager.h"
 #include <esp_wifi.h>
 #include "WiFiConnectionManager.h"
+#include "TimeService.h"
+#include "SntpClient.h"
+#include "HistoryLog.h"
+#include "AdaptiveSampler.h"
+#include "SensorFilter.h"
+#include "SensorRegistry.h"
+#include "I2CBus.h"
+#include "ComfortMetrics.h"
+#include "MQTTTopics.h"
+#include "PayloadWriter.h"
+#include "PublishQueue.h"
+#include "MessageSpool.h"
 
 // System Constants
 constexpr uint32_t BOOT_DELAY_MS = 250;
@@ -44,7 +58,6 @@ SystemMonitor sysMonitor(&mqttManager);
 RelayControlHandler* g_relayHandler = nullptr;
 BabelSensor babelSensor(SENSORHUB_URL);
 static DisplayHandler* display = nullptr;
-static BME280Handler bme280;
 
 // Network status tracking
 enum class NetworkStatus {
@@ -58,15 +71,17 @@ enum class NetworkStatus {
 NetworkStatus networkStatus = NetworkStatus::DISCONNECTED;
 bool mqttInitialized = false;
 bool ntpInitialized = false;
+static bool sntpStarted = false;
 bool webServerInitialized = false;
 static unsigned long lastDiscoveryAttempt = 0;
-static bool initialDiscoveryDone = false;
+static bool discoveryPending = true;
 static unsigned long lastWdtReset = 0;
 static unsigned long lastRemoteTempUpdate = 0;
 static unsigned long lastReconnectAttempt = 0;
 static unsigned long lastMemoryCheck = 0;
 static unsigned long lastStackCheck = 0;
 static float lastBabelTemp = 0.0;
+static unsigned long lastBabelReading = 0;
 static uint32_t minHeapSeen = UINT32_MAX;
 static uint8_t mqttReconnectCount = 0;
 
@@ -95,6 +110,7 @@ bool initializeSystem();
 void setupRelayControl();
 bool setupMDNS();
 bool setupNTP();
+void onNtpResult(bool success, const SntpSample& sample);
 void initializeMQTT();
 bool initializeWebServerManager();
 bool setupNetwork();
@@ -122,10 +138,7 @@ void startPortalMode() {
         
         // Show "AP" on display
         if (display) {
-            display->setDigit(0, CHAR_A);
-            display->setDigit(1, CHAR_P);
-            display->setDigit(2, CHAR_BLANK);
-            display->setDigit(3, CHAR_BLANK);
+            display->showText("AP");
             display->update();
         }
     } else {
@@ -177,12 +190,10 @@ void setup() {
                     Serial.println("Warning: mDNS setup failed");
                 }
                 
-                // Setup NTP now that we have connectivity
-                if (setupNTP()) {
-                    Serial.println("NTP synchronization successful");
-                    lastNtpSync = millis();
-                } else {
-                    Serial.println("NTP synchronization failed, will retry later");
+                // Setup NTP now that we have connectivity; the result
+                // arrives later through onNtpResult()
+                if (!setupNTP()) {
+                    Serial.println("NTP synchronization could not be started, will retry later");
                     lastNtpSync = millis() - NTP_SYNC_INTERVAL + 60000; // Retry in 1 minute
                 }
                 
@@ -208,17 +219,11 @@ void setup() {
     
     // Display initialization screen
     if (display) {
-        display->setDigit(0, CHAR_BLANK);
-        display->setDigit(1, CHAR_BLANK);
-        display->setDigit(2, CHAR_BLANK);
-        display->setDigit(3, CHAR_BLANK);
+        display->clear();
         display->update();
         delay(500);
         
-        display->setDigit(0, CHAR_I);
-        display->setDigit(1, CHAR_n);
-        display->setDigit(2, CHAR_I);
-        display->setDigit(3, CHAR_t);
+        display->showText("Init");
         display->update();
     }
 
@@ -243,8 +248,8 @@ void setup() {
         startPortalMode();
     }
 
-    // Initialize BME280 sensor (works with or without WiFi)
-    if (!bme280.init()) {
+    // Find the BME280 sensors (works with or without WiFi)
+    if (SensorRegistry::getInstance().begin() == 0) {
         Serial.println("Warning: BME280 initialization failed");
         g_state->setBMEWorking(false);
     } else {
@@ -283,43 +288,29 @@ void loop() {
     // Monitor and manage network connectivity
     monitorNetwork();
 
-    // Explicit MQTT reconnection handling
-    if (networkStatus == NetworkStatus::CONNECTED && mqttInitialized) {
-        static unsigned long lastMqttCheck = 0;
-        unsigned long now = millis();
-        
-        if (now - lastMqttCheck >= 10000) { // Check every 10 seconds
-            lastMqttCheck = now;
-            
-            if (!mqttManager.connected()) {
-                Serial.println("[MAIN] MQTT not connected, forcing reconnection attempt");
-                
-                // Force fresh reconnection attempt
-                bool reconnectResult = mqttManager.connect();
-                if (reconnectResult) {
-                    Serial.println("[MAIN] MQTT reconnection successful from main loop");
-                } else {
-                    Serial.println("[MAIN] MQTT reconnection failed from main loop");
-                }
-            } else {
-                // Silently verify connection is working
-                mqttManager.loop();
-            }
-        }
-    }
-    
-
     // Update remote temperature at fixed interval if network is up
     if (networkStatus == NetworkStatus::CONNECTED && now - lastRemoteTempUpdate >= REMOTE_TEMP_UPDATE_INTERVAL) {
         // Check if sensor is enabled before attempting to get temperature
         if (babelSensor.isEnabled()) {
             float remoteTemp = babelSensor.getRemoteTemperature();
-            if (remoteTemp != 0.0 && remoteTemp != lastBabelTemp) {
-                g_state->setRemoteTemperature(remoteTemp);
+            unsigned long readingTime = babelSensor.getLastReadingTime();
+            if (readingTime != 0 && readingTime != lastBabelReading) {
+                // Every new reading refreshes the age, even when the value
+                // is the same; 0 °C is a real reading here
+                g_state->setRemoteTemperature(remoteTemp, readingTime);
+                bool changed = lastBabelReading == 0 || remoteTemp != lastBabelTemp;
+                lastBabelReading = readingTime;
                 lastBabelTemp = remoteTemp;
-                Serial.printf("Updated remote temperature: %.2f°C\n", remoteTemp);
+                if (changed) {
+                    if (display) {
+                        display->wake();
+                    }
+                    Serial.printf("Updated remote temperature: %.2f°C\n", remoteTemp);
+                } else {
+                    Serial.println("Remote temperature unchanged");
+                }
             } else {
-                Serial.println("Remote temperature unchanged or invalid");
+                Serial.println("No new remote temperature reading");
             }
         } else {
             // Try to initialize if not already enabled but should be
@@ -347,48 +338,31 @@ void loop() {
         lastStackCheck = now;
     }
     
-    // Home Assistant Discovery Management
-    // First check if we need to do the initial discovery
-    if (!initialDiscoveryDone && mqttManager.connected()) {
-        Serial.println("Publishing initial Home Assistant discovery");
-        // Using a simplified discovery approach to reduce memory usage
-        mqttManager.publishSensorDiscovery("temperature", "°C", "temperature");
-        delay(500);
-        mqttManager.publishSensorDiscovery("humidity", "%", "humidity");
-        
-        initialDiscoveryDone = true;
+    // Home Assistant Discovery Management. The configs go through the
+    // publish queue; while it is full the round is resumed a little later.
+    if (discoveryPending && mqttManager.connected() &&
+        now - lastDiscoveryAttempt >= MQTT_QUEUE_RETRY_MS) {
         lastDiscoveryAttempt = now;
+        discoveryPending = !mqttManager.publishHomeAssistantDiscovery();
     }
     // Periodic re-discovery to ensure entities stay available
-    else if (initialDiscoveryDone && now - lastDiscoveryAttempt > DISCOVERY_INTERVAL) {
-        if (mqttManager.connected()) {
-            Serial.println("Publishing periodic Home Assistant discovery refresh");
-            mqttManager.publishSensorDiscovery("temperature", "°C", "temperature");
-            delay(500);
-            mqttManager.publishSensorDiscovery("humidity", "%", "humidity");
-        }
-        lastDiscoveryAttempt = now;
+    else if (!discoveryPending && now - lastDiscoveryAttempt > DISCOVERY_INTERVAL) {
+        Serial.println("Publishing periodic Home Assistant discovery refresh");
+        discoveryPending = true;
     }
     
     if (networkStatus == NetworkStatus::CONNECTED) {
         unsigned long now = millis();
-        if (now - lastNtpSync >= NTP_SYNC_INTERVAL) {
+        if (now - lastNtpSync >= NTP_SYNC_INTERVAL && !SntpClient::getInstance().isBusy()) {
             Serial.println("[NTP] Resynchronizing NTP time");
-            bool ntpSuccess = setupNTP();
-            
-            // Record the attempt in SystemMonitor
-            sysMonitor.recordNtpSyncAttempt(ntpSuccess);
-            
-            if (ntpSuccess) {
-                Serial.println("[NTP] Time resynchronized successfully");
-                lastNtpSync = now;
-            } else {
-                Serial.println("[NTP] Resynchronization failed");
-                // Retry sooner if failed
+            if (!setupNTP()) {
                 lastNtpSync = now - (NTP_SYNC_INTERVAL - 300000); // Try again in 5 minutes
             }
         }
     }
+    
+    // Advance any NTP exchange in flight; never blocks
+    SntpClient::getInstance().loop();
     // Short yield to give other tasks time to execute
     delay(10);
 }
@@ -419,10 +393,10 @@ void checkHeapFragmentation() {
         
         // Recovery actions for low memory
         if (mqttManager.connected()) {
-            mqttManager.forceDisconnect();
-            Serial.println("MQTT disconnected to free memory");
-            delay(200);
-            mqttManager.connect();  // Try to reconnect with fresh state
+            // The network task drops the connection and reconnects after
+            // the backoff, with fresh buffers
+            mqttManager.requestReconnect();
+            Serial.println("MQTT reconnect requested to free memory");
         }
     }
 }
@@ -474,6 +448,14 @@ bool initializeSystem() {
     }
     Serial.println("SPIFFS mounted successfully");
 
+    // Reopen the persisted sensor history
+    if (!HistoryLog::getInstance().begin()) {
+        Serial.println("Warning: Sensor history log unavailable");
+    }
+
+    // Telemetry spilled to flash before a reset is replayed once MQTT is up
+    MessageSpool::getInstance().begin();
+
     // Initialize Global State
     g_state = &GlobalState::getInstance();
     if (!g_state) {
@@ -498,7 +480,7 @@ bool initializeSystem() {
     g_state->setDisplay(display);
    
     // Initialize I2C bus for sensors
-    if (!Wire.begin(I2C_SDA, I2C_SCL, 100000)) {
+    if (!I2CBus::getInstance().begin(I2C_SDA, I2C_SCL, I2C_CLOCK_HZ)) {
         Serial.println("Critical: I2C initialization failed");
         return false;
     }
@@ -537,6 +519,13 @@ void initializeDisplayPreferences() {
                  prefs.nightStartHour,
                  prefs.nightEndHour);
     
+    // Sensor acquisition and filtering; the sensor task picks these up
+    SensorFilter::Settings filterSettings;
+    SensorFilter::parse(prefs.sensorFilter, filterSettings);
+    SensorFilter::getInstance().setSettings(filterSettings);
+    Serial.printf("[INIT] Sensor filter: %s\n", SensorFilter::toString(filterSettings).c_str());
+    ComfortMetrics::getInstance().setAltitude(prefs.sensorAltitude);
+
     // Apply preferences to display
     DisplayHandler* display = g_state->getDisplay();
     if (display) {
@@ -571,33 +560,14 @@ void displayDeviceId() {
     unsigned long startTime = millis();
     int currentDot = 0;
     
-    // Convert and show the ID digits
-    for(int i = 0; i < 4; i++) {
-        char c = deviceIdString[i];
-        int digit;
-        if(c >= '0' && c <= '9') {
-            digit = c - '0' + CHAR_0;
-        } else {
-            digit = c - 'A' + CHAR_A;
-        }
-        display->setDigit(i, digit, false);
-    }
+    // Show the ID digits
+    const uint32_t idFrame = SegmentFont::renderText(deviceIdString);
+    display->showFrame(idFrame);
     
     // Keep updating the display with walking dot
     while(millis() - startTime < TOTAL_DISPLAY_TIME) {
         currentDot = ((millis() - startTime) / DOT_INTERVAL_MS) % 4;
-        
-        for(int i = 0; i < 4; i++) {
-            char c = deviceIdString[i];
-            int digit;
-            if(c >= '0' && c <= '9') {
-                digit = c - '0' + CHAR_0;
-            } else {
-                digit = c - 'A' + CHAR_A;
-            }
-            display->setDigit(i, digit, (i == currentDot));
-        }
-        
+        display->showFrame(SegmentFont::withDecimalPoint(idFrame, currentDot));
         display->update();
         delay(50);
     }
@@ -649,27 +619,70 @@ bool setupNTP() {
         return false;
     }
     
-    // Setup time
-    configTime(0, 0, NTP_SERVER);
     setenv("TZ", TZ_INFO, 1);
     tzset();
     
-    // Check if time was set successfully
-    struct tm timeinfo;
-    unsigned long startAttempt = millis();
-    while (!getLocalTime(&timeinfo) && millis() - startAttempt < 5000) {
-        delay(100);
+    // The UDP socket needs the network stack, so open it on first use
+    SntpClient& sntp = SntpClient::getInstance();
+    if (!sntpStarted) {
+        if (!sntp.begin(NTP_SERVERS)) {
+            Serial.println("Warning: SNTP client could not be started");
+            return false;
+        }
+        sntp.onResult(onNtpResult);
+        sntpStarted = true;
+    }
+    
+    // Runs in the background, loop() drives it to completion
+    if (!sntp.requestSync()) {
+        return sntp.isBusy();
+    }
+    lastNtpSync = millis();
+    return true;
+}
+
+void onNtpResult(bool success, const SntpSample& sample) {
+    unsigned long now = millis();
+    sysMonitor.recordNtpSyncAttempt(success);
+    
+    if (!success) {
+        Serial.println("Warning: Failed to set time via NTP");
+        // Retry after a minute until the first sync, then after 5 minutes
+        lastNtpSync = now - NTP_SYNC_INTERVAL + (ntpInitialized ? 300000 : 60000);
+        return;
     }
     
-    if (getLocalTime(&timeinfo)) {
+    // The display clock slews towards the new sample on its own
+    TimeService::getInstance().onNtpSync(sample.utcUs, sample.monoUs);
+    
+    // Keep the system clock in line for everything using getLocalTime()
+    if (sample.offsetUs > TIME_STEP_THRESHOLD_US || sample.offsetUs < -TIME_STEP_THRESHOLD_US) {
+        struct timeval tv;
+        tv.tv_sec = (time_t)(sample.utcUs / 1000000LL);
+        tv.tv_usec = (suseconds_t)(sample.utcUs % 1000000LL);
+        // utcUs refers to monoUs; carry it forward to now
+        int64_t since = esp_timer_get_time() - sample.monoUs;
+        tv.tv_sec += (time_t)(since / 1000000LL);
+        tv.tv_usec += (suseconds_t)(since % 1000000LL);
+        if (tv.tv_usec >= 1000000) {
+            tv.tv_sec++;
+            tv.tv_usec -= 1000000;
+        }
+        settimeofday(&tv, nullptr);
+    } else {
+        struct timeval delta;
+        delta.tv_sec = (time_t)(sample.offsetUs / 1000000LL);
+        delta.tv_usec = (suseconds_t)(sample.offsetUs % 1000000LL);
+        adjtime(&delta, nullptr);
+    }
+    
+    struct tm timeinfo;
+    if (getLocalTime(&timeinfo, 0)) {
         Serial.printf("NTP time set: %02d:%02d:%02d\n", 
                      timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
-        ntpInitialized = true;
-        return true;
-    } else {
-        Serial.println("Warning: Failed to set time via NTP");
-        return false;
     }
+    ntpInitialized = true;
+    lastNtpSync = now;
 }
 
 void initializeMQTT() {
@@ -920,20 +933,45 @@ void createTasks() {
 
 void networkTask(void* parameter) {
     const TickType_t xDelay = pdMS_TO_TICKS(1000); // Check every second
+    PublishQueue& queue = PublishQueue::getInstance();
+    MessageSpool& spool = MessageSpool::getInstance();
+    
+    // Producers wake us through the task notification when they enqueue
+    queue.setConsumer(xTaskGetCurrentTaskHandle());
     
     while (true) {
         esp_task_wdt_reset();
         
-        // This task currently only serves to keep the watchdog fed
-        // And to provide separate stack space for network operations
+        // Send what the other tasks queued; they never wait for the broker.
+        // Then connect, reconnect or collect PUBACKs, one step at a time.
+        uint16_t sent = 0;
+        bool replaying = false;
+        TickType_t connectWait = xDelay;
+        if (mqttInitialized && networkStatus == NetworkStatus::CONNECTED) {
+            sent = mqttManager.processQueue();
+            
+            // Then telemetry captured while the broker was unreachable
+            mqttManager.replaySpool();
+            replaying = mqttManager.isConnectedToMQTT() && spool.depth() > 0;
+            
+            connectWait = pdMS_TO_TICKS(mqttManager.step());
+        }
         
-        vTaskDelay(xDelay);
+        // Keep going while a backlog drains, otherwise sleep until notified
+        TickType_t wait = xDelay;
+        if (sent > 0 && queue.depth() > 0) {
+            wait = 1;
+        } else if (replaying) {
+            wait = pdMS_TO_TICKS(MQTT_SPOOL_REPLAY_INTERVAL);
+        }
+        if (connectWait < wait) {
+            wait = connectWait > 0 ? connectWait : 1;
+        }
+        ulTaskNotifyTake(pdTRUE, wait);
     }
 }
 
 void displayTask(void* parameter) {
-    TickType_t lastWakeTime = xTaskGetTickCount();
-    const TickType_t frequency = pdMS_TO_TICKS(100);  // 10Hz refresh rate
     struct tm timeinfo;
     DisplayMode mode = DisplayMode::TIME;
     
@@ -941,6 +979,9 @@ void displayTask(void* parameter) {
     unsigned long lastMutexCheck = 0;
     const unsigned long MUTEX_CHECK_INTERVAL = 30000; // 30 seconds
     
+    // Sleep between visible changes; producers wake us through the task notification
+    display->setTaskHandle(xTaskGetCurrentTaskHandle());
+    
     while (true) {
         esp_task_wdt_reset();
         unsigned long now = millis();
@@ -964,134 +1005,218 @@ void displayTask(void* parameter) {
         // Update display based on current mode
         switch(currentMode) {
             case DisplayMode::TIME:
-                if (getLocalTime(&timeinfo)) {
+                if (TimeService::getInstance().getLocalTime(timeinfo)) {
                     display->showTime(timeinfo.tm_hour, timeinfo.tm_min);
                 } else if (networkStatus == NetworkStatus::PORTAL_ACTIVE) {
                     // Show "AP" for Access Point mode when time is not available
-                    display->setDigit(0, CHAR_A);
-                    display->setDigit(1, CHAR_P);
-                    display->setDigit(2, CHAR_BLANK);
-                    display->setDigit(3, CHAR_BLANK);
+                    display->showText("AP");
                 }
                 break;
             case DisplayMode::DATE:
-                if (getLocalTime(&timeinfo)) {
+                if (TimeService::getInstance().getLocalTime(timeinfo)) {
                     display->showDate(timeinfo.tm_mday, timeinfo.tm_mon + 1);
                 }
                 break;
             case DisplayMode::TEMPERATURE:
-                display->showTemperature(g_state->getTemperature());
-                break;
             case DisplayMode::HUMIDITY:
-                display->showHumidity(g_state->getHumidity());
+            case DisplayMode::PRESSURE: {
+                // Sensor modes show the sensor their playlist entry picked
+                SensorRegistry::Reading reading;
+                if (!SensorRegistry::getInstance().getReading(display->getCurrentSensor(), reading)) {
+                    break;
+                }
+                if (currentMode == DisplayMode::TEMPERATURE) {
+                    display->showTemperature(reading.temperature);
+                } else if (currentMode == DisplayMode::HUMIDITY) {
+                    display->showHumidity(reading.humidity);
+                } else {
+                    display->showPressure(reading.pressure);
+                }
                 break;
-            case DisplayMode::PRESSURE:
-                display->showPressure(g_state->getPressure());
+            }
+            case DisplayMode::DEW_POINT:
+            case DisplayMode::ABS_HUMIDITY:
+            case DisplayMode::HEAT_INDEX:
+            case DisplayMode::SEA_LEVEL_PRESSURE: {
+                ComfortMetrics::Values comfort;
+                if (!ComfortMetrics::getInstance().get(display->getCurrentSensor(), comfort)) {
+                    break;
+                }
+                if (currentMode == DisplayMode::DEW_POINT) {
+                    display->showDewPoint(comfort.dewPoint);
+                } else if (currentMode == DisplayMode::ABS_HUMIDITY) {
+                    display->showAbsoluteHumidity(comfort.absoluteHumidity);
+                } else if (currentMode == DisplayMode::HEAT_INDEX) {
+                    display->showHeatIndex(comfort.heatIndex);
+                } else {
+                    display->showSeaLevelPressure(comfort.seaLevelPressure);
+                }
                 break;
+            }
             case DisplayMode::REMOTE_TEMP:
                 display->showRemoteTemp(g_state->getRemoteTemperature());
                 break;
+            case DisplayMode::MESSAGE:
+                // Frames are published by the scroll timer
+                break;
         }
 
         display->update();
-        vTaskDelayUntil(&lastWakeTime, frequency);
+        display->waitForChange();
     }
 }
 
 void publishRelayState(uint8_t relayId, RelayState state, RelayCommandSource source) {
     if (mqttInitialized && mqttManager.connected() && networkStatus == NetworkStatus::CONNECTED) {
-        StaticJsonDocument<128> stateDoc;
-        stateDoc["relay_id"] = relayId;
-        stateDoc["state"] = (state == RelayState::ON);
+        char buffer[96];
+        PayloadWriter json(buffer, sizeof(buffer));
+        json.add("relay_id", relayId);
+        json.add("state", state == RelayState::ON);
         
         // Include the source of the state change
         switch (source) {
             case RelayCommandSource::USER:
-                stateDoc["source"] = "user";
+                json.add("source", "user");
                 break;
             case RelayCommandSource::MQTT:
-                stateDoc["source"] = "mqtt";
+                json.add("source", "mqtt");
                 break;
             default:
-                stateDoc["source"] = "system";
+                json.add("source", "system");
                 break;
         }
         
-        String statePayload;
-        serializeJson(stateDoc, statePayload);
-        
-        // Use consistent topic construction with MAC-based ID for uniqueness
-        String clientId = "ablutionoracle_" + WiFi.macAddress().substring(9);
-        clientId.replace(":", "");
-        String stateTopic = String("chaoticvolt/") + String(MQTT_CLIENT_ID) + "/" + String(MQTT_TOPIC_RELAY) + "/state";
-        
-        mqttManager.publish(stateTopic.c_str(), statePayload.c_str(), true);
+        mqttManager.enqueue(MQTTTopics::RELAY_STATE, json.finish(), true);
+    }
+}
+
+// Pushes changed oversampling/IIR settings to one sensor. Only called while
+// that sensor has no conversion running, so the new registers apply from
+// its next one.
+static void applySensorSettings(uint8_t index, uint32_t& appliedGeneration) {
+    SensorFilter& filter = SensorFilter::getInstance();
+    uint32_t generation = filter.getGeneration();
+    if (generation == appliedGeneration) {
+        return;
+    }
+    SensorFilter::Settings settings = filter.getSettings();
+    BME280Handler& sensor = SensorRegistry::getInstance().driver(index);
+    if (sensor.setAcquisition(settings.channels[SensorFilter::TEMPERATURE].oversampling,
+                              settings.channels[SensorFilter::PRESSURE].oversampling,
+                              settings.channels[SensorFilter::HUMIDITY].oversampling,
+                              settings.iirCoefficient)) {
+        Serial.printf("[SENSOR] Sensor %u acquisition updated, conversion time %u us\n",
+                      index, sensor.getMeasurementTimeUs());
+    }
+    appliedGeneration = generation;
+}
+
+// Filters, stores and publishes a completed sample of one sensor
+static void processSample(uint8_t index, unsigned long& lastStatusPublish) {
+    const unsigned long STATUS_PUBLISH_INTERVAL = 60000;  // Publish status every minute (reduced from 5 min)
+    SensorRegistry& sensors = SensorRegistry::getInstance();
+    BME280Handler& sensor = sensors.driver(index);
+    unsigned long now = millis();
+
+    // Range check, median and EMA per channel
+    float values[SensorFilter::CHANNEL_COUNT] = {
+        sensor.getTemperature(), sensor.getHumidity(), sensor.getPressure()
+    };
+    if (!SensorFilter::getInstance().apply(index, values)) {
+        Serial.printf("Invalid readings from sensor %u, skipping publication\n", index);
+        return;
+    }
+    float temperature = values[SensorFilter::TEMPERATURE];
+    float humidity = values[SensorFilter::HUMIDITY];
+    float pressure = values[SensorFilter::PRESSURE];
+
+    sensors.update(index, temperature, humidity, pressure);
+    ComfortMetrics& comfort = ComfortMetrics::getInstance();
+    comfort.update(index, temperature, humidity, pressure);
+    if (index == 0) {
+        // The primary sensor feeds GlobalState and the history
+        g_state->updateSensorData(temperature, humidity, pressure);
+    }
+    if (display) {
+        display->wake();
+    }
+
+    // Slow down while nothing moves, speed up when it does
+    AdaptiveSampler& sampler = AdaptiveSampler::getInstance();
+    sensor.setSampleInterval(sampler.onSample(index, temperature, humidity, pressure));
+
+    // Ensure we publish a status more frequently, while connected
+    bool online = mqttInitialized && mqttManager.connected() && networkStatus == NetworkStatus::CONNECTED;
+    if (online && now - lastStatusPublish >= STATUS_PUBLISH_INTERVAL) {
+        if (mqttManager.enqueue(MQTTTopics::STATUS, "online", true)) {
+            Serial.println("Queued status: online (retained)");
+            lastStatusPublish = now;
+        } else {
+            Serial.println("Failed to publish status, will retry sooner");
+            lastStatusPublish = now - STATUS_PUBLISH_INTERVAL + 10000; // Retry in 10 seconds
+        }
+    }
+
+    // Readings are published when they moved or a heartbeat is due
+    if (sampler.shouldPublish(index, temperature, humidity, pressure)) {
+        // Values with 1 decimal place precision, built on the stack
+        char buffer[256];
+        PayloadWriter json(buffer, sizeof(buffer));
+        json.add("temperature", temperature, 1);
+        json.add("humidity", humidity, 1);
+        json.add("pressure", pressure, 1);
+        ComfortMetrics::Values derived;
+        if (comfort.get(index, derived)) {
+            json.add("dew_point", derived.dewPoint, 1);
+            json.add("absolute_humidity", derived.absoluteHumidity, 1);
+            json.add("heat_index", derived.heatIndex, 1);
+            json.add("sea_level_pressure", derived.seaLevelPressure, 1);
+        }
+
+        // Publish to MQTT using the EXACT same topic format as in the discovery
+        char sensorTopic[128];
+        MQTTManager::sensorStateTopic(index, sensorTopic, sizeof(sensorTopic));
+
+        // Spooled while offline; refused only if it could not be kept at
+        // all, and the sampler then retries with the next sample
+        if (!mqttManager.enqueueTelemetry(sensorTopic, json.finish())) {
+            Serial.println("Failed to queue sensor data, will retry next cycle");
+        } else {
+            Serial.printf("Queued data of sensor %u%s\n", index, online ? "" : " (offline)");
+            sampler.onPublished(index, temperature, humidity, pressure);
+        }
     }
 }
 
 void sensorTask(void* parameter) {
-    TickType_t lastWakeTime = xTaskGetTickCount();
-    const TickType_t frequency = pdMS_TO_TICKS(2000);  // 0.5Hz measurement rate
     unsigned long lastStatusPublish = 0;
-    const unsigned long STATUS_PUBLISH_INTERVAL = 60000;  // Publish status every minute (reduced from 5 min)
+    SensorRegistry& sensors = SensorRegistry::getInstance();
+    uint32_t appliedSettings[SensorRegistry::MAX_SENSORS] = {};
+    
+    // Conversions are paced by the BME280 timers; this task only wakes to
+    // start one and to collect its result
+    if (g_state->isBMEWorking()) {
+        for (uint8_t i = 0; i < sensors.count(); i++) {
+            applySensorSettings(i, appliedSettings[i]);
+        }
+        sensors.startSampling(xTaskGetCurrentTaskHandle(), BME280_SAMPLE_INTERVAL);
+    }
     
     while (true) {
         esp_task_wdt_reset();
-        unsigned long now = millis();
-
-        // Take sensor measurements if BME280 is working
-        if (g_state->isBMEWorking() && bme280.takeMeasurement()) {
-            float temperature = bme280.getTemperature();
-            float humidity = bme280.getHumidity();
-            float pressure = bme280.getPressure();
+        
+        // Time out now and then so the watchdog is fed without a sensor
+        uint32_t events = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &events, pdMS_TO_TICKS(BME280_SAMPLE_INTERVAL));
 
-            // Validate readings before using them
-            if (temperature != BME280_INVALID_TEMP && 
-                humidity != BME280_INVALID_HUM && 
-                pressure != BME280_INVALID_PRES) {
-                
-                g_state->updateSensorData(temperature, humidity, pressure);
-                
-                // Only publish to MQTT if connected
-                if (mqttInitialized && mqttManager.connected() && networkStatus == NetworkStatus::CONNECTED) {
-                    // Ensure we publish a status more frequently
-                    String statusTopic = String("chaoticvolt/") + String(MQTT_CLIENT_ID) + "/sensor/status";
-                    
-                    if (now - lastStatusPublish >= STATUS_PUBLISH_INTERVAL) {
-                        if (mqttManager.publish(statusTopic.c_str(), "online", true)) {
-                            Serial.println("Published status: online (retained)");
-                            lastStatusPublish = now;
-                        } else {
-                            Serial.println("Failed to publish status, will retry sooner");
-                            lastStatusPublish = now - STATUS_PUBLISH_INTERVAL + 10000; // Retry in 10 seconds
-                        }
-                    }
-                    
-                    // Format the values with 1 decimal place precision
-                    char tempStr[8], humStr[8], presStr[8];
-                    snprintf(tempStr, sizeof(tempStr), "%.1f", temperature);
-                    snprintf(humStr, sizeof(humStr), "%.1f", humidity);
-                    snprintf(presStr, sizeof(presStr), "%.1f", pressure);
-                    
-                    // Create the JSON string manually to ensure exact formatting
-                    char payload[192];
-                    snprintf(payload, sizeof(payload), "{\"temperature\":%s,\"humidity\":%s,\"pressure\":%s}", 
-                            tempStr, humStr, presStr);
-                    
-                    // Publish to MQTT using the EXACT same topic format as in the discovery
-                    String sensorTopic = String("chaoticvolt/") + String(MQTT_CLIENT_ID) + "/sensor/sensors";
-                    
-                    if (!mqttManager.publish(sensorTopic.c_str(), payload)) {
-                        Serial.println("Failed to publish sensor data, will retry next cycle");
-                    } else {
-                        Serial.println("Successfully published sensor data");
-                    }
-                }
-            } else {
-                Serial.println("Invalid sensor readings, skipping publication");
+        // Collect finished conversions if a BME280 is working
+        uint32_t sampled = g_state->isBMEWorking() ? sensors.handleEvents(events) : 0;
+        for (uint8_t i = 0; i < sensors.count(); i++) {
+            if (sampled & (1u << i)) {
+                // The sensor is idle until its next start event
+                applySensorSettings(i, appliedSettings[i]);
+                processSample(i, lastStatusPublish);
             }
         }
-        
-        vTaskDelayUntil(&lastWakeTime, frequency);
     }
 }
\ No newline at end of file
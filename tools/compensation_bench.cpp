@@ -0,0 +1,162 @@
+// Host benchmark for the BME280 compensation kernels in BME280Compensation.h.
+//
+// Checks both variants against the datasheet reference values and reports
+// the cost per sample. The Bosch driver headers are fetched by the native
+// environment, so build that once first:
+//
+//   pio run -e native
+//   g++ -std=gnu++14 -O2 -Iinclude -I.pio/libdeps/native/BME280_driver \
+//       tools/compensation_bench.cpp -o compensation_bench
+//   ./compensation_bench
+//
+// Exits non-zero when a reference check fails.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include "BME280Compensation.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#else
+#define HAVE_TSC 0
+#endif
+
+using namespace BME280Compensation;
+
+namespace {
+
+const int SAMPLES = 1 << 16;
+const int ROUNDS = 50;
+
+// Temperature and pressure trimming from the Bosch reference example
+// (BMP280 datasheet, section 3.12); humidity trimming is a typical BME280 part
+bme280_calib_data referenceCalibration() {
+    bme280_calib_data calib = {};
+    calib.dig_t1 = 27504;
+    calib.dig_t2 = 26435;
+    calib.dig_t3 = -1000;
+    calib.dig_p1 = 36477;
+    calib.dig_p2 = -10685;
+    calib.dig_p3 = 3024;
+    calib.dig_p4 = 2855;
+    calib.dig_p5 = 140;
+    calib.dig_p6 = -7;
+    calib.dig_p7 = 15500;
+    calib.dig_p8 = -14600;
+    calib.dig_p9 = 6000;
+    calib.dig_h1 = 75;
+    calib.dig_h2 = 362;
+    calib.dig_h3 = 0;
+    calib.dig_h4 = 315;
+    calib.dig_h5 = 50;
+    calib.dig_h6 = 30;
+    return calib;
+}
+
+const int32_t REF_ADC_T = 519888;
+const int32_t REF_ADC_P = 415148;
+const int32_t REF_ADC_H = 30000;
+const int32_t REF_T_FINE = 128422;
+const float REF_TEMPERATURE = 25.08f;   // degC
+const float REF_PRESSURE = 1006.53f;    // hPa
+
+struct Raw {
+    int32_t t, p, h;
+};
+
+Raw samples[SAMPLES];
+volatile float sink;
+
+bool check(const char* what, float value, float expected, float tolerance) {
+    bool ok = std::fabs(value - expected) <= tolerance;
+    printf("  %-12s %10.3f (expected %10.3f +/- %.3f) %s\n",
+           what, value, expected, tolerance, ok ? "ok" : "FAIL");
+    return ok;
+}
+
+template <typename T>
+bool verify(const char* name, const bme280_calib_data& calib, float& humidity) {
+    typedef Compensator<T> C;
+    Context ctx;
+    float t = C::celsius(C::temperature(calib, REF_ADC_T, ctx));
+    int32_t tFine = ctx.tFine;
+    float p = C::hectopascal(C::pressure(calib, REF_ADC_P, ctx));
+    humidity = C::percent(C::humidity(calib, REF_ADC_H, ctx));
+
+    printf("%s\n", name);
+    bool ok = check("t_fine", (float)tFine, (float)REF_T_FINE, 1.0f);
+    ok &= check("temperature", t, REF_TEMPERATURE, 0.01f);
+    ok &= check("pressure", p, REF_PRESSURE, 0.01f);
+    printf("  %-12s %10.3f\n", "humidity", humidity);
+    return ok;
+}
+
+template <typename T>
+void bench(const char* name, const bme280_calib_data& calib) {
+    typedef Compensator<T> C;
+    double bestNs = 1e30;
+    double bestCycles = 1e30;
+
+    for (int round = 0; round < ROUNDS; round++) {
+        float acc = 0;
+        auto start = std::chrono::steady_clock::now();
+#if HAVE_TSC
+        uint64_t tsc = __rdtsc();
+#endif
+        for (int i = 0; i < SAMPLES; i++) {
+            Context ctx;
+            T t = C::temperature(calib, samples[i].t, ctx);
+            T p = C::pressure(calib, samples[i].p, ctx);
+            T h = C::humidity(calib, samples[i].h, ctx);
+            acc += C::celsius(t) + C::hectopascal(p) + C::percent(h);
+        }
+#if HAVE_TSC
+        double cycles = (double)(__rdtsc() - tsc) / SAMPLES;
+        if (cycles < bestCycles) bestCycles = cycles;
+#endif
+        double ns = std::chrono::duration<double, std::nano>(
+                        std::chrono::steady_clock::now() - start).count() / SAMPLES;
+        if (ns < bestNs) bestNs = ns;
+        sink = acc;
+    }
+
+#if HAVE_TSC
+    printf("  %-8s %7.1f ns/sample %8.1f TSC cycles/sample\n", name, bestNs, bestCycles);
+#else
+    printf("  %-8s %7.1f ns/sample\n", name, bestNs);
+#endif
+}
+
+} // namespace
+
+int main() {
+    bme280_calib_data calib = referenceCalibration();
+
+    float humidityFixed = 0;
+    float humidityFloat = 0;
+    bool ok = verify<int32_t>("int32_t", calib, humidityFixed);
+    ok &= verify<float>("float", calib, humidityFloat);
+
+    // No published humidity vector; the two variants must agree instead
+    printf("humidity variants\n");
+    ok &= check("difference", humidityFixed - humidityFloat, 0.0f, 0.1f);
+
+    // Spread the inputs around the reference point so the loop sees varying
+    // data (about 0..50 degC, 800..1100 hPa)
+    uint32_t seed = 1;
+    for (int i = 0; i < SAMPLES; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        samples[i].t = REF_ADC_T - 60000 + (int32_t)(seed >> 16) % 120000;
+        samples[i].p = REF_ADC_P - 40000 + (int32_t)(seed >> 8) % 80000;
+        samples[i].h = REF_ADC_H - 10000 + (int32_t)(seed >> 12) % 20000;
+    }
+
+    printf("cost per sample (temperature, pressure, humidity; best of %d)\n", ROUNDS);
+    bench<int32_t>("int32_t", calib);
+    bench<float>("float", calib);
+
+    printf(ok ? "all checks passed\n" : "reference check FAILED\n");
+    return ok ? 0 : 1;
+}
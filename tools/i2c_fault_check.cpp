@@ -0,0 +1,92 @@
+// Host check for the I2CBus error paths, driven by the NativeHAL fault
+// injection (SDA held low by a slave, NACKed transfers) against the
+// simulated BME280 at 0x76.
+//
+//   g++ -std=gnu++14 -O2 -DNATIVE_BUILD -DARDUINO=10819 -DESP32 -Iinclude \
+//       -Ilib/NativeHAL/src -pthread tools/i2c_fault_check.cpp src/I2CBus.cpp \
+//       lib/NativeHAL/src/*.cpp -o i2c_fault_check
+//   ./i2c_fault_check
+//
+// Exits non-zero when a check fails.
+
+#include <Arduino.h>
+#include <cstdlib>
+#include "I2CBus.h"
+#include "NativeHAL.h"
+#include "config.h"
+
+namespace {
+
+const uint8_t ADDRESS = 0x76;
+const uint8_t REG_CHIP_ID = 0xD0;
+const uint8_t CHIP_ID = 0x60;
+
+int failures = 0;
+
+void check(bool condition, const char* what) {
+    printf("%-56s %s\n", what, condition ? "ok" : "FAILED");
+    if (!condition) {
+        failures++;
+    }
+}
+
+bool readChipId() {
+    uint8_t id = 0;
+    return I2CBus::getInstance().read(ADDRESS, REG_CHIP_ID, &id, 1) && id == CHIP_ID;
+}
+
+uint32_t readErrors() {
+    return I2CBus::getInstance().getStats(I2CBus::READ).errors;
+}
+
+} // namespace
+
+void setup() {
+    I2CBus& bus = I2CBus::getInstance();
+
+    // A slave left mid-byte by a reset holds SDA until clocked out
+    NativeHAL::holdI2CData(3);
+    check(bus.begin(I2C_SDA, I2C_SCL, I2C_CLOCK_HZ), "begin() frees a bus held at boot");
+    check(!NativeHAL::i2cDataHeld(), "SDA released");
+    check(bus.getRecoveries() == 1, "recovery counted");
+    check(readChipId(), "chip ID readable afterwards");
+
+    // Held during a transaction: recovered and retried once
+    uint32_t errors = readErrors();
+    NativeHAL::holdI2CData(5);
+    check(readChipId(), "read with SDA held succeeds after recovery");
+    check(bus.getRecoveries() == 2, "recovery counted");
+    check(readErrors() == errors + 1, "failed attempt counted as an error");
+
+    // A single NACK with the bus idle is reported, not recovered from
+    errors = readErrors();
+    NativeHAL::failI2CTransfers(ADDRESS, 1);
+    check(!readChipId(), "single NACK fails the read");
+    check(readErrors() == errors + 1, "NACK counted as an error");
+    check(bus.getRecoveries() == 2, "no recovery for one NACK");
+    check(readChipId(), "next read succeeds");
+
+    // I2C_RECOVERY_THRESHOLD NACKs in a row reset the bus and retry
+    errors = readErrors();
+    NativeHAL::failI2CTransfers(ADDRESS, I2C_RECOVERY_THRESHOLD);
+    for (int i = 1; i < I2C_RECOVERY_THRESHOLD; i++) {
+        check(!readChipId(), "NACK below the threshold fails");
+    }
+    check(readChipId(), "NACK at the threshold recovers and retries");
+    check(bus.getRecoveries() == 3, "recovery counted");
+    check(readErrors() == errors + I2C_RECOVERY_THRESHOLD, "every NACK counted as an error");
+
+    // Longer than nine clocks: recovery gives up
+    NativeHAL::holdI2CData(20);
+    check(!readChipId(), "read with SDA stuck for good fails");
+    check(bus.getFailedRecoveries() == 1, "failed recovery counted");
+    NativeHAL::holdI2CData(0);
+    check(readChipId(), "bus usable once the slave lets go");
+
+    printf("recoveries=%u failed=%u read errors=%u\n", bus.getRecoveries(), bus.getFailedRecoveries(),
+           readErrors());
+    exit(failures == 0 ? 0 : 1);
+}
+
+void loop() {
+}
@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+"""Local MQTT stand-in broker for the native build.
+
+Answers just enough of MQTT 3.1.1 for MQTTManager: CONNACK, SUBACK, PUBACK
+for QoS 1 publishes and PINGRESP. Every packet is logged with a timestamp.
+With --kill-after it closes each connection that many seconds after the
+CONNACK, like a broker that keeps restarting.
+
+  python3 tools/mqtt_standin.py [--port 1883] [--kill-after SECONDS]
+
+tools/reconnect_check.py runs it in-process.
+"""
+
+import argparse
+import socket
+import threading
+import time
+
+
+class Broker:
+    def __init__(self, port=1883, kill_after=0.0, log=print):
+        self.port = port
+        self.kill_after = kill_after
+        self.log = log
+        self.connects = []
+        self.lock = threading.Lock()
+
+    def serve_forever(self):
+        listener = socket.socket()
+        listener.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        listener.bind(("127.0.0.1", self.port))
+        listener.listen(16)
+        self.log("Stand-in broker on port %d" % self.port)
+        while True:
+            conn, addr = listener.accept()
+            threading.Thread(target=self.session, args=(conn, addr), daemon=True).start()
+
+    def start(self):
+        threading.Thread(target=self.serve_forever, daemon=True).start()
+
+    def session(self, conn, addr):
+        try:
+            while True:
+                header, body = read_packet(conn)
+                kind = header & 0xF0
+                if kind == 0x10:
+                    with self.lock:
+                        self.connects.append(time.time())
+                    self.log("%.3f CONNECT from %s:%d" % (time.time(), addr[0], addr[1]))
+                    conn.sendall(b"\x20\x02\x00\x00")
+                    if self.kill_after:
+                        threading.Timer(self.kill_after, drop, args=(conn,)).start()
+                elif kind == 0x30:
+                    length = body[0] << 8 | body[1]
+                    if (header >> 1) & 3 == 1:
+                        conn.sendall(b"\x40\x02" + body[2 + length:4 + length])
+                elif kind == 0x80:
+                    # One granted QoS 1 per subscription request
+                    conn.sendall(b"\x90\x03" + body[:2] + b"\x01")
+                elif kind == 0xC0:
+                    conn.sendall(b"\xd0\x00")
+                elif kind == 0xE0:
+                    break
+        except (EOFError, OSError):
+            pass
+        conn.close()
+
+
+def drop(conn):
+    try:
+        conn.shutdown(socket.SHUT_RDWR)
+    except OSError:
+        pass
+
+
+def read_exact(conn, size):
+    data = b""
+    while len(data) < size:
+        chunk = conn.recv(size - len(data))
+        if not chunk:
+            raise EOFError
+        data += chunk
+    return data
+
+
+def read_packet(conn):
+    header = read_exact(conn, 1)[0]
+    length, multiplier = 0, 1
+    while True:
+        byte = read_exact(conn, 1)[0]
+        length += (byte & 0x7F) * multiplier
+        multiplier *= 128
+        if not byte & 0x80:
+            break
+    return header, read_exact(conn, length) if length else b""
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--port", type=int, default=1883)
+    parser.add_argument("--kill-after", type=float, default=0.0,
+                        help="close each connection this many seconds after CONNACK")
+    args = parser.parse_args()
+    Broker(args.port, args.kill_after, lambda line: print(line, flush=True)).serve_forever()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,214 @@
+// Host check that publishing does not touch the heap.
+//
+// malloc, realloc and calloc (and with them operator new) are wrapped and
+// counted while the sensor, status and relay state messages go through the
+// same steps as on the device. Each one is formatted with PayloadWriter to
+// an MQTTTopics topic and handed to the PublishQueue. It is then moved into
+// the InFlightWindow, encoded by MQTTTransport at QoS 1 and released by the
+// PUBACK. The transport talks to a loopback Client that answers CONNECT and
+// every QoS 1 PUBLISH the way a broker would.
+//
+//   g++ -std=gnu++14 -O2 -DNATIVE_BUILD -DARDUINO=10819 -DESP32 -Iinclude \
+//       -Ilib/NativeHAL/src -pthread tools/publish_alloc_check.cpp \
+//       src/PayloadWriter.cpp src/PublishQueue.cpp src/MessageRing.cpp \
+//       src/InFlightWindow.cpp src/MQTTTransport.cpp lib/NativeHAL/src/*.cpp \
+//       -o publish_alloc_check
+//   ./publish_alloc_check
+//
+// Exits non-zero when anything was allocated or a message went missing.
+
+#include <Arduino.h>
+#include <Client.h>
+#include <atomic>
+#include <cstdlib>
+#include "InFlightWindow.h"
+#include "MQTTTopics.h"
+#include "MQTTTransport.h"
+#include "PayloadWriter.h"
+#include "PublishQueue.h"
+
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_realloc(void* pointer, size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+
+namespace {
+
+std::atomic<uint32_t> allocations(0);
+thread_local bool counting = false;
+
+} // namespace
+
+extern "C" void* malloc(size_t size) {
+    if (counting) {
+        allocations++;
+    }
+    return __libc_malloc(size);
+}
+
+extern "C" void* realloc(void* pointer, size_t size) {
+    if (counting) {
+        allocations++;
+    }
+    return __libc_realloc(pointer, size);
+}
+
+extern "C" void* calloc(size_t count, size_t size) {
+    if (counting) {
+        allocations++;
+    }
+    return __libc_calloc(count, size);
+}
+
+namespace {
+
+const int ROUNDS = 100;
+const int MESSAGES_PER_ROUND = 3;
+
+// Broker on the other end of the wire: a CONNACK for CONNECT, a PUBACK for
+// every QoS 1 PUBLISH. Fixed buffers only, so it adds nothing to the count.
+class LoopbackClient : public Client {
+public:
+    int connect(IPAddress, uint16_t) override { return 1; }
+    int connect(const char*, uint16_t) override { return 1; }
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* data, size_t size) override {
+        // MQTTTransport writes whole packets
+        if (size < 2) {
+            return size;
+        }
+        uint8_t type = data[0] & 0xF0;
+        size_t offset = 1;
+        while (offset < size && (data[offset] & 0x80)) {
+            offset++;
+        }
+        offset++;
+        if (type == 0x10) {
+            const uint8_t connack[] = {0x20, 0x02, 0x00, 0x00};
+            reply(connack, sizeof(connack));
+        } else if (type == 0x30 && (data[0] & 0x06) == 0x02) {
+            size_t topicLength = (data[offset] << 8) | data[offset + 1];
+            size_t id = offset + 2 + topicLength;
+            if (id + 2 > size) {
+                return size;
+            }
+            const uint8_t puback[] = {0x40, 0x02, data[id], data[id + 1]};
+            reply(puback, sizeof(puback));
+        }
+        return size;
+    }
+
+    int available() override { return pending - position; }
+    int read() override { return position < pending ? inbound[position++] : -1; }
+    int read(uint8_t* data, size_t size) override {
+        size_t count = 0;
+        while (count < size && position < pending) {
+            data[count++] = inbound[position++];
+        }
+        return count;
+    }
+    int peek() override { return position < pending ? inbound[position] : -1; }
+    void stop() override {}
+    uint8_t connected() override { return 1; }
+    operator bool() override { return true; }
+
+private:
+    void reply(const uint8_t* data, size_t size) {
+        if (position == pending) {
+            position = pending = 0;
+        }
+        memcpy(inbound + pending, data, size);
+        pending += size;
+    }
+
+    uint8_t inbound[256];
+    size_t pending = 0;
+    size_t position = 0;
+};
+
+LoopbackClient wire;
+MQTTTransport transport(wire);
+InFlightWindow window;
+uint16_t lastPacketId = 0;
+uint32_t acknowledged = 0;
+
+// What main.cpp and SystemMonitor produce, through the same writer
+void produce(uint32_t round) {
+    char buffer[256];
+    PayloadWriter json(buffer, sizeof(buffer));
+    json.add("temperature", 21.0 + (round % 10) / 10.0, 1);
+    json.add("humidity", 45.3, 1);
+    json.add("pressure", 1013.25, 2);
+    json.add("dew_point", 9.1, 1);
+    json.add("sequence", (unsigned long)round);
+    PublishQueue::getInstance().enqueue(MQTTTopics::SENSORS, json.finish());
+
+    PublishQueue::getInstance().enqueue(MQTTTopics::STATUS, "online", true);
+
+    char state[96];
+    PayloadWriter relay(state, sizeof(state));
+    relay.add("relay_id", 1);
+    relay.add("state", (round & 1) != 0);
+    relay.add("source", "mqtt");
+    PublishQueue::getInstance().enqueue(MQTTTopics::RELAY_STATE, relay.finish(), true);
+}
+
+// MQTTManager::processQueue() at QoS 1, followed by the PUBACKs
+uint32_t drain() {
+    PublishQueue& queue = PublishQueue::getInstance();
+    PublishQueue::Message message;
+    uint32_t sent = 0;
+    while (queue.front(message)) {
+        if (++lastPacketId == 0) {
+            lastPacketId = 1;
+        }
+        if (!window.add(message.topic, message.payload, message.retained, lastPacketId)) {
+            transport.loop();
+            continue;
+        }
+        transport.publish(message.topic, message.payload, message.retained, 1, lastPacketId);
+        queue.pop(message.sequence);
+        sent++;
+    }
+    transport.loop();
+    return sent;
+}
+
+} // namespace
+
+void setup() {
+    transport.setAckCallback([](uint16_t packetId) {
+        if (window.acknowledge(packetId)) {
+            acknowledged++;
+        }
+    });
+    bool present = false;
+    transport.connect("alloc-check", nullptr, nullptr, MQTTTopics::STATUS, "offline", 1, true, false);
+    if (transport.pollConnack(present) != MQTTTransport::Handshake::ACCEPTED) {
+        printf("Loopback handshake failed\n");
+        exit(1);
+    }
+
+    // One round first, so anything set up lazily is not counted
+    produce(0);
+    uint32_t warmup = drain();
+
+    counting = true;
+    uint32_t sent = 0;
+    for (int round = 1; round <= ROUNDS; round++) {
+        produce(round);
+        sent += drain();
+    }
+    counting = false;
+
+    uint32_t expected = ROUNDS * MESSAGES_PER_ROUND;
+    printf("published %u messages, %u acknowledged, %u allocations\n", sent, acknowledged - warmup,
+           allocations.load());
+    bool ok = allocations.load() == 0 && sent == expected && acknowledged - warmup == expected &&
+              window.depth() == 0;
+    printf("%s\n", ok ? "ok" : "FAILED");
+    exit(ok ? 0 : 1);
+}
+
+void loop() {
+}
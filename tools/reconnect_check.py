@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""Host check that a broker which keeps dropping connections is not stormed.
+
+Runs the native firmware against tools/mqtt_standin.py, which closes every
+connection KILL_AFTER seconds after the CONNACK. None of those connections
+holds for MQTT_STABLE_CONNECTION, so each drop is a flap and the backoff
+keeps doubling from INITIAL_RECONNECT_DELAY up to MAX_RECONNECT_DELAY.
+Over DURATION seconds that leaves about 8 connects, and the backoff on
+/api/mqtt at 60000 ms. Before the single supervisor the same run saw 18
+connects in 55 s.
+
+  pio run -e native
+  python3 tools/reconnect_check.py [.pio/build/native/program]
+
+Uses port 1883 (MQTT_PORT) for the stand-in and 8080 for /api/mqtt, so
+nothing else may listen there. The firmware gets a scratch data directory
+with WiFi credentials and the broker set to 127.0.0.1. Exits non-zero when
+a check fails.
+"""
+
+import json
+import os
+import subprocess
+import sys
+import tempfile
+import time
+import urllib.request
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from mqtt_standin import Broker  # noqa: E402
+
+DURATION = 90
+KILL_AFTER = 2.0
+MAX_CONNECTS = 10
+MAX_RECONNECT_DELAY_MS = 60000
+
+failures = 0
+
+
+def check(condition, what):
+    global failures
+    print("%-52s %s" % (what, "ok" if condition else "FAILED"))
+    if not condition:
+        failures += 1
+
+
+def write(root, path, value):
+    path = os.path.join(root, path)
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    with open(path, "w") as f:
+        f.write(value)
+
+
+def main():
+    program = sys.argv[1] if len(sys.argv) > 1 else ".pio/build/native/program"
+    root = tempfile.mkdtemp(prefix="reconnect_check_")
+    write(root, "nvs/wifi_config/ssid", "test")
+    write(root, "nvs/wifi_config/password", "secret123")
+    write(root, "spiffs/prefs/display/mqttBroker", "127.0.0.1")
+
+    broker = Broker(kill_after=KILL_AFTER, log=lambda line: None)
+    broker.start()
+
+    log = open(os.path.join(root, "firmware.log"), "w")
+    firmware = subprocess.Popen([program], stdout=log, stderr=subprocess.STDOUT,
+                                env=dict(os.environ, NTPCLOCK_FS_ROOT=root))
+    time.sleep(DURATION)
+
+    stats = None
+    try:
+        with urllib.request.urlopen("http://127.0.0.1:8080/api/mqtt", timeout=5) as reply:
+            stats = json.load(reply)["connection"]
+    except (OSError, ValueError, KeyError) as error:
+        print("/api/mqtt: %s" % error)
+    firmware.terminate()
+    firmware.wait()
+
+    with broker.lock:
+        connects = list(broker.connects)
+    gaps = ", ".join("%.1f" % (b - a) for a, b in zip(connects, connects[1:]))
+    print("%d connects in %d s, gaps %s s" % (len(connects), DURATION, gaps or "-"))
+    if stats:
+        print("attempts=%d connects=%d flaps=%d backoff=%d ms" %
+              (stats["attempts"], stats["connects"], stats["flaps"], stats["backoff_ms"]))
+    print("firmware output in %s" % log.name)
+
+    check(len(connects) >= 2, "reconnected after a drop")
+    check(len(connects) <= MAX_CONNECTS, "no reconnect storm")
+    check(all(b - a > KILL_AFTER for a, b in zip(connects, connects[1:])), "every reconnect waited for a backoff")
+    check(stats is not None and stats["flaps"] >= len(connects) - 1, "drops counted as flaps")
+    check(stats is not None and stats["backoff_ms"] == MAX_RECONNECT_DELAY_MS, "backoff reached MAX_RECONNECT_DELAY")
+    sys.exit(0 if failures == 0 else 1)
+
+
+if __name__ == "__main__":
+    main()
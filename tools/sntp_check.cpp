@@ -0,0 +1,81 @@
+// Host check for SntpClient against the local stand-ins in sntp_standin.py.
+//
+// One sync queries the slow, fast and silent stand-ins plus a name that
+// does not resolve, and must:
+//   - pick the fast server (index 1),
+//   - report the stand-ins' +250 ms offset within 5 ms,
+//   - leave the servers' 20 ms hold time out of the round trip,
+//   - time out the silent server and the bad name instead of hanging,
+//   - never spend more than 5 ms in one loop() call.
+//
+//   python3 tools/sntp_standin.py &
+//   g++ -std=gnu++14 -O2 -DNATIVE_BUILD -DARDUINO=10819 -DESP32 -Iinclude \
+//       -Ilib/NativeHAL/src -pthread tools/sntp_check.cpp src/SntpClient.cpp \
+//       src/DnsLookup.cpp lib/NativeHAL/src/*.cpp -o sntp_check
+//   ./sntp_check
+//
+// Exits non-zero when a check fails.
+
+#include <Arduino.h>
+#include <cstdlib>
+#include "SntpClient.h"
+#include "config.h"
+
+namespace {
+
+const int64_t STANDIN_OFFSET_US = 250000;
+const int64_t OFFSET_TOLERANCE_US = 5000;
+const uint32_t HOLD_US = 20000;
+const unsigned long MAX_LOOP_US = 5000;
+
+int failures = 0;
+
+void check(bool condition, const char* what) {
+    printf("%-52s %s\n", what, condition ? "ok" : "FAILED");
+    if (!condition) {
+        failures++;
+    }
+}
+
+} // namespace
+
+void setup() {
+    SntpClient& client = SntpClient::getInstance();
+    client.begin("127.0.0.1:12301,localhost:12302,127.0.0.1:12303,no.such.host.invalid");
+
+    bool done = false;
+    bool success = false;
+    SntpSample sample = {};
+    client.onResult([&](bool ok, const SntpSample& result) {
+        success = ok;
+        sample = result;
+        done = true;
+    });
+
+    unsigned long start = millis();
+    check(client.requestSync(), "request started");
+
+    unsigned long slowestLoop = 0;
+    while (!done && millis() - start < 4 * SntpClient::MAX_SERVERS * SNTP_SERVER_TIMEOUT_MS) {
+        unsigned long before = micros();
+        client.loop();
+        slowestLoop = std::max(slowestLoop, micros() - before);
+        delay(1);
+    }
+    unsigned long elapsed = millis() - start;
+
+    printf("server=%u offset=%lld us rtt=%u us elapsed=%lu ms slowest loop=%lu us\n",
+           sample.server, (long long)sample.offsetUs, sample.rttUs, elapsed, slowestLoop);
+    check(done && success, "sync finished with a sample");
+    check(sample.server == 1, "fast server chosen");
+    check(llabs(sample.offsetUs - STANDIN_OFFSET_US) <= OFFSET_TOLERANCE_US, "offset matches the stand-ins");
+    check(sample.rttUs < HOLD_US, "server hold time left out of the round trip");
+    check(elapsed <= (SntpClient::MAX_SERVERS + 1) * SNTP_SERVER_TIMEOUT_MS, "silent server and bad name timed out");
+    check(!client.isBusy(), "client idle afterwards");
+    check(slowestLoop <= MAX_LOOP_US, "loop() never blocks");
+
+    exit(failures == 0 ? 0 : 1);
+}
+
+void loop() {
+}
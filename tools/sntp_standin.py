@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+"""Local NTP stand-in servers for tools/sntp_check.cpp.
+
+Starts three servers on 127.0.0.1, all running SKEW seconds ahead of the
+host clock:
+
+  12301  slow:   PATH_DELAY of simulated network delay, split evenly
+                 between the two directions
+  12302  fast:   no network delay
+  12303  silent: never answers
+
+Both answering servers hold each request for HOLD seconds between their
+receive and transmit timestamps. A correct client leaves that out of the
+round trip, and prefers the fast server.
+
+  python3 tools/sntp_standin.py [base_port]
+"""
+
+import socket
+import struct
+import sys
+import threading
+import time
+
+NTP_EPOCH = 2208988800
+SKEW = 0.25
+HOLD = 0.02
+PATH_DELAY = 0.06
+
+
+def timestamp(t):
+    t += NTP_EPOCH + SKEW
+    seconds = int(t)
+    return struct.pack("!II", seconds, int((t - seconds) * 2**32))
+
+
+def serve(port, path_delay, answer):
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind(("127.0.0.1", port))
+    while True:
+        data, addr = sock.recvfrom(512)
+        if not answer or len(data) < 48:
+            continue
+        time.sleep(path_delay / 2)
+        received = time.time()
+        time.sleep(HOLD)
+        # LI 0, version 4, mode 4 (server), stratum 2; originate echoes the
+        # client's transmit timestamp
+        header = bytes([0x24, 2, 6, 0xEC]) + b"\0" * 8 + b"LOCL"
+        reply = header + timestamp(received) + data[40:48] + timestamp(received) + timestamp(time.time())
+        time.sleep(path_delay / 2)
+        sock.sendto(reply, addr)
+
+
+def main():
+    base = int(sys.argv[1]) if len(sys.argv) > 1 else 12301
+    servers = [(base, PATH_DELAY, True), (base + 1, 0.0, True), (base + 2, 0.0, False)]
+    for port, path_delay, answer in servers:
+        threading.Thread(target=serve, args=(port, path_delay, answer), daemon=True).start()
+    print("NTP stand-ins on ports %d (slow), %d (fast), %d (silent)" % (base, base + 1, base + 2), flush=True)
+    while True:
+        time.sleep(3600)
+
+
+if __name__ == "__main__":
+    main()